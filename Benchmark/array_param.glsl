@@ -0,0 +1,17 @@
+float lookup(float tab[64], int i)
+{
+  return tab[i - (i / 64) * 64];
+}
+
+float arrayparam(int n)
+{
+  float tab[64];
+  int i;
+  float s;
+  for ( i = 0; i < 64; i++ )
+    tab[i] = float(i) * 0.5;
+  s = 0.0;
+  for ( i = 0; i < n; i++ )
+    s = s + lookup(tab, i);
+  return s;
+}
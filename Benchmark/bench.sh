@@ -0,0 +1,69 @@
+#!/bin/bash
+
+# Times the compiler and the generated code on every benchmark shader.
+# Running './bench.sh' will not rebuild your project, but './bench.sh .' will
+# Set RUNS to change how many times each shader is executed (default 20).
+
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELL='\033[0;33m' 
+NC='\033[0m' # Default Color
+
+RUNS=${RUNS:-20}
+
+dir=$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )
+cd $dir  # This should allow you to call this script from anywhere
+
+# If glc is missing or argument is specified, rebuild project
+if [ ! -f ../glc ] || [ $# -eq 1 ]; then
+  printf "$YELL Rebuilding project...\n $NC"
+  (cd .. && make clean && make -j8)
+fi
+
+if [ ! -f ../glc ]; then
+  printf "$RED Unable to make project\n $NC"
+  exit 1
+fi
+
+rm *.bc 2> /dev/null
+
+function now {
+        date +%s%N
+}
+
+function runBench {
+        glsl=$1
+        fbname=${glsl%%.*}
+        bc=${fbname}.bc
+
+        entry=""
+        [ -f ${fbname}.dat ] && entry="-fdat=${fbname}.dat"
+
+        start=$(now)
+        ../glc $GLCFLAGS $entry < $glsl > $bc 2> /dev/null
+        if [ $? -ne 0 ]; then 
+                printf "$YELL%-24s glc exited with error status\n$NC" $fbname
+                return
+        fi
+        compile=$(( ($(now) - start) / 1000 ))
+
+        start=$(now)
+        for (( i = 0; i < $RUNS; i++ )); do
+                ../gli $bc &> /dev/null
+        done
+        run=$(( ($(now) - start) / 1000 / $RUNS ))
+
+        insts="-"
+        if which llvm-dis &> /dev/null; then
+                insts=$(llvm-dis < $bc | grep -c "^  [%a-z]")
+        fi
+
+        printf "%-24s compile %8d us   run %8d us   insts %6s\n" $fbname $compile $run $insts
+}
+
+printf "${NC}%-24s (GLCFLAGS='%s', %d runs)\n" "benchmark" "$GLCFLAGS" $RUNS
+for glsl in ${BENCH:-*.glsl}; do
+    runBench $glsl
+done
+
+printf $NC
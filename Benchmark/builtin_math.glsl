@@ -0,0 +1,16 @@
+vec4 a;
+vec4 b;
+
+float builtinmath(int n)
+{
+  int i;
+  float acc;
+  vec4 p;
+  acc = 0.0;
+  p = a;
+  for ( i = 0; i < n; i++ ) {
+    p = normalize(mix(p, b, 0.5));
+    acc = acc + clamp(dot(p, b), 0.0, 1.0) + sqrt(abs(p.x));
+  }
+  return acc;
+}
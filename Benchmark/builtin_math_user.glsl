@@ -0,0 +1,47 @@
+vec4 a;
+vec4 b;
+
+float mydot(vec4 x, vec4 y)
+{
+  return x.x * y.x + x.y * y.y + x.z * y.z + x.w * y.w;
+}
+
+float myclamp(float x, float lo, float hi)
+{
+  if ( x < lo )
+    return lo;
+  if ( x > hi )
+    return hi;
+  return x;
+}
+
+float mysqrt(float x)
+{
+  int k;
+  float g;
+  g = x;
+  if ( g < 1.0 )
+    g = 1.0;
+  for ( k = 0; k < 8; k++ )
+    g = 0.5 * (g + x / g);
+  return g;
+}
+
+float builtinmath(int n)
+{
+  int i;
+  float acc;
+  float d;
+  vec4 p;
+  acc = 0.0;
+  p = a;
+  for ( i = 0; i < n; i++ ) {
+    p = p + (b - p) * 0.5;
+    p = p / mysqrt(mydot(p, p));
+    d = p.x;
+    if ( d < 0.0 )
+      d = 0.0 - d;
+    acc = acc + myclamp(mydot(p, b), 0.0, 1.0) + mysqrt(d);
+  }
+  return acc;
+}
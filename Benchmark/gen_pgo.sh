@@ -0,0 +1,18 @@
+#!/bin/bash
+
+# Writes pgo_branch.txt, per-invocation input for the pgo_branch benchmark.
+# The inputs are skewed: most records take the switch's default, which
+# comes last in the source, and few enough reach the if's heavy arm that
+# a static guess gets both branches wrong.
+# Usage: ./gen_pgo.sh [records] [common percent]   (default 1000000 95)
+
+dir=$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )
+cd $dir
+
+awk -v n=${1:-1000000} -v p=${2:-95} 'BEGIN {
+    srand(1)
+    for (i = 0; i < n; i++) {
+        op = rand() * 100 < p ? 7 : int(rand() * 7)
+        printf "%d %.4f\n", op, rand()
+    }
+}' > pgo_branch.txt
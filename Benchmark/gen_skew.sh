@@ -0,0 +1,15 @@
+#!/bin/bash
+
+# Writes skew.txt, per-invocation input for the skew benchmark in which the
+# first few percent of the records loop 200x longer than the rest, so a
+# static split leaves most workers idle at the end of a batch.
+# Usage: ./gen_skew.sh [records] [heavy percent]   (default 1000000 5)
+
+dir=$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )
+cd $dir
+
+awk -v n=${1:-1000000} -v p=${2:-5} 'BEGIN {
+    heavy = int(n * p / 100)
+    for (i = 0; i < n; i++)
+        print (i < heavy ? 2000 : 10), 1.0
+}' > skew.txt
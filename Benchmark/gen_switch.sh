@@ -0,0 +1,40 @@
+#!/bin/bash
+
+# Regenerates the switch_<N>.glsl/.dat benchmarks. Each shader walks every
+# case of two N-way switches: one whose arms only pick a value (lowered to a
+# lookup table) and one whose arms do work (lowered to an LLVM switch).
+# Usage: ./gen_switch.sh [N ...]   (default 10 100 1000)
+
+dir=$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )
+cd $dir
+
+for n in ${@:-10 100 1000}; do
+    out=switch_$n.glsl
+    {
+        echo "float switch$n(int n)"
+        echo "{"
+        echo "  int i;"
+        echo "  int k;"
+        echo "  float w;"
+        echo "  float acc;"
+        echo "  acc = 0.0;"
+        echo "  for ( i = 0; i < n; i++ ) {"
+        echo "    k = i - (i / $n) * $n;"
+        echo "    switch ( k ) {"
+        for (( j = 0; j < n; j++ )); do
+            echo "      case $j: w = $(( j % 9 )).5; break;"
+        done
+        echo "      default: w = 0.0; break;"
+        echo "    }"
+        echo "    switch ( k ) {"
+        for (( j = 0; j < n; j++ )); do
+            echo "      case $j: acc = acc + w * 0.$(( j % 7 + 1 )); break;"
+        done
+        echo "      default: acc = acc - 1.0; break;"
+        echo "    }"
+        echo "  }"
+        echo "  return acc;"
+        echo "}"
+    } > $out
+    printf "funct: switch$n\nparam: int, 100000\n" > switch_$n.dat
+done
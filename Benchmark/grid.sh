@@ -0,0 +1,30 @@
+#!/bin/bash
+
+# Shades a framebuffer with a per-pixel benchmark shader under glc-exec at
+# several tile sizes, reporting megapixels/s from one thread up to every
+# core. Set SIZE to the framebuffer (default 2048x2048), TILES to the tile
+# edges to try (default "8 16 32 64 128 2048"), LANES to the lane width and
+# GLCFLAGS as for bench.sh. The last run's image is left in <shader>.ppm.
+# Usage: ./grid.sh [shader]   (default grid_rings)
+
+RED='\033[0;31m'
+NC='\033[0m' # Default Color
+
+SIZE=${SIZE:-2048x2048}
+TILES=${TILES:-8 16 32 64 128 2048}
+LANES=${LANES:-1}
+name=${1:-grid_rings}
+
+dir=$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )
+cd $dir  # This should allow you to call this script from anywhere
+
+if [ ! -f ../glc-exec ]; then
+  printf "$RED Build glc-exec first\n $NC"
+  exit 1
+fi
+
+../glc $GLCFLAGS -flanes=$LANES -fdat=$name.dat < $name.glsl > $name.bc || exit 1
+for tile in $TILES; do
+        ../glc-exec -fgrid=$SIZE -ftile=$tile -flanes=$LANES -fscale -frepeat=3 -fimage=$name.ppm $name.bc
+        echo
+done
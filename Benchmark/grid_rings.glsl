@@ -0,0 +1,14 @@
+float scale;
+
+vec4 rings(vec2 centre, vec3 tint)
+{
+  vec2 p;
+  float d;
+  float r;
+  p = (gl_FragCoord.xy - centre) * scale;
+  d = length(p);
+  r = 0.5 + 0.5 * sin(d);
+  if ( d > 40.0 )
+    r = r * 0.25;
+  return vec4(tint * r, 1.0);
+}
@@ -0,0 +1,25 @@
+float scale;
+
+float heavy(float x)
+{
+  int k;
+  float acc;
+  acc = x;
+  for ( k = 0; k < 64; k++ )
+    acc = acc * scale + 1.0;
+  return acc;
+}
+
+float guardcall(int n)
+{
+  int i;
+  float sum;
+  sum = 0.0;
+  for ( i = 0; i < n; i++ ) {
+    if ( i > n - 8 && heavy(sum) > 0.0 )
+      sum = sum + 1.0;
+    if ( i < 8 || heavy(sum) < 0.0 )
+      sum = sum + 0.5;
+  }
+  return sum;
+}
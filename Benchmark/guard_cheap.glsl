@@ -0,0 +1,20 @@
+vec2 lo;
+vec2 hi;
+
+int guardcheap(int n)
+{
+  int i;
+  int hits;
+  float x;
+  float y;
+  hits = 0;
+  x = 0.0;
+  y = 0.0;
+  for ( i = 0; i < n; i++ ) {
+    x = x + 0.25;
+    y = y + 0.5;
+    if ( x > lo.x && x < hi.x && y > lo.y && y < hi.y )
+      hits = hits + 1;
+  }
+  return hits;
+}
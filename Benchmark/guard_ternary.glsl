@@ -0,0 +1,25 @@
+float bias;
+
+float slow(float x)
+{
+  int k;
+  float acc;
+  acc = x;
+  for ( k = 0; k < 64; k++ )
+    acc = acc * 0.5 + bias;
+  return acc;
+}
+
+float guardternary(int n)
+{
+  int i;
+  float sum;
+  float f;
+  sum = 0.0;
+  for ( i = 0; i < n; i++ ) {
+    f = sum * 0.5;
+    sum = sum + (i == 0 ? slow(f) : f);
+    sum = sum + (i > 0 ? 1.0 : 2.0);
+  }
+  return sum;
+}
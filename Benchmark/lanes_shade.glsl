@@ -0,0 +1,14 @@
+float falloff;
+
+float shade(float x, float y)
+{
+  float d;
+  float k;
+  d = x * x + y * y;
+  if ( d < 1.0 ) {
+    k = 1.0 - d * falloff;
+    return k * k * (3.0 - 2.0 * k);
+  }
+  else
+    return 0.0;
+}
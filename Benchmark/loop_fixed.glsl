@@ -0,0 +1,17 @@
+float loopfixed(int n)
+{
+  int i;
+  int j;
+  float x;
+  float p;
+  float acc;
+  acc = 0.0;
+  for ( i = 0; i < n; i++ ) {
+    x = float(i) * 0.0001;
+    p = 0.0;
+    for ( j = 0; j < 8; j++ )
+      p = p * x + float(j) * 0.5;
+    acc = acc + p;
+  }
+  return acc;
+}
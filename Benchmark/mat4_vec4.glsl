@@ -0,0 +1,17 @@
+vec4 c0;
+vec4 c1;
+vec4 c2;
+vec4 c3;
+vec4 v;
+
+float matvec4(int n)
+{
+  int i;
+  mat4 m;
+  vec4 r;
+  m = mat4(c0, c1, c2, c3);
+  r = v;
+  for ( i = 0; i < n; i++ )
+    r = m * r;
+  return r.x + r.y + r.z + r.w;
+}
@@ -0,0 +1,31 @@
+vec4 c0;
+vec4 c1;
+vec4 c2;
+vec4 c3;
+vec4 v;
+
+float matvec4(int n)
+{
+  int i;
+  float x;
+  float y;
+  float z;
+  float w;
+  float tx;
+  float ty;
+  float tz;
+  x = v.x;
+  y = v.y;
+  z = v.z;
+  w = v.w;
+  for ( i = 0; i < n; i++ ) {
+    tx = c0.x * x + c1.x * y + c2.x * z + c3.x * w;
+    ty = c0.y * x + c1.y * y + c2.y * z + c3.y * w;
+    tz = c0.z * x + c1.z * y + c2.z * z + c3.z * w;
+    w = c0.w * x + c1.w * y + c2.w * z + c3.w * w;
+    x = tx;
+    y = ty;
+    z = tz;
+  }
+  return x + y + z + w;
+}
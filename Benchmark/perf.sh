@@ -0,0 +1,31 @@
+#!/bin/bash
+
+# Samples glc-exec with Linux perf while it runs a benchmark shader N times
+# (default 1000000) and reports the hottest symbols; with -fperf-map the
+# JIT-compiled shader functions show up by name.
+# Usage: ./perf.sh [shader]   (default builtin_math_user)
+
+RED='\033[0;31m'
+NC='\033[0m' # Default Color
+
+N=${N:-1000000}
+name=${1:-builtin_math_user}
+
+dir=$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )
+cd $dir  # This should allow you to call this script from anywhere
+
+if [ ! -f ../glc-exec ]; then
+  printf "$RED Build glc-exec first\n $NC"
+  exit 1
+fi
+if ! command -v perf > /dev/null; then
+  printf "$RED perf is not installed\n $NC"
+  exit 1
+fi
+
+tmp=$(mktemp -d)
+trap "rm -rf $tmp" EXIT
+
+../glc $GLCFLAGS -fdat=$name.dat < $name.glsl > $tmp/$name.bc || exit 1
+perf record -q -o $tmp/perf.data ../glc-exec -fperf-map -fdat=$name.dat -fn=$N -frepeat=3 $tmp/$name.bc || exit 1
+perf report -i $tmp/perf.data --stdio --sort sym 2>/dev/null | grep -v '^#' | grep -v '^$' | head -20
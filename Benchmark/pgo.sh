@@ -0,0 +1,37 @@
+#!/bin/bash
+
+# Profile-guided branch layout: builds pgo_branch instrumented, runs it over
+# pgo_branch.txt (see gen_pgo.sh) to count its branches, rebuilds it with
+# -fprofile-use, and compares that build's throughput with the plain one.
+# Usage: ./pgo.sh [shader]   (default pgo_branch)
+
+RED='\033[0;31m'
+NC='\033[0m' # Default Color
+
+name=${1:-pgo_branch}
+
+dir=$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )
+cd $dir  # This should allow you to call this script from anywhere
+
+if [ ! -f ../glc-exec ]; then
+  printf "$RED Build glc-exec first\n $NC"
+  exit 1
+fi
+[ -f $name.txt ] || ./gen_pgo.sh
+
+tmp=$(mktemp -d)
+trap "rm -rf $tmp" EXIT
+
+../glc $GLCFLAGS -finstrument -fdat=$name.dat < $name.glsl > $tmp/prof.bc || exit 1
+../glc-exec -fdat=$name.dat -finput=$name.txt -fprofile-report=/dev/null \
+    -fprofile-out=$tmp/$name.prof $tmp/prof.bc > /dev/null || exit 1
+echo "branch counts:"
+cat $tmp/$name.prof
+echo
+
+../glc $GLCFLAGS -fdat=$name.dat < $name.glsl > $tmp/plain.bc || exit 1
+../glc $GLCFLAGS -fprofile-use=$tmp/$name.prof -fdat=$name.dat < $name.glsl > $tmp/pgo.bc || exit 1
+echo "plain:"
+../glc-exec -fdat=$name.dat -finput=$name.txt -frepeat=5 $tmp/plain.bc
+echo "profile-guided:"
+../glc-exec -fdat=$name.dat -finput=$name.txt -frepeat=5 $tmp/pgo.bc
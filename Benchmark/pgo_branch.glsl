@@ -0,0 +1,25 @@
+float pgo(int op, float x)
+{
+  int i;
+  float acc;
+  acc = x;
+  for ( i = 0; i < 16; i++ ) {
+    switch ( op ) {
+      case 0: acc = acc * 1.5 - 0.25; break;
+      case 1: acc = acc * 0.5 + 0.75; break;
+      case 2: acc = sqrt(acc * acc + 1.0); break;
+      case 3: acc = acc - floor(acc); break;
+      case 4: acc = abs(acc - 0.5); break;
+      case 5: acc = acc * acc * 0.5; break;
+      case 6: acc = min(acc, 0.75) + 0.125; break;
+      default: acc = acc * 0.999 + 0.001; break;
+    }
+    if ( acc > 2.0 ) {
+      acc = sqrt(acc) + sin(acc) * cos(acc);
+    }
+    else {
+      acc = acc + 0.0625;
+    }
+  }
+  return acc;
+}
@@ -0,0 +1,32 @@
+#!/bin/bash
+
+# Cost of glc -finstrument: runs a benchmark shader N times (default 1000)
+# built plainly and instrumented, then prints the instrumented build's flat
+# profile and call graph.
+# Usage: ./profile.sh [shader]   (default builtin_math_user)
+
+RED='\033[0;31m'
+NC='\033[0m' # Default Color
+
+N=${N:-1000}
+name=${1:-builtin_math_user}
+
+dir=$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )
+cd $dir  # This should allow you to call this script from anywhere
+
+if [ ! -f ../glc-exec ]; then
+  printf "$RED Build glc-exec first\n $NC"
+  exit 1
+fi
+
+tmp=$(mktemp -d)
+trap "rm -rf $tmp" EXIT
+
+../glc $GLCFLAGS -fdat=$name.dat < $name.glsl > $tmp/plain.bc || exit 1
+../glc $GLCFLAGS -finstrument -fdat=$name.dat < $name.glsl > $tmp/prof.bc || exit 1
+echo "plain:"
+../glc-exec -fdat=$name.dat -fn=$N -frepeat=3 $tmp/plain.bc
+echo "instrumented:"
+../glc-exec -fdat=$name.dat -fn=$N -frepeat=3 -fprofile-report=$tmp/report.txt $tmp/prof.bc
+echo
+cat $tmp/report.txt
@@ -0,0 +1,40 @@
+#!/bin/bash
+
+# Hot reload under glc-exec: runs a copy of a benchmark shader over N
+# invocations per batch (default 1000000) while watching it. After a few
+# seconds the copy is replaced by the edited shader given (by default
+# lanes_shade with one more multiply), and later made not to compile. The
+# report shows the reload's compile latency and the throughput before and
+# after; the broken version is never swapped in.
+# Usage: ./reload.sh [shader] [edited shader]   (default lanes_shade)
+
+RED='\033[0;31m'
+NC='\033[0m' # Default Color
+
+N=${N:-1000000}
+name=${1:-lanes_shade}
+
+dir=$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )
+cd $dir  # This should allow you to call this script from anywhere
+
+if [ ! -f ../glc-exec ]; then
+  printf "$RED Build glc-exec first\n $NC"
+  exit 1
+fi
+
+tmp=$(mktemp -d)
+trap "rm -rf $tmp" EXIT
+
+cp $name.glsl $tmp/$name.glsl
+../glc $GLCFLAGS -fdat=$name.dat < $name.glsl > $tmp/$name.bc || exit 1
+../glc-exec -fdat=$name.dat -fn=$N -fwatch=$tmp/$name.glsl -fglc-flags="$GLCFLAGS" -fduration=9 $tmp/$name.bc &
+sleep 3
+if [ -n "$2" ]; then
+        cp $2 $tmp/$name.glsl
+else
+        # same function, one more multiply per invocation
+        sed 's/return k \* k/return k * k * k/' $name.glsl > $tmp/$name.glsl
+fi
+sleep 3
+echo "this is not glsl" >> $tmp/$name.glsl
+wait
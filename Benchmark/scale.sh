@@ -0,0 +1,51 @@
+#!/bin/bash
+
+# Throughput of every benchmark shader under glc-exec, from one thread up to
+# every core. Set N to change the number of invocations (default 1000000),
+# CHUNK the invocations handed to a worker at a time, LANES the lane width
+# (4, 8 or 16), SCHED the scheduler (steal or static) and GLCFLAGS as for
+# bench.sh. A shader with a <name>.txt beside it takes its per-invocation
+# arguments from that file (see gen_skew.sh). Shaders that read
+# gl_FragCoord shade a grid instead (see grid.sh).
+# Running './scale.sh .' rebuilds the project first.
+
+RED='\033[0;31m'
+YELL='\033[0;33m' 
+NC='\033[0m' # Default Color
+
+N=${N:-1000000}
+CHUNK=${CHUNK:-4096}
+LANES=${LANES:-1}
+SCHED=${SCHED:-steal}
+
+dir=$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )
+cd $dir  # This should allow you to call this script from anywhere
+
+if [ ! -f ../glc-exec ] || [ $# -eq 1 ]; then
+  printf "$YELL Rebuilding project...\n $NC"
+  (cd .. && make clean && make -j8)
+fi
+
+if [ ! -f ../glc-exec ]; then
+  printf "$RED Unable to make project\n $NC"
+  exit 1
+fi
+
+rm *.bc 2> /dev/null
+
+for glsl in ${BENCH:-*.glsl}; do
+        fbname=${glsl%%.*}
+        [ -f ${fbname}.dat ] || continue
+        grep -q gl_FragCoord $glsl && continue
+        ../glc $GLCFLAGS -flanes=$LANES -fdat=${fbname}.dat < $glsl > ${fbname}.bc 2> /dev/null
+        if [ $? -ne 0 ]; then 
+                printf "$YELL%-24s glc exited with error status\n$NC" $fbname
+                continue
+        fi
+        input=""
+        [ -f ${fbname}.txt ] && input="-finput=${fbname}.txt"
+        ../glc-exec -fn=$N $input -fchunk=$CHUNK -flanes=$LANES -fsched=$SCHED -fscale -frepeat=3 ${fbname}.bc
+        echo
+done
+
+printf $NC
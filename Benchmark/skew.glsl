@@ -0,0 +1,12 @@
+float skew(int n, float x)
+{
+  int i;
+  float acc;
+  acc = x;
+  i = 0;
+  while ( i < n ) {
+    acc = acc * 0.999 + 0.5;
+    i++;
+  }
+  return acc;
+}
@@ -0,0 +1,39 @@
+#!/bin/bash
+
+# Compares streaming execution with in-memory execution on one benchmark.
+# The .dat invocation is repeated N times (default 4000000) into a column
+# file and a column stream; glc-exec then runs the file in memory and the
+# stream from a pipe in blocks of BLOCK rows (default 65536).
+# Usage: ./stream.sh [shader]   (default lanes_shade)
+
+RED='\033[0;31m'
+NC='\033[0m' # Default Color
+
+N=${N:-4000000}
+BLOCK=${BLOCK:-65536}
+name=${1:-lanes_shade}
+
+dir=$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )
+cd $dir  # This should allow you to call this script from anywhere
+
+if [ ! -f ../glc-exec ] || [ ! -f ../glc-dat2col ]; then
+  printf "$RED Build glc-exec and glc-dat2col first\n $NC"
+  exit 1
+fi
+
+tmp=$(mktemp -d)
+trap "rm -rf $tmp" EXIT
+
+../glc $GLCFLAGS -fdat=$name.dat < $name.glsl > $tmp/$name.bc || exit 1
+# one record per invocation: the .dat arguments, flattened
+args=$(sed -n 's/^ *param: *[A-Za-z0-9_]* *,//p' $name.dat | tr ',\n' '  ')
+awk -v n=$N -v r="$args" 'BEGIN { for (i = 0; i < n; i++) print r }' > $tmp/records.txt
+../glc-dat2col $name.dat $tmp/$name.col $tmp/records.txt || exit 1
+../glc-dat2col -s $name.dat $tmp/$name.stm $tmp/records.txt || exit 1
+
+echo "in memory:"
+../glc-exec -fdat=$name.dat -fcolumns=$tmp/$name.col -fresult=$tmp/out.col $tmp/$name.bc
+echo "streamed, binary:"
+cat $tmp/$name.stm | ../glc-exec -fdat=$name.dat -fstream -fblock=$BLOCK -fresult=$tmp/out.stm $tmp/$name.bc
+echo "streamed, text:"
+../glc-exec -fdat=$name.dat -fstream=$tmp/records.txt -fblock=$BLOCK -foutput=/dev/null $tmp/$name.bc
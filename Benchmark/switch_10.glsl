@@ -0,0 +1,38 @@
+float switch10(int n)
+{
+  int i;
+  int k;
+  float w;
+  float acc;
+  acc = 0.0;
+  for ( i = 0; i < n; i++ ) {
+    k = i - (i / 10) * 10;
+    switch ( k ) {
+      case 0: w = 0.5; break;
+      case 1: w = 1.5; break;
+      case 2: w = 2.5; break;
+      case 3: w = 3.5; break;
+      case 4: w = 4.5; break;
+      case 5: w = 5.5; break;
+      case 6: w = 6.5; break;
+      case 7: w = 7.5; break;
+      case 8: w = 8.5; break;
+      case 9: w = 0.5; break;
+      default: w = 0.0; break;
+    }
+    switch ( k ) {
+      case 0: acc = acc + w * 0.1; break;
+      case 1: acc = acc + w * 0.2; break;
+      case 2: acc = acc + w * 0.3; break;
+      case 3: acc = acc + w * 0.4; break;
+      case 4: acc = acc + w * 0.5; break;
+      case 5: acc = acc + w * 0.6; break;
+      case 6: acc = acc + w * 0.7; break;
+      case 7: acc = acc + w * 0.1; break;
+      case 8: acc = acc + w * 0.2; break;
+      case 9: acc = acc + w * 0.3; break;
+      default: acc = acc - 1.0; break;
+    }
+  }
+  return acc;
+}
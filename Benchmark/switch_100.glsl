@@ -0,0 +1,218 @@
+float switch100(int n)
+{
+  int i;
+  int k;
+  float w;
+  float acc;
+  acc = 0.0;
+  for ( i = 0; i < n; i++ ) {
+    k = i - (i / 100) * 100;
+    switch ( k ) {
+      case 0: w = 0.5; break;
+      case 1: w = 1.5; break;
+      case 2: w = 2.5; break;
+      case 3: w = 3.5; break;
+      case 4: w = 4.5; break;
+      case 5: w = 5.5; break;
+      case 6: w = 6.5; break;
+      case 7: w = 7.5; break;
+      case 8: w = 8.5; break;
+      case 9: w = 0.5; break;
+      case 10: w = 1.5; break;
+      case 11: w = 2.5; break;
+      case 12: w = 3.5; break;
+      case 13: w = 4.5; break;
+      case 14: w = 5.5; break;
+      case 15: w = 6.5; break;
+      case 16: w = 7.5; break;
+      case 17: w = 8.5; break;
+      case 18: w = 0.5; break;
+      case 19: w = 1.5; break;
+      case 20: w = 2.5; break;
+      case 21: w = 3.5; break;
+      case 22: w = 4.5; break;
+      case 23: w = 5.5; break;
+      case 24: w = 6.5; break;
+      case 25: w = 7.5; break;
+      case 26: w = 8.5; break;
+      case 27: w = 0.5; break;
+      case 28: w = 1.5; break;
+      case 29: w = 2.5; break;
+      case 30: w = 3.5; break;
+      case 31: w = 4.5; break;
+      case 32: w = 5.5; break;
+      case 33: w = 6.5; break;
+      case 34: w = 7.5; break;
+      case 35: w = 8.5; break;
+      case 36: w = 0.5; break;
+      case 37: w = 1.5; break;
+      case 38: w = 2.5; break;
+      case 39: w = 3.5; break;
+      case 40: w = 4.5; break;
+      case 41: w = 5.5; break;
+      case 42: w = 6.5; break;
+      case 43: w = 7.5; break;
+      case 44: w = 8.5; break;
+      case 45: w = 0.5; break;
+      case 46: w = 1.5; break;
+      case 47: w = 2.5; break;
+      case 48: w = 3.5; break;
+      case 49: w = 4.5; break;
+      case 50: w = 5.5; break;
+      case 51: w = 6.5; break;
+      case 52: w = 7.5; break;
+      case 53: w = 8.5; break;
+      case 54: w = 0.5; break;
+      case 55: w = 1.5; break;
+      case 56: w = 2.5; break;
+      case 57: w = 3.5; break;
+      case 58: w = 4.5; break;
+      case 59: w = 5.5; break;
+      case 60: w = 6.5; break;
+      case 61: w = 7.5; break;
+      case 62: w = 8.5; break;
+      case 63: w = 0.5; break;
+      case 64: w = 1.5; break;
+      case 65: w = 2.5; break;
+      case 66: w = 3.5; break;
+      case 67: w = 4.5; break;
+      case 68: w = 5.5; break;
+      case 69: w = 6.5; break;
+      case 70: w = 7.5; break;
+      case 71: w = 8.5; break;
+      case 72: w = 0.5; break;
+      case 73: w = 1.5; break;
+      case 74: w = 2.5; break;
+      case 75: w = 3.5; break;
+      case 76: w = 4.5; break;
+      case 77: w = 5.5; break;
+      case 78: w = 6.5; break;
+      case 79: w = 7.5; break;
+      case 80: w = 8.5; break;
+      case 81: w = 0.5; break;
+      case 82: w = 1.5; break;
+      case 83: w = 2.5; break;
+      case 84: w = 3.5; break;
+      case 85: w = 4.5; break;
+      case 86: w = 5.5; break;
+      case 87: w = 6.5; break;
+      case 88: w = 7.5; break;
+      case 89: w = 8.5; break;
+      case 90: w = 0.5; break;
+      case 91: w = 1.5; break;
+      case 92: w = 2.5; break;
+      case 93: w = 3.5; break;
+      case 94: w = 4.5; break;
+      case 95: w = 5.5; break;
+      case 96: w = 6.5; break;
+      case 97: w = 7.5; break;
+      case 98: w = 8.5; break;
+      case 99: w = 0.5; break;
+      default: w = 0.0; break;
+    }
+    switch ( k ) {
+      case 0: acc = acc + w * 0.1; break;
+      case 1: acc = acc + w * 0.2; break;
+      case 2: acc = acc + w * 0.3; break;
+      case 3: acc = acc + w * 0.4; break;
+      case 4: acc = acc + w * 0.5; break;
+      case 5: acc = acc + w * 0.6; break;
+      case 6: acc = acc + w * 0.7; break;
+      case 7: acc = acc + w * 0.1; break;
+      case 8: acc = acc + w * 0.2; break;
+      case 9: acc = acc + w * 0.3; break;
+      case 10: acc = acc + w * 0.4; break;
+      case 11: acc = acc + w * 0.5; break;
+      case 12: acc = acc + w * 0.6; break;
+      case 13: acc = acc + w * 0.7; break;
+      case 14: acc = acc + w * 0.1; break;
+      case 15: acc = acc + w * 0.2; break;
+      case 16: acc = acc + w * 0.3; break;
+      case 17: acc = acc + w * 0.4; break;
+      case 18: acc = acc + w * 0.5; break;
+      case 19: acc = acc + w * 0.6; break;
+      case 20: acc = acc + w * 0.7; break;
+      case 21: acc = acc + w * 0.1; break;
+      case 22: acc = acc + w * 0.2; break;
+      case 23: acc = acc + w * 0.3; break;
+      case 24: acc = acc + w * 0.4; break;
+      case 25: acc = acc + w * 0.5; break;
+      case 26: acc = acc + w * 0.6; break;
+      case 27: acc = acc + w * 0.7; break;
+      case 28: acc = acc + w * 0.1; break;
+      case 29: acc = acc + w * 0.2; break;
+      case 30: acc = acc + w * 0.3; break;
+      case 31: acc = acc + w * 0.4; break;
+      case 32: acc = acc + w * 0.5; break;
+      case 33: acc = acc + w * 0.6; break;
+      case 34: acc = acc + w * 0.7; break;
+      case 35: acc = acc + w * 0.1; break;
+      case 36: acc = acc + w * 0.2; break;
+      case 37: acc = acc + w * 0.3; break;
+      case 38: acc = acc + w * 0.4; break;
+      case 39: acc = acc + w * 0.5; break;
+      case 40: acc = acc + w * 0.6; break;
+      case 41: acc = acc + w * 0.7; break;
+      case 42: acc = acc + w * 0.1; break;
+      case 43: acc = acc + w * 0.2; break;
+      case 44: acc = acc + w * 0.3; break;
+      case 45: acc = acc + w * 0.4; break;
+      case 46: acc = acc + w * 0.5; break;
+      case 47: acc = acc + w * 0.6; break;
+      case 48: acc = acc + w * 0.7; break;
+      case 49: acc = acc + w * 0.1; break;
+      case 50: acc = acc + w * 0.2; break;
+      case 51: acc = acc + w * 0.3; break;
+      case 52: acc = acc + w * 0.4; break;
+      case 53: acc = acc + w * 0.5; break;
+      case 54: acc = acc + w * 0.6; break;
+      case 55: acc = acc + w * 0.7; break;
+      case 56: acc = acc + w * 0.1; break;
+      case 57: acc = acc + w * 0.2; break;
+      case 58: acc = acc + w * 0.3; break;
+      case 59: acc = acc + w * 0.4; break;
+      case 60: acc = acc + w * 0.5; break;
+      case 61: acc = acc + w * 0.6; break;
+      case 62: acc = acc + w * 0.7; break;
+      case 63: acc = acc + w * 0.1; break;
+      case 64: acc = acc + w * 0.2; break;
+      case 65: acc = acc + w * 0.3; break;
+      case 66: acc = acc + w * 0.4; break;
+      case 67: acc = acc + w * 0.5; break;
+      case 68: acc = acc + w * 0.6; break;
+      case 69: acc = acc + w * 0.7; break;
+      case 70: acc = acc + w * 0.1; break;
+      case 71: acc = acc + w * 0.2; break;
+      case 72: acc = acc + w * 0.3; break;
+      case 73: acc = acc + w * 0.4; break;
+      case 74: acc = acc + w * 0.5; break;
+      case 75: acc = acc + w * 0.6; break;
+      case 76: acc = acc + w * 0.7; break;
+      case 77: acc = acc + w * 0.1; break;
+      case 78: acc = acc + w * 0.2; break;
+      case 79: acc = acc + w * 0.3; break;
+      case 80: acc = acc + w * 0.4; break;
+      case 81: acc = acc + w * 0.5; break;
+      case 82: acc = acc + w * 0.6; break;
+      case 83: acc = acc + w * 0.7; break;
+      case 84: acc = acc + w * 0.1; break;
+      case 85: acc = acc + w * 0.2; break;
+      case 86: acc = acc + w * 0.3; break;
+      case 87: acc = acc + w * 0.4; break;
+      case 88: acc = acc + w * 0.5; break;
+      case 89: acc = acc + w * 0.6; break;
+      case 90: acc = acc + w * 0.7; break;
+      case 91: acc = acc + w * 0.1; break;
+      case 92: acc = acc + w * 0.2; break;
+      case 93: acc = acc + w * 0.3; break;
+      case 94: acc = acc + w * 0.4; break;
+      case 95: acc = acc + w * 0.5; break;
+      case 96: acc = acc + w * 0.6; break;
+      case 97: acc = acc + w * 0.7; break;
+      case 98: acc = acc + w * 0.1; break;
+      case 99: acc = acc + w * 0.2; break;
+      default: acc = acc - 1.0; break;
+    }
+  }
+  return acc;
+}
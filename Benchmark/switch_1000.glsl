@@ -0,0 +1,2018 @@
+float switch1000(int n)
+{
+  int i;
+  int k;
+  float w;
+  float acc;
+  acc = 0.0;
+  for ( i = 0; i < n; i++ ) {
+    k = i - (i / 1000) * 1000;
+    switch ( k ) {
+      case 0: w = 0.5; break;
+      case 1: w = 1.5; break;
+      case 2: w = 2.5; break;
+      case 3: w = 3.5; break;
+      case 4: w = 4.5; break;
+      case 5: w = 5.5; break;
+      case 6: w = 6.5; break;
+      case 7: w = 7.5; break;
+      case 8: w = 8.5; break;
+      case 9: w = 0.5; break;
+      case 10: w = 1.5; break;
+      case 11: w = 2.5; break;
+      case 12: w = 3.5; break;
+      case 13: w = 4.5; break;
+      case 14: w = 5.5; break;
+      case 15: w = 6.5; break;
+      case 16: w = 7.5; break;
+      case 17: w = 8.5; break;
+      case 18: w = 0.5; break;
+      case 19: w = 1.5; break;
+      case 20: w = 2.5; break;
+      case 21: w = 3.5; break;
+      case 22: w = 4.5; break;
+      case 23: w = 5.5; break;
+      case 24: w = 6.5; break;
+      case 25: w = 7.5; break;
+      case 26: w = 8.5; break;
+      case 27: w = 0.5; break;
+      case 28: w = 1.5; break;
+      case 29: w = 2.5; break;
+      case 30: w = 3.5; break;
+      case 31: w = 4.5; break;
+      case 32: w = 5.5; break;
+      case 33: w = 6.5; break;
+      case 34: w = 7.5; break;
+      case 35: w = 8.5; break;
+      case 36: w = 0.5; break;
+      case 37: w = 1.5; break;
+      case 38: w = 2.5; break;
+      case 39: w = 3.5; break;
+      case 40: w = 4.5; break;
+      case 41: w = 5.5; break;
+      case 42: w = 6.5; break;
+      case 43: w = 7.5; break;
+      case 44: w = 8.5; break;
+      case 45: w = 0.5; break;
+      case 46: w = 1.5; break;
+      case 47: w = 2.5; break;
+      case 48: w = 3.5; break;
+      case 49: w = 4.5; break;
+      case 50: w = 5.5; break;
+      case 51: w = 6.5; break;
+      case 52: w = 7.5; break;
+      case 53: w = 8.5; break;
+      case 54: w = 0.5; break;
+      case 55: w = 1.5; break;
+      case 56: w = 2.5; break;
+      case 57: w = 3.5; break;
+      case 58: w = 4.5; break;
+      case 59: w = 5.5; break;
+      case 60: w = 6.5; break;
+      case 61: w = 7.5; break;
+      case 62: w = 8.5; break;
+      case 63: w = 0.5; break;
+      case 64: w = 1.5; break;
+      case 65: w = 2.5; break;
+      case 66: w = 3.5; break;
+      case 67: w = 4.5; break;
+      case 68: w = 5.5; break;
+      case 69: w = 6.5; break;
+      case 70: w = 7.5; break;
+      case 71: w = 8.5; break;
+      case 72: w = 0.5; break;
+      case 73: w = 1.5; break;
+      case 74: w = 2.5; break;
+      case 75: w = 3.5; break;
+      case 76: w = 4.5; break;
+      case 77: w = 5.5; break;
+      case 78: w = 6.5; break;
+      case 79: w = 7.5; break;
+      case 80: w = 8.5; break;
+      case 81: w = 0.5; break;
+      case 82: w = 1.5; break;
+      case 83: w = 2.5; break;
+      case 84: w = 3.5; break;
+      case 85: w = 4.5; break;
+      case 86: w = 5.5; break;
+      case 87: w = 6.5; break;
+      case 88: w = 7.5; break;
+      case 89: w = 8.5; break;
+      case 90: w = 0.5; break;
+      case 91: w = 1.5; break;
+      case 92: w = 2.5; break;
+      case 93: w = 3.5; break;
+      case 94: w = 4.5; break;
+      case 95: w = 5.5; break;
+      case 96: w = 6.5; break;
+      case 97: w = 7.5; break;
+      case 98: w = 8.5; break;
+      case 99: w = 0.5; break;
+      case 100: w = 1.5; break;
+      case 101: w = 2.5; break;
+      case 102: w = 3.5; break;
+      case 103: w = 4.5; break;
+      case 104: w = 5.5; break;
+      case 105: w = 6.5; break;
+      case 106: w = 7.5; break;
+      case 107: w = 8.5; break;
+      case 108: w = 0.5; break;
+      case 109: w = 1.5; break;
+      case 110: w = 2.5; break;
+      case 111: w = 3.5; break;
+      case 112: w = 4.5; break;
+      case 113: w = 5.5; break;
+      case 114: w = 6.5; break;
+      case 115: w = 7.5; break;
+      case 116: w = 8.5; break;
+      case 117: w = 0.5; break;
+      case 118: w = 1.5; break;
+      case 119: w = 2.5; break;
+      case 120: w = 3.5; break;
+      case 121: w = 4.5; break;
+      case 122: w = 5.5; break;
+      case 123: w = 6.5; break;
+      case 124: w = 7.5; break;
+      case 125: w = 8.5; break;
+      case 126: w = 0.5; break;
+      case 127: w = 1.5; break;
+      case 128: w = 2.5; break;
+      case 129: w = 3.5; break;
+      case 130: w = 4.5; break;
+      case 131: w = 5.5; break;
+      case 132: w = 6.5; break;
+      case 133: w = 7.5; break;
+      case 134: w = 8.5; break;
+      case 135: w = 0.5; break;
+      case 136: w = 1.5; break;
+      case 137: w = 2.5; break;
+      case 138: w = 3.5; break;
+      case 139: w = 4.5; break;
+      case 140: w = 5.5; break;
+      case 141: w = 6.5; break;
+      case 142: w = 7.5; break;
+      case 143: w = 8.5; break;
+      case 144: w = 0.5; break;
+      case 145: w = 1.5; break;
+      case 146: w = 2.5; break;
+      case 147: w = 3.5; break;
+      case 148: w = 4.5; break;
+      case 149: w = 5.5; break;
+      case 150: w = 6.5; break;
+      case 151: w = 7.5; break;
+      case 152: w = 8.5; break;
+      case 153: w = 0.5; break;
+      case 154: w = 1.5; break;
+      case 155: w = 2.5; break;
+      case 156: w = 3.5; break;
+      case 157: w = 4.5; break;
+      case 158: w = 5.5; break;
+      case 159: w = 6.5; break;
+      case 160: w = 7.5; break;
+      case 161: w = 8.5; break;
+      case 162: w = 0.5; break;
+      case 163: w = 1.5; break;
+      case 164: w = 2.5; break;
+      case 165: w = 3.5; break;
+      case 166: w = 4.5; break;
+      case 167: w = 5.5; break;
+      case 168: w = 6.5; break;
+      case 169: w = 7.5; break;
+      case 170: w = 8.5; break;
+      case 171: w = 0.5; break;
+      case 172: w = 1.5; break;
+      case 173: w = 2.5; break;
+      case 174: w = 3.5; break;
+      case 175: w = 4.5; break;
+      case 176: w = 5.5; break;
+      case 177: w = 6.5; break;
+      case 178: w = 7.5; break;
+      case 179: w = 8.5; break;
+      case 180: w = 0.5; break;
+      case 181: w = 1.5; break;
+      case 182: w = 2.5; break;
+      case 183: w = 3.5; break;
+      case 184: w = 4.5; break;
+      case 185: w = 5.5; break;
+      case 186: w = 6.5; break;
+      case 187: w = 7.5; break;
+      case 188: w = 8.5; break;
+      case 189: w = 0.5; break;
+      case 190: w = 1.5; break;
+      case 191: w = 2.5; break;
+      case 192: w = 3.5; break;
+      case 193: w = 4.5; break;
+      case 194: w = 5.5; break;
+      case 195: w = 6.5; break;
+      case 196: w = 7.5; break;
+      case 197: w = 8.5; break;
+      case 198: w = 0.5; break;
+      case 199: w = 1.5; break;
+      case 200: w = 2.5; break;
+      case 201: w = 3.5; break;
+      case 202: w = 4.5; break;
+      case 203: w = 5.5; break;
+      case 204: w = 6.5; break;
+      case 205: w = 7.5; break;
+      case 206: w = 8.5; break;
+      case 207: w = 0.5; break;
+      case 208: w = 1.5; break;
+      case 209: w = 2.5; break;
+      case 210: w = 3.5; break;
+      case 211: w = 4.5; break;
+      case 212: w = 5.5; break;
+      case 213: w = 6.5; break;
+      case 214: w = 7.5; break;
+      case 215: w = 8.5; break;
+      case 216: w = 0.5; break;
+      case 217: w = 1.5; break;
+      case 218: w = 2.5; break;
+      case 219: w = 3.5; break;
+      case 220: w = 4.5; break;
+      case 221: w = 5.5; break;
+      case 222: w = 6.5; break;
+      case 223: w = 7.5; break;
+      case 224: w = 8.5; break;
+      case 225: w = 0.5; break;
+      case 226: w = 1.5; break;
+      case 227: w = 2.5; break;
+      case 228: w = 3.5; break;
+      case 229: w = 4.5; break;
+      case 230: w = 5.5; break;
+      case 231: w = 6.5; break;
+      case 232: w = 7.5; break;
+      case 233: w = 8.5; break;
+      case 234: w = 0.5; break;
+      case 235: w = 1.5; break;
+      case 236: w = 2.5; break;
+      case 237: w = 3.5; break;
+      case 238: w = 4.5; break;
+      case 239: w = 5.5; break;
+      case 240: w = 6.5; break;
+      case 241: w = 7.5; break;
+      case 242: w = 8.5; break;
+      case 243: w = 0.5; break;
+      case 244: w = 1.5; break;
+      case 245: w = 2.5; break;
+      case 246: w = 3.5; break;
+      case 247: w = 4.5; break;
+      case 248: w = 5.5; break;
+      case 249: w = 6.5; break;
+      case 250: w = 7.5; break;
+      case 251: w = 8.5; break;
+      case 252: w = 0.5; break;
+      case 253: w = 1.5; break;
+      case 254: w = 2.5; break;
+      case 255: w = 3.5; break;
+      case 256: w = 4.5; break;
+      case 257: w = 5.5; break;
+      case 258: w = 6.5; break;
+      case 259: w = 7.5; break;
+      case 260: w = 8.5; break;
+      case 261: w = 0.5; break;
+      case 262: w = 1.5; break;
+      case 263: w = 2.5; break;
+      case 264: w = 3.5; break;
+      case 265: w = 4.5; break;
+      case 266: w = 5.5; break;
+      case 267: w = 6.5; break;
+      case 268: w = 7.5; break;
+      case 269: w = 8.5; break;
+      case 270: w = 0.5; break;
+      case 271: w = 1.5; break;
+      case 272: w = 2.5; break;
+      case 273: w = 3.5; break;
+      case 274: w = 4.5; break;
+      case 275: w = 5.5; break;
+      case 276: w = 6.5; break;
+      case 277: w = 7.5; break;
+      case 278: w = 8.5; break;
+      case 279: w = 0.5; break;
+      case 280: w = 1.5; break;
+      case 281: w = 2.5; break;
+      case 282: w = 3.5; break;
+      case 283: w = 4.5; break;
+      case 284: w = 5.5; break;
+      case 285: w = 6.5; break;
+      case 286: w = 7.5; break;
+      case 287: w = 8.5; break;
+      case 288: w = 0.5; break;
+      case 289: w = 1.5; break;
+      case 290: w = 2.5; break;
+      case 291: w = 3.5; break;
+      case 292: w = 4.5; break;
+      case 293: w = 5.5; break;
+      case 294: w = 6.5; break;
+      case 295: w = 7.5; break;
+      case 296: w = 8.5; break;
+      case 297: w = 0.5; break;
+      case 298: w = 1.5; break;
+      case 299: w = 2.5; break;
+      case 300: w = 3.5; break;
+      case 301: w = 4.5; break;
+      case 302: w = 5.5; break;
+      case 303: w = 6.5; break;
+      case 304: w = 7.5; break;
+      case 305: w = 8.5; break;
+      case 306: w = 0.5; break;
+      case 307: w = 1.5; break;
+      case 308: w = 2.5; break;
+      case 309: w = 3.5; break;
+      case 310: w = 4.5; break;
+      case 311: w = 5.5; break;
+      case 312: w = 6.5; break;
+      case 313: w = 7.5; break;
+      case 314: w = 8.5; break;
+      case 315: w = 0.5; break;
+      case 316: w = 1.5; break;
+      case 317: w = 2.5; break;
+      case 318: w = 3.5; break;
+      case 319: w = 4.5; break;
+      case 320: w = 5.5; break;
+      case 321: w = 6.5; break;
+      case 322: w = 7.5; break;
+      case 323: w = 8.5; break;
+      case 324: w = 0.5; break;
+      case 325: w = 1.5; break;
+      case 326: w = 2.5; break;
+      case 327: w = 3.5; break;
+      case 328: w = 4.5; break;
+      case 329: w = 5.5; break;
+      case 330: w = 6.5; break;
+      case 331: w = 7.5; break;
+      case 332: w = 8.5; break;
+      case 333: w = 0.5; break;
+      case 334: w = 1.5; break;
+      case 335: w = 2.5; break;
+      case 336: w = 3.5; break;
+      case 337: w = 4.5; break;
+      case 338: w = 5.5; break;
+      case 339: w = 6.5; break;
+      case 340: w = 7.5; break;
+      case 341: w = 8.5; break;
+      case 342: w = 0.5; break;
+      case 343: w = 1.5; break;
+      case 344: w = 2.5; break;
+      case 345: w = 3.5; break;
+      case 346: w = 4.5; break;
+      case 347: w = 5.5; break;
+      case 348: w = 6.5; break;
+      case 349: w = 7.5; break;
+      case 350: w = 8.5; break;
+      case 351: w = 0.5; break;
+      case 352: w = 1.5; break;
+      case 353: w = 2.5; break;
+      case 354: w = 3.5; break;
+      case 355: w = 4.5; break;
+      case 356: w = 5.5; break;
+      case 357: w = 6.5; break;
+      case 358: w = 7.5; break;
+      case 359: w = 8.5; break;
+      case 360: w = 0.5; break;
+      case 361: w = 1.5; break;
+      case 362: w = 2.5; break;
+      case 363: w = 3.5; break;
+      case 364: w = 4.5; break;
+      case 365: w = 5.5; break;
+      case 366: w = 6.5; break;
+      case 367: w = 7.5; break;
+      case 368: w = 8.5; break;
+      case 369: w = 0.5; break;
+      case 370: w = 1.5; break;
+      case 371: w = 2.5; break;
+      case 372: w = 3.5; break;
+      case 373: w = 4.5; break;
+      case 374: w = 5.5; break;
+      case 375: w = 6.5; break;
+      case 376: w = 7.5; break;
+      case 377: w = 8.5; break;
+      case 378: w = 0.5; break;
+      case 379: w = 1.5; break;
+      case 380: w = 2.5; break;
+      case 381: w = 3.5; break;
+      case 382: w = 4.5; break;
+      case 383: w = 5.5; break;
+      case 384: w = 6.5; break;
+      case 385: w = 7.5; break;
+      case 386: w = 8.5; break;
+      case 387: w = 0.5; break;
+      case 388: w = 1.5; break;
+      case 389: w = 2.5; break;
+      case 390: w = 3.5; break;
+      case 391: w = 4.5; break;
+      case 392: w = 5.5; break;
+      case 393: w = 6.5; break;
+      case 394: w = 7.5; break;
+      case 395: w = 8.5; break;
+      case 396: w = 0.5; break;
+      case 397: w = 1.5; break;
+      case 398: w = 2.5; break;
+      case 399: w = 3.5; break;
+      case 400: w = 4.5; break;
+      case 401: w = 5.5; break;
+      case 402: w = 6.5; break;
+      case 403: w = 7.5; break;
+      case 404: w = 8.5; break;
+      case 405: w = 0.5; break;
+      case 406: w = 1.5; break;
+      case 407: w = 2.5; break;
+      case 408: w = 3.5; break;
+      case 409: w = 4.5; break;
+      case 410: w = 5.5; break;
+      case 411: w = 6.5; break;
+      case 412: w = 7.5; break;
+      case 413: w = 8.5; break;
+      case 414: w = 0.5; break;
+      case 415: w = 1.5; break;
+      case 416: w = 2.5; break;
+      case 417: w = 3.5; break;
+      case 418: w = 4.5; break;
+      case 419: w = 5.5; break;
+      case 420: w = 6.5; break;
+      case 421: w = 7.5; break;
+      case 422: w = 8.5; break;
+      case 423: w = 0.5; break;
+      case 424: w = 1.5; break;
+      case 425: w = 2.5; break;
+      case 426: w = 3.5; break;
+      case 427: w = 4.5; break;
+      case 428: w = 5.5; break;
+      case 429: w = 6.5; break;
+      case 430: w = 7.5; break;
+      case 431: w = 8.5; break;
+      case 432: w = 0.5; break;
+      case 433: w = 1.5; break;
+      case 434: w = 2.5; break;
+      case 435: w = 3.5; break;
+      case 436: w = 4.5; break;
+      case 437: w = 5.5; break;
+      case 438: w = 6.5; break;
+      case 439: w = 7.5; break;
+      case 440: w = 8.5; break;
+      case 441: w = 0.5; break;
+      case 442: w = 1.5; break;
+      case 443: w = 2.5; break;
+      case 444: w = 3.5; break;
+      case 445: w = 4.5; break;
+      case 446: w = 5.5; break;
+      case 447: w = 6.5; break;
+      case 448: w = 7.5; break;
+      case 449: w = 8.5; break;
+      case 450: w = 0.5; break;
+      case 451: w = 1.5; break;
+      case 452: w = 2.5; break;
+      case 453: w = 3.5; break;
+      case 454: w = 4.5; break;
+      case 455: w = 5.5; break;
+      case 456: w = 6.5; break;
+      case 457: w = 7.5; break;
+      case 458: w = 8.5; break;
+      case 459: w = 0.5; break;
+      case 460: w = 1.5; break;
+      case 461: w = 2.5; break;
+      case 462: w = 3.5; break;
+      case 463: w = 4.5; break;
+      case 464: w = 5.5; break;
+      case 465: w = 6.5; break;
+      case 466: w = 7.5; break;
+      case 467: w = 8.5; break;
+      case 468: w = 0.5; break;
+      case 469: w = 1.5; break;
+      case 470: w = 2.5; break;
+      case 471: w = 3.5; break;
+      case 472: w = 4.5; break;
+      case 473: w = 5.5; break;
+      case 474: w = 6.5; break;
+      case 475: w = 7.5; break;
+      case 476: w = 8.5; break;
+      case 477: w = 0.5; break;
+      case 478: w = 1.5; break;
+      case 479: w = 2.5; break;
+      case 480: w = 3.5; break;
+      case 481: w = 4.5; break;
+      case 482: w = 5.5; break;
+      case 483: w = 6.5; break;
+      case 484: w = 7.5; break;
+      case 485: w = 8.5; break;
+      case 486: w = 0.5; break;
+      case 487: w = 1.5; break;
+      case 488: w = 2.5; break;
+      case 489: w = 3.5; break;
+      case 490: w = 4.5; break;
+      case 491: w = 5.5; break;
+      case 492: w = 6.5; break;
+      case 493: w = 7.5; break;
+      case 494: w = 8.5; break;
+      case 495: w = 0.5; break;
+      case 496: w = 1.5; break;
+      case 497: w = 2.5; break;
+      case 498: w = 3.5; break;
+      case 499: w = 4.5; break;
+      case 500: w = 5.5; break;
+      case 501: w = 6.5; break;
+      case 502: w = 7.5; break;
+      case 503: w = 8.5; break;
+      case 504: w = 0.5; break;
+      case 505: w = 1.5; break;
+      case 506: w = 2.5; break;
+      case 507: w = 3.5; break;
+      case 508: w = 4.5; break;
+      case 509: w = 5.5; break;
+      case 510: w = 6.5; break;
+      case 511: w = 7.5; break;
+      case 512: w = 8.5; break;
+      case 513: w = 0.5; break;
+      case 514: w = 1.5; break;
+      case 515: w = 2.5; break;
+      case 516: w = 3.5; break;
+      case 517: w = 4.5; break;
+      case 518: w = 5.5; break;
+      case 519: w = 6.5; break;
+      case 520: w = 7.5; break;
+      case 521: w = 8.5; break;
+      case 522: w = 0.5; break;
+      case 523: w = 1.5; break;
+      case 524: w = 2.5; break;
+      case 525: w = 3.5; break;
+      case 526: w = 4.5; break;
+      case 527: w = 5.5; break;
+      case 528: w = 6.5; break;
+      case 529: w = 7.5; break;
+      case 530: w = 8.5; break;
+      case 531: w = 0.5; break;
+      case 532: w = 1.5; break;
+      case 533: w = 2.5; break;
+      case 534: w = 3.5; break;
+      case 535: w = 4.5; break;
+      case 536: w = 5.5; break;
+      case 537: w = 6.5; break;
+      case 538: w = 7.5; break;
+      case 539: w = 8.5; break;
+      case 540: w = 0.5; break;
+      case 541: w = 1.5; break;
+      case 542: w = 2.5; break;
+      case 543: w = 3.5; break;
+      case 544: w = 4.5; break;
+      case 545: w = 5.5; break;
+      case 546: w = 6.5; break;
+      case 547: w = 7.5; break;
+      case 548: w = 8.5; break;
+      case 549: w = 0.5; break;
+      case 550: w = 1.5; break;
+      case 551: w = 2.5; break;
+      case 552: w = 3.5; break;
+      case 553: w = 4.5; break;
+      case 554: w = 5.5; break;
+      case 555: w = 6.5; break;
+      case 556: w = 7.5; break;
+      case 557: w = 8.5; break;
+      case 558: w = 0.5; break;
+      case 559: w = 1.5; break;
+      case 560: w = 2.5; break;
+      case 561: w = 3.5; break;
+      case 562: w = 4.5; break;
+      case 563: w = 5.5; break;
+      case 564: w = 6.5; break;
+      case 565: w = 7.5; break;
+      case 566: w = 8.5; break;
+      case 567: w = 0.5; break;
+      case 568: w = 1.5; break;
+      case 569: w = 2.5; break;
+      case 570: w = 3.5; break;
+      case 571: w = 4.5; break;
+      case 572: w = 5.5; break;
+      case 573: w = 6.5; break;
+      case 574: w = 7.5; break;
+      case 575: w = 8.5; break;
+      case 576: w = 0.5; break;
+      case 577: w = 1.5; break;
+      case 578: w = 2.5; break;
+      case 579: w = 3.5; break;
+      case 580: w = 4.5; break;
+      case 581: w = 5.5; break;
+      case 582: w = 6.5; break;
+      case 583: w = 7.5; break;
+      case 584: w = 8.5; break;
+      case 585: w = 0.5; break;
+      case 586: w = 1.5; break;
+      case 587: w = 2.5; break;
+      case 588: w = 3.5; break;
+      case 589: w = 4.5; break;
+      case 590: w = 5.5; break;
+      case 591: w = 6.5; break;
+      case 592: w = 7.5; break;
+      case 593: w = 8.5; break;
+      case 594: w = 0.5; break;
+      case 595: w = 1.5; break;
+      case 596: w = 2.5; break;
+      case 597: w = 3.5; break;
+      case 598: w = 4.5; break;
+      case 599: w = 5.5; break;
+      case 600: w = 6.5; break;
+      case 601: w = 7.5; break;
+      case 602: w = 8.5; break;
+      case 603: w = 0.5; break;
+      case 604: w = 1.5; break;
+      case 605: w = 2.5; break;
+      case 606: w = 3.5; break;
+      case 607: w = 4.5; break;
+      case 608: w = 5.5; break;
+      case 609: w = 6.5; break;
+      case 610: w = 7.5; break;
+      case 611: w = 8.5; break;
+      case 612: w = 0.5; break;
+      case 613: w = 1.5; break;
+      case 614: w = 2.5; break;
+      case 615: w = 3.5; break;
+      case 616: w = 4.5; break;
+      case 617: w = 5.5; break;
+      case 618: w = 6.5; break;
+      case 619: w = 7.5; break;
+      case 620: w = 8.5; break;
+      case 621: w = 0.5; break;
+      case 622: w = 1.5; break;
+      case 623: w = 2.5; break;
+      case 624: w = 3.5; break;
+      case 625: w = 4.5; break;
+      case 626: w = 5.5; break;
+      case 627: w = 6.5; break;
+      case 628: w = 7.5; break;
+      case 629: w = 8.5; break;
+      case 630: w = 0.5; break;
+      case 631: w = 1.5; break;
+      case 632: w = 2.5; break;
+      case 633: w = 3.5; break;
+      case 634: w = 4.5; break;
+      case 635: w = 5.5; break;
+      case 636: w = 6.5; break;
+      case 637: w = 7.5; break;
+      case 638: w = 8.5; break;
+      case 639: w = 0.5; break;
+      case 640: w = 1.5; break;
+      case 641: w = 2.5; break;
+      case 642: w = 3.5; break;
+      case 643: w = 4.5; break;
+      case 644: w = 5.5; break;
+      case 645: w = 6.5; break;
+      case 646: w = 7.5; break;
+      case 647: w = 8.5; break;
+      case 648: w = 0.5; break;
+      case 649: w = 1.5; break;
+      case 650: w = 2.5; break;
+      case 651: w = 3.5; break;
+      case 652: w = 4.5; break;
+      case 653: w = 5.5; break;
+      case 654: w = 6.5; break;
+      case 655: w = 7.5; break;
+      case 656: w = 8.5; break;
+      case 657: w = 0.5; break;
+      case 658: w = 1.5; break;
+      case 659: w = 2.5; break;
+      case 660: w = 3.5; break;
+      case 661: w = 4.5; break;
+      case 662: w = 5.5; break;
+      case 663: w = 6.5; break;
+      case 664: w = 7.5; break;
+      case 665: w = 8.5; break;
+      case 666: w = 0.5; break;
+      case 667: w = 1.5; break;
+      case 668: w = 2.5; break;
+      case 669: w = 3.5; break;
+      case 670: w = 4.5; break;
+      case 671: w = 5.5; break;
+      case 672: w = 6.5; break;
+      case 673: w = 7.5; break;
+      case 674: w = 8.5; break;
+      case 675: w = 0.5; break;
+      case 676: w = 1.5; break;
+      case 677: w = 2.5; break;
+      case 678: w = 3.5; break;
+      case 679: w = 4.5; break;
+      case 680: w = 5.5; break;
+      case 681: w = 6.5; break;
+      case 682: w = 7.5; break;
+      case 683: w = 8.5; break;
+      case 684: w = 0.5; break;
+      case 685: w = 1.5; break;
+      case 686: w = 2.5; break;
+      case 687: w = 3.5; break;
+      case 688: w = 4.5; break;
+      case 689: w = 5.5; break;
+      case 690: w = 6.5; break;
+      case 691: w = 7.5; break;
+      case 692: w = 8.5; break;
+      case 693: w = 0.5; break;
+      case 694: w = 1.5; break;
+      case 695: w = 2.5; break;
+      case 696: w = 3.5; break;
+      case 697: w = 4.5; break;
+      case 698: w = 5.5; break;
+      case 699: w = 6.5; break;
+      case 700: w = 7.5; break;
+      case 701: w = 8.5; break;
+      case 702: w = 0.5; break;
+      case 703: w = 1.5; break;
+      case 704: w = 2.5; break;
+      case 705: w = 3.5; break;
+      case 706: w = 4.5; break;
+      case 707: w = 5.5; break;
+      case 708: w = 6.5; break;
+      case 709: w = 7.5; break;
+      case 710: w = 8.5; break;
+      case 711: w = 0.5; break;
+      case 712: w = 1.5; break;
+      case 713: w = 2.5; break;
+      case 714: w = 3.5; break;
+      case 715: w = 4.5; break;
+      case 716: w = 5.5; break;
+      case 717: w = 6.5; break;
+      case 718: w = 7.5; break;
+      case 719: w = 8.5; break;
+      case 720: w = 0.5; break;
+      case 721: w = 1.5; break;
+      case 722: w = 2.5; break;
+      case 723: w = 3.5; break;
+      case 724: w = 4.5; break;
+      case 725: w = 5.5; break;
+      case 726: w = 6.5; break;
+      case 727: w = 7.5; break;
+      case 728: w = 8.5; break;
+      case 729: w = 0.5; break;
+      case 730: w = 1.5; break;
+      case 731: w = 2.5; break;
+      case 732: w = 3.5; break;
+      case 733: w = 4.5; break;
+      case 734: w = 5.5; break;
+      case 735: w = 6.5; break;
+      case 736: w = 7.5; break;
+      case 737: w = 8.5; break;
+      case 738: w = 0.5; break;
+      case 739: w = 1.5; break;
+      case 740: w = 2.5; break;
+      case 741: w = 3.5; break;
+      case 742: w = 4.5; break;
+      case 743: w = 5.5; break;
+      case 744: w = 6.5; break;
+      case 745: w = 7.5; break;
+      case 746: w = 8.5; break;
+      case 747: w = 0.5; break;
+      case 748: w = 1.5; break;
+      case 749: w = 2.5; break;
+      case 750: w = 3.5; break;
+      case 751: w = 4.5; break;
+      case 752: w = 5.5; break;
+      case 753: w = 6.5; break;
+      case 754: w = 7.5; break;
+      case 755: w = 8.5; break;
+      case 756: w = 0.5; break;
+      case 757: w = 1.5; break;
+      case 758: w = 2.5; break;
+      case 759: w = 3.5; break;
+      case 760: w = 4.5; break;
+      case 761: w = 5.5; break;
+      case 762: w = 6.5; break;
+      case 763: w = 7.5; break;
+      case 764: w = 8.5; break;
+      case 765: w = 0.5; break;
+      case 766: w = 1.5; break;
+      case 767: w = 2.5; break;
+      case 768: w = 3.5; break;
+      case 769: w = 4.5; break;
+      case 770: w = 5.5; break;
+      case 771: w = 6.5; break;
+      case 772: w = 7.5; break;
+      case 773: w = 8.5; break;
+      case 774: w = 0.5; break;
+      case 775: w = 1.5; break;
+      case 776: w = 2.5; break;
+      case 777: w = 3.5; break;
+      case 778: w = 4.5; break;
+      case 779: w = 5.5; break;
+      case 780: w = 6.5; break;
+      case 781: w = 7.5; break;
+      case 782: w = 8.5; break;
+      case 783: w = 0.5; break;
+      case 784: w = 1.5; break;
+      case 785: w = 2.5; break;
+      case 786: w = 3.5; break;
+      case 787: w = 4.5; break;
+      case 788: w = 5.5; break;
+      case 789: w = 6.5; break;
+      case 790: w = 7.5; break;
+      case 791: w = 8.5; break;
+      case 792: w = 0.5; break;
+      case 793: w = 1.5; break;
+      case 794: w = 2.5; break;
+      case 795: w = 3.5; break;
+      case 796: w = 4.5; break;
+      case 797: w = 5.5; break;
+      case 798: w = 6.5; break;
+      case 799: w = 7.5; break;
+      case 800: w = 8.5; break;
+      case 801: w = 0.5; break;
+      case 802: w = 1.5; break;
+      case 803: w = 2.5; break;
+      case 804: w = 3.5; break;
+      case 805: w = 4.5; break;
+      case 806: w = 5.5; break;
+      case 807: w = 6.5; break;
+      case 808: w = 7.5; break;
+      case 809: w = 8.5; break;
+      case 810: w = 0.5; break;
+      case 811: w = 1.5; break;
+      case 812: w = 2.5; break;
+      case 813: w = 3.5; break;
+      case 814: w = 4.5; break;
+      case 815: w = 5.5; break;
+      case 816: w = 6.5; break;
+      case 817: w = 7.5; break;
+      case 818: w = 8.5; break;
+      case 819: w = 0.5; break;
+      case 820: w = 1.5; break;
+      case 821: w = 2.5; break;
+      case 822: w = 3.5; break;
+      case 823: w = 4.5; break;
+      case 824: w = 5.5; break;
+      case 825: w = 6.5; break;
+      case 826: w = 7.5; break;
+      case 827: w = 8.5; break;
+      case 828: w = 0.5; break;
+      case 829: w = 1.5; break;
+      case 830: w = 2.5; break;
+      case 831: w = 3.5; break;
+      case 832: w = 4.5; break;
+      case 833: w = 5.5; break;
+      case 834: w = 6.5; break;
+      case 835: w = 7.5; break;
+      case 836: w = 8.5; break;
+      case 837: w = 0.5; break;
+      case 838: w = 1.5; break;
+      case 839: w = 2.5; break;
+      case 840: w = 3.5; break;
+      case 841: w = 4.5; break;
+      case 842: w = 5.5; break;
+      case 843: w = 6.5; break;
+      case 844: w = 7.5; break;
+      case 845: w = 8.5; break;
+      case 846: w = 0.5; break;
+      case 847: w = 1.5; break;
+      case 848: w = 2.5; break;
+      case 849: w = 3.5; break;
+      case 850: w = 4.5; break;
+      case 851: w = 5.5; break;
+      case 852: w = 6.5; break;
+      case 853: w = 7.5; break;
+      case 854: w = 8.5; break;
+      case 855: w = 0.5; break;
+      case 856: w = 1.5; break;
+      case 857: w = 2.5; break;
+      case 858: w = 3.5; break;
+      case 859: w = 4.5; break;
+      case 860: w = 5.5; break;
+      case 861: w = 6.5; break;
+      case 862: w = 7.5; break;
+      case 863: w = 8.5; break;
+      case 864: w = 0.5; break;
+      case 865: w = 1.5; break;
+      case 866: w = 2.5; break;
+      case 867: w = 3.5; break;
+      case 868: w = 4.5; break;
+      case 869: w = 5.5; break;
+      case 870: w = 6.5; break;
+      case 871: w = 7.5; break;
+      case 872: w = 8.5; break;
+      case 873: w = 0.5; break;
+      case 874: w = 1.5; break;
+      case 875: w = 2.5; break;
+      case 876: w = 3.5; break;
+      case 877: w = 4.5; break;
+      case 878: w = 5.5; break;
+      case 879: w = 6.5; break;
+      case 880: w = 7.5; break;
+      case 881: w = 8.5; break;
+      case 882: w = 0.5; break;
+      case 883: w = 1.5; break;
+      case 884: w = 2.5; break;
+      case 885: w = 3.5; break;
+      case 886: w = 4.5; break;
+      case 887: w = 5.5; break;
+      case 888: w = 6.5; break;
+      case 889: w = 7.5; break;
+      case 890: w = 8.5; break;
+      case 891: w = 0.5; break;
+      case 892: w = 1.5; break;
+      case 893: w = 2.5; break;
+      case 894: w = 3.5; break;
+      case 895: w = 4.5; break;
+      case 896: w = 5.5; break;
+      case 897: w = 6.5; break;
+      case 898: w = 7.5; break;
+      case 899: w = 8.5; break;
+      case 900: w = 0.5; break;
+      case 901: w = 1.5; break;
+      case 902: w = 2.5; break;
+      case 903: w = 3.5; break;
+      case 904: w = 4.5; break;
+      case 905: w = 5.5; break;
+      case 906: w = 6.5; break;
+      case 907: w = 7.5; break;
+      case 908: w = 8.5; break;
+      case 909: w = 0.5; break;
+      case 910: w = 1.5; break;
+      case 911: w = 2.5; break;
+      case 912: w = 3.5; break;
+      case 913: w = 4.5; break;
+      case 914: w = 5.5; break;
+      case 915: w = 6.5; break;
+      case 916: w = 7.5; break;
+      case 917: w = 8.5; break;
+      case 918: w = 0.5; break;
+      case 919: w = 1.5; break;
+      case 920: w = 2.5; break;
+      case 921: w = 3.5; break;
+      case 922: w = 4.5; break;
+      case 923: w = 5.5; break;
+      case 924: w = 6.5; break;
+      case 925: w = 7.5; break;
+      case 926: w = 8.5; break;
+      case 927: w = 0.5; break;
+      case 928: w = 1.5; break;
+      case 929: w = 2.5; break;
+      case 930: w = 3.5; break;
+      case 931: w = 4.5; break;
+      case 932: w = 5.5; break;
+      case 933: w = 6.5; break;
+      case 934: w = 7.5; break;
+      case 935: w = 8.5; break;
+      case 936: w = 0.5; break;
+      case 937: w = 1.5; break;
+      case 938: w = 2.5; break;
+      case 939: w = 3.5; break;
+      case 940: w = 4.5; break;
+      case 941: w = 5.5; break;
+      case 942: w = 6.5; break;
+      case 943: w = 7.5; break;
+      case 944: w = 8.5; break;
+      case 945: w = 0.5; break;
+      case 946: w = 1.5; break;
+      case 947: w = 2.5; break;
+      case 948: w = 3.5; break;
+      case 949: w = 4.5; break;
+      case 950: w = 5.5; break;
+      case 951: w = 6.5; break;
+      case 952: w = 7.5; break;
+      case 953: w = 8.5; break;
+      case 954: w = 0.5; break;
+      case 955: w = 1.5; break;
+      case 956: w = 2.5; break;
+      case 957: w = 3.5; break;
+      case 958: w = 4.5; break;
+      case 959: w = 5.5; break;
+      case 960: w = 6.5; break;
+      case 961: w = 7.5; break;
+      case 962: w = 8.5; break;
+      case 963: w = 0.5; break;
+      case 964: w = 1.5; break;
+      case 965: w = 2.5; break;
+      case 966: w = 3.5; break;
+      case 967: w = 4.5; break;
+      case 968: w = 5.5; break;
+      case 969: w = 6.5; break;
+      case 970: w = 7.5; break;
+      case 971: w = 8.5; break;
+      case 972: w = 0.5; break;
+      case 973: w = 1.5; break;
+      case 974: w = 2.5; break;
+      case 975: w = 3.5; break;
+      case 976: w = 4.5; break;
+      case 977: w = 5.5; break;
+      case 978: w = 6.5; break;
+      case 979: w = 7.5; break;
+      case 980: w = 8.5; break;
+      case 981: w = 0.5; break;
+      case 982: w = 1.5; break;
+      case 983: w = 2.5; break;
+      case 984: w = 3.5; break;
+      case 985: w = 4.5; break;
+      case 986: w = 5.5; break;
+      case 987: w = 6.5; break;
+      case 988: w = 7.5; break;
+      case 989: w = 8.5; break;
+      case 990: w = 0.5; break;
+      case 991: w = 1.5; break;
+      case 992: w = 2.5; break;
+      case 993: w = 3.5; break;
+      case 994: w = 4.5; break;
+      case 995: w = 5.5; break;
+      case 996: w = 6.5; break;
+      case 997: w = 7.5; break;
+      case 998: w = 8.5; break;
+      case 999: w = 0.5; break;
+      default: w = 0.0; break;
+    }
+    switch ( k ) {
+      case 0: acc = acc + w * 0.1; break;
+      case 1: acc = acc + w * 0.2; break;
+      case 2: acc = acc + w * 0.3; break;
+      case 3: acc = acc + w * 0.4; break;
+      case 4: acc = acc + w * 0.5; break;
+      case 5: acc = acc + w * 0.6; break;
+      case 6: acc = acc + w * 0.7; break;
+      case 7: acc = acc + w * 0.1; break;
+      case 8: acc = acc + w * 0.2; break;
+      case 9: acc = acc + w * 0.3; break;
+      case 10: acc = acc + w * 0.4; break;
+      case 11: acc = acc + w * 0.5; break;
+      case 12: acc = acc + w * 0.6; break;
+      case 13: acc = acc + w * 0.7; break;
+      case 14: acc = acc + w * 0.1; break;
+      case 15: acc = acc + w * 0.2; break;
+      case 16: acc = acc + w * 0.3; break;
+      case 17: acc = acc + w * 0.4; break;
+      case 18: acc = acc + w * 0.5; break;
+      case 19: acc = acc + w * 0.6; break;
+      case 20: acc = acc + w * 0.7; break;
+      case 21: acc = acc + w * 0.1; break;
+      case 22: acc = acc + w * 0.2; break;
+      case 23: acc = acc + w * 0.3; break;
+      case 24: acc = acc + w * 0.4; break;
+      case 25: acc = acc + w * 0.5; break;
+      case 26: acc = acc + w * 0.6; break;
+      case 27: acc = acc + w * 0.7; break;
+      case 28: acc = acc + w * 0.1; break;
+      case 29: acc = acc + w * 0.2; break;
+      case 30: acc = acc + w * 0.3; break;
+      case 31: acc = acc + w * 0.4; break;
+      case 32: acc = acc + w * 0.5; break;
+      case 33: acc = acc + w * 0.6; break;
+      case 34: acc = acc + w * 0.7; break;
+      case 35: acc = acc + w * 0.1; break;
+      case 36: acc = acc + w * 0.2; break;
+      case 37: acc = acc + w * 0.3; break;
+      case 38: acc = acc + w * 0.4; break;
+      case 39: acc = acc + w * 0.5; break;
+      case 40: acc = acc + w * 0.6; break;
+      case 41: acc = acc + w * 0.7; break;
+      case 42: acc = acc + w * 0.1; break;
+      case 43: acc = acc + w * 0.2; break;
+      case 44: acc = acc + w * 0.3; break;
+      case 45: acc = acc + w * 0.4; break;
+      case 46: acc = acc + w * 0.5; break;
+      case 47: acc = acc + w * 0.6; break;
+      case 48: acc = acc + w * 0.7; break;
+      case 49: acc = acc + w * 0.1; break;
+      case 50: acc = acc + w * 0.2; break;
+      case 51: acc = acc + w * 0.3; break;
+      case 52: acc = acc + w * 0.4; break;
+      case 53: acc = acc + w * 0.5; break;
+      case 54: acc = acc + w * 0.6; break;
+      case 55: acc = acc + w * 0.7; break;
+      case 56: acc = acc + w * 0.1; break;
+      case 57: acc = acc + w * 0.2; break;
+      case 58: acc = acc + w * 0.3; break;
+      case 59: acc = acc + w * 0.4; break;
+      case 60: acc = acc + w * 0.5; break;
+      case 61: acc = acc + w * 0.6; break;
+      case 62: acc = acc + w * 0.7; break;
+      case 63: acc = acc + w * 0.1; break;
+      case 64: acc = acc + w * 0.2; break;
+      case 65: acc = acc + w * 0.3; break;
+      case 66: acc = acc + w * 0.4; break;
+      case 67: acc = acc + w * 0.5; break;
+      case 68: acc = acc + w * 0.6; break;
+      case 69: acc = acc + w * 0.7; break;
+      case 70: acc = acc + w * 0.1; break;
+      case 71: acc = acc + w * 0.2; break;
+      case 72: acc = acc + w * 0.3; break;
+      case 73: acc = acc + w * 0.4; break;
+      case 74: acc = acc + w * 0.5; break;
+      case 75: acc = acc + w * 0.6; break;
+      case 76: acc = acc + w * 0.7; break;
+      case 77: acc = acc + w * 0.1; break;
+      case 78: acc = acc + w * 0.2; break;
+      case 79: acc = acc + w * 0.3; break;
+      case 80: acc = acc + w * 0.4; break;
+      case 81: acc = acc + w * 0.5; break;
+      case 82: acc = acc + w * 0.6; break;
+      case 83: acc = acc + w * 0.7; break;
+      case 84: acc = acc + w * 0.1; break;
+      case 85: acc = acc + w * 0.2; break;
+      case 86: acc = acc + w * 0.3; break;
+      case 87: acc = acc + w * 0.4; break;
+      case 88: acc = acc + w * 0.5; break;
+      case 89: acc = acc + w * 0.6; break;
+      case 90: acc = acc + w * 0.7; break;
+      case 91: acc = acc + w * 0.1; break;
+      case 92: acc = acc + w * 0.2; break;
+      case 93: acc = acc + w * 0.3; break;
+      case 94: acc = acc + w * 0.4; break;
+      case 95: acc = acc + w * 0.5; break;
+      case 96: acc = acc + w * 0.6; break;
+      case 97: acc = acc + w * 0.7; break;
+      case 98: acc = acc + w * 0.1; break;
+      case 99: acc = acc + w * 0.2; break;
+      case 100: acc = acc + w * 0.3; break;
+      case 101: acc = acc + w * 0.4; break;
+      case 102: acc = acc + w * 0.5; break;
+      case 103: acc = acc + w * 0.6; break;
+      case 104: acc = acc + w * 0.7; break;
+      case 105: acc = acc + w * 0.1; break;
+      case 106: acc = acc + w * 0.2; break;
+      case 107: acc = acc + w * 0.3; break;
+      case 108: acc = acc + w * 0.4; break;
+      case 109: acc = acc + w * 0.5; break;
+      case 110: acc = acc + w * 0.6; break;
+      case 111: acc = acc + w * 0.7; break;
+      case 112: acc = acc + w * 0.1; break;
+      case 113: acc = acc + w * 0.2; break;
+      case 114: acc = acc + w * 0.3; break;
+      case 115: acc = acc + w * 0.4; break;
+      case 116: acc = acc + w * 0.5; break;
+      case 117: acc = acc + w * 0.6; break;
+      case 118: acc = acc + w * 0.7; break;
+      case 119: acc = acc + w * 0.1; break;
+      case 120: acc = acc + w * 0.2; break;
+      case 121: acc = acc + w * 0.3; break;
+      case 122: acc = acc + w * 0.4; break;
+      case 123: acc = acc + w * 0.5; break;
+      case 124: acc = acc + w * 0.6; break;
+      case 125: acc = acc + w * 0.7; break;
+      case 126: acc = acc + w * 0.1; break;
+      case 127: acc = acc + w * 0.2; break;
+      case 128: acc = acc + w * 0.3; break;
+      case 129: acc = acc + w * 0.4; break;
+      case 130: acc = acc + w * 0.5; break;
+      case 131: acc = acc + w * 0.6; break;
+      case 132: acc = acc + w * 0.7; break;
+      case 133: acc = acc + w * 0.1; break;
+      case 134: acc = acc + w * 0.2; break;
+      case 135: acc = acc + w * 0.3; break;
+      case 136: acc = acc + w * 0.4; break;
+      case 137: acc = acc + w * 0.5; break;
+      case 138: acc = acc + w * 0.6; break;
+      case 139: acc = acc + w * 0.7; break;
+      case 140: acc = acc + w * 0.1; break;
+      case 141: acc = acc + w * 0.2; break;
+      case 142: acc = acc + w * 0.3; break;
+      case 143: acc = acc + w * 0.4; break;
+      case 144: acc = acc + w * 0.5; break;
+      case 145: acc = acc + w * 0.6; break;
+      case 146: acc = acc + w * 0.7; break;
+      case 147: acc = acc + w * 0.1; break;
+      case 148: acc = acc + w * 0.2; break;
+      case 149: acc = acc + w * 0.3; break;
+      case 150: acc = acc + w * 0.4; break;
+      case 151: acc = acc + w * 0.5; break;
+      case 152: acc = acc + w * 0.6; break;
+      case 153: acc = acc + w * 0.7; break;
+      case 154: acc = acc + w * 0.1; break;
+      case 155: acc = acc + w * 0.2; break;
+      case 156: acc = acc + w * 0.3; break;
+      case 157: acc = acc + w * 0.4; break;
+      case 158: acc = acc + w * 0.5; break;
+      case 159: acc = acc + w * 0.6; break;
+      case 160: acc = acc + w * 0.7; break;
+      case 161: acc = acc + w * 0.1; break;
+      case 162: acc = acc + w * 0.2; break;
+      case 163: acc = acc + w * 0.3; break;
+      case 164: acc = acc + w * 0.4; break;
+      case 165: acc = acc + w * 0.5; break;
+      case 166: acc = acc + w * 0.6; break;
+      case 167: acc = acc + w * 0.7; break;
+      case 168: acc = acc + w * 0.1; break;
+      case 169: acc = acc + w * 0.2; break;
+      case 170: acc = acc + w * 0.3; break;
+      case 171: acc = acc + w * 0.4; break;
+      case 172: acc = acc + w * 0.5; break;
+      case 173: acc = acc + w * 0.6; break;
+      case 174: acc = acc + w * 0.7; break;
+      case 175: acc = acc + w * 0.1; break;
+      case 176: acc = acc + w * 0.2; break;
+      case 177: acc = acc + w * 0.3; break;
+      case 178: acc = acc + w * 0.4; break;
+      case 179: acc = acc + w * 0.5; break;
+      case 180: acc = acc + w * 0.6; break;
+      case 181: acc = acc + w * 0.7; break;
+      case 182: acc = acc + w * 0.1; break;
+      case 183: acc = acc + w * 0.2; break;
+      case 184: acc = acc + w * 0.3; break;
+      case 185: acc = acc + w * 0.4; break;
+      case 186: acc = acc + w * 0.5; break;
+      case 187: acc = acc + w * 0.6; break;
+      case 188: acc = acc + w * 0.7; break;
+      case 189: acc = acc + w * 0.1; break;
+      case 190: acc = acc + w * 0.2; break;
+      case 191: acc = acc + w * 0.3; break;
+      case 192: acc = acc + w * 0.4; break;
+      case 193: acc = acc + w * 0.5; break;
+      case 194: acc = acc + w * 0.6; break;
+      case 195: acc = acc + w * 0.7; break;
+      case 196: acc = acc + w * 0.1; break;
+      case 197: acc = acc + w * 0.2; break;
+      case 198: acc = acc + w * 0.3; break;
+      case 199: acc = acc + w * 0.4; break;
+      case 200: acc = acc + w * 0.5; break;
+      case 201: acc = acc + w * 0.6; break;
+      case 202: acc = acc + w * 0.7; break;
+      case 203: acc = acc + w * 0.1; break;
+      case 204: acc = acc + w * 0.2; break;
+      case 205: acc = acc + w * 0.3; break;
+      case 206: acc = acc + w * 0.4; break;
+      case 207: acc = acc + w * 0.5; break;
+      case 208: acc = acc + w * 0.6; break;
+      case 209: acc = acc + w * 0.7; break;
+      case 210: acc = acc + w * 0.1; break;
+      case 211: acc = acc + w * 0.2; break;
+      case 212: acc = acc + w * 0.3; break;
+      case 213: acc = acc + w * 0.4; break;
+      case 214: acc = acc + w * 0.5; break;
+      case 215: acc = acc + w * 0.6; break;
+      case 216: acc = acc + w * 0.7; break;
+      case 217: acc = acc + w * 0.1; break;
+      case 218: acc = acc + w * 0.2; break;
+      case 219: acc = acc + w * 0.3; break;
+      case 220: acc = acc + w * 0.4; break;
+      case 221: acc = acc + w * 0.5; break;
+      case 222: acc = acc + w * 0.6; break;
+      case 223: acc = acc + w * 0.7; break;
+      case 224: acc = acc + w * 0.1; break;
+      case 225: acc = acc + w * 0.2; break;
+      case 226: acc = acc + w * 0.3; break;
+      case 227: acc = acc + w * 0.4; break;
+      case 228: acc = acc + w * 0.5; break;
+      case 229: acc = acc + w * 0.6; break;
+      case 230: acc = acc + w * 0.7; break;
+      case 231: acc = acc + w * 0.1; break;
+      case 232: acc = acc + w * 0.2; break;
+      case 233: acc = acc + w * 0.3; break;
+      case 234: acc = acc + w * 0.4; break;
+      case 235: acc = acc + w * 0.5; break;
+      case 236: acc = acc + w * 0.6; break;
+      case 237: acc = acc + w * 0.7; break;
+      case 238: acc = acc + w * 0.1; break;
+      case 239: acc = acc + w * 0.2; break;
+      case 240: acc = acc + w * 0.3; break;
+      case 241: acc = acc + w * 0.4; break;
+      case 242: acc = acc + w * 0.5; break;
+      case 243: acc = acc + w * 0.6; break;
+      case 244: acc = acc + w * 0.7; break;
+      case 245: acc = acc + w * 0.1; break;
+      case 246: acc = acc + w * 0.2; break;
+      case 247: acc = acc + w * 0.3; break;
+      case 248: acc = acc + w * 0.4; break;
+      case 249: acc = acc + w * 0.5; break;
+      case 250: acc = acc + w * 0.6; break;
+      case 251: acc = acc + w * 0.7; break;
+      case 252: acc = acc + w * 0.1; break;
+      case 253: acc = acc + w * 0.2; break;
+      case 254: acc = acc + w * 0.3; break;
+      case 255: acc = acc + w * 0.4; break;
+      case 256: acc = acc + w * 0.5; break;
+      case 257: acc = acc + w * 0.6; break;
+      case 258: acc = acc + w * 0.7; break;
+      case 259: acc = acc + w * 0.1; break;
+      case 260: acc = acc + w * 0.2; break;
+      case 261: acc = acc + w * 0.3; break;
+      case 262: acc = acc + w * 0.4; break;
+      case 263: acc = acc + w * 0.5; break;
+      case 264: acc = acc + w * 0.6; break;
+      case 265: acc = acc + w * 0.7; break;
+      case 266: acc = acc + w * 0.1; break;
+      case 267: acc = acc + w * 0.2; break;
+      case 268: acc = acc + w * 0.3; break;
+      case 269: acc = acc + w * 0.4; break;
+      case 270: acc = acc + w * 0.5; break;
+      case 271: acc = acc + w * 0.6; break;
+      case 272: acc = acc + w * 0.7; break;
+      case 273: acc = acc + w * 0.1; break;
+      case 274: acc = acc + w * 0.2; break;
+      case 275: acc = acc + w * 0.3; break;
+      case 276: acc = acc + w * 0.4; break;
+      case 277: acc = acc + w * 0.5; break;
+      case 278: acc = acc + w * 0.6; break;
+      case 279: acc = acc + w * 0.7; break;
+      case 280: acc = acc + w * 0.1; break;
+      case 281: acc = acc + w * 0.2; break;
+      case 282: acc = acc + w * 0.3; break;
+      case 283: acc = acc + w * 0.4; break;
+      case 284: acc = acc + w * 0.5; break;
+      case 285: acc = acc + w * 0.6; break;
+      case 286: acc = acc + w * 0.7; break;
+      case 287: acc = acc + w * 0.1; break;
+      case 288: acc = acc + w * 0.2; break;
+      case 289: acc = acc + w * 0.3; break;
+      case 290: acc = acc + w * 0.4; break;
+      case 291: acc = acc + w * 0.5; break;
+      case 292: acc = acc + w * 0.6; break;
+      case 293: acc = acc + w * 0.7; break;
+      case 294: acc = acc + w * 0.1; break;
+      case 295: acc = acc + w * 0.2; break;
+      case 296: acc = acc + w * 0.3; break;
+      case 297: acc = acc + w * 0.4; break;
+      case 298: acc = acc + w * 0.5; break;
+      case 299: acc = acc + w * 0.6; break;
+      case 300: acc = acc + w * 0.7; break;
+      case 301: acc = acc + w * 0.1; break;
+      case 302: acc = acc + w * 0.2; break;
+      case 303: acc = acc + w * 0.3; break;
+      case 304: acc = acc + w * 0.4; break;
+      case 305: acc = acc + w * 0.5; break;
+      case 306: acc = acc + w * 0.6; break;
+      case 307: acc = acc + w * 0.7; break;
+      case 308: acc = acc + w * 0.1; break;
+      case 309: acc = acc + w * 0.2; break;
+      case 310: acc = acc + w * 0.3; break;
+      case 311: acc = acc + w * 0.4; break;
+      case 312: acc = acc + w * 0.5; break;
+      case 313: acc = acc + w * 0.6; break;
+      case 314: acc = acc + w * 0.7; break;
+      case 315: acc = acc + w * 0.1; break;
+      case 316: acc = acc + w * 0.2; break;
+      case 317: acc = acc + w * 0.3; break;
+      case 318: acc = acc + w * 0.4; break;
+      case 319: acc = acc + w * 0.5; break;
+      case 320: acc = acc + w * 0.6; break;
+      case 321: acc = acc + w * 0.7; break;
+      case 322: acc = acc + w * 0.1; break;
+      case 323: acc = acc + w * 0.2; break;
+      case 324: acc = acc + w * 0.3; break;
+      case 325: acc = acc + w * 0.4; break;
+      case 326: acc = acc + w * 0.5; break;
+      case 327: acc = acc + w * 0.6; break;
+      case 328: acc = acc + w * 0.7; break;
+      case 329: acc = acc + w * 0.1; break;
+      case 330: acc = acc + w * 0.2; break;
+      case 331: acc = acc + w * 0.3; break;
+      case 332: acc = acc + w * 0.4; break;
+      case 333: acc = acc + w * 0.5; break;
+      case 334: acc = acc + w * 0.6; break;
+      case 335: acc = acc + w * 0.7; break;
+      case 336: acc = acc + w * 0.1; break;
+      case 337: acc = acc + w * 0.2; break;
+      case 338: acc = acc + w * 0.3; break;
+      case 339: acc = acc + w * 0.4; break;
+      case 340: acc = acc + w * 0.5; break;
+      case 341: acc = acc + w * 0.6; break;
+      case 342: acc = acc + w * 0.7; break;
+      case 343: acc = acc + w * 0.1; break;
+      case 344: acc = acc + w * 0.2; break;
+      case 345: acc = acc + w * 0.3; break;
+      case 346: acc = acc + w * 0.4; break;
+      case 347: acc = acc + w * 0.5; break;
+      case 348: acc = acc + w * 0.6; break;
+      case 349: acc = acc + w * 0.7; break;
+      case 350: acc = acc + w * 0.1; break;
+      case 351: acc = acc + w * 0.2; break;
+      case 352: acc = acc + w * 0.3; break;
+      case 353: acc = acc + w * 0.4; break;
+      case 354: acc = acc + w * 0.5; break;
+      case 355: acc = acc + w * 0.6; break;
+      case 356: acc = acc + w * 0.7; break;
+      case 357: acc = acc + w * 0.1; break;
+      case 358: acc = acc + w * 0.2; break;
+      case 359: acc = acc + w * 0.3; break;
+      case 360: acc = acc + w * 0.4; break;
+      case 361: acc = acc + w * 0.5; break;
+      case 362: acc = acc + w * 0.6; break;
+      case 363: acc = acc + w * 0.7; break;
+      case 364: acc = acc + w * 0.1; break;
+      case 365: acc = acc + w * 0.2; break;
+      case 366: acc = acc + w * 0.3; break;
+      case 367: acc = acc + w * 0.4; break;
+      case 368: acc = acc + w * 0.5; break;
+      case 369: acc = acc + w * 0.6; break;
+      case 370: acc = acc + w * 0.7; break;
+      case 371: acc = acc + w * 0.1; break;
+      case 372: acc = acc + w * 0.2; break;
+      case 373: acc = acc + w * 0.3; break;
+      case 374: acc = acc + w * 0.4; break;
+      case 375: acc = acc + w * 0.5; break;
+      case 376: acc = acc + w * 0.6; break;
+      case 377: acc = acc + w * 0.7; break;
+      case 378: acc = acc + w * 0.1; break;
+      case 379: acc = acc + w * 0.2; break;
+      case 380: acc = acc + w * 0.3; break;
+      case 381: acc = acc + w * 0.4; break;
+      case 382: acc = acc + w * 0.5; break;
+      case 383: acc = acc + w * 0.6; break;
+      case 384: acc = acc + w * 0.7; break;
+      case 385: acc = acc + w * 0.1; break;
+      case 386: acc = acc + w * 0.2; break;
+      case 387: acc = acc + w * 0.3; break;
+      case 388: acc = acc + w * 0.4; break;
+      case 389: acc = acc + w * 0.5; break;
+      case 390: acc = acc + w * 0.6; break;
+      case 391: acc = acc + w * 0.7; break;
+      case 392: acc = acc + w * 0.1; break;
+      case 393: acc = acc + w * 0.2; break;
+      case 394: acc = acc + w * 0.3; break;
+      case 395: acc = acc + w * 0.4; break;
+      case 396: acc = acc + w * 0.5; break;
+      case 397: acc = acc + w * 0.6; break;
+      case 398: acc = acc + w * 0.7; break;
+      case 399: acc = acc + w * 0.1; break;
+      case 400: acc = acc + w * 0.2; break;
+      case 401: acc = acc + w * 0.3; break;
+      case 402: acc = acc + w * 0.4; break;
+      case 403: acc = acc + w * 0.5; break;
+      case 404: acc = acc + w * 0.6; break;
+      case 405: acc = acc + w * 0.7; break;
+      case 406: acc = acc + w * 0.1; break;
+      case 407: acc = acc + w * 0.2; break;
+      case 408: acc = acc + w * 0.3; break;
+      case 409: acc = acc + w * 0.4; break;
+      case 410: acc = acc + w * 0.5; break;
+      case 411: acc = acc + w * 0.6; break;
+      case 412: acc = acc + w * 0.7; break;
+      case 413: acc = acc + w * 0.1; break;
+      case 414: acc = acc + w * 0.2; break;
+      case 415: acc = acc + w * 0.3; break;
+      case 416: acc = acc + w * 0.4; break;
+      case 417: acc = acc + w * 0.5; break;
+      case 418: acc = acc + w * 0.6; break;
+      case 419: acc = acc + w * 0.7; break;
+      case 420: acc = acc + w * 0.1; break;
+      case 421: acc = acc + w * 0.2; break;
+      case 422: acc = acc + w * 0.3; break;
+      case 423: acc = acc + w * 0.4; break;
+      case 424: acc = acc + w * 0.5; break;
+      case 425: acc = acc + w * 0.6; break;
+      case 426: acc = acc + w * 0.7; break;
+      case 427: acc = acc + w * 0.1; break;
+      case 428: acc = acc + w * 0.2; break;
+      case 429: acc = acc + w * 0.3; break;
+      case 430: acc = acc + w * 0.4; break;
+      case 431: acc = acc + w * 0.5; break;
+      case 432: acc = acc + w * 0.6; break;
+      case 433: acc = acc + w * 0.7; break;
+      case 434: acc = acc + w * 0.1; break;
+      case 435: acc = acc + w * 0.2; break;
+      case 436: acc = acc + w * 0.3; break;
+      case 437: acc = acc + w * 0.4; break;
+      case 438: acc = acc + w * 0.5; break;
+      case 439: acc = acc + w * 0.6; break;
+      case 440: acc = acc + w * 0.7; break;
+      case 441: acc = acc + w * 0.1; break;
+      case 442: acc = acc + w * 0.2; break;
+      case 443: acc = acc + w * 0.3; break;
+      case 444: acc = acc + w * 0.4; break;
+      case 445: acc = acc + w * 0.5; break;
+      case 446: acc = acc + w * 0.6; break;
+      case 447: acc = acc + w * 0.7; break;
+      case 448: acc = acc + w * 0.1; break;
+      case 449: acc = acc + w * 0.2; break;
+      case 450: acc = acc + w * 0.3; break;
+      case 451: acc = acc + w * 0.4; break;
+      case 452: acc = acc + w * 0.5; break;
+      case 453: acc = acc + w * 0.6; break;
+      case 454: acc = acc + w * 0.7; break;
+      case 455: acc = acc + w * 0.1; break;
+      case 456: acc = acc + w * 0.2; break;
+      case 457: acc = acc + w * 0.3; break;
+      case 458: acc = acc + w * 0.4; break;
+      case 459: acc = acc + w * 0.5; break;
+      case 460: acc = acc + w * 0.6; break;
+      case 461: acc = acc + w * 0.7; break;
+      case 462: acc = acc + w * 0.1; break;
+      case 463: acc = acc + w * 0.2; break;
+      case 464: acc = acc + w * 0.3; break;
+      case 465: acc = acc + w * 0.4; break;
+      case 466: acc = acc + w * 0.5; break;
+      case 467: acc = acc + w * 0.6; break;
+      case 468: acc = acc + w * 0.7; break;
+      case 469: acc = acc + w * 0.1; break;
+      case 470: acc = acc + w * 0.2; break;
+      case 471: acc = acc + w * 0.3; break;
+      case 472: acc = acc + w * 0.4; break;
+      case 473: acc = acc + w * 0.5; break;
+      case 474: acc = acc + w * 0.6; break;
+      case 475: acc = acc + w * 0.7; break;
+      case 476: acc = acc + w * 0.1; break;
+      case 477: acc = acc + w * 0.2; break;
+      case 478: acc = acc + w * 0.3; break;
+      case 479: acc = acc + w * 0.4; break;
+      case 480: acc = acc + w * 0.5; break;
+      case 481: acc = acc + w * 0.6; break;
+      case 482: acc = acc + w * 0.7; break;
+      case 483: acc = acc + w * 0.1; break;
+      case 484: acc = acc + w * 0.2; break;
+      case 485: acc = acc + w * 0.3; break;
+      case 486: acc = acc + w * 0.4; break;
+      case 487: acc = acc + w * 0.5; break;
+      case 488: acc = acc + w * 0.6; break;
+      case 489: acc = acc + w * 0.7; break;
+      case 490: acc = acc + w * 0.1; break;
+      case 491: acc = acc + w * 0.2; break;
+      case 492: acc = acc + w * 0.3; break;
+      case 493: acc = acc + w * 0.4; break;
+      case 494: acc = acc + w * 0.5; break;
+      case 495: acc = acc + w * 0.6; break;
+      case 496: acc = acc + w * 0.7; break;
+      case 497: acc = acc + w * 0.1; break;
+      case 498: acc = acc + w * 0.2; break;
+      case 499: acc = acc + w * 0.3; break;
+      case 500: acc = acc + w * 0.4; break;
+      case 501: acc = acc + w * 0.5; break;
+      case 502: acc = acc + w * 0.6; break;
+      case 503: acc = acc + w * 0.7; break;
+      case 504: acc = acc + w * 0.1; break;
+      case 505: acc = acc + w * 0.2; break;
+      case 506: acc = acc + w * 0.3; break;
+      case 507: acc = acc + w * 0.4; break;
+      case 508: acc = acc + w * 0.5; break;
+      case 509: acc = acc + w * 0.6; break;
+      case 510: acc = acc + w * 0.7; break;
+      case 511: acc = acc + w * 0.1; break;
+      case 512: acc = acc + w * 0.2; break;
+      case 513: acc = acc + w * 0.3; break;
+      case 514: acc = acc + w * 0.4; break;
+      case 515: acc = acc + w * 0.5; break;
+      case 516: acc = acc + w * 0.6; break;
+      case 517: acc = acc + w * 0.7; break;
+      case 518: acc = acc + w * 0.1; break;
+      case 519: acc = acc + w * 0.2; break;
+      case 520: acc = acc + w * 0.3; break;
+      case 521: acc = acc + w * 0.4; break;
+      case 522: acc = acc + w * 0.5; break;
+      case 523: acc = acc + w * 0.6; break;
+      case 524: acc = acc + w * 0.7; break;
+      case 525: acc = acc + w * 0.1; break;
+      case 526: acc = acc + w * 0.2; break;
+      case 527: acc = acc + w * 0.3; break;
+      case 528: acc = acc + w * 0.4; break;
+      case 529: acc = acc + w * 0.5; break;
+      case 530: acc = acc + w * 0.6; break;
+      case 531: acc = acc + w * 0.7; break;
+      case 532: acc = acc + w * 0.1; break;
+      case 533: acc = acc + w * 0.2; break;
+      case 534: acc = acc + w * 0.3; break;
+      case 535: acc = acc + w * 0.4; break;
+      case 536: acc = acc + w * 0.5; break;
+      case 537: acc = acc + w * 0.6; break;
+      case 538: acc = acc + w * 0.7; break;
+      case 539: acc = acc + w * 0.1; break;
+      case 540: acc = acc + w * 0.2; break;
+      case 541: acc = acc + w * 0.3; break;
+      case 542: acc = acc + w * 0.4; break;
+      case 543: acc = acc + w * 0.5; break;
+      case 544: acc = acc + w * 0.6; break;
+      case 545: acc = acc + w * 0.7; break;
+      case 546: acc = acc + w * 0.1; break;
+      case 547: acc = acc + w * 0.2; break;
+      case 548: acc = acc + w * 0.3; break;
+      case 549: acc = acc + w * 0.4; break;
+      case 550: acc = acc + w * 0.5; break;
+      case 551: acc = acc + w * 0.6; break;
+      case 552: acc = acc + w * 0.7; break;
+      case 553: acc = acc + w * 0.1; break;
+      case 554: acc = acc + w * 0.2; break;
+      case 555: acc = acc + w * 0.3; break;
+      case 556: acc = acc + w * 0.4; break;
+      case 557: acc = acc + w * 0.5; break;
+      case 558: acc = acc + w * 0.6; break;
+      case 559: acc = acc + w * 0.7; break;
+      case 560: acc = acc + w * 0.1; break;
+      case 561: acc = acc + w * 0.2; break;
+      case 562: acc = acc + w * 0.3; break;
+      case 563: acc = acc + w * 0.4; break;
+      case 564: acc = acc + w * 0.5; break;
+      case 565: acc = acc + w * 0.6; break;
+      case 566: acc = acc + w * 0.7; break;
+      case 567: acc = acc + w * 0.1; break;
+      case 568: acc = acc + w * 0.2; break;
+      case 569: acc = acc + w * 0.3; break;
+      case 570: acc = acc + w * 0.4; break;
+      case 571: acc = acc + w * 0.5; break;
+      case 572: acc = acc + w * 0.6; break;
+      case 573: acc = acc + w * 0.7; break;
+      case 574: acc = acc + w * 0.1; break;
+      case 575: acc = acc + w * 0.2; break;
+      case 576: acc = acc + w * 0.3; break;
+      case 577: acc = acc + w * 0.4; break;
+      case 578: acc = acc + w * 0.5; break;
+      case 579: acc = acc + w * 0.6; break;
+      case 580: acc = acc + w * 0.7; break;
+      case 581: acc = acc + w * 0.1; break;
+      case 582: acc = acc + w * 0.2; break;
+      case 583: acc = acc + w * 0.3; break;
+      case 584: acc = acc + w * 0.4; break;
+      case 585: acc = acc + w * 0.5; break;
+      case 586: acc = acc + w * 0.6; break;
+      case 587: acc = acc + w * 0.7; break;
+      case 588: acc = acc + w * 0.1; break;
+      case 589: acc = acc + w * 0.2; break;
+      case 590: acc = acc + w * 0.3; break;
+      case 591: acc = acc + w * 0.4; break;
+      case 592: acc = acc + w * 0.5; break;
+      case 593: acc = acc + w * 0.6; break;
+      case 594: acc = acc + w * 0.7; break;
+      case 595: acc = acc + w * 0.1; break;
+      case 596: acc = acc + w * 0.2; break;
+      case 597: acc = acc + w * 0.3; break;
+      case 598: acc = acc + w * 0.4; break;
+      case 599: acc = acc + w * 0.5; break;
+      case 600: acc = acc + w * 0.6; break;
+      case 601: acc = acc + w * 0.7; break;
+      case 602: acc = acc + w * 0.1; break;
+      case 603: acc = acc + w * 0.2; break;
+      case 604: acc = acc + w * 0.3; break;
+      case 605: acc = acc + w * 0.4; break;
+      case 606: acc = acc + w * 0.5; break;
+      case 607: acc = acc + w * 0.6; break;
+      case 608: acc = acc + w * 0.7; break;
+      case 609: acc = acc + w * 0.1; break;
+      case 610: acc = acc + w * 0.2; break;
+      case 611: acc = acc + w * 0.3; break;
+      case 612: acc = acc + w * 0.4; break;
+      case 613: acc = acc + w * 0.5; break;
+      case 614: acc = acc + w * 0.6; break;
+      case 615: acc = acc + w * 0.7; break;
+      case 616: acc = acc + w * 0.1; break;
+      case 617: acc = acc + w * 0.2; break;
+      case 618: acc = acc + w * 0.3; break;
+      case 619: acc = acc + w * 0.4; break;
+      case 620: acc = acc + w * 0.5; break;
+      case 621: acc = acc + w * 0.6; break;
+      case 622: acc = acc + w * 0.7; break;
+      case 623: acc = acc + w * 0.1; break;
+      case 624: acc = acc + w * 0.2; break;
+      case 625: acc = acc + w * 0.3; break;
+      case 626: acc = acc + w * 0.4; break;
+      case 627: acc = acc + w * 0.5; break;
+      case 628: acc = acc + w * 0.6; break;
+      case 629: acc = acc + w * 0.7; break;
+      case 630: acc = acc + w * 0.1; break;
+      case 631: acc = acc + w * 0.2; break;
+      case 632: acc = acc + w * 0.3; break;
+      case 633: acc = acc + w * 0.4; break;
+      case 634: acc = acc + w * 0.5; break;
+      case 635: acc = acc + w * 0.6; break;
+      case 636: acc = acc + w * 0.7; break;
+      case 637: acc = acc + w * 0.1; break;
+      case 638: acc = acc + w * 0.2; break;
+      case 639: acc = acc + w * 0.3; break;
+      case 640: acc = acc + w * 0.4; break;
+      case 641: acc = acc + w * 0.5; break;
+      case 642: acc = acc + w * 0.6; break;
+      case 643: acc = acc + w * 0.7; break;
+      case 644: acc = acc + w * 0.1; break;
+      case 645: acc = acc + w * 0.2; break;
+      case 646: acc = acc + w * 0.3; break;
+      case 647: acc = acc + w * 0.4; break;
+      case 648: acc = acc + w * 0.5; break;
+      case 649: acc = acc + w * 0.6; break;
+      case 650: acc = acc + w * 0.7; break;
+      case 651: acc = acc + w * 0.1; break;
+      case 652: acc = acc + w * 0.2; break;
+      case 653: acc = acc + w * 0.3; break;
+      case 654: acc = acc + w * 0.4; break;
+      case 655: acc = acc + w * 0.5; break;
+      case 656: acc = acc + w * 0.6; break;
+      case 657: acc = acc + w * 0.7; break;
+      case 658: acc = acc + w * 0.1; break;
+      case 659: acc = acc + w * 0.2; break;
+      case 660: acc = acc + w * 0.3; break;
+      case 661: acc = acc + w * 0.4; break;
+      case 662: acc = acc + w * 0.5; break;
+      case 663: acc = acc + w * 0.6; break;
+      case 664: acc = acc + w * 0.7; break;
+      case 665: acc = acc + w * 0.1; break;
+      case 666: acc = acc + w * 0.2; break;
+      case 667: acc = acc + w * 0.3; break;
+      case 668: acc = acc + w * 0.4; break;
+      case 669: acc = acc + w * 0.5; break;
+      case 670: acc = acc + w * 0.6; break;
+      case 671: acc = acc + w * 0.7; break;
+      case 672: acc = acc + w * 0.1; break;
+      case 673: acc = acc + w * 0.2; break;
+      case 674: acc = acc + w * 0.3; break;
+      case 675: acc = acc + w * 0.4; break;
+      case 676: acc = acc + w * 0.5; break;
+      case 677: acc = acc + w * 0.6; break;
+      case 678: acc = acc + w * 0.7; break;
+      case 679: acc = acc + w * 0.1; break;
+      case 680: acc = acc + w * 0.2; break;
+      case 681: acc = acc + w * 0.3; break;
+      case 682: acc = acc + w * 0.4; break;
+      case 683: acc = acc + w * 0.5; break;
+      case 684: acc = acc + w * 0.6; break;
+      case 685: acc = acc + w * 0.7; break;
+      case 686: acc = acc + w * 0.1; break;
+      case 687: acc = acc + w * 0.2; break;
+      case 688: acc = acc + w * 0.3; break;
+      case 689: acc = acc + w * 0.4; break;
+      case 690: acc = acc + w * 0.5; break;
+      case 691: acc = acc + w * 0.6; break;
+      case 692: acc = acc + w * 0.7; break;
+      case 693: acc = acc + w * 0.1; break;
+      case 694: acc = acc + w * 0.2; break;
+      case 695: acc = acc + w * 0.3; break;
+      case 696: acc = acc + w * 0.4; break;
+      case 697: acc = acc + w * 0.5; break;
+      case 698: acc = acc + w * 0.6; break;
+      case 699: acc = acc + w * 0.7; break;
+      case 700: acc = acc + w * 0.1; break;
+      case 701: acc = acc + w * 0.2; break;
+      case 702: acc = acc + w * 0.3; break;
+      case 703: acc = acc + w * 0.4; break;
+      case 704: acc = acc + w * 0.5; break;
+      case 705: acc = acc + w * 0.6; break;
+      case 706: acc = acc + w * 0.7; break;
+      case 707: acc = acc + w * 0.1; break;
+      case 708: acc = acc + w * 0.2; break;
+      case 709: acc = acc + w * 0.3; break;
+      case 710: acc = acc + w * 0.4; break;
+      case 711: acc = acc + w * 0.5; break;
+      case 712: acc = acc + w * 0.6; break;
+      case 713: acc = acc + w * 0.7; break;
+      case 714: acc = acc + w * 0.1; break;
+      case 715: acc = acc + w * 0.2; break;
+      case 716: acc = acc + w * 0.3; break;
+      case 717: acc = acc + w * 0.4; break;
+      case 718: acc = acc + w * 0.5; break;
+      case 719: acc = acc + w * 0.6; break;
+      case 720: acc = acc + w * 0.7; break;
+      case 721: acc = acc + w * 0.1; break;
+      case 722: acc = acc + w * 0.2; break;
+      case 723: acc = acc + w * 0.3; break;
+      case 724: acc = acc + w * 0.4; break;
+      case 725: acc = acc + w * 0.5; break;
+      case 726: acc = acc + w * 0.6; break;
+      case 727: acc = acc + w * 0.7; break;
+      case 728: acc = acc + w * 0.1; break;
+      case 729: acc = acc + w * 0.2; break;
+      case 730: acc = acc + w * 0.3; break;
+      case 731: acc = acc + w * 0.4; break;
+      case 732: acc = acc + w * 0.5; break;
+      case 733: acc = acc + w * 0.6; break;
+      case 734: acc = acc + w * 0.7; break;
+      case 735: acc = acc + w * 0.1; break;
+      case 736: acc = acc + w * 0.2; break;
+      case 737: acc = acc + w * 0.3; break;
+      case 738: acc = acc + w * 0.4; break;
+      case 739: acc = acc + w * 0.5; break;
+      case 740: acc = acc + w * 0.6; break;
+      case 741: acc = acc + w * 0.7; break;
+      case 742: acc = acc + w * 0.1; break;
+      case 743: acc = acc + w * 0.2; break;
+      case 744: acc = acc + w * 0.3; break;
+      case 745: acc = acc + w * 0.4; break;
+      case 746: acc = acc + w * 0.5; break;
+      case 747: acc = acc + w * 0.6; break;
+      case 748: acc = acc + w * 0.7; break;
+      case 749: acc = acc + w * 0.1; break;
+      case 750: acc = acc + w * 0.2; break;
+      case 751: acc = acc + w * 0.3; break;
+      case 752: acc = acc + w * 0.4; break;
+      case 753: acc = acc + w * 0.5; break;
+      case 754: acc = acc + w * 0.6; break;
+      case 755: acc = acc + w * 0.7; break;
+      case 756: acc = acc + w * 0.1; break;
+      case 757: acc = acc + w * 0.2; break;
+      case 758: acc = acc + w * 0.3; break;
+      case 759: acc = acc + w * 0.4; break;
+      case 760: acc = acc + w * 0.5; break;
+      case 761: acc = acc + w * 0.6; break;
+      case 762: acc = acc + w * 0.7; break;
+      case 763: acc = acc + w * 0.1; break;
+      case 764: acc = acc + w * 0.2; break;
+      case 765: acc = acc + w * 0.3; break;
+      case 766: acc = acc + w * 0.4; break;
+      case 767: acc = acc + w * 0.5; break;
+      case 768: acc = acc + w * 0.6; break;
+      case 769: acc = acc + w * 0.7; break;
+      case 770: acc = acc + w * 0.1; break;
+      case 771: acc = acc + w * 0.2; break;
+      case 772: acc = acc + w * 0.3; break;
+      case 773: acc = acc + w * 0.4; break;
+      case 774: acc = acc + w * 0.5; break;
+      case 775: acc = acc + w * 0.6; break;
+      case 776: acc = acc + w * 0.7; break;
+      case 777: acc = acc + w * 0.1; break;
+      case 778: acc = acc + w * 0.2; break;
+      case 779: acc = acc + w * 0.3; break;
+      case 780: acc = acc + w * 0.4; break;
+      case 781: acc = acc + w * 0.5; break;
+      case 782: acc = acc + w * 0.6; break;
+      case 783: acc = acc + w * 0.7; break;
+      case 784: acc = acc + w * 0.1; break;
+      case 785: acc = acc + w * 0.2; break;
+      case 786: acc = acc + w * 0.3; break;
+      case 787: acc = acc + w * 0.4; break;
+      case 788: acc = acc + w * 0.5; break;
+      case 789: acc = acc + w * 0.6; break;
+      case 790: acc = acc + w * 0.7; break;
+      case 791: acc = acc + w * 0.1; break;
+      case 792: acc = acc + w * 0.2; break;
+      case 793: acc = acc + w * 0.3; break;
+      case 794: acc = acc + w * 0.4; break;
+      case 795: acc = acc + w * 0.5; break;
+      case 796: acc = acc + w * 0.6; break;
+      case 797: acc = acc + w * 0.7; break;
+      case 798: acc = acc + w * 0.1; break;
+      case 799: acc = acc + w * 0.2; break;
+      case 800: acc = acc + w * 0.3; break;
+      case 801: acc = acc + w * 0.4; break;
+      case 802: acc = acc + w * 0.5; break;
+      case 803: acc = acc + w * 0.6; break;
+      case 804: acc = acc + w * 0.7; break;
+      case 805: acc = acc + w * 0.1; break;
+      case 806: acc = acc + w * 0.2; break;
+      case 807: acc = acc + w * 0.3; break;
+      case 808: acc = acc + w * 0.4; break;
+      case 809: acc = acc + w * 0.5; break;
+      case 810: acc = acc + w * 0.6; break;
+      case 811: acc = acc + w * 0.7; break;
+      case 812: acc = acc + w * 0.1; break;
+      case 813: acc = acc + w * 0.2; break;
+      case 814: acc = acc + w * 0.3; break;
+      case 815: acc = acc + w * 0.4; break;
+      case 816: acc = acc + w * 0.5; break;
+      case 817: acc = acc + w * 0.6; break;
+      case 818: acc = acc + w * 0.7; break;
+      case 819: acc = acc + w * 0.1; break;
+      case 820: acc = acc + w * 0.2; break;
+      case 821: acc = acc + w * 0.3; break;
+      case 822: acc = acc + w * 0.4; break;
+      case 823: acc = acc + w * 0.5; break;
+      case 824: acc = acc + w * 0.6; break;
+      case 825: acc = acc + w * 0.7; break;
+      case 826: acc = acc + w * 0.1; break;
+      case 827: acc = acc + w * 0.2; break;
+      case 828: acc = acc + w * 0.3; break;
+      case 829: acc = acc + w * 0.4; break;
+      case 830: acc = acc + w * 0.5; break;
+      case 831: acc = acc + w * 0.6; break;
+      case 832: acc = acc + w * 0.7; break;
+      case 833: acc = acc + w * 0.1; break;
+      case 834: acc = acc + w * 0.2; break;
+      case 835: acc = acc + w * 0.3; break;
+      case 836: acc = acc + w * 0.4; break;
+      case 837: acc = acc + w * 0.5; break;
+      case 838: acc = acc + w * 0.6; break;
+      case 839: acc = acc + w * 0.7; break;
+      case 840: acc = acc + w * 0.1; break;
+      case 841: acc = acc + w * 0.2; break;
+      case 842: acc = acc + w * 0.3; break;
+      case 843: acc = acc + w * 0.4; break;
+      case 844: acc = acc + w * 0.5; break;
+      case 845: acc = acc + w * 0.6; break;
+      case 846: acc = acc + w * 0.7; break;
+      case 847: acc = acc + w * 0.1; break;
+      case 848: acc = acc + w * 0.2; break;
+      case 849: acc = acc + w * 0.3; break;
+      case 850: acc = acc + w * 0.4; break;
+      case 851: acc = acc + w * 0.5; break;
+      case 852: acc = acc + w * 0.6; break;
+      case 853: acc = acc + w * 0.7; break;
+      case 854: acc = acc + w * 0.1; break;
+      case 855: acc = acc + w * 0.2; break;
+      case 856: acc = acc + w * 0.3; break;
+      case 857: acc = acc + w * 0.4; break;
+      case 858: acc = acc + w * 0.5; break;
+      case 859: acc = acc + w * 0.6; break;
+      case 860: acc = acc + w * 0.7; break;
+      case 861: acc = acc + w * 0.1; break;
+      case 862: acc = acc + w * 0.2; break;
+      case 863: acc = acc + w * 0.3; break;
+      case 864: acc = acc + w * 0.4; break;
+      case 865: acc = acc + w * 0.5; break;
+      case 866: acc = acc + w * 0.6; break;
+      case 867: acc = acc + w * 0.7; break;
+      case 868: acc = acc + w * 0.1; break;
+      case 869: acc = acc + w * 0.2; break;
+      case 870: acc = acc + w * 0.3; break;
+      case 871: acc = acc + w * 0.4; break;
+      case 872: acc = acc + w * 0.5; break;
+      case 873: acc = acc + w * 0.6; break;
+      case 874: acc = acc + w * 0.7; break;
+      case 875: acc = acc + w * 0.1; break;
+      case 876: acc = acc + w * 0.2; break;
+      case 877: acc = acc + w * 0.3; break;
+      case 878: acc = acc + w * 0.4; break;
+      case 879: acc = acc + w * 0.5; break;
+      case 880: acc = acc + w * 0.6; break;
+      case 881: acc = acc + w * 0.7; break;
+      case 882: acc = acc + w * 0.1; break;
+      case 883: acc = acc + w * 0.2; break;
+      case 884: acc = acc + w * 0.3; break;
+      case 885: acc = acc + w * 0.4; break;
+      case 886: acc = acc + w * 0.5; break;
+      case 887: acc = acc + w * 0.6; break;
+      case 888: acc = acc + w * 0.7; break;
+      case 889: acc = acc + w * 0.1; break;
+      case 890: acc = acc + w * 0.2; break;
+      case 891: acc = acc + w * 0.3; break;
+      case 892: acc = acc + w * 0.4; break;
+      case 893: acc = acc + w * 0.5; break;
+      case 894: acc = acc + w * 0.6; break;
+      case 895: acc = acc + w * 0.7; break;
+      case 896: acc = acc + w * 0.1; break;
+      case 897: acc = acc + w * 0.2; break;
+      case 898: acc = acc + w * 0.3; break;
+      case 899: acc = acc + w * 0.4; break;
+      case 900: acc = acc + w * 0.5; break;
+      case 901: acc = acc + w * 0.6; break;
+      case 902: acc = acc + w * 0.7; break;
+      case 903: acc = acc + w * 0.1; break;
+      case 904: acc = acc + w * 0.2; break;
+      case 905: acc = acc + w * 0.3; break;
+      case 906: acc = acc + w * 0.4; break;
+      case 907: acc = acc + w * 0.5; break;
+      case 908: acc = acc + w * 0.6; break;
+      case 909: acc = acc + w * 0.7; break;
+      case 910: acc = acc + w * 0.1; break;
+      case 911: acc = acc + w * 0.2; break;
+      case 912: acc = acc + w * 0.3; break;
+      case 913: acc = acc + w * 0.4; break;
+      case 914: acc = acc + w * 0.5; break;
+      case 915: acc = acc + w * 0.6; break;
+      case 916: acc = acc + w * 0.7; break;
+      case 917: acc = acc + w * 0.1; break;
+      case 918: acc = acc + w * 0.2; break;
+      case 919: acc = acc + w * 0.3; break;
+      case 920: acc = acc + w * 0.4; break;
+      case 921: acc = acc + w * 0.5; break;
+      case 922: acc = acc + w * 0.6; break;
+      case 923: acc = acc + w * 0.7; break;
+      case 924: acc = acc + w * 0.1; break;
+      case 925: acc = acc + w * 0.2; break;
+      case 926: acc = acc + w * 0.3; break;
+      case 927: acc = acc + w * 0.4; break;
+      case 928: acc = acc + w * 0.5; break;
+      case 929: acc = acc + w * 0.6; break;
+      case 930: acc = acc + w * 0.7; break;
+      case 931: acc = acc + w * 0.1; break;
+      case 932: acc = acc + w * 0.2; break;
+      case 933: acc = acc + w * 0.3; break;
+      case 934: acc = acc + w * 0.4; break;
+      case 935: acc = acc + w * 0.5; break;
+      case 936: acc = acc + w * 0.6; break;
+      case 937: acc = acc + w * 0.7; break;
+      case 938: acc = acc + w * 0.1; break;
+      case 939: acc = acc + w * 0.2; break;
+      case 940: acc = acc + w * 0.3; break;
+      case 941: acc = acc + w * 0.4; break;
+      case 942: acc = acc + w * 0.5; break;
+      case 943: acc = acc + w * 0.6; break;
+      case 944: acc = acc + w * 0.7; break;
+      case 945: acc = acc + w * 0.1; break;
+      case 946: acc = acc + w * 0.2; break;
+      case 947: acc = acc + w * 0.3; break;
+      case 948: acc = acc + w * 0.4; break;
+      case 949: acc = acc + w * 0.5; break;
+      case 950: acc = acc + w * 0.6; break;
+      case 951: acc = acc + w * 0.7; break;
+      case 952: acc = acc + w * 0.1; break;
+      case 953: acc = acc + w * 0.2; break;
+      case 954: acc = acc + w * 0.3; break;
+      case 955: acc = acc + w * 0.4; break;
+      case 956: acc = acc + w * 0.5; break;
+      case 957: acc = acc + w * 0.6; break;
+      case 958: acc = acc + w * 0.7; break;
+      case 959: acc = acc + w * 0.1; break;
+      case 960: acc = acc + w * 0.2; break;
+      case 961: acc = acc + w * 0.3; break;
+      case 962: acc = acc + w * 0.4; break;
+      case 963: acc = acc + w * 0.5; break;
+      case 964: acc = acc + w * 0.6; break;
+      case 965: acc = acc + w * 0.7; break;
+      case 966: acc = acc + w * 0.1; break;
+      case 967: acc = acc + w * 0.2; break;
+      case 968: acc = acc + w * 0.3; break;
+      case 969: acc = acc + w * 0.4; break;
+      case 970: acc = acc + w * 0.5; break;
+      case 971: acc = acc + w * 0.6; break;
+      case 972: acc = acc + w * 0.7; break;
+      case 973: acc = acc + w * 0.1; break;
+      case 974: acc = acc + w * 0.2; break;
+      case 975: acc = acc + w * 0.3; break;
+      case 976: acc = acc + w * 0.4; break;
+      case 977: acc = acc + w * 0.5; break;
+      case 978: acc = acc + w * 0.6; break;
+      case 979: acc = acc + w * 0.7; break;
+      case 980: acc = acc + w * 0.1; break;
+      case 981: acc = acc + w * 0.2; break;
+      case 982: acc = acc + w * 0.3; break;
+      case 983: acc = acc + w * 0.4; break;
+      case 984: acc = acc + w * 0.5; break;
+      case 985: acc = acc + w * 0.6; break;
+      case 986: acc = acc + w * 0.7; break;
+      case 987: acc = acc + w * 0.1; break;
+      case 988: acc = acc + w * 0.2; break;
+      case 989: acc = acc + w * 0.3; break;
+      case 990: acc = acc + w * 0.4; break;
+      case 991: acc = acc + w * 0.5; break;
+      case 992: acc = acc + w * 0.6; break;
+      case 993: acc = acc + w * 0.7; break;
+      case 994: acc = acc + w * 0.1; break;
+      case 995: acc = acc + w * 0.2; break;
+      case 996: acc = acc + w * 0.3; break;
+      case 997: acc = acc + w * 0.4; break;
+      case 998: acc = acc + w * 0.5; break;
+      case 999: acc = acc + w * 0.6; break;
+      default: acc = acc - 1.0; break;
+    }
+  }
+  return acc;
+}
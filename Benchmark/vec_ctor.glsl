@@ -0,0 +1,17 @@
+vec4 a;
+
+float vecctor(int n)
+{
+  int i;
+  float t;
+  vec4 acc;
+  vec4 p;
+  acc = vec4(0.0);
+  t = 0.0;
+  for ( i = 0; i < n; i++ ) {
+    p = vec4(a.xy, t, 1.0);
+    acc = acc + p * vec4(a.w, t, a.z, 0.5) + vec4(p.zw, a.yx);
+    t = t + 0.001;
+  }
+  return acc.x + acc.y + acc.z + acc.w;
+}
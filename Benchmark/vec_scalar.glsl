@@ -0,0 +1,19 @@
+vec4 base;
+
+float vecscalar(int n)
+{
+  int i;
+  float x;
+  vec4 v;
+  vec4 acc;
+  acc = vec4(0.0, 0.0, 0.0, 0.0);
+  for ( i = 0; i < n; i++ ) {
+    x = float(i) * 0.001;
+    v = base * x + x;
+    v = v / 2.0 - x;
+    acc += v * 0.5;
+    acc *= 0.999;
+    acc.xy -= x;
+  }
+  return acc.x + acc.y + acc.z + acc.w;
+}
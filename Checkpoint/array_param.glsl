@@ -0,0 +1,27 @@
+float sum(float a[4])
+{
+   int i;
+   float s;
+   s = 0.0;
+   for ( i = 0; i < 4; i++ )
+      s = s + a[i];
+   return s;
+}
+
+float scaled(float b[4], float k)
+{
+   int i;
+   for ( i = 0; i < 4; i++ )
+      b[i] = b[i] * k;
+   return sum(b);
+}
+
+float arrayparam(float k)
+{
+   float t[4];
+   t[0] = 1.0;
+   t[1] = 2.0;
+   t[2] = 3.0;
+   t[3] = 4.0;
+   return scaled(t, k) + sum(t);
+}
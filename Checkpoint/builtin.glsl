@@ -0,0 +1,16 @@
+
+vec3 v;
+
+float builtins(float t)
+{
+   float r;
+   r = length(v);
+   r = r + dot(v, vec3(1.0));
+   r = r + min(v.x, v.y) + max(v, vec3(5.0)).x;
+   r = r + clamp(v.z, 0.0, 10.0);
+   r = r + mix(2.0, 6.0, t);
+   r = r + sqrt(16.0) + pow(2.0, 3.0) + abs(1.0 - 3.5);
+   r = r + floor(2.75) + fract(2.75);
+   r = r + floor(normalize(v).z * 13.0 + 0.5);
+   return r;
+}
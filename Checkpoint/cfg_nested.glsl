@@ -0,0 +1,26 @@
+float cfgnested(int n)
+{
+   int i;
+   float r;
+   r = 0.0;
+   for ( i = 0; i < n; i++ ) {
+      if ( i == 1 )
+         continue;
+      switch ( i ) {
+        case 2: r = r + 10.0; continue;
+        case 5: r = r + 100.0;
+        default: r = r + 1.0; break;
+      }
+      if ( i > 6 ) {
+         r = r * 2.0;
+         break;
+      } else {
+         r = r + 0.5;
+      }
+   }
+   while ( true ) {
+      if ( r > 500.0 )
+         return r;
+      r = r * 3.0;
+   }
+}
@@ -1,12 +1,16 @@
 #!/bin/bash
 
 # Running './check.sh' will not rebuild your project, but './check.sh .' will
+# Set GLCFLAGS to pass extra options to glc, e.g. GLCFLAGS=-fssa ./check.sh
+# Each test's .dat is passed as -fdat so glc knows the entry point
+# Set GLI=glc-exec to run the tests through the batch executor instead of gli
 
 RED='\033[0;31m'
 GREEN='\033[0;32m'
 YELL='\033[0;33m' 
 NC='\033[0m' # Default Color
 
+GLI=${GLI:-gli}
 TA="cse131_testcases"  # name of directory containing TA's test cases
 
 
@@ -50,7 +54,9 @@ function runTest {
         printf "${NC}${prefix}Test case %s: " $fbname
                  
         # glc
-        eval $path/glc < $glsl > $bc 2> /dev/null        
+        entry=""
+        [ -f ${fbname}.dat ] && entry="-fdat=${fbname}.dat"
+        eval $path/glc $GLCFLAGS $entry < $glsl > $bc 2> /dev/null
         if [ $? -ne 0 ]; then 
                 printf "$YELL\nglc exited with error status\n"
                 printf "run  ../glc < $glsl  for more info\n"
@@ -58,17 +64,17 @@ function runTest {
         fi
 
         # gli
-        eval $path/gli $bc &> /dev/null
+        eval $path/$GLI $bc &> /dev/null
         if [ $? -ne 0 ]; then
-                printf "$YELL\ngli exited with error status\n"
-                printf "run  ../gli $bc  for more info\n"
+                printf "$YELL\n$GLI exited with error status\n"
+                printf "run  ../$GLI $bc  for more info\n"
                 continue
         fi
 
 
 
         # Print Result
-        if diff <(eval $path/gli $bc 2> /dev/null) $out ; then
+        if diff <(eval $path/$GLI $bc 2> /dev/null) $out ; then
                 printf "$GREEN PASS\n"
         else
                 printf "$RED FAIL\n"  
@@ -0,0 +1,18 @@
+
+const int N = 4;
+const float SCALE = 0.5 * float(N);
+const vec3 AXIS = vec3(1.0, -2.0, SCALE);
+float bias = SCALE + 1.0;
+
+float constfold(int n)
+{
+   const float k = AXIS.z * 3.0;
+   float r;
+   int i;
+   r = 0.0;
+   for ( i = 0; i < N; i++ )
+      r = r + k;
+   r = r + (N > 2 ? AXIS.y : 100.0);
+   r = r + dot(AXIS, vec3(1.0)) * bias;
+   return r - float(n);
+}
@@ -0,0 +1,21 @@
+#pragma fastmath
+float poly(float x)
+{
+   return x * x * 0.5 + x * 2.0 + 1.0;
+}
+
+#pragma fastmath none
+float strict(float a, float b)
+{
+   return a * b + a;
+}
+
+float fastmath(int n)
+{
+   int i;
+   float s;
+   s = 0.0;
+   for ( i = 0; i < n; i++ )
+      s = s + poly(float(i)) + strict(float(i), 0.25);
+   return s;
+}
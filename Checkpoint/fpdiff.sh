@@ -0,0 +1,73 @@
+#!/bin/bash
+
+# Reports how far results drift from the .out goldens under fast-math.
+# Running './fpdiff.sh' will not rebuild your project, but './fpdiff.sh .' will
+# Set FASTMATH to the flags under test (default -ffast-math), e.g.
+#   FASTMATH="-fcontract -fnnan" ./fpdiff.sh
+
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELL='\033[0;33m' 
+NC='\033[0m' # Default Color
+
+FASTMATH=${FASTMATH:--ffast-math}
+
+dir=$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )
+cd $dir  # This should allow you to call this script from anywhere
+
+# If glc is missing or argument is specified, rebuild project
+if [ ! -f ../glc ] || [ $# -eq 1 ]; then
+  printf "$YELL Rebuilding project...\n $NC"
+  (cd .. && make clean && make -j8)
+fi
+
+if [ ! -f ../glc ]; then
+  printf "$RED Unable to make project\n $NC"
+  exit 1
+fi
+
+rm *.bc 2> /dev/null
+
+function diffTest {
+        glsl=$1
+        fbname=${glsl%%.*}
+        bc=${fbname}.bc
+        out=${fbname}.out
+
+        entry=""
+        [ -f ${fbname}.dat ] && entry="-fdat=${fbname}.dat"
+        ../glc $GLCFLAGS $FASTMATH $entry < $glsl > $bc 2> /dev/null
+        if [ $? -ne 0 ]; then 
+                printf "$YELL%-24s glc exited with error status\n$NC" $fbname
+                return
+        fi
+
+        # largest absolute and relative difference over the numbers printed
+        paste -d' ' <(../gli $bc 2> /dev/null | tr -s ' ' '\n') <(tr -s ' ' '\n' < $out) |
+        awk -v name=$fbname -v red="$RED" -v green="$GREEN" -v yell="$YELL" -v nc="$NC" '
+            function abs(x) { return x < 0 ? -x : x }
+            $1 != $2 {
+                if ($1 + 0 == $1 && $2 + 0 == $2) {
+                    d = abs($1 - $2); r = $2 != 0 ? d / abs($2) : d
+                    if (d > maxabs) maxabs = d
+                    if (r > maxrel) maxrel = r
+                    drift = 1
+                } else
+                    bad = 1
+            }
+            END {
+                if (bad)
+                    printf "%s%-24s output differs%s\n", red, name, nc
+                else if (drift)
+                    printf "%s%-24s abs %.3e   rel %.3e%s\n", yell, name, maxabs, maxrel, nc
+                else
+                    printf "%s%-24s exact%s\n", green, name, nc
+            }'
+}
+
+printf "${NC}%-24s (GLCFLAGS='%s', FASTMATH='%s')\n" "test" "$GLCFLAGS" "$FASTMATH"
+for glsl in *.glsl; do
+    diffTest $glsl
+done
+
+printf $NC
@@ -0,0 +1,26 @@
+float scale;
+float unused;
+
+float sq(float x)
+{
+   return x * x;
+}
+
+vec2 swap(vec2 v)
+{
+   return vec2(v.y, v.x);
+}
+
+float helpers(int n)
+{
+   int i;
+   float s;
+   vec2 p;
+   s = 0.0;
+   p = vec2(1.0, 2.0);
+   for ( i = 0; i < n; i++ ) {
+      p = swap(p);
+      s = s + sq(p.x) * scale;
+   }
+   return s;
+}
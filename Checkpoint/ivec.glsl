@@ -0,0 +1,25 @@
+
+int ivecmix(int n)
+{
+   ivec4 h;
+   uvec2 u;
+   bvec2 b;
+   vec4 f;
+   int r;
+   h = ivec4(1);
+   h.y = 2;
+   h.z = 3;
+   h.w = 4;
+   h = h * 3 + ivec4(n);
+   h.yw = h.xz / 2;
+   f = vec4(h) * 0.5;
+   h = h - ivec4(f);
+   u = uvec2(h.zw);
+   b = bvec2(h.xy - ivec2(4));
+   r = h.x + h.y * 10 + h.z * 100 + h.w * 1000;
+   if ( b.y )
+      r = r + 10000;
+   if ( h.xy != ivec2(h.x) )
+      r = r + 20000;
+   return r + int(u.x / uint(2));
+}
@@ -0,0 +1,14 @@
+float loopivwrite(int n)
+{
+   int i;
+   float s;
+   s = 0.0;
+   for ( i = 0; i < 8; i++ ) {
+      s = s + float(i);
+      if ( i == n )
+         i = 5;
+   }
+   for ( i = 0; i < 3; i++ )
+      s = s + 100.0;
+   return s;
+}
@@ -0,0 +1,29 @@
+float loopunroll(int n)
+{
+   int i;
+   int j;
+   float s;
+   s = 0.0;
+   for ( i = 0; i < 4; i++ )
+      s = s + float(i);
+   for ( i = 0; i < 10; i++ ) {
+      if ( i == 2 )
+         continue;
+      if ( i == 6 )
+         break;
+      s = s + 1.0;
+   }
+   #pragma unroll 3
+   for ( i = 0; i < n; i++ )
+      s = s + 2.0;
+   #pragma unroll 1
+   for ( j = 8; j > 0; j -= 3 )
+      s = s + float(j);
+   #pragma unroll
+   #pragma vectorize 4
+   while ( i > 0 ) {
+      s = s + 0.5;
+      i--;
+   }
+   return s;
+}
@@ -0,0 +1,13 @@
+
+vec2 v;
+
+float matvec(float s)
+{
+   mat2 m;
+   vec2 r;
+   m = mat2(1.0, 2.0, 3.0, 4.0);
+   r = m * v;
+   m[1] = m[1] * s;
+   r = r + v * m;
+   return r.x + r.y;
+}
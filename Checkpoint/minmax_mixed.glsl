@@ -0,0 +1,12 @@
+vec3 v;
+
+float minmaxmixed(float x)
+{
+   float r;
+   vec3 c;
+   r = min(x, 1) + max(1, x);
+   c = clamp(v, 0, 5);
+   r = r + c.x + c.y + c.z;
+   r = r + max(v, 2).x + min(v, 4).z;
+   return r;
+}
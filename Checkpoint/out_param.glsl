@@ -0,0 +1,29 @@
+void minmax(float a, float b, out float lo, out float hi)
+{
+   if ( a < b ) {
+      lo = a;
+      hi = b;
+   }
+   else {
+      lo = b;
+      hi = a;
+   }
+}
+
+void accumulate(inout vec2 acc, float x)
+{
+   acc.x = acc.x + x;
+   acc.y = acc.y * x;
+}
+
+float outparam(float k)
+{
+   float lo;
+   float hi;
+   vec2 v;
+   minmax(k, 5.0, lo, hi);
+   v = vec2(1.0, 3.0);
+   accumulate(v, k);
+   minmax(hi, lo, v.y, v.x);
+   return lo + hi * 2.0 + v.x * 3.0 + v.y;
+}
@@ -0,0 +1,19 @@
+int count;
+
+bool touch(int v)
+{
+  count = count + 1;
+  return v > 0;
+}
+
+int shortcircuit(int a)
+{
+  int r;
+  r = 0;
+  if ( a > 5 && touch(a) )
+    r = r + 1;
+  if ( a < 5 || touch(a) )
+    r = r + 10;
+  r = r + (a > 100 ? (touch(a) ? 1000 : 0) : 0);
+  return r * 100 + count;
+}
@@ -0,0 +1,24 @@
+float ssavars(int n)
+{
+   int i;
+   int j;
+   float s;
+   vec3 v;
+   float a[4];
+   s = 0.0;
+   v = vec3(1.0, 2.0, 3.0);
+   for ( i = 0; i < 4; i++ )
+      a[i] = float(i) * 0.5;
+   for ( i = 0; i < n; i++ ) {
+      j = 0;
+      while ( j < i ) {
+         v.y = v.y + 1.0;
+         j++;
+      }
+      if ( i > 1 )
+         s = s + v.y;
+      else
+         s = s - a[i];
+   }
+   return s + v.x + v.z;
+}
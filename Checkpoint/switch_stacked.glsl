@@ -0,0 +1,16 @@
+float switchstacked(int n)
+{
+   int i;
+   float r;
+   r = 0.0;
+   for ( i = 0; i < n; i++ ) {
+      switch ( i ) {
+        case 0:
+        case 2: r = r + 1.0; break;
+        case 1: case 3: case 5: { r = r + 10.0; break; }
+        case 7:
+        default: r = r + 100.0;
+      }
+   }
+   return r;
+}
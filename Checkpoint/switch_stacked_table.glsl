@@ -0,0 +1,19 @@
+float switchstackedtable(int n)
+{
+   int i;
+   float w;
+   float r;
+   r = 0.0;
+   for ( i = 0; i < n; i++ ) {
+      switch ( i ) {
+        case 0: case 1: w = 0.5; break;
+        case 2: w = 2.0; break;
+        case 3:
+        case 4:
+        case 5: w = 4.0; break;
+        case 6: default: w = 8.0; break;
+      }
+      r = r + w;
+   }
+   return r;
+}
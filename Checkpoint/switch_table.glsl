@@ -0,0 +1,18 @@
+float switchtable(int n)
+{
+   int i;
+   float w;
+   float r;
+   r = 0.0;
+   for ( i = 0; i < n; i++ ) {
+      switch ( i - 2 ) {
+        case 0: w = 1.5; break;
+        case 1: { w = 2.0; break; }
+        case 2: w = 4.0; break;
+        case 4: w = 8.0; break;
+        default: w = 0.25; break;
+      }
+      r = r + w;
+   }
+   return r;
+}
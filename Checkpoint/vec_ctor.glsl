@@ -0,0 +1,16 @@
+
+vec2 v;
+
+float vecctor(float s)
+{
+   vec4 a;
+   vec3 b;
+   vec4 c;
+   mat2 m;
+   a = vec4(v.xy, 0.0, 1.0);
+   b = vec3(s, v.y, 3.0);
+   c = vec4(b.zy, v);
+   c = c + vec4(1.0, 2.0, 3.0, 4.0);
+   m = mat2(v, vec2(s, 1));
+   return dot(a, c) + b.x * 100.0 + length(vec2(3, 4)) + (m * v).y;
+}
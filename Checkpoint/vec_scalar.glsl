@@ -0,0 +1,15 @@
+float vecscalar(float x)
+{
+   vec4 v;
+   vec3 w;
+   v = vec4(1.0, 2.0, 3.0, 4.0) * x;
+   v = v + 1.0;
+   v = 12.0 - v;
+   v = v / 2.0;
+   v += x;
+   v *= 2.0;
+   v.xz -= 1.0;
+   w = v.xyz;
+   w /= x;
+   return w.x + w.y + w.z + v.w;
+}
@@ -67,6 +67,7 @@ class Node  {
     virtual ~Node() {}
     
     yyltype *GetLocation()   { return location; }
+    int GetLine()            { return location ? location->first_line : 0; }
     void SetParent(Node *p)  { parent = p; }
     Node *GetParent()        { return parent; }
 
@@ -2,11 +2,13 @@
  * -----------------
  * Implementation of Decl node classes.
  */
+#include <string.h>
 #include "ast_decl.h"
 #include "ast_type.h"
 #include "ast_stmt.h"
 #include "symtable.h"
 #include "ast.h"
+#include "errors.h"
   
 Decl::Decl(Identifier *n) : Node(*n->GetLocation()) {
     Assert(n != NULL);
@@ -42,32 +44,52 @@ void VarDecl::PrintChildren(int indentLevel) {
 }
 
 llvm::Value *VarDecl::Emit() {
-    llvm::Module *module = irgen->GetOrCreateModule("glsl.bc");
     llvm::Type *type = irgen->GetType(this->GetType());
-    llvm::Value* val;
-    if(GetAssignTo())
-        val=GetAssignTo()->Emit();
-    else
-        val=llvm::Constant::getNullValue(type);  
+    char *name = this->GetIdentifier()->GetName();
+
+    // const declarations and global initializers are folded at compile time
+    llvm::Constant *init = NULL;
+    if(GetAssignTo() && (symtab->global || isConst())) {
+        init = GetAssignTo()->EvalConstant();
+        if(init != NULL && init->getType() != type)
+            init = llvm::dyn_cast<llvm::Constant>(irgen->CreateCast(init, type, GetAssignTo()->IsUnsigned(), GetType()->IsUnsigned()));
+        if(init == NULL && symtab->global)
+            ReportError::Formatted(GetLocation(), "Initializer for global '%s' is not a constant expression", name);
+    }
+
     // Global Var
     if(symtab->global == true) {
-        llvm::Constant* init = dynamic_cast<llvm::Constant*>(val);
-        llvm::GlobalVariable *var = new llvm::GlobalVariable(*irgen->GetOrCreateModule("glsl.bc.bc"), type, isConst(), llvm::GlobalValue::ExternalLinkage, init, this->GetIdentifier()->GetName());
-        symtab->AddSymbol(this->GetIdentifier()->GetName(), var);
+        if(init == NULL)
+            init = llvm::Constant::getNullValue(type);
+        llvm::GlobalVariable *var = new llvm::GlobalVariable(*irgen->GetOrCreateModule("glsl.bc"), type, isConst(), irgen->GetGlobalLinkage(name), init, name);
+        symtab->AddSymbol(name, var, this->GetType(), isConst() ? init : NULL);
         return var;
-    }   
+    }
+    // Local const: uses see the folded value, no storage is needed
+    if(isConst() && init != NULL) {
+        symtab->AddSymbol(name, init, this->GetType(), init);
+        return init;
+    }
     // Local var
     else{
-        char *name = this->GetIdentifier()->GetName();
-        llvm::BasicBlock *bb = Node::irgen->GetBasicBlock();
-        llvm::Value *value =  new llvm::AllocaInst(type, name, bb);
+        llvm::Value* val = NULL;
         if(GetAssignTo())
-            llvm::Value* store=new llvm::StoreInst(val,value,bb);
-        symtab->AddSymbol(this->GetIdentifier()->GetName(), value);
+            val=GetAssignTo()->Emit();
+        // only locals that are never subscripted can live in registers
+        FnDecl *fn = FnDecl::Enclosing(this);
+        bool promotable = !type->isArrayTy() && (fn == NULL || !fn->IsIndexed(this));
+        llvm::Value *value = irgen->CreateLocal(type, name, promotable);
+        if(val)
+            irgen->CreateStore(val, value);
+        symtab->AddSymbol(name, value, this->GetType());
         return value;
     }
 }
 
+static map<string, FnDecl*> functions;
+static set<string> writtenGlobals;
+// the function whose body is being parsed
+static FnDecl *parsing = NULL;
 
 FnDecl::FnDecl(Identifier *n, Type *r, List<VarDecl*> *d) : Decl(n) {
     Assert(n != NULL && r!= NULL && d != NULL);
@@ -75,6 +97,12 @@ FnDecl::FnDecl(Identifier *n, Type *r, List<VarDecl*> *d) : Decl(n) {
     (formals=d)->SetParentAll(this);
     body = NULL;
     returnTypeq = NULL;
+    fastMath = -1;
+    usesFragCoord = false;
+    fragCoordIndexed = false;
+    masked = NULL;
+    functions[n->GetName()] = this;
+    parsing = this;
 }
 
 FnDecl::FnDecl(Identifier *n, Type *r, TypeQualifier *rq, List<VarDecl*> *d) : Decl(n) {
@@ -83,10 +111,125 @@ FnDecl::FnDecl(Identifier *n, Type *r, TypeQualifier *rq, List<VarDecl*> *d) : D
     (returnTypeq=rq)->SetParent(this);
     (formals=d)->SetParentAll(this);
     body = NULL;
+    fastMath = -1;
+    usesFragCoord = false;
+    fragCoordIndexed = false;
+    masked = NULL;
+    functions[n->GetName()] = this;
+    parsing = this;
+}
+
+FnDecl *FnDecl::LookUp(const char *name) {
+    map<string, FnDecl*>::iterator it = functions.find(name);
+    return it == functions.end() ? NULL : it->second;
 }
 
 void FnDecl::SetFunctionBody(Stmt *b) { 
     (body=b)->SetParent(this);
+    ResolveUses();
+    parsing = NULL;
+}
+
+void FnDecl::NoteFragCoord() {
+    if(parsing != NULL)
+        parsing->usesFragCoord = true;
+}
+
+void FnDecl::NoteIndexed(VarExpr *v) {
+    if(parsing != NULL)
+        parsing->indexedUses.push_back(v);
+}
+
+void FnDecl::NoteWritten(VarExpr *v) {
+    if(parsing != NULL)
+        parsing->writtenUses.push_back(v);
+}
+
+bool FnDecl::IsGlobalWritten(const char *name) {
+    return writtenGlobals.count(name) != 0;
+}
+
+FnDecl *FnDecl::Enclosing(Node *n) {
+    for(; n != NULL; n = n->GetParent())
+        if(FnDecl *fn = dynamic_cast<FnDecl*>(n))
+            return fn;
+    return NULL;
+}
+
+// The last declaration of name among the statements of list before child
+static VarDecl *DeclaredBefore(List<Stmt*> *list, Node *child, const char *name) {
+    VarDecl *found = NULL;
+    for(int i = 0; i < list->NumElements() && list->Nth(i) != child; i++) {
+        DeclStmt *ds = dynamic_cast<DeclStmt*>(list->Nth(i));
+        VarDecl *d = ds ? dynamic_cast<VarDecl*>(ds->GetDecl()) : NULL;
+        if(d != NULL && !strcmp(d->GetIdentifier()->GetName(), name))
+            found = d;
+    }
+    return found;
+}
+
+// The local or parameter a use in the body names: the nearest block (or
+// switch) declaring it before the statement holding the use, then the
+// formals. NULL for a global or the hidden gl_FragCoord.
+static VarDecl *Resolve(VarExpr *v) {
+    const char *name = v->GetIdentifier()->GetName();
+    Node *child = v;
+    for(Node *n = v->GetParent(); n != NULL; child = n, n = n->GetParent()) {
+        VarDecl *d = NULL;
+        if(StmtBlock *b = dynamic_cast<StmtBlock*>(n))
+            d = DeclaredBefore(b->GetStmts(), child, name);
+        else if(SwitchStmt *sw = dynamic_cast<SwitchStmt*>(n))
+            d = DeclaredBefore(sw->GetCases(), child, name);
+        else if(FnDecl *fn = dynamic_cast<FnDecl*>(n)) {
+            for(int i = 0; i < fn->GetFormals()->NumElements(); i++)
+                if(!strcmp(fn->GetFormals()->Nth(i)->GetIdentifier()->GetName(), name))
+                    d = fn->GetFormals()->Nth(i);
+            return d;
+        }
+        if(d != NULL)
+            return d;
+    }
+    return NULL;
+}
+
+void FnDecl::ResolveUses() {
+    for(size_t i = 0; i < indexedUses.size(); i++) {
+        VarDecl *d = Resolve(indexedUses[i]);
+        if(d != NULL)
+            indexed.insert(d);
+        else if(!strcmp(indexedUses[i]->GetIdentifier()->GetName(), "gl_FragCoord"))
+            fragCoordIndexed = true;
+    }
+    for(size_t i = 0; i < writtenUses.size(); i++) {
+        VarDecl *d = Resolve(writtenUses[i]);
+        if(d != NULL)
+            written.insert(d);
+        else
+            writtenGlobals.insert(writtenUses[i]->GetIdentifier()->GetName());
+    }
+    indexedUses.clear();
+}
+
+bool FnDecl::WritesVariable(Node *within, VarExpr *v) {
+    FnDecl *fn = Enclosing(v);
+    VarDecl *d = Resolve(v);
+    if(fn == NULL || d == NULL)
+        return true;
+    for(size_t i = 0; i < fn->writtenUses.size(); i++) {
+        VarExpr *w = fn->writtenUses[i];
+        if(strcmp(w->GetIdentifier()->GetName(), v->GetIdentifier()->GetName()) || Resolve(w) != d)
+            continue;
+        for(Node *n = w; n != NULL; n = n->GetParent())
+            if(n == within)
+                return true;
+    }
+    return false;
+}
+
+void FnDecl::SetFastMath(const char *spec) {
+    fastMath = IRGenerator::ParseFastMath(spec);
+    if(fastMath < 0)
+        ReportError::Formatted(GetLocation(), "Unknown flag in #pragma fastmath %s", spec);
 }
 
 void FnDecl::PrintChildren(int indentLevel) {
@@ -96,6 +239,43 @@ void FnDecl::PrintChildren(int indentLevel) {
     if (body) body->Print(indentLevel+1, "(body) ");
 }
 
+void FnDecl::EmitParams(llvm::Function *fun, llvm::Function::arg_iterator arg) {
+    for(int i = 0; arg != fun->arg_end(); arg++, i++) {
+        if(i == this->GetFormals()->NumElements()) {
+            // the hidden gl_FragCoord
+            arg->setName("gl_FragCoord");
+            llvm::Value *local = irgen->CreateLocal(arg->getType(), "gl_FragCoord", !fragCoordIndexed);
+            irgen->CreateStore(arg, local);
+            symtab->AddSymbol("gl_FragCoord", local, Type::vec4Type);
+            continue;
+        }
+        VarDecl *decl = this->GetFormals()->Nth(i);
+        char *id = decl->GetIdentifier()->GetName();
+        arg->setName(id);
+        if(!arg->getType()->isPointerTy())
+            irgen->CreateStore(arg, decl->Emit());
+        // out and inout parameters live in a local that every return
+        // copies back, so the caller sees the writes only once it resumes
+        else if(decl->isOut()) {
+            fun->addAttribute(arg->getArgNo() + 1, llvm::Attribute::NoCapture);
+            llvm::Value *local = decl->Emit();
+            if(decl->isInOut())
+                irgen->CreateStore(irgen->CreateLoad(arg), local);
+            irgen->AddCopyOut(local, arg);
+        }
+        else {
+            // an array the function writes is copied, since the caller's
+            // must not change; otherwise it is used in place
+            fun->addAttribute(arg->getArgNo() + 1, llvm::Attribute::ReadOnly);
+            fun->addAttribute(arg->getArgNo() + 1, llvm::Attribute::NoCapture);
+            if(IsWritten(decl))
+                irgen->CreateStore(irgen->CreateLoad(arg), decl->Emit());
+            else
+                symtab->AddSymbol(id, arg, decl->GetType());
+        }
+    }
+}
+
 llvm::Value* FnDecl::Emit() {
     scope s;
     symtab->Push(&s);
@@ -109,30 +289,89 @@ llvm::Value* FnDecl::Emit() {
     vector<llvm::Type*> v;
     for(int i = 0; i < this->GetFormals()->NumElements(); i++) {
         VarDecl *decl = this->GetFormals()->Nth(i);
-        v.push_back(irgen->GetType(decl->GetType()));
+        llvm::Type *ty = irgen->GetType(decl->GetType());
+        // arrays and out/inout parameters are passed by reference
+        if(ty->isArrayTy() || decl->isOut())
+            ty = llvm::PointerType::getUnqual(ty);
+        v.push_back(ty);
     }
+    if(usesFragCoord)
+        v.push_back(irgen->GetType(Type::vec4Type));
 
     llvm::ArrayRef<llvm::Type*> arrR(v);
     llvm::FunctionType *funType = llvm::FunctionType::get(irgen->GetType(returnType), arrR, false);
     llvm::Function *fun = llvm::cast<llvm::Function>(module->getOrInsertFunction(name, funType));
-    irgen->SetFunction(fun);
+    irgen->SetFunctionLinkage(fun);
     llvm::LLVMContext *context = irgen->GetContext();
+    irgen->BeginFunction(fun);
+    if(fastMath >= 0)
+        irgen->SetFastMath(fastMath);
+    irgen->EmitProfEnter(fun);
 
-    llvm::BasicBlock *bb = llvm::BasicBlock::Create(*context, "entry", fun);
-    irgen->SetBasicBlock(bb);
-
-    int i = 0;
-    for(llvm::Function::arg_iterator arg = fun->arg_begin(); arg != fun->arg_end(); arg++, i++) {
-        VarDecl *decl = this->GetFormals()->Nth(i);
-        llvm::Value *v = decl->Emit();
-        string id = decl->GetIdentifier()->GetName();
-        arg->setName(id);
-        llvm::Value *val = new llvm::StoreInst(arg, v, irgen->GetBasicBlock());
-    }
+    EmitParams(fun, fun->arg_begin());
     
     body->Emit();
+    // falling off the end returns from a void function and cannot happen
+    // in any other
+    if(irgen->IsReachable()) {
+        if(type->isVoidTy()) {
+            irgen->EmitCopyOuts();
+            irgen->EmitProfExit();
+            llvm::ReturnInst::Create(*context, irgen->GetBasicBlock());
+        }
+        else
+            new llvm::UnreachableInst(*context, irgen->GetBasicBlock());
+    }
+    irgen->EndFunction();
+    irgen->MarkNoAlias(fun);
+    irgen->MarkInlineCandidate(fun, body->GetCost());
     symtab->Pop();
-    symtab->AddSymbol(this->GetIdentifier()->GetName(), fun);
+    symtab->AddSymbol(this->GetIdentifier()->GetName(), fun, returnType);
+    if(irgen->GetLaneWidth() > 1 && ReportError::NumErrors() == 0)
+        EmitMasked(fun);
     return fun;
 }
 
+// The lane variant is the body again, under the mask of its first
+// parameter. An instrumented function has none.
+void FnDecl::EmitMasked(llvm::Function *fun) {
+    char *name = this->GetIdentifier()->GetName();
+    if(IsOptionOn("instrument")) {
+        laneFallback = "is instrumented (glc -finstrument)";
+        irgen->AddLaneFallback(name, laneFallback);
+        return;
+    }
+
+    llvm::FunctionType *funType = fun->getFunctionType();
+    vector<llvm::Type*> v(1, irgen->GetBoolType());
+    v.insert(v.end(), funType->param_begin(), funType->param_end());
+    llvm::FunctionType *maskedType = llvm::FunctionType::get(funType->getReturnType(), v, false);
+    masked = llvm::Function::Create(maskedType, llvm::GlobalValue::InternalLinkage, string(name) + ".masked",
+                                    irgen->GetOrCreateModule("glsl.bc"));
+    masked->setCallingConv(llvm::CallingConv::Fast);
+
+    scope s;
+    symtab->Push(&s);
+    symtab->global = false;
+    irgen->BeginFunction(masked);
+    if(fastMath >= 0)
+        irgen->SetFastMath(fastMath);
+    llvm::Function::arg_iterator arg = masked->arg_begin();
+    arg->setName("mask");
+    irgen->BeginLanes(arg, funType->getReturnType());
+    EmitParams(masked, ++arg);
+    body->Emit();
+    laneFallback = irgen->EndLanes();
+    irgen->EndFunction();
+    symtab->Pop();
+
+    if(laneFallback.empty()) {
+        irgen->AddLaneVariant(masked, fun);
+        return;
+    }
+    masked->dropAllReferences();
+    masked->eraseFromParent();
+    masked = NULL;
+    irgen->AddLaneFallback(name, laneFallback);
+}
+
@@ -17,12 +17,16 @@
 #include "list.h"
 #include "ast_expr.h"
 #include "llvm/IR/Value.h"
+#include "llvm/IR/Function.h"
+#include <set>
+#include <vector>
 
 class Type;
 class TypeQualifier;
 class NamedType;
 class Identifier;
 class Stmt;
+class VarExpr;
 
 void yyerror(const char *msg);
 
@@ -56,6 +60,9 @@ class VarDecl : public Decl
     Type *GetType() const { return type; }
     Expr *GetAssignTo() { return assignTo; }
     bool isConst(){ return (typeq==TypeQualifier::constTypeQualifier); }
+    // out and inout parameters are passed by reference
+    bool isOut(){ return (typeq==TypeQualifier::outTypeQualifier || isInOut()); }
+    bool isInOut(){ return (typeq==TypeQualifier::inoutTypeQualifier); }
     llvm::Value *Emit();
     
 };
@@ -74,17 +81,58 @@ class FnDecl : public Decl
     Type *returnType;
     TypeQualifier *returnTypeq;
     Stmt *body;
+    int fastMath; // from "#pragma fastmath", -1 to use the command line
+    bool usesFragCoord;
+    // variables subscripted and written in the body, noted while parsing
+    // and resolved to their declarations once it is complete; the written
+    // uses are kept for WritesVariable
+    vector<VarExpr*> indexedUses, writtenUses;
+    set<Decl*> indexed, written;
+    bool fragCoordIndexed;
+    // the lane variant under glc -flanes, or why there is none
+    llvm::Function *masked;
+    string laneFallback;
+
+    void ResolveUses();
+    void EmitParams(llvm::Function *fun, llvm::Function::arg_iterator arg);
+    void EmitMasked(llvm::Function *fun);
     
   public:
-    FnDecl() : Decl(), formals(NULL), returnType(NULL), returnTypeq(NULL), body(NULL) {}
+    FnDecl() : Decl(), formals(NULL), returnType(NULL), returnTypeq(NULL), body(NULL), fastMath(-1), usesFragCoord(false),
+               fragCoordIndexed(false), masked(NULL) {}
     FnDecl(Identifier *name, Type *returnType, List<VarDecl*> *formals);
     FnDecl(Identifier *name, Type *returnType, TypeQualifier *returnTypeq, List<VarDecl*> *formals);
     void SetFunctionBody(Stmt *b);
+    void SetFastMath(const char *spec);
     const char *GetPrintNameForNode() { return "FnDecl"; }
     void PrintChildren(int indentLevel);
 
     Type *GetType() const { return returnType; }
     List<VarDecl*> *GetFormals() { return formals; }
+    // Functions by name; GLSL declares a function before any call to it
+    static FnDecl *LookUp(const char *name);
+    // A function that reads gl_FragCoord, or calls one that does, takes it
+    // as a hidden last parameter, so each invocation has its own
+    bool UsesFragCoord() const { return usesFragCoord; }
+    static void NoteFragCoord();
+    // The function around a node of its body, or NULL outside any
+    static FnDecl *Enclosing(Node *n);
+    // A local or parameter that is subscripted stays in memory, and an in
+    // array the function writes is copied. Both are per declaration, so
+    // another function's variable of the same name does not count. A
+    // global is written if any function writes it.
+    static void NoteIndexed(VarExpr *v);
+    static void NoteWritten(VarExpr *v);
+    bool IsIndexed(Decl *d) const { return indexed.count(d) != 0; }
+    bool IsWritten(Decl *d) const { return written.count(d) != 0; }
+    static bool IsGlobalWritten(const char *name);
+    // Whether anything within a node may write the variable v names; true
+    // for a global, which a call could write
+    static bool WritesVariable(Node *within, VarExpr *v);
+    // The <name>.masked variant a lane variant calls (see irgen.h), or
+    // NULL with the reason the function has none
+    llvm::Function *GetMaskedVariant() const { return masked; }
+    const string &GetLaneFallback() const { return laneFallback; }
     llvm::Value *Emit();
 };
 
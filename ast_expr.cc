@@ -5,10 +5,13 @@
 
 #include <string.h>
 #include <vector>
+#include <set>
+#include <string>
 #include "ast_expr.h"
 #include "ast_type.h"
 #include "ast_decl.h"
 #include "symtable.h"
+#include "errors.h"
 
 IntConstant::IntConstant(yyltype loc, int val) : Expr(loc) {
     value = val;
@@ -43,6 +46,8 @@ llvm::Value *BoolConstant::Emit() {
 VarExpr::VarExpr(yyltype loc, Identifier *ident) : Expr(loc) {
     Assert(ident != NULL);
     this->id = ident;
+    if(!strcmp(ident->GetName(), "gl_FragCoord"))
+        FnDecl::NoteFragCoord();
 }
 
 void VarExpr::PrintChildren(int indentLevel) {
@@ -52,11 +57,37 @@ llvm::Value *VarExpr::EmitAddress(){
     llvm::Value *var=symtab->LookUpValue(id->GetName());
     return var;
 }
+bool VarExpr::IsUnsigned() {
+    Type *t = symtab->LookUpType(id->GetName());
+    ArrayType *arr = dynamic_cast<ArrayType*>(t);
+    if(arr)
+        t = arr->GetElemType();
+    return t != NULL && t->IsUnsigned();
+}
+
+llvm::Constant *VarExpr::EvalConstant() {
+    return symtab->LookUpConstant(id->GetName());
+}
+
 llvm::Value *VarExpr::Emit() {
-    llvm::Value *v = symtab->LookUpValue(GetIdentifier()->GetName());
-    llvm::Twine *twine = new llvm::Twine(this->id->GetName());
-    llvm::Value *in = new llvm::LoadInst(v, *twine, irgen->GetBasicBlock());
-    return in;
+    // consts are substituted as immediates instead of loaded
+    if(llvm::Constant *c = EvalConstant())
+        return c;
+    return irgen->CreateLoad(EmitAddress(), id->GetName());
+}
+
+llvm::Constant *ArithmeticExpr::EvalConstant() {
+    if(left == NULL) {
+        llvm::Constant *rhs = op->IsOp("-") || op->IsOp("+") ? right->EvalConstant() : NULL;
+        if(rhs == NULL || op->IsOp("+"))
+            return rhs;
+        return rhs->getType()->isFPOrFPVectorTy() ? llvm::ConstantExpr::getFNeg(rhs) : llvm::ConstantExpr::getNeg(rhs);
+    }
+    llvm::Constant *lhs = left->EvalConstant();
+    llvm::Constant *rhs = right->EvalConstant();
+    if(lhs == NULL || rhs == NULL || irgen->IsMatrixType(lhs->getType()) || irgen->IsMatrixType(rhs->getType()))
+        return NULL;
+    return llvm::cast<llvm::Constant>(irgen->CreateBinaryOp(op->GetToken()[0], lhs, rhs, IsUnsigned()));
 }
 
 llvm::Value *ArithmeticExpr::Emit() {
@@ -66,20 +97,31 @@ llvm::Value *ArithmeticExpr::Emit() {
     FieldAccess* r = dynamic_cast<FieldAccess*>(right);
     char *swiz=NULL;
     char *rswiz=NULL;
-    if(this->left == NULL && this->right != NULL) {
+    if(this->left == NULL && (op->IsOp("-") || op->IsOp("+"))) {
         llvm::Value *rhs = this->right->Emit();
-        llvm::LoadInst *ld = llvm::cast<llvm::LoadInst>(rhs);
-        llvm::Value *loc = ld->getPointerOperand();
-        if(rhs->getType() == irgen->GetType(Type::intType)) {
-            llvm::Value *val = llvm::ConstantInt::get(irgen->GetIntType(), 1);
+        if(op->IsOp("+"))
+            return rhs;
+        if(llvm::Constant *c = llvm::dyn_cast<llvm::Constant>(rhs))
+            return rhs->getType()->isFPOrFPVectorTy() ? llvm::ConstantExpr::getFNeg(c) : llvm::ConstantExpr::getNeg(c);
+        bb = irgen->GetBasicBlock();
+        if(rhs->getType()->isFPOrFPVectorTy())
+            return llvm::BinaryOperator::CreateFNeg(rhs, "", bb);
+        return llvm::BinaryOperator::CreateNeg(rhs, "", bb);
+    }
+    if(this->left == NULL && this->right != NULL) {
+        llvm::Value *loc = this->right->EmitAddress();
+        llvm::Value *rhs = r ? r->EmitSwizzle(irgen->CreateLoad(loc)) : irgen->CreateLoad(loc);
+        bb = irgen->GetBasicBlock();
+        if(rhs->getType()->isIntOrIntVectorTy()) {
+            llvm::Value *val = llvm::ConstantInt::get(rhs->getType(), 1);
             if(op->IsOp("++")) {
-                llvm::Value *dec = llvm::BinaryOperator::CreateAdd(rhs, val, "", bb);
-                llvm::Value *in = new llvm::StoreInst(dec, loc, bb);
+                llvm::Value *dec = irgen->CreateBinaryOp('+', rhs, val, false);
+                llvm::Value *in = irgen->CreateStore(dec, loc);
                 return dec;
             }
             else {
-                llvm::Value *dec = llvm::BinaryOperator::CreateSub(rhs, val, "", bb);
-                llvm::Value *in = new llvm::StoreInst(dec, loc, bb);
+                llvm::Value *dec = irgen->CreateBinaryOp('-', rhs, val, false);
+                llvm::Value *in = irgen->CreateStore(dec, loc);
                 return dec;
             }
         }
@@ -87,12 +129,12 @@ llvm::Value *ArithmeticExpr::Emit() {
             llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1.0);
             if(op->IsOp("++")) {
                 llvm::Value *dec = llvm::BinaryOperator::CreateFAdd(rhs, val, "", bb);
-                llvm::Value *in = new llvm::StoreInst(dec, loc, bb);
+                llvm::Value *in = irgen->CreateStore(dec, loc);
                 return dec;
             }
             else {
                 llvm::Value *dec = llvm::BinaryOperator::CreateFSub(rhs, val, "", bb);
-                llvm::Value *in = new llvm::StoreInst(dec, loc, bb);
+                llvm::Value *in = irgen->CreateStore(dec, loc);
                 return dec;
             }
         }
@@ -112,14 +154,14 @@ llvm::Value *ArithmeticExpr::Emit() {
                     ridx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
                 else if(swiz[i] == 'w')
                     ridx = llvm::ConstantInt::get(irgen->GetIntType(), 3);                                      
-                loc=new llvm::LoadInst(ra,"",bb);
+                loc=irgen->CreateLoad(ra);
                 llvm::Value *extract=llvm::ExtractElementInst::Create(loc,ridx,"",bb);
                 if(op->IsOp("++"))
                     lv = llvm::BinaryOperator::CreateFAdd(extract,val, "FA", bb);           
                 else
                     lv = llvm::BinaryOperator::CreateFSub(extract,val, "FA", bb);
                 store=llvm::InsertElementInst::Create(loc,lv,ridx,"",bb);               
-                llvm::Value* result = new llvm::StoreInst(store,ra, "",bb); 
+                llvm::Value* result = irgen->CreateStore(store, ra); 
             }
             rhs=right->Emit();
             return rhs;
@@ -129,1096 +171,107 @@ llvm::Value *ArithmeticExpr::Emit() {
     if(this->left != NULL && this->right != NULL) {
         llvm::Value *rhs = this->right->Emit();
         llvm::Value *lhs = this->left->Emit();
-        int rlen=0;
-        int llen=0;
-        if(l)
-            llen=strlen(l->GetField()->GetName());
-        if(r)
-            rlen=strlen(r->GetField()->GetName());
-        llvm::LoadInst *ld = llvm::cast<llvm::LoadInst>(rhs);
-        llvm::Value *loc = ld->getPointerOperand();
-
-        if(op->IsOp("+")) {
-            if(rhs->getType() == irgen->GetType(Type::intType)) {
-                llvm::Value *result = llvm::BinaryOperator::CreateAdd(lhs, rhs, "", bb);
-                return result;
-            }
-            else if (rhs->getType() == irgen->GetType(Type::floatType)&&lhs->getType() == irgen->GetType(Type::floatType)) {
-                llvm::Value *result = llvm::BinaryOperator::CreateFAdd(lhs, rhs, "", bb);
-                return result;      
-            }
-            else {
-                if (rhs->getType() != irgen->GetType(Type::floatType)&&lhs->getType() != irgen->GetType(Type::floatType)) {
-                    llvm::Value *result = llvm::BinaryOperator::CreateFAdd(lhs, rhs, "", bb);
-                    return result;
-                }
-                else if (rhs->getType() == irgen->GetType(Type::floatType) &&lhs->getType() != irgen->GetType(Type::floatType)) {
-                    llvm::Value *undefVal = llvm::UndefValue::get(lhs->getType());
-                    llvm::Constant *idx;
-                    if(!l) {
-                        if(lhs->getType()==irgen->GetType(Type::vec2Type))
-                            llen=2;
-                        else if (lhs->getType()==irgen->GetType(Type::vec3Type))
-                            llen=3;
-                        else if (lhs->getType()==irgen->GetType(Type::vec4Type))
-                            llen=4;
-                    }
-                    for (int i=0;i<llen;i++) {
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-                        undefVal=llvm::InsertElementInst::Create(undefVal,rhs,idx,"newelement",bb);
-                    }
-                    llvm::Value *result = llvm::BinaryOperator::CreateFAdd(lhs,undefVal, "", bb);
-                    return result;
-                }
-                else {
-                    llvm::Value *undefVal = llvm::UndefValue::get(rhs->getType());
-                    llvm::Constant *idx;
-                    if(!r) {
-                        if(rhs->getType()==irgen->GetType(Type::vec2Type))
-                            rlen=2;
-                        else if (rhs->getType()==irgen->GetType(Type::vec3Type))
-                            rlen=3;
-                        else if (rhs->getType()==irgen->GetType(Type::vec4Type))
-                            rlen=4;
-                    }
-                    for (int i=0;i<rlen;i++) {
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-                        undefVal=llvm::InsertElementInst::Create(undefVal,lhs,idx,"newelement",bb);
-                    }
-                    llvm::Value *result = llvm::BinaryOperator::CreateFAdd(rhs,undefVal, "", bb);
-                    return result;
-                }
-            }
-        }
-
-        else if(op->IsOp("*")) {
-            if(rhs->getType() == irgen->GetType(Type::intType)) {
-                llvm::Value *result = llvm::BinaryOperator::CreateMul(lhs, rhs, "", bb);
-                return result;
-            }
-            else if (rhs->getType() == irgen->GetType(Type::floatType)&&lhs->getType() == irgen->GetType(Type::floatType)) {       
-                llvm::Value *result = llvm::BinaryOperator::CreateFMul(lhs, rhs, "", bb);
-                return result;      
-            }
-            else {
-                if (rhs->getType() != irgen->GetType(Type::floatType)&&lhs->getType() != irgen->GetType(Type::floatType)) {
-                    llvm::Value *result = llvm::BinaryOperator::CreateFMul(lhs, rhs, "", bb);
-                    return result;
-                }
-                else if (rhs->getType() == irgen->GetType(Type::floatType) &&lhs->getType() != irgen->GetType(Type::floatType)) {
-                    llvm::Value *undefVal = llvm::UndefValue::get(lhs->getType());
-                    llvm::Constant *idx;
-                    if(!l) {
-                        if(lhs->getType()==irgen->GetType(Type::vec2Type))
-                            llen=2;
-                        else if (lhs->getType()==irgen->GetType(Type::vec3Type))
-                            llen=3;
-                        else if (lhs->getType()==irgen->GetType(Type::vec4Type))
-                            llen=4;
-                    }
-                    for(int i=0;i<llen;i++) {
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-                        undefVal=llvm::InsertElementInst::Create(undefVal,rhs,idx,"newelement",bb);
-                    }
-                    llvm::Value *result = llvm::BinaryOperator::CreateFMul(lhs,undefVal, "", bb);
-                    return result;
-                }
-                else {
-                    llvm::Value *undefVal = llvm::UndefValue::get(rhs->getType());
-                    llvm::Constant *idx;
-                    if(!r) {
-                        if (rhs->getType()==irgen->GetType(Type::vec2Type))
-                            rlen=2;
-                        else if (rhs->getType()==irgen->GetType(Type::vec3Type))
-                            rlen=3;
-                        else if (rhs->getType()==irgen->GetType(Type::vec4Type))
-                            rlen=4;
-                    }
-                    for (int i=0;i<rlen;i++) {
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-                        undefVal=llvm::InsertElementInst::Create(undefVal,lhs,idx,"newelement",bb);
-                    }
-                    llvm::Value *result = llvm::BinaryOperator::CreateFMul(undefVal,rhs, "", bb);
-                    return result;
-                }
-            }
-        }
-
-        else if (op->IsOp("-")) {
-            if(rhs->getType() == irgen->GetType(Type::intType)){
-                llvm::Value *result = llvm::BinaryOperator::CreateSub(lhs, rhs, "", bb);
-                return result;
-            }
-            else if (rhs->getType() == irgen->GetType(Type::floatType)&&lhs->getType() == irgen->GetType(Type::floatType)) {       
-                llvm::Value *result = llvm::BinaryOperator::CreateFSub(lhs, rhs, "", bb);
-                return result;      
-            }
-            else {
-                if (rhs->getType() != irgen->GetType(Type::floatType)&&lhs->getType() != irgen->GetType(Type::floatType)) {
-                    llvm::Value *result = llvm::BinaryOperator::CreateFSub(lhs, rhs, "", bb);
-                    return result;
-                }
-                else if (rhs->getType() == irgen->GetType(Type::floatType) &&lhs->getType() != irgen->GetType(Type::floatType)) {
-                    llvm::Value *undefVal = llvm::UndefValue::get(lhs->getType());
-                    llvm::Constant *idx;
-                    if (!l) {
-                        if(lhs->getType()==irgen->GetType(Type::vec2Type))
-                            llen=2;
-                        else if(lhs->getType()==irgen->GetType(Type::vec3Type))
-                            llen=3;
-                        else if(lhs->getType()==irgen->GetType(Type::vec4Type))
-                            llen=4;
-                    }
-                    for(int i=0;i<llen;i++) {
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-                        undefVal=llvm::InsertElementInst::Create(undefVal,rhs,idx,"newelement",bb);
-                    }
-                    llvm::Value *result = llvm::BinaryOperator::CreateFSub(lhs,undefVal, "", bb);
-                    return result;
-                }
-                else {
-                    llvm::Value *undefVal = llvm::UndefValue::get(rhs->getType());
-                    llvm::Constant *idx;
-                    if (!r){
-                        if (rhs->getType()==irgen->GetType(Type::vec2Type))
-                            rlen=2;
-                        else if (rhs->getType()==irgen->GetType(Type::vec3Type))
-                            rlen=3;
-                        else if (rhs->getType()==irgen->GetType(Type::vec4Type))
-                            rlen=4;
-                    }
-                    for (int i=0;i<rlen;i++) {
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-                        undefVal=llvm::InsertElementInst::Create(undefVal,lhs,idx,"newelement",bb);
-                    }
-                    llvm::Value *result = llvm::BinaryOperator::CreateFSub(undefVal,rhs, "", bb);
-                    return result;
-                }
-            }
-        }
-
-        else if (op->IsOp("/")) {
-            if(rhs->getType() == irgen->GetType(Type::intType)){
-                llvm::Value *result = llvm::BinaryOperator::CreateSDiv(lhs, rhs, "", bb);
-                return result;
-            }
-            else if (rhs->getType() == irgen->GetType(Type::floatType)&&lhs->getType() == irgen->GetType(Type::floatType)) {       
-                llvm::Value *result = llvm::BinaryOperator::CreateFDiv(lhs, rhs, "", bb);
-                return result;      
-            }
-            else {
-                if (rhs->getType() != irgen->GetType(Type::floatType)&&lhs->getType() != irgen->GetType(Type::floatType)) {
-                    llvm::Value *result = llvm::BinaryOperator::CreateFDiv(lhs, rhs, "", bb);
-                    return result;
-                }
-            else if (rhs->getType() == irgen->GetType(Type::floatType) &&lhs->getType() != irgen->GetType(Type::floatType)) {
-                llvm::Value *undefVal = llvm::UndefValue::get(lhs->getType());
-                llvm::Constant *idx;
-                if (!l){
-                    if (lhs->getType()==irgen->GetType(Type::vec2Type))
-                        llen=2;
-                    else if (lhs->getType()==irgen->GetType(Type::vec3Type))
-                        llen=3;
-                    else if (lhs->getType()==irgen->GetType(Type::vec4Type))
-                        llen=4;
-                }
-                for (int i=0;i<llen;i++) {
-                    idx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-                    undefVal=llvm::InsertElementInst::Create(undefVal,rhs,idx,"newelement",bb);
-                }
-                llvm::Value *result = llvm::BinaryOperator::CreateFDiv(lhs,undefVal, "", bb);
-                return result;
-            }
-            else {
-                llvm::Value *undefVal = llvm::UndefValue::get(rhs->getType());
-                llvm::Constant *idx;
-                if (!r){
-                    if (rhs->getType()==irgen->GetType(Type::vec2Type))
-                        rlen=2;
-                    else if (rhs->getType()==irgen->GetType(Type::vec3Type))
-                        rlen=3;
-                    else if (rhs->getType()==irgen->GetType(Type::vec4Type))
-                        rlen=4;
-                }
-                for (int i=0;i<rlen;i++){
-                    idx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-                    undefVal=llvm::InsertElementInst::Create(undefVal,lhs,idx,"newelement",bb);
-                }
-                llvm::Value *result = llvm::BinaryOperator::CreateFDiv(undefVal,rhs, "", bb);
-                return result;
-            }
-            }
-        }
+        if(irgen->IsMatrixType(lhs->getType()) || irgen->IsMatrixType(rhs->getType()))
+            return irgen->CreateMatrixOp(op->GetToken()[0], lhs, rhs);
+        // a scalar operand of a vector op is broadcast with a single
+        // insertelement + shufflevector, or a constant splat
+        return irgen->CreateBinaryOp(op->GetToken()[0], lhs, rhs, IsUnsigned());
     }
     return NULL;
 }
 
+static llvm::CmpInst::Predicate ComparePredicate(Operator *op, bool fp, bool isUnsigned) {
+    if(op->IsOp(">"))
+        return fp ? llvm::CmpInst::FCMP_OGT : isUnsigned ? llvm::CmpInst::ICMP_UGT : llvm::CmpInst::ICMP_SGT;
+    if(op->IsOp("<"))
+        return fp ? llvm::CmpInst::FCMP_OLT : isUnsigned ? llvm::CmpInst::ICMP_ULT : llvm::CmpInst::ICMP_SLT;
+    if(op->IsOp(">="))
+        return fp ? llvm::CmpInst::FCMP_OGE : isUnsigned ? llvm::CmpInst::ICMP_UGE : llvm::CmpInst::ICMP_SGE;
+    if(op->IsOp("<="))
+        return fp ? llvm::CmpInst::FCMP_OLE : isUnsigned ? llvm::CmpInst::ICMP_ULE : llvm::CmpInst::ICMP_SLE;
+    if(op->IsOp("=="))
+        return fp ? llvm::CmpInst::FCMP_OEQ : llvm::CmpInst::ICMP_EQ;
+    return fp ? llvm::CmpInst::FCMP_ONE : llvm::CmpInst::ICMP_NE;
+}
+
 llvm::Value *RelationalExpr::Emit() {
-    Operator *op = this->op;
     llvm::Value *lhs = left->Emit();
     llvm::Value *rhs = right->Emit();
-    llvm::BasicBlock *bb = irgen->GetBasicBlock();
-    llvm::CmpInst::Predicate pred = NULL;
-
-    if((lhs->getType() == irgen->GetType(Type::floatType)) && (rhs->getType() == irgen->GetType(Type::floatType))) {
-        if(op->IsOp(">"))
-            pred = llvm::CmpInst::FCMP_OGT;
-        else if(op->IsOp("<"))
-            pred = llvm::CmpInst::FCMP_OLT;
-        else if(op->IsOp(">="))
-            pred = llvm::CmpInst::FCMP_OGE;
-        else if(op->IsOp("<="))
-            pred = llvm::CmpInst::FCMP_OLE;
-        else if(op->IsOp("=="))
-            pred = llvm::CmpInst::FCMP_OEQ;
-        else if(op->IsOp("!="))
-            pred = llvm::CmpInst::FCMP_ONE;
-
-        llvm::Value *v = llvm::CmpInst::Create(llvm::CmpInst::FCmp, pred, lhs, rhs, "", bb);
-        return v;
-    }
+    return EmitCompare(lhs, rhs);
+}
 
-    if((lhs->getType() == irgen->GetType(Type::intType)) && (rhs->getType() == irgen->GetType(Type::intType))) {
-        if(op->IsOp(">"))
-            pred = llvm::CmpInst::ICMP_SGT;
-        else if(op->IsOp("<"))
-            pred = llvm::CmpInst::ICMP_SLT;
-        else if(op->IsOp(">="))
-            pred = llvm::CmpInst::ICMP_SGE;
-        else if(op->IsOp("<="))
-            pred = llvm::CmpInst::ICMP_SLE;
-        else if(op->IsOp("=="))
-            pred = llvm::CmpInst::ICMP_EQ;
-        else if(op->IsOp("!="))
-            pred = llvm::CmpInst::ICMP_NE;
-
-        llvm::Value *v = llvm::CmpInst::Create(llvm::CmpInst::ICmp, pred, lhs, rhs, "", bb);
-        return v;
-    }
-    return NULL;
+llvm::Value *RelationalExpr::EmitCompare(llvm::Value *lhs, llvm::Value *rhs) {
+    if(lhs->getType() != rhs->getType() || lhs->getType()->isVectorTy())
+        return NULL;
+    bool fp = lhs->getType()->isFloatingPointTy();
+    bool u = left->IsUnsigned() || right->IsUnsigned();
+    return irgen->CreateCompare(ComparePredicate(op, fp, u), lhs, rhs);
+}
+
+llvm::Constant *RelationalExpr::EvalConstant() {
+    llvm::Constant *lhs = left->EvalConstant();
+    llvm::Constant *rhs = right->EvalConstant();
+    if(lhs == NULL || rhs == NULL)
+        return NULL;
+    return llvm::dyn_cast_or_null<llvm::Constant>(EmitCompare(lhs, rhs));
 }
 
 llvm::Value *AssignExpr::Emit() {
     Operator *op = this->op;
-    llvm::Value *store;
-    llvm::Value *rv = this->right->Emit();
-    llvm::Value *lv = this->left->Emit();
-    llvm::LoadInst *ld = llvm::cast<llvm::LoadInst>(lv);
-    llvm::Value *loc = ld->getPointerOperand();
-    llvm::BasicBlock *bb = irgen->GetBasicBlock();
     FieldAccess* l=dynamic_cast<FieldAccess*>(left);
-    FieldAccess* r=dynamic_cast<FieldAccess*>(right);
-    char *swiz = NULL;
-    char *rswiz = NULL;
+    llvm::Value *rv = this->right->Emit();
+    llvm::Value *loc = this->left->EmitAddress();
+    // a plain store never needs the old value unless only some lanes change
+    llvm::Value *old = NULL;
+    llvm::Value *lv = NULL;
+    if(l || !op->IsOp("="))
+        old = irgen->CreateLoad(loc);
+    if(!op->IsOp("="))
+        lv = l ? l->EmitSwizzle(old) : old;
+
     if(op->IsOp("=")) {
-        if (l) {
-            llvm::Value* la=l->EmitAddress();
-            if (rv->getType() == irgen->GetType(Type::floatType)){
-                swiz=l->GetField()->GetName();
-                llvm::Constant *idx;
-                for(int i=0;i<strlen(swiz); i++) {
-                    if(swiz[i] == 'x')
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                    else if(swiz[i] == 'y')
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                    else if(swiz[i] == 'z')
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                    else if(swiz[i] == 'w')
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                    loc=new llvm::LoadInst(la,"",bb);
-                    store=llvm::InsertElementInst::Create(loc,rv,idx,"",bb);
-                    llvm::Value* result = new llvm::StoreInst(store, la, "",bb);
-                } 
-            }
-            else{
-                if (!r){
-                    swiz = l->GetField()->GetName();
-                    llvm::Constant *idx;
-                    for(int i=0;i<strlen(swiz); i++) {
-                        if(swiz[i] == 'x')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                        else if(swiz[i] == 'y')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                        else if(swiz[i] == 'z')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                        else if(swiz[i] == 'w')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                        loc=new llvm::LoadInst(la,"",bb);
-                        llvm::Constant* ridx=llvm::ConstantInt::get(irgen->GetIntType(), i);
-                        llvm::Value *extract=llvm::ExtractElementInst::Create(rv,ridx,"",bb);
-                        store = llvm::InsertElementInst::Create(loc,extract,idx,"",bb);
-                        llvm::Value* result = new llvm::StoreInst(store, la, "",bb);
-                    }
-                }
-                else{
-                    llvm::Value *ra = r->EmitAddress();
-                    llvm::Value *rloc=new llvm::LoadInst(ra,"",bb);
-                    swiz = l->GetField()->GetName();
-                    rswiz = r->GetField()->GetName();
-                    llvm::Constant *idx;
-                    llvm::Constant *ridx;
-                    for(int i=0;i<strlen(swiz); i++) {
-                        if(swiz[i] == 'x')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                        else if(swiz[i] == 'y')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                        else if(swiz[i] == 'z')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                        else if(swiz[i] == 'w')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                        if(rswiz[i] == 'x')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                        else if(rswiz[i] == 'y')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                        else if(rswiz[i] == 'z')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                        else if(rswiz[i] == 'w')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                        loc=new llvm::LoadInst(la,"",bb);
-                        llvm::Value *extract=llvm::ExtractElementInst::Create(rloc,ridx,"",bb);
-                        store = llvm::InsertElementInst::Create(loc,extract,idx,"",bb);
-                        llvm::Value* result = new llvm::StoreInst(store, la, "",bb);
-                    }
-                }
-            }
-        }   
-        else {
-           llvm::Value* in = new llvm::StoreInst(rv, loc, bb);
-        }
+        // one shuffle merges the new lanes into the old vector
+        if(l)
+            irgen->CreateStore(irgen->CreateSwizzleInsert(old, rv, l->GetField()->GetName()), loc);
+        else
+            irgen->CreateStore(rv, loc);
+        return rv;
     }
-    if(op->IsOp("+=")) {
-        if(!l&&(lv->getType() == irgen->GetType(Type::floatType))){
-            if (r) {
-                llvm::Value *ra = r->EmitAddress();
-                rswiz = r->GetField()->GetName();
-                llvm::Value *rloc=new llvm::LoadInst(ra,"",bb);
-                llvm::Constant *ridx;
-                for(int i = 0;i<strlen(rswiz); i++) {
-                    if(rswiz[i] == 'x')
-                        ridx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                    else if(rswiz[i] == 'y')
-                        ridx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                    else if(rswiz[i] == 'z')
-                        ridx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                    else if(rswiz[i] == 'w')
-                        ridx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                    llvm::Value *extract=llvm::ExtractElementInst::Create(rloc,ridx,"",bb);
-                    llvm::Value *add = llvm::BinaryOperator::CreateFAdd(lv, extract, "RFloatPlusEqual", bb);
-                    llvm::Value *in = new llvm::StoreInst(add, loc, bb);
-                }                           
-            }
-            else {
-                llvm::Value *add = llvm::BinaryOperator::CreateFAdd(lv, rv, "LFloatPlusEqual", bb);
-                llvm::Value *in = new llvm::StoreInst(add, loc, bb);            
-            }
-        }
-        else if(lv->getType() == irgen->GetType(Type::intType)) {
-            llvm::Value *add = llvm::BinaryOperator::CreateAdd(lv, rv, "IntPlusEqual", bb);
-            llvm::Value *in = new llvm::StoreInst(add, loc, bb);    
-        }
-        else if(l) {
-            llvm::Value* la=l->EmitAddress();
-
-            if(r) {
-                llvm::Value *ra = r->EmitAddress();
-                llvm::Value *rloc = new llvm::LoadInst(ra,"",bb);
-                swiz = l->GetField()->GetName();
-                rswiz = r->GetField()->GetName();
-                llvm::Constant *idx;
-                llvm::Constant *ridx;
-                for(int i=0;i<strlen(swiz); i++) {
-                    int j=0;
-                    if (strlen(rswiz)>1)
-                        j=i;
-                    if(swiz[i] == 'x')
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                    else if(swiz[i] == 'y')
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                    else if(swiz[i] == 'z')
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                    else if(swiz[i] == 'w')
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                    if(rswiz[j] == 'x')
-                        ridx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                    else if(rswiz[j] == 'y')
-                        ridx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                    else if(rswiz[j] == 'z')
-                        ridx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                    else if(rswiz[j] == 'w')
-                        ridx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                    loc = new llvm::LoadInst(la,"",bb);
-                    llvm::Value *extract1=llvm::ExtractElementInst::Create(rloc,ridx,"",bb);
-                    llvm::Value *extract2=llvm::ExtractElementInst::Create(loc,idx,"",bb);
-                    llvm::Value *add = llvm::BinaryOperator::CreateFAdd(extract1,extract2, "FAtoFA", bb);
-                    loc = new llvm::LoadInst(la,"",bb);
-                    store = llvm::InsertElementInst::Create(loc,add,idx,"",bb);
-                    llvm::Value* result = new llvm::StoreInst(store, la, "",bb);
-                }
-            }
-            else if(rv->getType() == irgen->GetType(Type::floatType)) {
-                swiz=l->GetField()->GetName();
-                llvm::Constant *idx;            
-                for(int i=0;i<strlen(swiz); i++) {
-                    if(swiz[i] == 'x')
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                    else if(swiz[i] == 'y')
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                    else if(swiz[i] == 'z')
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                    else if(swiz[i] == 'w')
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                    loc=new llvm::LoadInst(la,"",bb);
-                    llvm::Value *extract=llvm::ExtractElementInst::Create(loc,idx,"",bb);
-                    llvm::Value *add = llvm::BinaryOperator::CreateFAdd(extract,rv, "FtoFA", bb);
-                    store=llvm::InsertElementInst::Create(loc,add,idx,"",bb);
-                    llvm::Value* result = new llvm::StoreInst(store, la, "",bb);
-                }
-            }
-            else {
-                swiz = l->GetField()->GetName();
-                llvm::Constant *idx;
-                for(int i=0;i<strlen(swiz); i++) {
-                    if(swiz[i] == 'x')
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                    else if(swiz[i] == 'y')
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                    else if(swiz[i] == 'z')
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                    else if(swiz[i] == 'w')
-                        idx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                        loc=new llvm::LoadInst(la,"",bb);
-                    llvm::Constant* ridx=llvm::ConstantInt::get(irgen->GetIntType(), i);
-                    llvm::Value *extract2=llvm::ExtractElementInst::Create(loc,idx,"",bb);
-                    llvm::Value *extract1=llvm::ExtractElementInst::Create(rv,ridx,"",bb);
-                    llvm::Value *add = llvm::BinaryOperator::CreateFAdd(extract1,extract2, "FAtoFA", bb);
-                    loc=new llvm::LoadInst(la,"",bb);
-                    store=llvm::InsertElementInst::Create(loc,add,idx,"",bb);
-                    llvm::Value* result = new llvm::StoreInst(store, la, "",bb);
-                }
-            }
-        }
-        else {
-            int veclen=0;
-            if (lv->getType()==irgen->GetType(Type::vec2Type))
-                veclen=2;
-            else if (lv->getType()==irgen->GetType(Type::vec3Type))
-                veclen=3;
-            else if (lv->getType()==irgen->GetType(Type::vec4Type))
-                veclen=4;
-            if (r){
-                llvm::Value *ra = r->EmitAddress();
-                llvm::Value *rloc=new llvm::LoadInst(ra,"",bb);
-                rswiz=r->GetField()->GetName();
-                llvm::Constant *ridx;
-                if (strlen(rswiz)>1)
-                    for(int i=0;i<strlen(rswiz); i++) {
-                        if(rswiz[i] == 'x')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                        else if(rswiz[i] == 'y')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                        else if(rswiz[i] == 'z')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                        else if(rswiz[i] == 'w')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                        lv=this->left->Emit();
-                        llvm::Constant* idx=llvm::ConstantInt::get(irgen->GetIntType(), i);
-                                llvm::Value *extract1=llvm::ExtractElementInst::Create(rloc,ridx,"",bb);
-                        llvm::Value *extract2=llvm::ExtractElementInst::Create(lv,idx,"",bb);               
-                        llvm::Value *add = llvm::BinaryOperator::CreateFAdd(extract1,extract2, "FAtoVec", bb);
-                        store=llvm::InsertElementInst::Create(lv,add,idx,"",bb);
-                        llvm::Value* result = new llvm::StoreInst(store, loc, "",bb);
-                    }
-                    if (strlen(rswiz)==1) {
-                        if(rswiz[0] == 'x')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                        else if(rswiz[0] == 'y')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                        else if(rswiz[0] == 'z')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                        else if(rswiz[0] == 'w')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                        for(int i=0;i<veclen;i++) {
-                            lv = this->left->Emit();
-                            llvm::Constant* idx=llvm::ConstantInt::get(irgen->GetIntType(), i);
-                            llvm::Value *extract1=llvm::ExtractElementInst::Create(rloc,ridx,"",bb);
-                            llvm::Value *extract2=llvm::ExtractElementInst::Create(lv,idx,"",bb);
-                            llvm::Value *add = llvm::BinaryOperator::CreateFAdd(extract1,extract2, "FAtoVec", bb);
-                            store=llvm::InsertElementInst::Create(lv,add,idx,"",bb);
-                            llvm::Value* result = new llvm::StoreInst(store, loc, "",bb);
-                        }
-                    }
-                }
-                else if(rv->getType() == irgen->GetType(Type::floatType)) {
-                    for (int i=0;i<veclen;i++) {
-                        lv=this->left->Emit();
-                        llvm::Constant* idx=llvm::ConstantInt::get(irgen->GetIntType(), i);
-                        llvm::Value *extract=llvm::ExtractElementInst::Create(lv,idx,"",bb);                
-                        llvm::Value *add = llvm::BinaryOperator::CreateFAdd(extract,rv, "FAtoVec", bb);
-                        store=llvm::InsertElementInst::Create(lv,add,idx,"",bb);
-                        llvm::Value* result = new llvm::StoreInst(store, loc, "",bb);
-                    }
-                }
-                else {
-                    llvm::Value *add = llvm::BinaryOperator::CreateFAdd(lv, rv, "VectoVec", bb);
-                    llvm::Value *in = new llvm::StoreInst(add, loc, bb);
-                }
-            }
-        }
-        else if(op->IsOp("-=")) {
-            if(!l && (lv->getType() == irgen->GetType(Type::floatType))) {
-                if (r){
-                    llvm::Value *ra = r->EmitAddress();
-                    rswiz=r->GetField()->GetName();
-                    llvm::Value *rloc=new llvm::LoadInst(ra,"",bb);
-                    llvm::Constant *ridx;
-                    for(int i=0;i<strlen(rswiz); i++){
-                        if(rswiz[i] == 'x')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                        else if(rswiz[i] == 'y')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                        else if(rswiz[i] == 'z')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                        else if(rswiz[i] == 'w')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                        llvm::Value *extract=llvm::ExtractElementInst::Create(rloc,ridx,"",bb);
-                        llvm::Value *sub = llvm::BinaryOperator::CreateFSub(lv, extract, "RFloatPlusEqual", bb);
-                        llvm::Value *in = new llvm::StoreInst(sub, loc, bb);
-                    }
-                }
-                else {
-                    llvm::Value *sub = llvm::BinaryOperator::CreateFSub(lv, rv, "LFloatPlusEqual", bb);
-                    llvm::Value *in = new llvm::StoreInst(sub, loc, bb);
-                }
-            }
-            else if(lv->getType() == irgen->GetType(Type::intType)) {
-                llvm::Value *sub = llvm::BinaryOperator::CreateSub(lv, rv, "IntPlusEqual", bb);
-                llvm::Value *in = new llvm::StoreInst(sub, loc, bb);
-            }
-            else if(l) {
-                llvm::Value* la = l->EmitAddress();
-                if(r) {
-                    llvm::Value *ra = r->EmitAddress();
-                    llvm::Value *rloc = new llvm::LoadInst(ra,"",bb);
-                    swiz=l->GetField()->GetName();
-                    rswiz=r->GetField()->GetName();
-                    llvm::Constant *idx;
-                    llvm::Constant *ridx;
-                    for(int i=0;i<strlen(swiz); i++) {
-                        int j=0;
-                        if (strlen(rswiz)>1)
-                            j=i;
-                        if(swiz[i] == 'x')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                        else if(swiz[i] == 'y')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                        else if(swiz[i] == 'z')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                        else if(swiz[i] == 'w')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                        if(rswiz[j] == 'x')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                        else if(rswiz[j] == 'y')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                        else if(rswiz[j] == 'z')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                        else if(rswiz[j] == 'w')
-                            ridx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                        loc=new llvm::LoadInst(la,"",bb);
-                        llvm::Value *extract1=llvm::ExtractElementInst::Create(rloc,ridx,"",bb);
-                        llvm::Value *extract2=llvm::ExtractElementInst::Create(loc,idx,"",bb);
-                        llvm::Value *sub = llvm::BinaryOperator::CreateFSub(extract2,extract1, "FAtoFA", bb);
-                        loc = new llvm::LoadInst(la,"",bb);
-                        store=llvm::InsertElementInst::Create(loc,sub,idx,"",bb);
-                        llvm::Value* result = new llvm::StoreInst(store, la, "",bb);
-                    }
-                }
-                else if (rv->getType() == irgen->GetType(Type::floatType)){
-                    swiz=l->GetField()->GetName();
-                    llvm::Constant *idx;
-                    for(int i=0;i<strlen(swiz); i++) {
-                        if(swiz[i] == 'x')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                        else if(swiz[i] == 'y')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                        else if(swiz[i] == 'z')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                        else if(swiz[i] == 'w')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                        loc=new llvm::LoadInst(la,"",bb);
-                        llvm::Value *extract=llvm::ExtractElementInst::Create(loc,idx,"",bb);
-                        llvm::Value *sub = llvm::BinaryOperator::CreateFSub(extract,rv, "FtoFA", bb);
-                        store=llvm::InsertElementInst::Create(loc,sub,idx,"",bb);
-                        llvm::Value* result = new llvm::StoreInst(store, la, "",bb);
-                    }
-                }
-                else {
-                    swiz=l->GetField()->GetName();
-                    llvm::Constant *idx;
-                    for(int i=0;i<strlen(swiz); i++) {
-                        if(swiz[i] == 'x')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                        else if(swiz[i] == 'y')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                        else if(swiz[i] == 'z')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                        else if(swiz[i] == 'w')
-                            idx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                        loc=new llvm::LoadInst(la,"",bb);
-                        llvm::Constant* ridx=llvm::ConstantInt::get(irgen->GetIntType(), i);
-                        llvm::Value *extract2=llvm::ExtractElementInst::Create(loc,idx,"",bb);
-                        llvm::Value *extract1=llvm::ExtractElementInst::Create(rv,ridx,"",bb);
-                        llvm::Value *sub = llvm::BinaryOperator::CreateFSub(extract2,extract1, "FAtoFA", bb);
-                        loc = new llvm::LoadInst(la,"",bb);
-                        store = llvm::InsertElementInst::Create(loc,sub,idx,"",bb);
-                        llvm::Value* result = new llvm::StoreInst(store, la, "",bb);
-                    }
-                } 
-            }
-            else{
-                int veclen=0;
-                if (lv->getType()==irgen->GetType(Type::vec2Type))
-                    veclen=2;
-                else if (lv->getType()==irgen->GetType(Type::vec3Type))
-                    veclen=3;
-                else if (lv->getType()==irgen->GetType(Type::vec4Type))
-                    veclen=4;
-                if(r) {
-                    llvm::Value *ra = r->EmitAddress();
-                    llvm::Value *rloc=new llvm::LoadInst(ra,"",bb);
-                    rswiz=r->GetField()->GetName();
-                    llvm::Constant *ridx;
-                    if (strlen(rswiz)>1)
-                        for(int i=0;i<strlen(rswiz); i++) {
-                            if(rswiz[i] == 'x')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                            else if(rswiz[i] == 'y')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                            else if(rswiz[i] == 'z')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                            else if(rswiz[i] == 'w')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                            lv=this->left->Emit();
-                            llvm::Constant* idx=llvm::ConstantInt::get(irgen->GetIntType(), i);
-                            llvm::Value *extract1=llvm::ExtractElementInst::Create(rloc,ridx,"",bb);
-                            llvm::Value *extract2=llvm::ExtractElementInst::Create(lv,idx,"",bb);               
-                            llvm::Value *sub = llvm::BinaryOperator::CreateFSub(extract2,extract1, "FAtoVec", bb);
-                            store=llvm::InsertElementInst::Create(lv,sub,idx,"",bb);
-                            llvm::Value* result = new llvm::StoreInst(store, loc, "",bb);
-                        }
-                        if (strlen(rswiz)==1) {
-                            if(rswiz[0] == 'x')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                            else if(rswiz[0] == 'y')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                            else if(rswiz[0] == 'z')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                            else if(rswiz[0] == 'w')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                            for (int i=0;i<veclen;i++) {
-                                lv=this->left->Emit();
-                                llvm::Constant* idx=llvm::ConstantInt::get(irgen->GetIntType(), i);
-                                llvm::Value *extract1=llvm::ExtractElementInst::Create(rloc,ridx,"",bb);
-                                llvm::Value *extract2=llvm::ExtractElementInst::Create(lv,idx,"",bb);               
-                                llvm::Value *sub = llvm::BinaryOperator::CreateFSub(extract2,extract1, "FAtoVec", bb);
-                                store=llvm::InsertElementInst::Create(lv,sub,idx,"",bb);
-                                llvm::Value* result = new llvm::StoreInst(store, loc, "",bb);
-                            }
-                        }
-                    }
-                    else if (rv->getType() == irgen->GetType(Type::floatType)) {
-                        for (int i=0;i<veclen;i++) {
-                            lv=this->left->Emit();
-                            llvm::Constant* idx=llvm::ConstantInt::get(irgen->GetIntType(), i);
-                            llvm::Value *extract=llvm::ExtractElementInst::Create(lv,idx,"",bb);
-                            llvm::Value *sub = llvm::BinaryOperator::CreateFSub(extract,rv, "FAtoVec", bb);
-                            store=llvm::InsertElementInst::Create(lv,sub,idx,"",bb);
-                            llvm::Value* result = new llvm::StoreInst(store, loc, "",bb);
-                        }
-                    }
-                    else {
-                        llvm::Value *sub = llvm::BinaryOperator::CreateFSub(lv, rv, "VectoVec", bb);
-                        llvm::Value *in = new llvm::StoreInst(sub, loc, bb);
-                    }
-                }
-            }
-            else if(op->IsOp("*=")) {
-                if(!l&&(lv->getType() == irgen->GetType(Type::floatType))){
-                    if(r) {
-                        llvm::Value *ra = r->EmitAddress();
-                        rswiz=r->GetField()->GetName();
-                        llvm::Value *rloc=new llvm::LoadInst(ra,"",bb);
-                        llvm::Constant *ridx;
-                        for(int i=0;i<strlen(rswiz); i++) {
-                            if(rswiz[i] == 'x')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                            else if(rswiz[i] == 'y')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                            else if(rswiz[i] == 'z')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                            else if(rswiz[i] == 'w')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-
-                            llvm::Value *extract=llvm::ExtractElementInst::Create(rloc,ridx,"",bb);
-                            llvm::Value *mul = llvm::BinaryOperator::CreateFMul(lv, extract, "RFloatPlusEqual", bb);
-                            llvm::Value *in = new llvm::StoreInst(mul, loc, bb);
-                        }
-                    }
-                    else {
-                        llvm::Value *mul = llvm::BinaryOperator::CreateFMul(lv, rv, "LFloatPlusEqual", bb);
-                        llvm::Value *in = new llvm::StoreInst(mul, loc, bb);
-                    }
-                }
-                else if(lv->getType() == irgen->GetType(Type::intType)) {
-                    llvm::Value *mul = llvm::BinaryOperator::CreateMul(lv, rv, "IntPlusEqual", bb);
-                    llvm::Value *in = new llvm::StoreInst(mul, loc, bb);
-                }
-                else if (l){
-                    llvm::Value* la=l->EmitAddress();
-                    if (r){
-                        llvm::Value *ra = r->EmitAddress();
-                        llvm::Value *rloc=new llvm::LoadInst(ra,"",bb);
-                        swiz=l->GetField()->GetName();
-                        rswiz=r->GetField()->GetName();
-                        llvm::Constant *idx;
-                        llvm::Constant *ridx;
-                        for(int i=0;i<strlen(swiz); i++) {
-                            int j=0;
-                            if (strlen(rswiz)>1)
-                                j=i;
-                            if(swiz[i] == 'x')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                            else if(swiz[i] == 'y')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                            else if(swiz[i] == 'z')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                            else if(swiz[i] == 'w')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                            if(rswiz[j] == 'x')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                            else if(rswiz[j] == 'y')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                            else if(rswiz[j] == 'z')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                            else if(rswiz[j] == 'w')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                            loc=new llvm::LoadInst(la,"",bb);
-                            llvm::Value *extract1=llvm::ExtractElementInst::Create(rloc,ridx,"",bb);
-                            llvm::Value *extract2=llvm::ExtractElementInst::Create(loc,idx,"",bb);
-                            llvm::Value *mul = llvm::BinaryOperator::CreateFMul(extract1,extract2, "FAtoFA", bb);
-                            loc=new llvm::LoadInst(la,"",bb);
-                            store=llvm::InsertElementInst::Create(loc,mul,idx,"",bb);
-                            llvm::Value* result = new llvm::StoreInst(store, la, "",bb);
-                        }
-                    }
-                    else if (rv->getType() == irgen->GetType(Type::floatType)){
-                        swiz=l->GetField()->GetName();
-                        llvm::Constant *idx;
-                        for(int i=0;i<strlen(swiz); i++) {
-                            if(swiz[i] == 'x')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                            else if(swiz[i] == 'y')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                            else if(swiz[i] == 'z')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                            else if(swiz[i] == 'w')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                            loc=new llvm::LoadInst(la,"",bb);
-                            llvm::Value *extract=llvm::ExtractElementInst::Create(loc,idx,"",bb);
-                            llvm::Value *mul = llvm::BinaryOperator::CreateFMul(extract,rv, "FtoFA", bb);
-                            store=llvm::InsertElementInst::Create(loc,mul,idx,"",bb);
-                            llvm::Value* result = new llvm::StoreInst(store, la, "",bb);
-                        }
-                    }
-                    else {
-                        swiz=l->GetField()->GetName();
-                        llvm::Constant *idx;
-                        for(int i=0;i<strlen(swiz); i++) {
-                            if(swiz[i] == 'x')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                            else if(swiz[i] == 'y')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                            else if(swiz[i] == 'z')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                            else if(swiz[i] == 'w')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                            loc=new llvm::LoadInst(la,"",bb);
-                            llvm::Constant* ridx=llvm::ConstantInt::get(irgen->GetIntType(), i);
-                            llvm::Value *extract2=llvm::ExtractElementInst::Create(loc,idx,"",bb);
-                            llvm::Value *extract1=llvm::ExtractElementInst::Create(rv,ridx,"",bb);
-                            llvm::Value *mul = llvm::BinaryOperator::CreateFMul(extract1,extract2, "FAtoFA", bb);
-                            loc=new llvm::LoadInst(la,"",bb);
-                            store=llvm::InsertElementInst::Create(loc,mul,idx,"",bb);
-                            llvm::Value* result = new llvm::StoreInst(store, la, "",bb);
-                    }
-                }
-            }
-            else{
-                int veclen=0;
-                if (lv->getType()==irgen->GetType(Type::vec2Type))
-                    veclen=2;
-                else if (lv->getType()==irgen->GetType(Type::vec3Type))
-                    veclen=3;
-                else if (lv->getType()==irgen->GetType(Type::vec4Type))
-                    veclen=4;
-                if (r){
-                    llvm::Value *ra = r->EmitAddress();
-                    llvm::Value *rloc=new llvm::LoadInst(ra,"",bb);
-                    rswiz=r->GetField()->GetName();
-                    llvm::Constant *ridx;
-                    if (strlen(rswiz)>1)
-                        for(int i=0;i<strlen(rswiz); i++) {
-                            if(rswiz[i] == 'x')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                            else if(rswiz[i] == 'y')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                            else if(rswiz[i] == 'z')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                            else if(rswiz[i] == 'w')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                            lv=this->left->Emit();
-                            llvm::Constant* idx=llvm::ConstantInt::get(irgen->GetIntType(), i);
-                            llvm::Value *extract1=llvm::ExtractElementInst::Create(rloc,ridx,"",bb);
-                            llvm::Value *extract2=llvm::ExtractElementInst::Create(lv,idx,"",bb);               
-                            llvm::Value *mul = llvm::BinaryOperator::CreateFMul(extract1,extract2, "FAtoVec", bb);
-                            store=llvm::InsertElementInst::Create(lv,mul,idx,"",bb);
-                            llvm::Value* result = new llvm::StoreInst(store, loc, "",bb);
-                        }
-                        if (strlen(rswiz)==1) {
-                            if(rswiz[0] == 'x')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                            else if(rswiz[0] == 'y')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                            else if(rswiz[0] == 'z')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                            else if(rswiz[0] == 'w')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                            for (int i=0;i<veclen;i++) {
-                                lv=this->left->Emit();
-                                llvm::Constant* idx=llvm::ConstantInt::get(irgen->GetIntType(), i);
-                                llvm::Value *extract1=llvm::ExtractElementInst::Create(rloc,ridx,"",bb);
-                                llvm::Value *extract2=llvm::ExtractElementInst::Create(lv,idx,"",bb);
-                                llvm::Value *mul = llvm::BinaryOperator::CreateFMul(extract1,extract2, "FAtoVec", bb);
-                                store=llvm::InsertElementInst::Create(lv,mul,idx,"",bb);
-                                llvm::Value* result = new llvm::StoreInst(store, loc, "",bb);
-                            }
-                        }
-                    }
-                    else if (rv->getType() == irgen->GetType(Type::floatType)){
-                        for (int i=0;i<veclen;i++) {
-                            lv=this->left->Emit();
-                            llvm::Constant* idx=llvm::ConstantInt::get(irgen->GetIntType(), i);
-                            llvm::Value *extract=llvm::ExtractElementInst::Create(lv,idx,"",bb);                
-                            llvm::Value *mul = llvm::BinaryOperator::CreateFMul(extract,rv, "FAtoVec", bb);
-                            store=llvm::InsertElementInst::Create(lv,mul,idx,"",bb);
-                            llvm::Value* result = new llvm::StoreInst(store, loc, "",bb);
-                        }
-                    }
-                    else {
-                        llvm::Value *mul = llvm::BinaryOperator::CreateFMul(lv, rv, "VectoVec", bb);
-                        llvm::Value *in = new llvm::StoreInst(mul, loc, bb);
-                    }
-                }
-            }
-            else if(op->IsOp("/=")) {
-                if(!l&&(lv->getType() == irgen->GetType(Type::floatType))){
-                    if (r){
-                        llvm::Value *ra = r->EmitAddress();
-                        rswiz=r->GetField()->GetName();
-                        llvm::Value *rloc=new llvm::LoadInst(ra,"",bb);
-                        llvm::Constant *ridx;
-                        for(int i=0;i<strlen(rswiz); i++){
-                            if(rswiz[i] == 'x')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                            else if(rswiz[i] == 'y')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                            else if(rswiz[i] == 'z')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                            else if(rswiz[i] == 'w')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-
-                            llvm::Value *extract=llvm::ExtractElementInst::Create(rloc,ridx,"",bb);
-                            llvm::Value *div = llvm::BinaryOperator::CreateFDiv(lv, extract, "RFloatPlusEqual", bb);
-                            llvm::Value *in = new llvm::StoreInst(div, loc, bb);
-                        }
-                    }
-                    else {
-                        llvm::Value *div = llvm::BinaryOperator::CreateFDiv(lv, rv, "LFloatPlusEqual", bb);
-                        llvm::Value *in = new llvm::StoreInst(div, loc, bb);
-                    }
-                }
-                else if(lv->getType() == irgen->GetType(Type::intType)) {
-                    llvm::Value *div = llvm::BinaryOperator::CreateSDiv(lv, rv, "IntPlusEqual", bb);
-                    llvm::Value *in = new llvm::StoreInst(div, loc, bb);    
-                }
-                else if (l) {
-                    llvm::Value* la=l->EmitAddress();
-                    if (r){
-                        llvm::Value *ra = r->EmitAddress();
-                        llvm::Value *rloc=new llvm::LoadInst(ra,"",bb);
-                        swiz=l->GetField()->GetName();
-                        rswiz=r->GetField()->GetName();
-                        llvm::Constant *idx = NULL;
-                        llvm::Constant *ridx = NULL;
-                        for(int i=0;i<strlen(swiz); i++) {
-                            int j=0;
-                            if (strlen(rswiz)>1)
-                                j=i;
-                            if(swiz[i] == 'x')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                            else if(swiz[i] == 'y')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                            else if(swiz[i] == 'z')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                            else if(swiz[i] == 'w')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                            if(rswiz[j] == 'x')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                            else if(rswiz[j] == 'y')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                            else if(rswiz[j] == 'z')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                            else if(rswiz[j] == 'w')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                            loc=new llvm::LoadInst(la,"",bb);
-                            llvm::Value *extract1=llvm::ExtractElementInst::Create(rloc,ridx,"",bb);
-                            llvm::Value *extract2=llvm::ExtractElementInst::Create(loc,idx,"",bb);
-                            llvm::Value *div = llvm::BinaryOperator::CreateFDiv(extract2,extract1, "FAtoFA", bb);
-                            loc=new llvm::LoadInst(la,"",bb);
-                            store=llvm::InsertElementInst::Create(loc,div,idx,"",bb);
-                            llvm::Value* result = new llvm::StoreInst(store, la, "",bb);
-                        }
-                    }
-                    else if (rv->getType() == irgen->GetType(Type::floatType)){
-                        swiz=l->GetField()->GetName();
-                        llvm::Constant *idx;
-                        for(int i=0;i<strlen(swiz); i++) {
-                            if(swiz[i] == 'x')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                            else if(swiz[i] == 'y')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                            else if(swiz[i] == 'z')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                            else if(swiz[i] == 'w')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                            loc=new llvm::LoadInst(la,"",bb);
-                            llvm::Value *extract=llvm::ExtractElementInst::Create(loc,idx,"",bb);
-                            llvm::Value *div = llvm::BinaryOperator::CreateFDiv(extract,rv, "FtoFA", bb);
-                            store=llvm::InsertElementInst::Create(loc,div,idx,"",bb);
-                            llvm::Value* result = new llvm::StoreInst(store, la, "",bb);
-                        }
-                    }
-                    else {
-                        swiz=l->GetField()->GetName();
-                        llvm::Constant *idx;
-                        for(int i=0;i<strlen(swiz); i++) {
-                            if(swiz[i] == 'x')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                            else if(swiz[i] == 'y')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                            else if(swiz[i] == 'z')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                            else if(swiz[i] == 'w')
-                                idx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                            loc=new llvm::LoadInst(la,"",bb);
-                            llvm::Constant* ridx=llvm::ConstantInt::get(irgen->GetIntType(), i);
-                            llvm::Value *extract2=llvm::ExtractElementInst::Create(loc,idx,"",bb);
-                            llvm::Value *extract1=llvm::ExtractElementInst::Create(rv,ridx,"",bb);
-                            llvm::Value *div = llvm::BinaryOperator::CreateFDiv(extract2,extract1, "FAtoFA", bb);
-                            loc=new llvm::LoadInst(la,"",bb);
-                            store=llvm::InsertElementInst::Create(loc,div,idx,"",bb);
-                            llvm::Value* result = new llvm::StoreInst(store, la, "",bb);
-                        }
-                    }
-                }
-                else{
-                    int veclen=0;
-                    if (lv->getType()==irgen->GetType(Type::vec2Type))
-                        veclen=2;
-                    else if (lv->getType()==irgen->GetType(Type::vec3Type))
-                        veclen=3;
-                    else if (lv->getType()==irgen->GetType(Type::vec4Type))
-                        veclen=4;
-                    if (r){
-                        llvm::Value *ra = r->EmitAddress();
-                        llvm::Value *rloc=new llvm::LoadInst(ra,"",bb);
-                        rswiz=r->GetField()->GetName();
-                        llvm::Constant *ridx;
-                    if (strlen(rswiz)>1)
-                        for(int i=0;i<strlen(rswiz); i++) {
-                            if(rswiz[i] == 'x')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                            else if(rswiz[i] == 'y')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                            else if(rswiz[i] == 'z')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                            else if(rswiz[i] == 'w')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                            lv=this->left->Emit();
-                            llvm::Constant* idx=llvm::ConstantInt::get(irgen->GetIntType(), i);
-                            llvm::Value *extract1=llvm::ExtractElementInst::Create(rloc,ridx,"",bb);
-                            llvm::Value *extract2=llvm::ExtractElementInst::Create(lv,idx,"",bb);               
-                            llvm::Value *div = llvm::BinaryOperator::CreateFDiv(extract2,extract1, "FAtoVec", bb);
-                            store=llvm::InsertElementInst::Create(lv,div,idx,"",bb);
-                            llvm::Value* result = new llvm::StoreInst(store, loc, "",bb);
-                        }
-                        if (strlen(rswiz)==1) {
-                            if(rswiz[0] == 'x')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                            else if(rswiz[0] == 'y')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                            else if(rswiz[0] == 'z')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                            else if(rswiz[0] == 'w')
-                                ridx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                            for (int i=0;i<veclen;i++) {
-                                lv=this->left->Emit();
-                                llvm::Constant* idx=llvm::ConstantInt::get(irgen->GetIntType(), i);
-                                llvm::Value *extract1=llvm::ExtractElementInst::Create(rloc,ridx,"",bb);
-                                llvm::Value *extract2=llvm::ExtractElementInst::Create(lv,idx,"",bb);
-                                llvm::Value *div = llvm::BinaryOperator::CreateFDiv(extract2,extract1, "FAtoVec", bb);
-                                store=llvm::InsertElementInst::Create(lv,div,idx,"",bb);
-                                llvm::Value* result = new llvm::StoreInst(store, loc, "",bb);
-                            }
-                        }
-                    }
-            else if (rv->getType() == irgen->GetType(Type::floatType)) {
-                for (int i=0;i<veclen;i++) {
-                    lv=this->left->Emit();
-                    llvm::Constant* idx=llvm::ConstantInt::get(irgen->GetIntType(), i);
-                    llvm::Value *extract=llvm::ExtractElementInst::Create(lv,idx,"",bb);                
-                    llvm::Value *div = llvm::BinaryOperator::CreateFDiv(extract,rv, "FAtoVec", bb);
-                    store=llvm::InsertElementInst::Create(lv,div,idx,"",bb);
-                    llvm::Value* result = new llvm::StoreInst(store, loc, "",bb);
-                }
-            }
 
-            else {
-                llvm::Value *div = llvm::BinaryOperator::CreateFDiv(lv, rv, "VectoVec", bb);
-                llvm::Value *in = new llvm::StoreInst(div, loc, bb);
-            }
-        }
-    }
-    return rv;
+    // compound assignment: the old value, or just its swizzled lanes, is
+    // combined with the right side like the binary operator would, so a
+    // scalar operand is broadcast once instead of lane by lane
+    char opc = op->GetToken()[0];
+    llvm::Value *result;
+    if(irgen->IsMatrixType(lv->getType()) || irgen->IsMatrixType(rv->getType()))
+        result = irgen->CreateMatrixOp(opc, lv, rv);
+    else
+        result = irgen->CreateBinaryOp(opc, lv, rv, left->IsUnsigned());
+    if(l)
+        irgen->CreateStore(irgen->CreateSwizzleInsert(old, result, l->GetField()->GetName()), loc);
+    else
+        irgen->CreateStore(result, loc);
+    return result;
 }
 
 llvm::Value *PostfixExpr::Emit() {
     Operator *op = this->op;
-    llvm::Value *v = left->Emit();
     char *swiz = NULL;
-    llvm::LoadInst *ld = llvm::cast<llvm::LoadInst>(v);
-    llvm::Value *loc = ld->getPointerOperand();
     FieldAccess* l = dynamic_cast<FieldAccess*>(left);
+    llvm::Value *loc = left->EmitAddress();
+    llvm::Value *v = l ? l->EmitSwizzle(irgen->CreateLoad(loc)) : irgen->CreateLoad(loc);
     llvm::BasicBlock *bb = irgen->GetBasicBlock();
     llvm::Value *val = llvm::ConstantInt::get(irgen->GetIntType(), 1);
 
-    if(v->getType() == irgen->GetType(Type::intType)) {
+    if(v->getType()->isIntOrIntVectorTy()) {
+        val = llvm::ConstantInt::get(v->getType(), 1);
         if(op->IsOp("++")) {
-            llvm::Value *dec = llvm::BinaryOperator::CreateAdd(v, val, "", bb);
-            llvm::Value *in = new llvm::StoreInst(dec, loc, bb);
+            llvm::Value *dec = irgen->CreateBinaryOp('+', v, val, false);
+            llvm::Value *in = irgen->CreateStore(dec, loc);
         }
         else  {
-            llvm::Value *dec = llvm::BinaryOperator::CreateSub(v, val, "", bb);
-            llvm::Value *in = new llvm::StoreInst(dec, loc, bb);
+            llvm::Value *dec = irgen->CreateBinaryOp('-', v, val, false);
+            llvm::Value *in = irgen->CreateStore(dec, loc);
         }
     }
     else if(!l&&v->getType() == irgen->GetType(Type::floatType)){
@@ -1226,11 +279,11 @@ llvm::Value *PostfixExpr::Emit() {
         if(op->IsOp("++")) {
         
             llvm::Value *dec = llvm::BinaryOperator::CreateFAdd(v, val, "", bb);
-            llvm::Value* in = new llvm::StoreInst(dec, loc, bb);
+            llvm::Value* in = irgen->CreateStore(dec, loc);
         }
         else {
             llvm::Value *dec = llvm::BinaryOperator::CreateFSub(v, val, "", bb);
-            llvm::Value *in = new llvm::StoreInst(dec, loc, bb);
+            llvm::Value *in = irgen->CreateStore(dec, loc);
         }
     }
     else if (l) {
@@ -1249,14 +302,14 @@ llvm::Value *PostfixExpr::Emit() {
                 idx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
             else if(swiz[i] == 'w')
                 idx = llvm::ConstantInt::get(irgen->GetIntType(), 3);                                           
-            loc = new llvm::LoadInst(la,"",bb);
+            loc = irgen->CreateLoad(la);
             llvm::Value *extract=llvm::ExtractElementInst::Create(loc,idx,"",bb);
             if(op->IsOp("++"))
                 lv = llvm::BinaryOperator::CreateFAdd(extract,val, "FA", bb);           
             else
                 lv = llvm::BinaryOperator::CreateFSub(extract,val, "FA", bb);
             store = llvm::InsertElementInst::Create(loc,lv,idx,"",bb);
-            llvm::Value* result = new llvm::StoreInst(store, la, "",bb);
+            llvm::Value* result = irgen->CreateStore(store, la);
         }       
     }
     else {
@@ -1279,55 +332,61 @@ llvm::Value *PostfixExpr::Emit() {
             else
                 lv = llvm::BinaryOperator::CreateFSub(extract,val, "FA", bb);
             store = llvm::InsertElementInst::Create(v,lv,idx,"",bb);              
-            llvm::Value* result = new llvm::StoreInst(store, loc, "",bb);
+            llvm::Value* result = irgen->CreateStore(store, loc);
         }
     }
     return v;
 }
 
 llvm::Value *FieldAccess::EmitAddress() {
-    VarExpr* isVar=dynamic_cast<VarExpr*>(base);
-    if(isVar) {
-        return isVar->EmitAddress();
-    }
-    FieldAccess* isFA=dynamic_cast<FieldAccess*>(base);
-    {
-        return isFA->EmitAddress();
-    }
+    // a swizzle is read and written through the whole vector
+    return base ? base->EmitAddress() : NULL;
 }
 
 llvm::Value *FieldAccess::Emit() {
-    if(this->base != NULL) {
-        llvm::Value *val = base->Emit();
-        llvm::BasicBlock *bb = irgen->GetBasicBlock();
-        vector<llvm::Constant*> swizzles;
-
-        if(this->field != NULL) {
-            llvm::Constant *idx;
-            char *c = this->field->GetName();
-            for(char* i = c; *i; i++) {
-                if(*i == 'x')
-                    idx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-                else if(*i == 'y')
-                    idx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-                else if(*i == 'z')
-                    idx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-                else if(*i == 'w')
-                    idx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-                else
-                    idx = llvm::ConstantInt::get(irgen->GetIntType(), 100);
-                swizzles.push_back(idx);
-            }
-            if(strlen(c) < 2)
-                return llvm::ExtractElementInst::Create(val, idx, "", bb);
+    if(this->base != NULL && this->field != NULL)
+        return EmitSwizzle(base->Emit());
+    return NULL;
+}
 
-            llvm::ArrayRef<llvm::Constant*> swizzleArrayRef(swizzles);
-            llvm::Constant *m = llvm::ConstantVector::get(swizzleArrayRef);
-            llvm::Value *v = new llvm::ShuffleVectorInst(val, val, m, "", bb);
-            return v;
-        }
+llvm::Constant *FieldAccess::EvalConstant() {
+    llvm::Constant *val = base != NULL && field != NULL ? base->EvalConstant() : NULL;
+    if(val == NULL)
+        return NULL;
+    return llvm::cast<llvm::Constant>(EmitSwizzle(val));
+}
+
+llvm::Value *FieldAccess::EmitSwizzle(llvm::Value *val) {
+    llvm::BasicBlock *bb = irgen->GetBasicBlock();
+    llvm::Constant *c = llvm::dyn_cast<llvm::Constant>(val);
+    vector<llvm::Constant*> swizzles;
+    llvm::Constant *idx;
+    char *f = this->field->GetName();
+    for(char* i = f; *i; i++) {
+        if(*i == 'x')
+            idx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
+        else if(*i == 'y')
+            idx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
+        else if(*i == 'z')
+            idx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
+        else if(*i == 'w')
+            idx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
+        else
+            idx = llvm::ConstantInt::get(irgen->GetIntType(), 100);
+        swizzles.push_back(idx);
     }
-    return NULL;
+    if(strlen(f) < 2) {
+        if(c != NULL)
+            return llvm::ConstantExpr::getExtractElement(c, idx);
+        return llvm::ExtractElementInst::Create(val, idx, "", bb);
+    }
+
+    llvm::ArrayRef<llvm::Constant*> swizzleArrayRef(swizzles);
+    llvm::Constant *m = llvm::ConstantVector::get(swizzleArrayRef);
+    if(c != NULL)
+        return llvm::ConstantExpr::getShuffleVector(c, c, m);
+    llvm::Value *v = new llvm::ShuffleVectorInst(val, val, m, "", bb);
+    return v;
 }
 
 Operator::Operator(yyltype loc, const char *tok) : Node(loc) {
@@ -1366,31 +425,44 @@ CompoundExpr::CompoundExpr(Expr *l, Operator *o)
     (op=o)->SetParent(this);
 }
 
+ArithmeticExpr::ArithmeticExpr(Operator *o, Expr *r) : CompoundExpr(o, r) {
+    if(o->IsOp("++") || o->IsOp("--"))
+        LValue::NoteWrite(r);
+}
+
+AssignExpr::AssignExpr(Expr *l, Operator *o, Expr *r) : CompoundExpr(l, o, r) {
+    LValue::NoteWrite(l);
+}
+
+PostfixExpr::PostfixExpr(Expr *l, Operator *o) : CompoundExpr(l, o) {
+    LValue::NoteWrite(l);
+}
+
 llvm::Value *EqualityExpr::Emit() {
-    Operator *op = this->op;
     llvm::Value *lhs = left->Emit();
     llvm::Value *rhs = right->Emit();
-    llvm::BasicBlock *bb = irgen->GetBasicBlock();
-    llvm::CmpInst::Predicate pred = NULL;
-
-    if((lhs->getType() == irgen->GetType(Type::floatType)) && (rhs->getType() == irgen->GetType(Type::floatType))) {
-        if(op->IsOp("=="))
-            pred = llvm::CmpInst::FCMP_OEQ;
-        if(op->IsOp("!="))
-            pred = llvm::CmpInst::FCMP_ONE;
-        llvm::Value *v = llvm::CmpInst::Create(llvm::CmpInst::FCmp, pred, lhs, rhs, "", bb);
-        return v;
-    }    
+    return EmitCompare(lhs, rhs);
+}
 
-    if((lhs->getType() == irgen->GetType(Type::intType)) && (rhs->getType() == irgen->GetType(Type::intType))) {
-        if(op->IsOp("=="))
-            pred = llvm::CmpInst::ICMP_EQ;
-        else if(op->IsOp("!="))
-            pred = llvm::CmpInst::ICMP_NE;
-        llvm::Value *v = llvm::CmpInst::Create(llvm::CmpInst::ICmp, pred, lhs, rhs, "", bb);
-        return v;
-    }
-    return NULL;
+llvm::Value *EqualityExpr::EmitCompare(llvm::Value *lhs, llvm::Value *rhs) {
+    if(lhs->getType() != rhs->getType())
+        return NULL;
+    bool fp = lhs->getType()->isFPOrFPVectorTy();
+    if(!lhs->getType()->isVectorTy())
+        return irgen->CreateCompare(ComparePredicate(op, fp, false), lhs, rhs);
+
+    // vectors compare all lanes at once, then reduce the lane mask
+    llvm::Value *lanes = irgen->CreateCompare(fp ? llvm::CmpInst::FCMP_OEQ : llvm::CmpInst::ICMP_EQ, lhs, rhs);
+    llvm::Value *v = irgen->CreateAll(lanes);
+    return op->IsOp("!=") ? irgen->CreateNot(v) : v;
+}
+
+llvm::Constant *EqualityExpr::EvalConstant() {
+    llvm::Constant *lhs = left->EvalConstant();
+    llvm::Constant *rhs = right->EvalConstant();
+    if(lhs == NULL || rhs == NULL)
+        return NULL;
+    return llvm::dyn_cast_or_null<llvm::Constant>(EmitCompare(lhs, rhs));
 }
 
 void CompoundExpr::PrintChildren(int indentLevel) {
@@ -1398,6 +470,20 @@ void CompoundExpr::PrintChildren(int indentLevel) {
    op->Print(indentLevel+1);
    if (right) right->Print(indentLevel+1);
 }
+
+int CompoundExpr::GetCost() {
+    return (left ? left->GetCost() : 0) + (right ? right->GetCost() : 0) + 1;
+}
+
+bool CompoundExpr::HasSideEffects() {
+    return (left && left->HasSideEffects()) || (right && right->HasSideEffects());
+}
+
+bool ArithmeticExpr::HasSideEffects() {
+    if(left == NULL && (op->IsOp("++") || op->IsOp("--")))
+        return true;
+    return CompoundExpr::HasSideEffects();
+}
   
 ConditionalExpr::ConditionalExpr(Expr *c, Expr *t, Expr *f)
   : Expr(Join(c->GetLocation(), f->GetLocation())) {
@@ -1407,28 +493,158 @@ ConditionalExpr::ConditionalExpr(Expr *c, Expr *t, Expr *f)
     (falseExpr=f)->SetParent(this);
 }
 
+int ConditionalExpr::GetCost() {
+    int t = trueExpr->GetCost();
+    int f = falseExpr->GetCost();
+    return cond->GetCost() + (t > f ? t : f) + 1;
+}
+
+bool ConditionalExpr::HasSideEffects() {
+    return cond->HasSideEffects() || trueExpr->HasSideEffects() || falseExpr->HasSideEffects();
+}
+
+llvm::Constant *ConditionalExpr::EvalConstant() {
+    llvm::Constant *c = cond->EvalConstant();
+    if(c == NULL)
+        return NULL;
+    return c->isNullValue() ? falseExpr->EvalConstant() : trueExpr->EvalConstant();
+}
+
+llvm::Value *Expr::EmitMasked(llvm::Value *mask) {
+    llvm::BasicBlock *bb = irgen->GetBasicBlock();
+    llvm::BasicBlock *ab = irgen->CreateBlock("lanes.arm");
+    llvm::BasicBlock *mb = irgen->CreateBlock("lanes.end");
+    irgen->SetLaneMask(mask);
+    irgen->EmitCondBranch(mask, ab, mb);
+
+    irgen->EmitBlock(ab);
+    llvm::Value *val = Emit();
+    llvm::BasicBlock *ae = irgen->GetBasicBlock();
+    irgen->EmitBranch(mb);
+
+    irgen->EmitBlock(mb);
+    llvm::PHINode *phi = llvm::PHINode::Create(val->getType(), 2, "", mb);
+    phi->addIncoming(llvm::UndefValue::get(val->getType()), bb);
+    phi->addIncoming(val, ae);
+    return phi;
+}
+
 llvm::Value *ConditionalExpr::Emit(){    
     llvm::Value *testval=this->cond->Emit();
-    llvm::Value *tval=this->trueExpr->Emit();
-    llvm::Value *fval=this->falseExpr->Emit();
-    llvm::Value *result=llvm::SelectInst::Create(testval,tval,fval,"",irgen->GetBasicBlock());
-    return result;    
+
+    // a constant condition only ever needs the arm it selects
+    if(llvm::Constant *c = llvm::dyn_cast<llvm::Constant>(testval))
+        return c->isNullValue() ? falseExpr->Emit() : trueExpr->Emit();
+
+    // cheap, pure arms: evaluate both and pick one without branching;
+    // where no invocation runs there is nothing to skip either
+    if((!trueExpr->HasSideEffects() && !falseExpr->HasSideEffects() &&
+        trueExpr->GetCost() + falseExpr->GetCost() <= SpeculationLimit) || irgen->IsMaskClear()) {
+        llvm::Value *tval=this->trueExpr->Emit();
+        llvm::Value *fval=this->falseExpr->Emit();
+        llvm::Value *result=llvm::SelectInst::Create(testval,tval,fval,"",irgen->GetBasicBlock());
+        return result;
+    }
+
+    // in a lane variant each arm runs for the invocations that take it
+    if(irgen->InLanes()) {
+        llvm::Value *saved = irgen->GetLaneMask();
+        llvm::Value *tval = trueExpr->EmitMasked(irgen->CreateMaskAnd(saved, testval));
+        llvm::Value *fval = falseExpr->EmitMasked(irgen->CreateMaskAnd(saved, irgen->CreateNot(testval)));
+        irgen->SetLaneMask(saved);
+        return llvm::SelectInst::Create(testval, tval, fval, "", irgen->GetBasicBlock());
+    }
+
+    // otherwise only evaluate the arm that is taken
+    llvm::BasicBlock *tb = irgen->CreateBlock("cond.true");
+    llvm::BasicBlock *fb = irgen->CreateBlock("cond.false");
+    llvm::BasicBlock *mb = irgen->CreateBlock("cond.end");
+    irgen->EmitProfiledBranch(testval, tb, fb, "cond", GetLine());
+
+    irgen->EmitBlock(tb);
+    llvm::Value *tval = this->trueExpr->Emit();
+    llvm::BasicBlock *te = irgen->GetBasicBlock();
+    irgen->EmitBranch(mb);
+
+    irgen->EmitBlock(fb);
+    llvm::Value *fval = this->falseExpr->Emit();
+    llvm::BasicBlock *fe = irgen->GetBasicBlock();
+    irgen->EmitBranch(mb);
+
+    irgen->EmitBlock(mb);
+    llvm::PHINode *phi = llvm::PHINode::Create(tval->getType(), 2, "", mb);
+    phi->addIncoming(tval, te);
+    phi->addIncoming(fval, fe);
+    return phi;
+}
+
+llvm::Constant *LogicalExpr::EvalConstant() {
+    llvm::Constant *lhs = left->EvalConstant();
+    if(lhs == NULL)
+        return NULL;
+    // false && x and true || x are decided without looking at x
+    if(op->IsOp("&&") == lhs->isNullValue())
+        return lhs;
+    return right->EvalConstant();
 }
 
 llvm::Value *LogicalExpr::Emit() {
     Operator *op = this->op;
     llvm::Value *lhs = left->Emit();
-    llvm::Value *rhs = right->Emit();
-    llvm::BasicBlock *bb = irgen->GetBasicBlock();
-    if(op->IsOp("&&")) {
-        llvm::Value *v = llvm::BinaryOperator::CreateAnd(lhs, rhs, "LogicalAnd", bb);
-        return v;
+
+    if(llvm::Constant *c = llvm::dyn_cast<llvm::Constant>(lhs)) {
+        if(op->IsOp("&&") == c->isNullValue())
+            return c;
+        return right->Emit();
+    }
+
+    // a cheap, pure right operand is cheaper to compute than to branch
+    // around; where no invocation runs there is nothing to skip either
+    if((!right->HasSideEffects() && right->GetCost() <= SpeculationLimit) || irgen->IsMaskClear()) {
+        llvm::Value *rhs = right->Emit();
+        llvm::BasicBlock *bb = irgen->GetBasicBlock();
+        if(op->IsOp("&&")) {
+            llvm::Value *v = llvm::BinaryOperator::CreateAnd(lhs, rhs, "LogicalAnd", bb);
+            return v;
+        }
+        if(op->IsOp("||")) {
+            llvm::Value *v = llvm::BinaryOperator::CreateOr(lhs, rhs, "LogicalOr", bb);
+            return v;
+        }
+        return NULL;
     }
-    if(op->IsOp("||")) {
-        llvm::Value *v = llvm::BinaryOperator::CreateOr(lhs, rhs, "LogicalOr", bb);
-        return v;
+
+    // in a lane variant the right operand runs for the invocations it decides
+    if(irgen->InLanes()) {
+        llvm::Value *saved = irgen->GetLaneMask();
+        llvm::Value *decides = op->IsOp("&&") ? lhs : irgen->CreateNot(lhs);
+        llvm::Value *rhs = right->EmitMasked(irgen->CreateMaskAnd(saved, decides));
+        irgen->SetLaneMask(saved);
+        llvm::BasicBlock *bb = irgen->GetBasicBlock();
+        if(op->IsOp("&&"))
+            return llvm::BinaryOperator::CreateAnd(lhs, rhs, "LogicalAnd", bb);
+        return llvm::BinaryOperator::CreateOr(lhs, rhs, "LogicalOr", bb);
     }
-    return NULL;
+
+    // short-circuit: only evaluate the right operand when it decides the result
+    llvm::BasicBlock *lb = irgen->GetBasicBlock();
+    llvm::BasicBlock *rb = irgen->CreateBlock(op->IsOp("&&") ? "and.rhs" : "or.rhs");
+    llvm::BasicBlock *mb = irgen->CreateBlock(op->IsOp("&&") ? "and.end" : "or.end");
+    if(op->IsOp("&&"))
+        irgen->EmitCondBranch(lhs, rb, mb);
+    else
+        irgen->EmitCondBranch(lhs, mb, rb);
+
+    irgen->EmitBlock(rb);
+    llvm::Value *rhs = right->Emit();
+    llvm::BasicBlock *re = irgen->GetBasicBlock();
+    irgen->EmitBranch(mb);
+
+    irgen->EmitBlock(mb);
+    llvm::PHINode *phi = llvm::PHINode::Create(irgen->GetBoolType(), 2, op->IsOp("&&") ? "LogicalAnd" : "LogicalOr", mb);
+    phi->addIncoming(llvm::ConstantInt::get(irgen->GetBoolType(), op->IsOp("||")), lb);
+    phi->addIncoming(rhs, re);
+    return phi;
 }
 
 void ConditionalExpr::PrintChildren(int indentLevel) {
@@ -1436,9 +652,26 @@ void ConditionalExpr::PrintChildren(int indentLevel) {
     trueExpr->Print(indentLevel+1, "(true) ");
     falseExpr->Print(indentLevel+1, "(false) ");
 }
+void LValue::NoteWrite(Expr *target) {
+    while(target != NULL) {
+        if(VarExpr *v = dynamic_cast<VarExpr*>(target)) {
+            FnDecl::NoteWritten(v);
+            return;
+        }
+        if(ArrayAccess *a = dynamic_cast<ArrayAccess*>(target))
+            target = a->GetBase();
+        else if(FieldAccess *f = dynamic_cast<FieldAccess*>(target))
+            target = f->GetBase();
+        else
+            return;
+    }
+}
+
 ArrayAccess::ArrayAccess(yyltype loc, Expr *b, Expr *s) : LValue(loc) {
     (base=b)->SetParent(this); 
     (subscript=s)->SetParent(this);
+    if(VarExpr *v = dynamic_cast<VarExpr*>(b))
+        FnDecl::NoteIndexed(v);
 }
 
 void ArrayAccess::PrintChildren(int indentLevel) {
@@ -1447,11 +680,32 @@ void ArrayAccess::PrintChildren(int indentLevel) {
 }
 
 llvm::Value *ArrayAccess::Emit() {
+    return irgen->CreateLoad(EmitAddress());
+}
+
+llvm::Value *ArrayAccess::EmitAddress() {
     vector<llvm::Value*> arrayBase;
     arrayBase.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-    arrayBase.push_back(subscript->Emit());
-    llvm::Value *elem = llvm::GetElementPtrInst::Create(dynamic_cast<llvm::LoadInst*>(this->base->Emit())->getPointerOperand(), arrayBase, "", irgen->GetBasicBlock());
-    return new llvm::LoadInst(elem, "", irgen->GetBasicBlock());
+    llvm::Value *arr = this->base->EmitAddress();
+    llvm::Type *ty = llvm::cast<llvm::PointerType>(arr->getType())->getElementType();
+    int count;
+    // m[i] selects a column out of the matrix's wrapped column array
+    if(irgen->IsMatrixType(ty)) {
+        arrayBase.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
+        count = irgen->GetMatrixSize(ty);
+    }
+    else
+        count = ty->isArrayTy() ? ty->getArrayNumElements() : ty->getVectorNumElements();
+
+    llvm::Value *index = subscript->Emit();
+    if(llvm::ConstantInt *c = llvm::dyn_cast<llvm::ConstantInt>(index)) {
+        if(c->getZExtValue() >= (uint64_t)count)
+            ReportError::Formatted(GetLocation(), "Array index %d is out of bounds", (int)c->getSExtValue());
+    }
+    else
+        irgen->CreateBoundsCheck(index, count);
+    arrayBase.push_back(index);
+    return llvm::GetElementPtrInst::Create(arr, arrayBase, "", irgen->GetBasicBlock());
 }
      
 FieldAccess::FieldAccess(Expr *b, Identifier *f) 
@@ -1473,6 +727,14 @@ Call::Call(yyltype loc, Expr *b, Identifier *f, List<Expr*> *a) : Expr(loc)  {
     if (base) base->SetParent(this);
     (field=f)->SetParent(this);
     (actuals=a)->SetParentAll(this);
+    // arguments for out parameters are written by the call
+    if(FnDecl *fn = FnDecl::LookUp(f->GetName())) {
+        for(int i = 0; i < a->NumElements() && i < fn->GetFormals()->NumElements(); i++)
+            if(fn->GetFormals()->Nth(i)->isOut())
+                LValue::NoteWrite(a->Nth(i));
+        if(fn->UsesFragCoord())
+            FnDecl::NoteFragCoord();
+    }
 }
 
 void Call::PrintChildren(int indentLevel) {
@@ -1481,17 +743,176 @@ void Call::PrintChildren(int indentLevel) {
    if (actuals) actuals->PrintAll(indentLevel+1, "(actuals) ");
 }
 
+bool Call::IsInline() {
+    return symtab->LookUpValue(field->GetName()) == NULL &&
+           (Type::LookUp(field->GetName()) != NULL || IRGenerator::IsBuiltin(field->GetName()));
+}
+
+bool Call::HasSideEffects() {
+    if(!IsInline())
+        return true;
+    for(int i = 0; i < actuals->NumElements(); i++)
+        if(actuals->Nth(i)->HasSideEffects())
+            return true;
+    return false;
+}
+
+int Call::GetCost() {
+    // a call is never worth speculating, whatever its arguments cost;
+    // built-ins and constructors expand to a handful of instructions
+    int cost = IsInline() ? 2 : 10;
+    for(int i = 0; i < actuals->NumElements(); i++)
+        cost += actuals->Nth(i)->GetCost();
+    return cost;
+}
+
+bool Call::IsUnsigned() {
+    Type *t = Type::LookUp(field->GetName());
+    if(t == NULL)
+        t = symtab->LookUpType(field->GetName());
+    if(t == NULL && IRGenerator::IsBuiltin(field->GetName()) && actuals->NumElements() > 0)
+        return actuals->Nth(0)->IsUnsigned();
+    return t != NULL && t->IsUnsigned();
+}
+
+llvm::Value *Call::EmitConstructor(Type *ctor, vector<llvm::Value*> &av) {
+    if (ctor->IsMatrix())
+      return irgen->CreateMatrix(irgen->GetType(ctor), av);
+    if (av.size() == 1)
+      return irgen->CreateCast(av[0], irgen->GetType(ctor), actuals->Nth(0)->IsUnsigned(), ctor->IsUnsigned());
+
+    // convert each argument to the element type, keeping its width
+    llvm::Type *ty = irgen->GetType(ctor);
+    for (int i = 0; i < av.size(); i++) {
+      llvm::Type *at = av[i]->getType();
+      llvm::Type *to = at->isVectorTy() ? llvm::VectorType::get(ty->getScalarType(), at->getVectorNumElements()) : ty->getScalarType();
+      if (!irgen->IsMatrixType(at))
+        av[i] = irgen->CreateCast(av[i], to, actuals->Nth(i)->IsUnsigned(), ctor->IsUnsigned());
+    }
+    return irgen->CreateVector(ty, av);
+}
+
+llvm::Constant *Call::EvalConstant() {
+    Type *ctor = Type::LookUp(field->GetName());
+    if (ctor == NULL || ctor->IsMatrix() || actuals->NumElements() == 0)
+      return NULL;
+    vector<llvm::Value*> av;
+    for (int i = 0; i < actuals->NumElements(); i++) {
+      llvm::Constant *c = actuals->Nth(i)->EvalConstant();
+      if (c == NULL)
+        return NULL;
+      av.push_back(c);
+    }
+    // with constant operands the constructor lowering folds completely
+    return llvm::dyn_cast<llvm::Constant>(EmitConstructor(ctor, av));
+}
+
+// Address of an argument passed by reference. Values without storage of
+// their own, and globals the callee could change while reading them, go
+// through a temporary copy.
+llvm::Value *Call::EmitReference(Expr *e) {
+    llvm::Value *addr = e->EmitAddress();
+    llvm::GlobalVariable *g = llvm::dyn_cast_or_null<llvm::GlobalVariable>(addr);
+    if(addr != NULL && !irgen->IsRegisterVariable(addr) && (g == NULL || !FnDecl::IsGlobalWritten(g->getName().data())))
+        return addr;
+    llvm::Value *val = e->Emit();
+    llvm::Value *tmp = irgen->CreateLocal(val->getType(), "arg", false);
+    irgen->CreateStore(val, tmp);
+    return tmp;
+}
+
+// Address for an out or inout argument. Variables in memory are passed
+// directly: the callee writes through the pointer only as it returns.
+// Swizzles and register variables go through a temporary that is
+// assigned back after the call.
+llvm::Value *Call::EmitOutArgument(Expr *e, bool copyIn, vector<pair<Expr*, llvm::Value*> > &copyBack) {
+    llvm::Value *addr = e->EmitAddress();
+    if(addr == NULL) {
+        ReportError::Formatted(e->GetLocation(), "Argument for an out parameter must be assignable");
+        return NULL;
+    }
+    if(dynamic_cast<FieldAccess*>(e) == NULL && !irgen->IsRegisterVariable(addr))
+        return addr;
+    llvm::Value *val = e->Emit();
+    llvm::Value *tmp = irgen->CreateLocal(val->getType(), "out", false);
+    if(copyIn)
+        irgen->CreateStore(val, tmp);
+    copyBack.push_back(make_pair(e, tmp));
+    return tmp;
+}
+
+void Call::EmitCopyBack(Expr *e, llvm::Value *tmp) {
+    llvm::Value *val = irgen->CreateLoad(tmp);
+    llvm::Value *addr = e->EmitAddress();
+    if(FieldAccess *swizzle = dynamic_cast<FieldAccess*>(e))
+        val = irgen->CreateSwizzleInsert(irgen->CreateLoad(addr), val, swizzle->GetField()->GetName());
+    irgen->CreateStore(val, addr);
+}
+
 llvm::Value *Call::Emit() {
     vector<llvm::Value*> av;
-    llvm::Function* f = (llvm::Function*)symtab->LookUpValue(field->GetName());
-    llvm::BasicBlock *bb = irgen->GetBasicBlock();
+    vector<pair<Expr*, llvm::Value*> > copyBack;
+    llvm::Function* f = llvm::dyn_cast_or_null<llvm::Function>(symtab->LookUpValue(field->GetName()));
+    FnDecl *fn = f ? FnDecl::LookUp(field->GetName()) : NULL;
 
     for(int i = 0; i < actuals->NumElements(); i++) {
-        av.push_back(actuals->Nth(i)->Emit());
+        VarDecl *formal = fn && i < fn->GetFormals()->NumElements() ? fn->GetFormals()->Nth(i) : NULL;
+        bool byRef = f != NULL && i < f->arg_size() && f->getFunctionType()->getParamType(i)->isPointerTy();
+        if(formal && formal->isOut())
+            av.push_back(EmitOutArgument(actuals->Nth(i), formal->isInOut(), copyBack));
+        else
+            av.push_back(byRef ? EmitReference(actuals->Nth(i)) : actuals->Nth(i)->Emit());
     }    
-    if (f==NULL)
-      std::cerr<<"FunctionCall"<<endl;
-    return llvm::CallInst::Create(f, av, "FunctionCall", bb);
+    // the caller passes on its own gl_FragCoord
+    if(fn != NULL && fn->UsesFragCoord()) {
+        llvm::Value *coord = symtab->LookUpValue("gl_FragCoord");
+        if(coord == NULL) {
+            ReportError::Formatted(GetLocation(), "%s reads gl_FragCoord and must be defined before it is called", field->GetName());
+            return NULL;
+        }
+        av.push_back(irgen->CreateLoad(coord, "gl_FragCoord"));
+    }
+
+    // type constructors, e.g. mat2(1.0, 2.0, 3.0, 4.0)
+    Type *ctor = Type::LookUp(field->GetName());
+    if (ctor != NULL)
+      return EmitConstructor(ctor, av);
+
+    if (f == NULL) {
+      bool u = actuals->NumElements() > 0 && actuals->Nth(0)->IsUnsigned();
+      llvm::Value *b = irgen->EmitBuiltin(field->GetName(), av, u);
+      if (b != NULL)
+        return b;
+    }
+
+    // unresolved callee: diagnose, and give the caller a value to keep going
+    if (f == NULL) {
+      if (symtab->LookUpValue(field->GetName()) != NULL)
+        ReportError::NotAFunction(field);
+      else
+        ReportError::IdentifierNotDeclared(field, LookingForFunction);
+      return llvm::UndefValue::get(irgen->GetType(Type::floatType));
+    }
+    // a lane variant calls the callee's, passing on its mask
+    if (irgen->InLanes()) {
+      if (fn != NULL && fn->GetMaskedVariant() != NULL) {
+        f = fn->GetMaskedVariant();
+        av.insert(av.begin(), irgen->GetLaneMask());
+      }
+      else {
+        string why = fn != NULL ? fn->GetLaneFallback() : "";
+        char line[32];
+        sprintf(line, " (line %d), which ", GetLine());
+        irgen->NoteLaneFallback(string("calls ") + field->GetName() + line +
+                                (why.empty() ? "is defined after the call" : why));
+      }
+    }
+    else
+      irgen->EmitProfCall(f, GetLine());
+    llvm::Value *call = irgen->CreateCall(f, av);
+    for (size_t i = 0; i < copyBack.size(); i++)
+      EmitCopyBack(copyBack[i].first, copyBack[i].second);
+    return call;
 } 
 
 
@@ -22,10 +22,37 @@ void yyerror(const char *msg);
 
 class Expr : public Stmt 
 {
+  protected:
+    // Operands at or below this cost that have no side effects are
+    // evaluated unconditionally and combined with a select/and/or
+    // instead of being guarded by a branch.
+    static const int SpeculationLimit = 4;
+
   public:
     Expr(yyltype loc) : Stmt(loc) {}
     Expr() : Stmt() {}
 
+    // Rough number of instructions needed to evaluate the expression and
+    // whether evaluating it is observable (stores, calls).
+    virtual int GetCost() { return 1; }
+    virtual bool HasSideEffects() { return false; }
+
+    // LLVM integer types carry no sign, so uint/uvec operands are tracked
+    // here to pick udiv and unsigned compares.
+    virtual bool IsUnsigned() { return false; }
+
+    // Folds the expression to a constant without emitting anything, or
+    // returns NULL when some operand is only known at run time.
+    virtual llvm::Constant *EvalConstant() { return NULL; }
+
+    // Storage an lvalue reads and writes through irgen->CreateLoad and
+    // CreateStore; NULL for expressions that are not lvalues.
+    virtual llvm::Value *EmitAddress() { return NULL; }
+
+    // In a lane variant: this for the invocations of mask, skipped when
+    // there are none, and undefined for the others (see irgen.h)
+    llvm::Value *EmitMasked(llvm::Value *mask);
+
     friend std::ostream& operator<< (std::ostream& stream, Expr * expr) {
         return stream << expr->GetPrintNameForNode();
     }
@@ -57,6 +84,8 @@ class IntConstant : public Expr
     const char *GetPrintNameForNode() { return "IntConstant"; }
     void PrintChildren(int indentLevel);
     llvm::Value *Emit();
+    llvm::Constant *EvalConstant() { return llvm::cast<llvm::Constant>(Emit()); }
+    int GetCost() { return 0; }
 };
 
 class FloatConstant: public Expr 
@@ -69,6 +98,8 @@ class FloatConstant: public Expr
     const char *GetPrintNameForNode() { return "FloatConstant"; }
     void PrintChildren(int indentLevel);
     llvm::Value *Emit();
+    llvm::Constant *EvalConstant() { return llvm::cast<llvm::Constant>(Emit()); }
+    int GetCost() { return 0; }
 };
 
 class BoolConstant : public Expr 
@@ -81,6 +112,8 @@ class BoolConstant : public Expr
     const char *GetPrintNameForNode() { return "BoolConstant"; }
     void PrintChildren(int indentLevel);
     llvm::Value *Emit();
+    llvm::Constant *EvalConstant() { return llvm::cast<llvm::Constant>(Emit()); }
+    int GetCost() { return 0; }
 };
 
 class VarExpr : public Expr
@@ -95,6 +128,8 @@ class VarExpr : public Expr
     Identifier *GetIdentifier() {return id;}
     llvm::Value *Emit();
     llvm::Value *EmitAddress();
+    bool IsUnsigned();
+    llvm::Constant *EvalConstant();
 };
 
 class Operator : public Node 
@@ -108,6 +143,7 @@ class Operator : public Node
     void PrintChildren(int indentLevel);
     friend ostream& operator<<(ostream& out, Operator *o) { return out << o->tokenString; }
     bool IsOp(const char *op) const;
+    const char *GetToken() const { return tokenString; }
  };
  
 class CompoundExpr : public Expr
@@ -121,15 +157,23 @@ class CompoundExpr : public Expr
     CompoundExpr(Operator *op, Expr *rhs);             // for unary
     CompoundExpr(Expr *lhs, Operator *op);             // for unary
     void PrintChildren(int indentLevel);
+    Operator *GetOp() { return op; }
+    Expr *GetLeft() { return left; }
+    Expr *GetRight() { return right; }
+    int GetCost();
+    bool HasSideEffects();
+    bool IsUnsigned() { return (left && left->IsUnsigned()) || right->IsUnsigned(); }
 };
 
 class ArithmeticExpr : public CompoundExpr 
 {
   public:
     ArithmeticExpr(Expr *lhs, Operator *op, Expr *rhs) : CompoundExpr(lhs,op,rhs) {}
-    ArithmeticExpr(Operator *op, Expr *rhs) : CompoundExpr(op,rhs) {}
+    ArithmeticExpr(Operator *op, Expr *rhs);
     const char *GetPrintNameForNode() { return "ArithmeticExpr"; }
     llvm::Value *Emit();
+    llvm::Constant *EvalConstant();
+    bool HasSideEffects();
 };
 
 class RelationalExpr : public CompoundExpr 
@@ -138,6 +182,9 @@ class RelationalExpr : public CompoundExpr
     RelationalExpr(Expr *lhs, Operator *op, Expr *rhs) : CompoundExpr(lhs,op,rhs) {}
     const char *GetPrintNameForNode() { return "RelationalExpr"; }
     llvm::Value *Emit();
+    llvm::Value *EmitCompare(llvm::Value *lhs, llvm::Value *rhs);
+    llvm::Constant *EvalConstant();
+    bool IsUnsigned() { return false; }
 };
 
 class EqualityExpr : public CompoundExpr 
@@ -146,6 +193,9 @@ class EqualityExpr : public CompoundExpr
     EqualityExpr(Expr *lhs, Operator *op, Expr *rhs) : CompoundExpr(lhs,op,rhs) {}
     const char *GetPrintNameForNode() { return "EqualityExpr"; }
     llvm::Value *Emit();
+    llvm::Value *EmitCompare(llvm::Value *lhs, llvm::Value *rhs);
+    llvm::Constant *EvalConstant();
+    bool IsUnsigned() { return false; }
 };
 
 class LogicalExpr : public CompoundExpr 
@@ -155,22 +205,26 @@ class LogicalExpr : public CompoundExpr
     LogicalExpr(Operator *op, Expr *rhs) : CompoundExpr(op,rhs) {}
     const char *GetPrintNameForNode() { return "LogicalExpr"; }
     llvm::Value *Emit();
+    llvm::Constant *EvalConstant();
+    bool IsUnsigned() { return false; }
 };
 
 class AssignExpr : public CompoundExpr 
 {
   public:
-    AssignExpr(Expr *lhs, Operator *op, Expr *rhs) : CompoundExpr(lhs,op,rhs) {}
+    AssignExpr(Expr *lhs, Operator *op, Expr *rhs);
     const char *GetPrintNameForNode() { return "AssignExpr"; }
     llvm::Value *Emit();
+    bool HasSideEffects() { return true; }
 };
 
 class PostfixExpr : public CompoundExpr
 {
   public:
-    PostfixExpr(Expr *lhs, Operator *op) : CompoundExpr(lhs,op) {}
+    PostfixExpr(Expr *lhs, Operator *op);
     const char *GetPrintNameForNode() { return "PostfixExpr"; }
     llvm::Value *Emit();
+    bool HasSideEffects() { return true; }
 
 };
 
@@ -183,12 +237,20 @@ class ConditionalExpr : public Expr
     ConditionalExpr(Expr *c, Expr *t, Expr *f);
     void PrintChildren(int indentLevel);
     const char *GetPrintNameForNode() { return "ConditionalExpr"; }
+    llvm::Constant *EvalConstant();
+    int GetCost();
+    bool HasSideEffects();
+    bool IsUnsigned() { return trueExpr->IsUnsigned(); }
 };
 
 class LValue : public Expr 
 {
   public:
     LValue(yyltype loc) : Expr(loc) {}
+    // Assignments, ++ and -- record the variable at the root of their
+    // target (a in a[i].x = ...) with the function being parsed (see
+    // FnDecl::IsWritten)
+    static void NoteWrite(Expr *target);
 };
 
 class ArrayAccess : public LValue 
@@ -201,6 +263,11 @@ class ArrayAccess : public LValue
     const char *GetPrintNameForNode() { return "ArrayAccess"; }
     void PrintChildren(int indentLevel);
     llvm::Value *Emit();
+    llvm::Value *EmitAddress();
+    Expr *GetBase() { return base; }
+    int GetCost() { return base->GetCost() + subscript->GetCost() + 1; }
+    bool HasSideEffects() { return base->HasSideEffects() || subscript->HasSideEffects(); }
+    bool IsUnsigned() { return base->IsUnsigned(); }
 };
 
 /* Note that field access is used both for qualified names
@@ -220,7 +287,13 @@ class FieldAccess : public LValue
     void PrintChildren(int indentLevel);
     llvm::Value *Emit();
     Identifier *GetField(){return field;}
+    Expr *GetBase() { return base; }
     llvm::Value *EmitAddress();
+    llvm::Value *EmitSwizzle(llvm::Value *val);
+    llvm::Constant *EvalConstant();
+    int GetCost() { return base ? base->GetCost() + 1 : 1; }
+    bool HasSideEffects() { return base ? base->HasSideEffects() : false; }
+    bool IsUnsigned() { return base ? base->IsUnsigned() : false; }
 
 };
 
@@ -234,6 +307,10 @@ class Call : public Expr
     Expr *base;	// will be NULL if no explicit base
     Identifier *field;
     List<Expr*> *actuals;
+
+    static llvm::Value *EmitReference(Expr *e);
+    static llvm::Value *EmitOutArgument(Expr *e, bool copyIn, vector<pair<Expr*, llvm::Value*> > &copyBack);
+    static void EmitCopyBack(Expr *e, llvm::Value *tmp);
     
   public:
     Call() : Expr(), base(NULL), field(NULL), actuals(NULL) {}
@@ -241,6 +318,12 @@ class Call : public Expr
     const char *GetPrintNameForNode() { return "Call"; }
     void PrintChildren(int indentLevel);
     llvm::Value *Emit();
+    llvm::Value *EmitConstructor(Type *ctor, vector<llvm::Value*> &av);
+    llvm::Constant *EvalConstant();
+    int GetCost();
+    bool HasSideEffects();
+    bool IsUnsigned();
+    bool IsInline(); // built-in function or type constructor
 };
 
 class ActualsError : public Call
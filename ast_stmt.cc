@@ -7,6 +7,7 @@
 #include "ast_decl.h"
 #include "ast_expr.h"
 #include "symtable.h"
+#include "errors.h"
 
 #include "irgen.h"
 #include "llvm/Bitcode/ReaderWriter.h"
@@ -29,6 +30,7 @@ llvm::Value *Program::Emit() {
     for(int i = 0; i < decls->NumElements(); i++) {
         decls->Nth(i)->Emit();
     }
+    irgen->FinishModule();
     llvm::WriteBitcodeToFile(module, llvm::outs());
     return NULL;
 }
@@ -38,107 +40,72 @@ llvm::Value *ForStmt::Emit() {
     symtab->Push(&s);
     symtab->global = false;
 
-    llvm::Function *f = irgen->GetFunction();
-    llvm::LLVMContext *context = irgen->GetContext();
-
-    llvm::BasicBlock *cb = irgen->GetBasicBlock();
-    llvm::BasicBlock *fb = llvm::BasicBlock::Create(*context, "footer", f);
-    llvm::BasicBlock *sb = llvm::BasicBlock::Create(*context, "step", f);
-    llvm::BasicBlock *db = llvm::BasicBlock::Create(*context, "body", f);
-    llvm::BasicBlock *hb = llvm::BasicBlock::Create(*context, "header", f);
-
     init->Emit();
-    llvm::BranchInst::Create(hb, cb);
-    hb->moveAfter(cb);
-    irgen->SetBasicBlock(hb);
-
-    llvm::Value *testVal = test->Emit();
-    llvm::BranchInst::Create(db, fb, testVal, hb);
-    irgen->SetBasicBlock(db);
-
-    irgen->fbs->push(fb);
-    irgen->cbs->push(sb);
-    irgen->lbs->push(fb);
-
-    body->Emit();
-    if(db->getTerminator() == NULL)
-        llvm::BranchInst::Create(sb, db);
-    sb->moveAfter(db);
-    irgen->SetBasicBlock(sb);
-    step->Emit();
-    llvm::BranchInst::Create(hb, sb);
-    fb->moveAfter(sb);
-
-    if(pred_begin(fb) == pred_end(fb))
-        new llvm::UnreachableInst(*context, fb);
-    else {
-        irgen->SetBasicBlock(fb);
-        llvm::BasicBlock *tfb = irgen->fbs->top();
-        if(irgen->fbs->size() != 0) {
-            if(fb != tfb) {
-                irgen->fbs->pop();
-                if(tfb->getTerminator() == NULL)
-                    llvm::BranchInst::Create(sb, tfb);
-            }
-        }
-    }
-
-    irgen->fbs->pop();
-    irgen->cbs->pop();
-    irgen->lbs->pop();
+    EmitLoop(step, GetTripCount());
 
     symtab->Pop();
     return NULL;
 }
 
+int ForStmt::GetTripCount() {
+    AssignExpr *a = dynamic_cast<AssignExpr*>(init);
+    CompoundExpr *t = dynamic_cast<CompoundExpr*>(test);
+    CompoundExpr *s = dynamic_cast<CompoundExpr*>(step);
+    if(a == NULL || t == NULL || s == NULL || !a->GetOp()->IsOp("=") || t->GetLeft() == NULL)
+        return -1;
+
+    // the same variable must be set, tested and stepped
+    VarExpr *iv = dynamic_cast<VarExpr*>(a->GetLeft());
+    VarExpr *tv = dynamic_cast<VarExpr*>(t->GetLeft());
+    VarExpr *sv = dynamic_cast<VarExpr*>(s->GetLeft() ? s->GetLeft() : s->GetRight());
+    if(iv == NULL || tv == NULL || sv == NULL)
+        return -1;
+    const char *name = iv->GetIdentifier()->GetName();
+    if(strcmp(name, tv->GetIdentifier()->GetName()) || strcmp(name, sv->GetIdentifier()->GetName()))
+        return -1;
+    // nor may the body change it
+    if(FnDecl::WritesVariable(body, iv))
+        return -1;
+
+    llvm::ConstantInt *start = llvm::dyn_cast_or_null<llvm::ConstantInt>(a->GetRight()->EvalConstant());
+    llvm::ConstantInt *bound = llvm::dyn_cast_or_null<llvm::ConstantInt>(t->GetRight()->EvalConstant());
+    if(start == NULL || bound == NULL)
+        return -1;
+
+    int64_t inc = 0;
+    Operator *op = s->GetOp();
+    if(op->IsOp("++"))
+        inc = 1;
+    else if(op->IsOp("--"))
+        inc = -1;
+    else if(op->IsOp("+=") || op->IsOp("-=")) {
+        llvm::ConstantInt *c = llvm::dyn_cast_or_null<llvm::ConstantInt>(s->GetRight()->EvalConstant());
+        if(c == NULL)
+            return -1;
+        inc = op->IsOp("+=") ? c->getSExtValue() : -c->getSExtValue();
+    }
+    if(inc == 0)
+        return -1;
+
+    Operator *rel = t->GetOp();
+    if(!rel->IsOp("<") && !rel->IsOp("<=") && !rel->IsOp(">") && !rel->IsOp(">=") && !rel->IsOp("!="))
+        return -1;
+    int64_t i = start->getSExtValue(), end = bound->getSExtValue();
+    for(int trips = 0; trips <= FullUnrollLimit; trips++, i += inc) {
+        bool more = rel->IsOp("<") ? i < end : rel->IsOp("<=") ? i <= end :
+                    rel->IsOp(">") ? i > end : rel->IsOp(">=") ? i >= end : i != end;
+        if(!more)
+            return trips;
+    }
+    return -1;
+}
+
 llvm::Value *WhileStmt::Emit() {
     scope s;
     symtab->Push(&s);
     symtab->global = false;
 
-    llvm::Function *f = irgen->GetFunction();
-    llvm::LLVMContext *context = irgen->GetContext();
-
-    llvm::BasicBlock *cb = irgen->GetBasicBlock();
-    llvm::BasicBlock *hb = llvm::BasicBlock::Create(*context, "header", f);
-    llvm::BasicBlock *fb = llvm::BasicBlock::Create(*context, "footer", f);
-    llvm::BasicBlock *db = llvm::BasicBlock::Create(*context, "body", f);
-
-    irgen->fbs->push(fb);
-    irgen->cbs->push(hb);
-    irgen->lbs->push(fb);
-
-    llvm::BranchInst::Create(hb, cb);
-    hb->moveAfter(cb);
-    irgen->SetBasicBlock(hb);
-
-    llvm::Value *testVal = test->Emit();
-    llvm::BranchInst::Create(db, fb, testVal, hb);
-    irgen->SetBasicBlock(db);
-
-    body->Emit();
-    if(db->getTerminator() == NULL)
-        llvm::BranchInst::Create(hb, db);
-
-    fb->moveAfter(db);
-
-    if(pred_begin(fb) == pred_end(fb))
-        new llvm::UnreachableInst(*context, fb);
-    else {
-        irgen->SetBasicBlock(fb);
-        llvm::BasicBlock* tfb = irgen->fbs->top();
-        if(irgen->fbs->size() != 0) {
-            if(fb != tfb) {
-                irgen->fbs->pop();
-                if(tfb->getTerminator() == NULL)
-                    llvm::BranchInst::Create(hb, tfb);
-            }
-        }
-    }
-
-    irgen->fbs->pop();
-    irgen->cbs->pop();
-    irgen->lbs->pop();
+    EmitLoop(NULL, -1);
 
     symtab->Pop();
     return NULL;
@@ -149,56 +116,224 @@ llvm::Value *IfStmt::Emit() {
     symtab->Push(&s);
     symtab->global = false;
 
-    llvm::Function *f = irgen->GetFunction();
-    llvm::LLVMContext *context = irgen->GetContext();
     llvm::Value *testVal = test->Emit();
+    if(irgen->InLanes()) {
+        EmitMasked(testVal);
+        symtab->Pop();
+        return NULL;
+    }
+    llvm::BasicBlock *tb = irgen->CreateBlock("then");
+    llvm::BasicBlock *eb = elseBody ? irgen->CreateBlock("else") : NULL;
+    llvm::BasicBlock *fb = irgen->CreateBlock("footer");
+    irgen->EmitProfiledBranch(testVal, tb, eb ? eb : fb, "if", test->GetLine());
 
-    llvm::BasicBlock *cb = irgen->GetBasicBlock();
-    llvm::BasicBlock *fb = llvm::BasicBlock::Create(*context, "footer", f);
-    irgen->fbs->push(fb);
-    llvm::BasicBlock *eb = llvm::BasicBlock::Create(*context, "else", f);
-    llvm::BasicBlock *tb = llvm::BasicBlock::Create(*context, "then", f);
+    irgen->EmitBlock(tb);
+    if(irgen->IsReachable())
+        body->Emit();
+
+    if(elseBody != NULL) {
+        irgen->EmitBranch(fb);
+        irgen->EmitBlock(eb);
+        if(irgen->IsReachable())
+            elseBody->Emit();
+    }
 
-    llvm::BranchInst::Create(tb, elseBody ? eb:fb, testVal, cb);
-    tb->moveAfter(cb);
-    irgen->SetBasicBlock(tb);
-    body->Emit();
-    eb->moveAfter(tb);
+    irgen->EmitBlock(fb);
+    symtab->Pop();
+    return NULL;
+}
 
-    if(tb->getTerminator() == NULL)
-        llvm::BranchInst::Create(fb, tb);
+// In a lane variant each arm runs under the mask narrowed by the test, and
+// is skipped when that leaves no invocation. The invocations rejoin after
+// it, but for those that left by break, continue or return.
+void IfStmt::EmitMasked(llvm::Value *testVal) {
+    llvm::Value *saved = irgen->GetLaneMask();
+    llvm::Value *taken = irgen->CreateMaskAnd(saved, testVal);
+    llvm::Value *skipped = irgen->CreateMaskAnd(saved, irgen->CreateNot(testVal));
+    llvm::BasicBlock *tb = irgen->CreateBlock("then");
+    llvm::BasicBlock *nb = irgen->CreateBlock(elseBody ? "else.test" : "footer");
+    irgen->SetLaneMask(taken);
+    irgen->EmitCondBranch(taken, tb, nb);
+
+    irgen->EmitBlock(tb);
+    if(irgen->IsReachable())
+        body->Emit();
+    irgen->EmitBlock(nb);
+    llvm::Value *thenOut = irgen->GetLaneMask();
+    llvm::Value *elseOut = skipped;
 
     if(elseBody != NULL) {
-        irgen->SetBasicBlock(eb);
-        elseBody->Emit();
+        llvm::BasicBlock *eb = irgen->CreateBlock("else");
+        llvm::BasicBlock *fb = irgen->CreateBlock("footer");
+        irgen->SetLaneMask(skipped);
+        irgen->EmitCondBranch(skipped, eb, fb);
+        irgen->EmitBlock(eb);
+        if(irgen->IsReachable())
+            elseBody->Emit();
+        irgen->EmitBlock(fb);
+        elseOut = irgen->GetLaneMask();
     }
+    if(thenOut == taken && elseOut == skipped)
+        irgen->SetLaneMask(saved);
+    else
+        irgen->SetLaneMask(irgen->CreateMaskOr(thenOut, elseOut));
+}
 
-    fb->moveAfter(eb);
+int IfStmt::GetCost() {
+    return test->GetCost() + body->GetCost() + (elseBody ? elseBody->GetCost() : 0) + 1;
+}
 
-    if(pred_begin(eb) == pred_end(eb))
-        new llvm::UnreachableInst(*context, eb);
-    else if (eb->getTerminator() == NULL && elseBody != NULL)
-        llvm::BranchInst::Create(fb, eb);
+// Smallest switch worth turning into a constant table, and the largest
+// table we are willing to emit for one.
+static const int MinTableCases = 4;
+static const int MaxTableSize = 4096;
 
-    if(pred_begin(fb) == pred_end(fb)) {
-        new llvm::UnreachableInst(*context, fb);
+// "case 1: case 2: s;" parses as Case(1, Case(2, s)), so the labels of an
+// arm are the chain of labels down to its first statement.
+void SwitchStmt::GroupArms(vector<SwitchArm> &arms) {
+    for(int i = 0; i < cases->NumElements(); i++) {
+        Stmt *s = cases->Nth(i);
+        SwitchLabel *l = dynamic_cast<SwitchLabel*>(s);
+        if(l == NULL) {
+            if(!arms.empty())
+                arms.back().body.push_back(s);
+            continue;
+        }
+        SwitchArm arm;
+        arm.isDefault = false;
+        for(; l != NULL; l = dynamic_cast<SwitchLabel*>(s)) {
+            if(l->GetLabel() == NULL)
+                arm.isDefault = true;
+            else
+                arm.labels.push_back(l->GetLabel());
+            s = l->GetStmt();
+        }
+        arm.body.push_back(s);
+        arms.push_back(arm);
     }
-    else {
-        irgen->SetBasicBlock(fb);
-        llvm::BasicBlock *tfb = irgen->fbs->top();
-        if(irgen->fbs->size() != 0) {
-            if(fb != tfb) {
-                irgen->fbs->pop();
-                if(tfb->getTerminator() == NULL)
-                    llvm::BranchInst::Create(fb, tfb);
-                if(irgen->fbs->size() == 1)
-                    irgen->fbs->pop();
-            }
+}
+
+// Expands declaration-free blocks so an arm's body can be matched as a
+// flat statement sequence.
+static void FlattenBody(vector<Stmt*> &in, vector<Stmt*> &out) {
+    for(size_t i = 0; i < in.size(); i++) {
+        StmtBlock *b = dynamic_cast<StmtBlock*>(in[i]);
+        if(b == NULL || b->GetDecls()->NumElements() != 0) {
+            out.push_back(in[i]);
+            continue;
         }
+        vector<Stmt*> inner;
+        for(int j = 0; j < b->GetStmts()->NumElements(); j++)
+            inner.push_back(b->GetStmts()->Nth(j));
+        FlattenBody(inner, out);
     }
+}
 
-    symtab->Pop();
-    return NULL;
+// Matches an arm of the form "x = <constant>; break;" and returns the
+// constant, storing the assigned variable's name in target. The last arm
+// may omit the break since it falls out of the switch anyway.
+static llvm::Constant *ArmValue(SwitchArm &arm, bool last, const char **target) {
+    vector<Stmt*> body;
+    FlattenBody(arm.body, body);
+    if(body.size() == 2 && dynamic_cast<BreakStmt*>(body[1]) != NULL)
+        body.pop_back();
+    else if(!last)
+        return NULL;
+    if(body.size() != 1)
+        return NULL;
+    AssignExpr *a = dynamic_cast<AssignExpr*>(body[0]);
+    if(a == NULL || !a->GetOp()->IsOp("="))
+        return NULL;
+    VarExpr *v = dynamic_cast<VarExpr*>(a->GetLeft());
+    if(v == NULL)
+        return NULL;
+    *target = v->GetIdentifier()->GetName();
+    return a->GetRight()->EvalConstant();
+}
+
+bool SwitchStmt::EmitLookupTable(llvm::Value *e, vector<SwitchArm> &arms) {
+    int numCases = 0;
+    const char *target = NULL;
+    llvm::Constant *dfltVal = NULL;
+    vector<int64_t> keys;
+    vector<llvm::Constant*> vals;
+
+    for(size_t i = 0; i < arms.size(); i++) {
+        const char *name = NULL;
+        llvm::Constant *c = ArmValue(arms[i], i + 1 == arms.size(), &name);
+        if(c == NULL || (target != NULL && strcmp(target, name) != 0))
+            return false;
+        if(!vals.empty() && c->getType() != vals[0]->getType())
+            return false;
+        target = name;
+        if(arms[i].isDefault)
+            dfltVal = c;
+        for(size_t j = 0; j < arms[i].labels.size(); j++) {
+            llvm::ConstantInt *k = llvm::dyn_cast_or_null<llvm::ConstantInt>(arms[i].labels[j]->EvalConstant());
+            if(k == NULL || k->getType() != e->getType())
+                return false;
+            keys.push_back(k->getSExtValue());
+            vals.push_back(c);
+            numCases++;
+        }
+    }
+    if(numCases < MinTableCases)
+        return false;
+
+    int64_t lo = keys[0], hi = keys[0];
+    for(size_t i = 1; i < keys.size(); i++) {
+        lo = keys[i] < lo ? keys[i] : lo;
+        hi = keys[i] > hi ? keys[i] : hi;
+    }
+    int64_t size = hi - lo + 1;
+    if(size > MaxTableSize || size > 2 * numCases)
+        return false;
+    // Without a default, values outside the cases leave the target as it
+    // was; that is only expressible as a table when there are no holes.
+    if(dfltVal == NULL && size != numCases)
+        return false;
+
+    llvm::Value *addr = symtab->LookUpValue(target);
+    llvm::Type *ty = vals[0]->getType();
+    if(addr == NULL || llvm::cast<llvm::PointerType>(addr->getType())->getElementType() != ty)
+        return false;
+    if(dfltVal != NULL && dfltVal->getType() != ty)
+        return false;
+
+    // Later duplicate labels are unreachable, so the first one wins.
+    vector<llvm::Constant*> elems(size, (llvm::Constant*)NULL);
+    for(size_t i = 0; i < keys.size(); i++) {
+        if(elems[keys[i] - lo] == NULL)
+            elems[keys[i] - lo] = vals[i];
+    }
+    for(int64_t i = 0; i < size; i++) {
+        if(elems[i] == NULL)
+            elems[i] = dfltVal;
+    }
+
+    llvm::BasicBlock *bb = irgen->GetBasicBlock();
+    llvm::ArrayType *tableTy = llvm::ArrayType::get(ty, size);
+    llvm::GlobalVariable *table = new llvm::GlobalVariable(*irgen->GetOrCreateModule("glsl.bc"), tableTy, true, llvm::GlobalValue::InternalLinkage, llvm::ConstantArray::get(tableTy, elems), "switch.table");
+
+    llvm::Value *idx = llvm::BinaryOperator::CreateSub(e, llvm::ConstantInt::get(e->getType(), lo), "", bb);
+    llvm::Value *inRange = new llvm::ICmpInst(*bb, llvm::CmpInst::ICMP_ULT, idx, llvm::ConstantInt::get(e->getType(), size));
+    llvm::Value *safe = llvm::SelectInst::Create(inRange, idx, llvm::ConstantInt::get(e->getType(), 0), "", bb);
+    vector<llvm::Value*> idxs;
+    idxs.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
+    idxs.push_back(safe);
+    llvm::Value *ptr = llvm::GetElementPtrInst::Create(table, idxs, "", bb);
+    llvm::Value *val = new llvm::LoadInst(ptr, "", bb);
+    llvm::Value *other = dfltVal != NULL ? dfltVal : irgen->CreateLoad(addr);
+    val = llvm::SelectInst::Create(inRange, val, other, "", bb);
+    irgen->CreateStore(val, addr);
+    return true;
+}
+
+int SwitchStmt::GetCost() {
+    int cost = expr->GetCost() + 1;
+    for(int i = 0; i < cases->NumElements(); i++)
+        cost += cases->Nth(i)->GetCost();
+    return cost;
 }
 
 llvm::Value *SwitchStmt::Emit() {
@@ -206,139 +341,166 @@ llvm::Value *SwitchStmt::Emit() {
     symtab->Push(&s);
     symtab->global = false;
 
-    llvm::Function *f = irgen->GetFunction();
-    llvm::LLVMContext *context = irgen->GetContext();
     llvm::Value *e = expr->Emit();
 
-    llvm::BasicBlock *dflt = llvm::BasicBlock::Create(*context, "default", f);
-    List<llvm::BasicBlock*> *bbList = new List<llvm::BasicBlock*>;
+    vector<SwitchArm> arms;
+    GroupArms(arms);
 
-    for(int i = 0; i < cases->NumElements(); i++) {
-        if(dynamic_cast<Default*>(cases->Nth(i)) != NULL)
-            bbList->Append(dflt);
-        else if(dynamic_cast<Case*>(cases->Nth(i)) != NULL) {
-            llvm::BasicBlock* cs = llvm::BasicBlock::Create(*context, "case", f);
-            bbList->Append(cs);
-        }
+    if(EmitLookupTable(e, arms)) {
+        symtab->Pop();
+        return NULL;
+    }
+    if(irgen->InLanes()) {
+        EmitMasked(e, arms);
+        symtab->Pop();
+        return NULL;
     }
 
-    llvm::BasicBlock* fb = llvm::BasicBlock::Create(*context, "footer", f);
-    irgen->fbs->push(fb);
-    irgen->lbs->push(fb);
-
-    llvm::SwitchInst *sw = llvm::SwitchInst::Create(e, fb, cases->NumElements(), irgen->GetBasicBlock());
-    Stmt* stmt = NULL;
-    int count = 0;
-    for(int i = 0; i < cases->NumElements(); i++) {
-        llvm::BasicBlock* cb = NULL;
-        if(count < bbList->NumElements()) {
-            cb = bbList->Nth(count);
-            irgen->SetBasicBlock(cb);
-        }
-        
-        Stmt *s = cases->Nth(i);
-
-        if(dynamic_cast<Case*>(s) != NULL) {
-            Case *c;
-            c = dynamic_cast<Case*>(s);
-            llvm::Value *label = c->GetLabel()->Emit();
-            if(cb != NULL)
-                sw->addCase(llvm::cast<llvm::ConstantInt>(label), cb);
-            scope s;
-            symtab->Push(&s);
-            c->Emit();
-
-            for(int j = i; j < cases->NumElements(); j++) {
-                if(j + 1 < cases->NumElements()) {
-                    if(dynamic_cast<Case*>(cases->Nth(j + 1)) == NULL && dynamic_cast<Default*>(cases->Nth(j + 1)) == NULL) {
-                        stmt = cases->Nth(j+1);
-                        if(stmt != NULL)
-                            stmt->Emit();
-                    }
-                    else
-                        j = cases->NumElements();
-                }
-            }
-            symtab->Pop();
-            count++;
-        }
-        else if(dynamic_cast<Default*>(cases->Nth(i)) != NULL) {
-            sw->setDefaultDest(dflt);
-            scope s;
-            symtab->Push(&s);
-            cases->Nth(i)->Emit();
-            for(int j = i; j < cases->NumElements(); j++) {
-                if(j + 1 < cases->NumElements()) {
-                    if(dynamic_cast<Case*>(cases->Nth(j + 1)) == NULL && dynamic_cast<Default*>(cases->Nth(j + 1)) == NULL) {
-                        stmt = cases->Nth(j+1);
-                        if(stmt != NULL)
-                            stmt->Emit();
-                    }
-                    else
-                        j = cases->NumElements();
-                }
+    llvm::BasicBlock *fb = irgen->CreateBlock("footer");
+    vector<llvm::BasicBlock*> blocks;
+    for(size_t i = 0; i < arms.size(); i++)
+        blocks.push_back(irgen->CreateBlock(arms[i].isDefault ? "default" : "case"));
+
+    llvm::BasicBlock *dflt = fb;
+    vector<pair<llvm::ConstantInt*, llvm::BasicBlock*> > labels;
+    for(size_t i = 0; i < arms.size(); i++) {
+        if(arms[i].isDefault)
+            dflt = blocks[i];
+        for(size_t j = 0; j < arms[i].labels.size(); j++) {
+            Expr *label = arms[i].labels[j];
+            llvm::ConstantInt *ki = llvm::dyn_cast_or_null<llvm::ConstantInt>(label->EvalConstant());
+            if(ki == NULL) {
+                ReportError::Formatted(label->GetLocation(), "case label must be an integer constant expression");
+                continue;
             }
-            symtab->Pop();
-            count++;
-        }
-
-        if(cb != NULL) {
-            if(cb->getTerminator() == NULL && dynamic_cast<Case*>(cases->Nth(i)) != NULL)
-                llvm::BranchInst::Create(bbList->Nth(count), cb);
+            if(ki->getType() != e->getType())
+                ki = llvm::cast<llvm::ConstantInt>(llvm::ConstantExpr::getIntegerCast(ki, e->getType(), true));
+            // A repeated label can never be reached; LLVM rejects duplicates.
+            bool repeated = false;
+            for(size_t k = 0; k < labels.size() && !repeated; k++)
+                repeated = labels[k].first == ki;
+            if(!repeated)
+                labels.push_back(make_pair(ki, blocks[i]));
         }
     }
+    irgen->EmitSwitch(e, dflt, labels, expr->GetLine());
+
+    // each arm falls through into the next one unless it breaks
+    irgen->PushJumpFrame(fb, NULL);
+    for(size_t i = 0; i < arms.size(); i++) {
+        irgen->EmitBlock(blocks[i]);
+        scope as;
+        symtab->Push(&as);
+        for(size_t j = 0; j < arms[i].body.size() && irgen->IsReachable(); j++)
+            arms[i].body[j]->Emit();
+        symtab->Pop();
+    }
+    irgen->PopJumpFrame();
 
-    if(pred_begin(dflt) == pred_end(dflt))
-        new llvm::UnreachableInst(*context, dflt);
-    else if(succ_begin(dflt) == succ_end(dflt))
-        llvm::BranchInst::Create(fb, dflt);
+    irgen->EmitBlock(fb);
+    symtab->Pop();
+    return NULL;
+}
 
-    if(pred_begin(fb) == pred_end(fb))
-        new llvm::UnreachableInst(*context, fb);
-    else {
-        irgen->SetBasicBlock(fb);
-        if(irgen->fbs->size() != 0) {
-            llvm::BasicBlock* tfb = irgen->fbs->top();
-            if(tfb != fb && tfb != NULL) {
-                irgen->fbs->pop();
-                if(tfb->getTerminator() == NULL)
-                    llvm::BranchInst::Create(fb, tfb);
-                if(irgen->fbs->size() == 1)
-                    irgen->fbs->pop();
-            }
+/* In a lane variant an arm runs for the invocations its labels match, and
+ * those that fall into it from the arm before; default takes the ones no
+ * label matches, and a repeated label belongs to its first arm. An arm is
+ * skipped when it has none. The invocations rejoin after the switch, but
+ * for those that continued or returned.
+ */
+void SwitchStmt::EmitMasked(llvm::Value *e, vector<SwitchArm> &arms) {
+    llvm::Value *saved = irgen->GetLaneMask();
+    llvm::Value *none = llvm::ConstantInt::getFalse(*irgen->GetContext());
+    llvm::Value *any = none;
+    vector<llvm::Value*> matched(arms.size(), none);
+    for(size_t i = 0; i < arms.size(); i++) {
+        for(size_t j = 0; j < arms[i].labels.size(); j++) {
+            llvm::ConstantInt *ki = llvm::dyn_cast_or_null<llvm::ConstantInt>(arms[i].labels[j]->EvalConstant());
+            if(ki == NULL)
+                continue;
+            if(ki->getType() != e->getType())
+                ki = llvm::cast<llvm::ConstantInt>(llvm::ConstantExpr::getIntegerCast(ki, e->getType(), true));
+            llvm::Value *hit = irgen->CreateCompare(llvm::CmpInst::ICMP_EQ, e, ki);
+            matched[i] = irgen->CreateMaskOr(matched[i], irgen->CreateMaskAnd(hit, irgen->CreateNot(any)));
+            any = irgen->CreateMaskOr(any, hit);
         }
     }
 
-    irgen->lbs->pop();
-    symtab->Pop();
-    return NULL;
+    irgen->SetLaneMask(none);
+    for(size_t i = 0; i < arms.size(); i++) {
+        llvm::Value *hits = matched[i];
+        if(arms[i].isDefault)
+            hits = irgen->CreateMaskOr(hits, irgen->CreateNot(any));
+        irgen->SetLaneMask(irgen->CreateMaskOr(irgen->GetLaneMask(), irgen->CreateMaskAnd(saved, hits)));
+        llvm::BasicBlock *ab = irgen->CreateBlock(arms[i].isDefault ? "default" : "case");
+        llvm::BasicBlock *nb = irgen->CreateBlock("case.end");
+        irgen->EmitCondBranch(irgen->GetLaneMask(), ab, nb);
+        irgen->EmitBlock(ab);
+        scope as;
+        symtab->Push(&as);
+        for(size_t j = 0; j < arms[i].body.size() && irgen->IsReachable() && !irgen->IsMaskClear(); j++)
+            arms[i].body[j]->Emit();
+        symtab->Pop();
+        irgen->EmitBlock(nb);
+    }
+
+    llvm::Value *rejoined = irgen->CreateMaskAnd(saved, irgen->GetLiveMask());
+    if(llvm::Value *continued = irgen->GetContinueMask())
+        rejoined = irgen->CreateMaskAnd(rejoined, irgen->CreateNot(irgen->ReadMask(continued)));
+    irgen->SetLaneMask(rejoined);
 }
 
 llvm::Value *StmtBlock::Emit() {
-    llvm::Value *v = NULL;
     for(int i = 0; i < decls->NumElements(); i++) {
         decls->Nth(i)->Emit();
     }
-    for(int i = 0; i < stmts->NumElements(); i++) {
+    // nothing after a return, break or continue can execute (in a lane
+    // variant, once they leave no invocation under the mask)
+    for(int i = 0; i < stmts->NumElements() && irgen->IsReachable() && !irgen->IsMaskClear(); i++) {
         stmts->Nth(i)->Emit();
     }
     return NULL;
 }
 
+int StmtBlock::GetCost() {
+    int cost = decls->NumElements();
+    for(int i = 0; i < stmts->NumElements(); i++)
+        cost += stmts->Nth(i)->GetCost();
+    return cost;
+}
+
+int DeclStmt::GetCost() {
+    return 1;
+}
+
 llvm::Value *DeclStmt::Emit() {
     llvm::Value* val = decl->Emit();
     return val;
 }
 
 llvm::Value *BreakStmt::Emit() {
-    llvm::BasicBlock *cb = irgen->GetBasicBlock();
-    llvm::BranchInst::Create(irgen->lbs->top(), cb);
+    if(irgen->InLanes()) {
+        irgen->EmitLaneBreak();
+        return NULL;
+    }
+    if(irgen->GetBreakTarget() == NULL) {
+        ReportError::BreakOutsideLoop(this);
+        return NULL;
+    }
+    irgen->EmitBranch(irgen->GetBreakTarget());
     return NULL;
 }
 
 llvm::Value *ContinueStmt::Emit() {
-    llvm::BasicBlock *cb = irgen->GetBasicBlock();
-    llvm::BranchInst::Create(irgen->cbs->top(), cb); 
+    if(irgen->InLanes()) {
+        irgen->EmitLaneContinue();
+        return NULL;
+    }
+    if(irgen->GetContinueTarget() == NULL) {
+        ReportError::ContinueOutsideLoop(this);
+        return NULL;
+    }
+    irgen->EmitBranch(irgen->GetContinueTarget());
     return NULL;
 }
 
@@ -350,30 +512,191 @@ llvm::Value *LoopStmt::Emit() {
     return NULL;
 }
 
+// Loops are emitted rotated: the test guards entry and is repeated after
+// the body and step, so a trip takes a single conditional branch. With
+// "#pragma unroll N" the rotated body holds N copies, each leaving on its
+// own test. A fully unrolled loop has a trip count the body cannot change,
+// so it is exactly that many trips in a row, with no tests and no loop.
+void LoopStmt::EmitLoop(Expr *step, int tripCount) {
+    int cost = body->GetCost() + test->GetCost() + (step ? step->GetCost() : 0);
+    bool full = tripCount >= 0 && (unroll == FullUnroll ? tripCount <= FullUnrollLimit :
+                                   unroll == 0 && tripCount * cost <= UnrollBudget);
+    int copies = unroll > 1 ? unroll : 1;
+    if(irgen->InLanes()) {
+        EmitMaskedLoop(step, full ? tripCount : -1, copies);
+        return;
+    }
+
+    llvm::BasicBlock *fb = irgen->CreateBlock("footer");
+
+    if(full) {
+        for(int i = 0; i < tripCount && irgen->IsReachable(); i++)
+            EmitTrip(step, fb);
+        if(irgen->IsReachable())
+            irgen->EmitBranch(fb);
+        irgen->EmitBlock(fb);
+        return;
+    }
+
+    llvm::BasicBlock *hb = irgen->CreateBlock("body");
+    llvm::BranchInst *latch = NULL;
+    if(irgen->IsReachable())
+        irgen->EmitProfiledBranch(test->Emit(), hb, fb, "loop", test->GetLine());
+    irgen->EmitBlock(hb, false);
+    if(irgen->IsReachable()) {
+        for(int i = 0; i < copies; i++) {
+            EmitTrip(step, fb);
+            llvm::Value *t = irgen->IsReachable() ? test->Emit() : NULL;
+            if(i + 1 < copies) {
+                llvm::BasicBlock *nb = irgen->CreateBlock("body");
+                irgen->EmitProfiledBranch(t, nb, fb, "loop", test->GetLine());
+                irgen->EmitBlock(nb);
+            }
+            else
+                latch = irgen->EmitProfiledBranch(t, hb, fb, "loop", test->GetLine());
+        }
+        irgen->SealBlock(hb);
+    }
+    SetHints(latch, full);
+    irgen->EmitBlock(fb);
+}
+
+void LoopStmt::SetHints(llvm::BranchInst *latch, bool full) {
+    if(latch == NULL)
+        return;
+    vector<pair<const char*, int> > hints;
+    if(unroll > 0)
+        hints.push_back(make_pair("llvm.loop.unroll.disable", 1));
+    else if(unroll == FullUnroll && !full)
+        hints.push_back(make_pair("llvm.loop.unroll.full", 1));
+    if(vectorize != 0)
+        hints.push_back(make_pair("llvm.vectorizer.enable", 1));
+    if(vectorize > 0)
+        hints.push_back(make_pair("llvm.vectorizer.width", vectorize));
+    if(!hints.empty())
+        irgen->SetLoopHints(latch, hints);
+}
+
+/* In a lane variant the test narrows the mask instead of leaving, and the
+ * loop goes round while any invocation is left in it: the test before each
+ * back edge is whether the mask still has one. Those that failed the test
+ * or broke out rejoin after the loop, but for those that returned. A fully
+ * unrolled loop is left early once a trip has cleared the mask.
+ */
+void LoopStmt::EmitMaskedLoop(Expr *step, int trips, int copies) {
+    llvm::Value *entered = irgen->GetLaneMask();
+    llvm::Value *continued = irgen->CreateMaskVariable("continue");
+    llvm::BasicBlock *fb = irgen->CreateBlock("footer");
+
+    if(trips >= 0) {
+        for(int i = 0; i < trips && irgen->IsReachable(); i++) {
+            llvm::Value *before = irgen->GetLaneMask();
+            EmitMaskedTrip(step, continued);
+            if(i + 1 < trips && irgen->GetLaneMask() != before) {
+                llvm::BasicBlock *nb = irgen->CreateBlock("body");
+                irgen->EmitCondBranch(irgen->GetLaneMask(), nb, fb);
+                irgen->EmitBlock(nb);
+            }
+        }
+    }
+    else {
+        llvm::BasicBlock *hb = irgen->CreateBlock("body");
+        llvm::BranchInst *latch = NULL;
+        llvm::Value *t = test->Emit();
+        irgen->SetLaneMask(irgen->CreateMaskAnd(irgen->GetLaneMask(), t));
+        irgen->EmitCondBranch(irgen->GetLaneMask(), hb, fb);
+        irgen->EmitBlock(hb, false);
+        if(irgen->IsReachable()) {
+            for(int i = 0; i < copies; i++) {
+                EmitMaskedTrip(step, continued);
+                t = test->Emit();
+                irgen->SetLaneMask(irgen->CreateMaskAnd(irgen->GetLaneMask(), t));
+                if(i + 1 < copies) {
+                    llvm::BasicBlock *nb = irgen->CreateBlock("body");
+                    irgen->EmitCondBranch(irgen->GetLaneMask(), nb, fb);
+                    irgen->EmitBlock(nb);
+                }
+                else
+                    latch = irgen->EmitCondBranch(irgen->GetLaneMask(), hb, fb);
+            }
+            irgen->SealBlock(hb);
+        }
+        SetHints(latch, false);
+    }
+    irgen->EmitBlock(fb);
+    irgen->SetLaneMask(irgen->CreateMaskAnd(entered, irgen->GetLiveMask()));
+}
+
+// A trip of a masked loop; the invocations that continue are gathered in
+// continued and resume at the step
+void LoopStmt::EmitMaskedTrip(Expr *step, llvm::Value *continued) {
+    scope s;
+    symtab->Push(&s);
+    irgen->WriteMask(continued, llvm::ConstantInt::getFalse(*irgen->GetContext()));
+    irgen->PushLaneLoop(continued);
+    if(irgen->IsReachable())
+        body->Emit();
+    irgen->PopJumpFrame();
+    symtab->Pop();
+
+    irgen->SetLaneMask(irgen->CreateMaskOr(irgen->GetLaneMask(), irgen->ReadMask(continued)));
+    if(step != NULL)
+        step->Emit();
+}
+
+// One trip of the loop body followed by the step; continue lands on the
+// step, which shares the body's last block unless something jumps there.
+// Each copy of the body declares its locals in a scope of its own.
+void LoopStmt::EmitTrip(Expr *step, llvm::BasicBlock *exit) {
+    scope s;
+    symtab->Push(&s);
+    llvm::BasicBlock *sb = irgen->CreateBlock("step");
+    irgen->PushJumpFrame(exit, sb);
+    if(irgen->IsReachable())
+        body->Emit();
+    irgen->PopJumpFrame();
+    symtab->Pop();
+
+    if(pred_begin(sb) == pred_end(sb))
+        delete sb;
+    else
+        irgen->EmitBlock(sb);
+    if(irgen->IsReachable() && step != NULL)
+        step->Emit();
+}
+
 llvm::Value *Default::Emit() {
-    llvm::Function *f = irgen->GetFunction();
-    llvm::LLVMContext *context = irgen->GetContext();
     stmt->Emit();
     return NULL;
 }
 
 llvm::Value *Case::Emit() {
-    llvm::Function *f = irgen->GetFunction();
-    llvm::LLVMContext *context = irgen->GetContext();
     stmt->Emit();
     return NULL;
 }
 
+int ReturnStmt::GetCost() {
+    return expr ? expr->GetCost() + 1 : 1;
+}
+
 llvm::Value *ReturnStmt::Emit() {
-    llvm::BasicBlock *bb = irgen->GetBasicBlock();
     llvm::LLVMContext *context = irgen->GetContext();
+    if(irgen->InLanes()) {
+        irgen->EmitLaneReturn(expr ? expr->Emit() : NULL);
+        return NULL;
+    }
     if(expr != NULL) {
         llvm::Value *val = expr->Emit();
-        llvm::ReturnInst::Create(*context, val, bb);
+        irgen->EmitCopyOuts();
+        irgen->EmitProfExit();
+        llvm::ReturnInst::Create(*context, val, irgen->GetBasicBlock());
     }
     else {
-        llvm::ReturnInst::Create(*context,bb);
+        irgen->EmitCopyOuts();
+        irgen->EmitProfExit();
+        llvm::ReturnInst::Create(*context, irgen->GetBasicBlock());
     }
+    irgen->SetBasicBlock(NULL);
     return NULL;
 }
 
@@ -463,18 +786,15 @@ void SwitchLabel::PrintChildren(int indentLevel) {
     if (stmt)  stmt->Print(indentLevel+1);
 }
 
-SwitchStmt::SwitchStmt(Expr *e, List<Stmt *> *c, Default *d) {
+SwitchStmt::SwitchStmt(Expr *e, List<Stmt *> *c) {
     Assert(e != NULL && c != NULL && c->NumElements() != 0 );
     (expr=e)->SetParent(this);
     (cases=c)->SetParentAll(this);
-    def = d;
-    if (def) def->SetParent(this);
 }
 
 void SwitchStmt::PrintChildren(int indentLevel) {
     if (expr) expr->Print(indentLevel+1);
     if (cases) cases->PrintAll(indentLevel+1);
-    if (def) def->Print(indentLevel+1);
 }
 
 
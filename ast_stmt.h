@@ -15,6 +15,7 @@
 
 #include "list.h"
 #include "ast.h"
+#include <vector>
 
 using namespace std;
 
@@ -43,6 +44,8 @@ class Stmt : public Node
      Stmt() : Node() {}
      Stmt(yyltype loc) : Node(loc) {}
      virtual llvm::Value *Emit() { return NULL; };
+     // Rough number of instructions the statement emits
+     virtual int GetCost() { return 1; }
 };
 
 class StmtBlock : public Stmt 
@@ -56,6 +59,9 @@ class StmtBlock : public Stmt
     const char *GetPrintNameForNode() { return "StmtBlock"; }
     void PrintChildren(int indentLevel);
     llvm::Value *Emit();
+    int GetCost();
+    List<VarDecl*> *GetDecls() { return decls; }
+    List<Stmt*> *GetStmts() { return stmts; }
 };
 
 class DeclStmt: public Stmt 
@@ -66,8 +72,10 @@ class DeclStmt: public Stmt
   public:
     DeclStmt(Decl *d);
     const char *GetPrintNameForNode() { return "DeclStmt"; }
+    Decl *GetDecl() { return decl; }
     void PrintChildren(int indentLevel);
     llvm::Value *Emit();
+    int GetCost();
 
 };
   
@@ -86,10 +94,34 @@ class ConditionalStmt : public Stmt
 
 class LoopStmt : public ConditionalStmt 
 {
+  protected:
+    // #pragma hints: unroll is 0 without a hint, 1 to keep the loop
+    // rolled, N to emit N copies of the body per trip, or FullUnroll;
+    // vectorize is 0, or the requested width (-1 for any width)
+    int unroll, vectorize;
+
+    // Loops up to this many instructions after unrolling are fully
+    // unrolled without a hint; FullUnrollLimit caps a requested one.
+    static const int UnrollBudget = 128;
+    static const int FullUnrollLimit = 1024;
+
+    void EmitLoop(Expr *step, int tripCount);
+    void EmitTrip(Expr *step, llvm::BasicBlock *exit);
+    void SetHints(llvm::BranchInst *latch, bool full);
+    // In a lane variant (see irgen.h); trips is the number of trips when
+    // fully unrolled, or -1
+    void EmitMaskedLoop(Expr *step, int trips, int copies);
+    void EmitMaskedTrip(Expr *step, llvm::Value *continued);
+
   public:
+    static const int FullUnroll = -1;
+
     LoopStmt(Expr *testExpr, Stmt *body)
-            : ConditionalStmt(testExpr, body) {}
+            : ConditionalStmt(testExpr, body), unroll(0), vectorize(0) {}
     llvm::Value *Emit();
+    int GetCost() { return UnrollBudget; }
+    void SetUnroll(int count) { unroll = count > 0 ? count : FullUnroll; }
+    void SetVectorize(int width) { vectorize = width > 0 ? width : -1; }
 };
 
 class ForStmt : public LoopStmt 
@@ -102,6 +134,9 @@ class ForStmt : public LoopStmt
     const char *GetPrintNameForNode() { return "ForStmt"; }
     void PrintChildren(int indentLevel);
     llvm::Value *Emit();
+    // Iterations of for(i = a; i < b; i++) style loops with constant
+    // bounds and step, or -1 when not known at compile time
+    int GetTripCount();
 
 };
 
@@ -126,6 +161,8 @@ class IfStmt : public ConditionalStmt
     const char *GetPrintNameForNode() { return "IfStmt"; }
     void PrintChildren(int indentLevel);
     llvm::Value *Emit();
+    void EmitMasked(llvm::Value *testVal);
+    int GetCost();
 
 };
 
@@ -164,6 +201,7 @@ class ReturnStmt : public Stmt
     const char *GetPrintNameForNode() { return "ReturnStmt"; }
     void PrintChildren(int indentLevel);
     llvm::Value *Emit();
+    int GetCost();
 
 };
 
@@ -178,6 +216,9 @@ class SwitchLabel : public Stmt
     SwitchLabel(Expr *label, Stmt *stmt);
     SwitchLabel(Stmt *stmt);
     void PrintChildren(int indentLevel);
+    int GetCost() { return stmt->GetCost(); }
+    Expr *GetLabel() { return label; }
+    Stmt *GetStmt() { return stmt; }
 
 };
 
@@ -188,7 +229,6 @@ class Case : public SwitchLabel
     Case(Expr *label, Stmt *stmt) : SwitchLabel(label, stmt) {}
     const char *GetPrintNameForNode() { return "Case"; }
     llvm::Value *Emit();
-    Expr* GetLabel() { return label; }
 
 };
 
@@ -200,19 +240,34 @@ class Default : public SwitchLabel
     llvm::Value *Emit();
 };
 
+// The labels stacked in front of one statement ("case 1: case 2: s;"),
+// together with that statement and the ones that follow it up to the
+// next label, in source order.
+struct SwitchArm
+{
+    vector<Expr*> labels;
+    bool isDefault;
+    vector<Stmt*> body;
+};
+
 class SwitchStmt : public Stmt
 {
   protected:
     Expr *expr;
     List<Stmt*> *cases;
-    Default *def;
+
+    void GroupArms(vector<SwitchArm> &arms);
+    bool EmitLookupTable(llvm::Value *e, vector<SwitchArm> &arms);
+    void EmitMasked(llvm::Value *e, vector<SwitchArm> &arms);
 
   public:
-    SwitchStmt() : expr(NULL), cases(NULL), def(NULL) {}
-    SwitchStmt(Expr *expr, List<Stmt*> *cases, Default *def);
+    SwitchStmt() : expr(NULL), cases(NULL) {}
+    SwitchStmt(Expr *expr, List<Stmt*> *cases);
     virtual const char *GetPrintNameForNode() { return "SwitchStmt"; }
+    List<Stmt*> *GetCases() { return cases; }
     void PrintChildren(int indentLevel);
     llvm::Value *Emit();
+    int GetCost();
 
 };
 
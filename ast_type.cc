@@ -39,6 +39,7 @@ Type *Type::errorType  = new Type("error");
 
 TypeQualifier *TypeQualifier::inTypeQualifier  = new TypeQualifier("in");
 TypeQualifier *TypeQualifier::outTypeQualifier = new TypeQualifier("out");
+TypeQualifier *TypeQualifier::inoutTypeQualifier = new TypeQualifier("inout");
 TypeQualifier *TypeQualifier::constTypeQualifier = new TypeQualifier("const");
 TypeQualifier *TypeQualifier::uniformTypeQualifier = new TypeQualifier("uniform");
 
@@ -60,6 +61,19 @@ void TypeQualifier::PrintChildren(int indentLevel) {
     printf("%s", typeQualifierName);
 }
 
+Type *Type::LookUp(const char *name) {
+    Type *builtins[] = { intType, uintType, floatType, boolType,
+                         vec2Type, vec3Type, vec4Type,
+                         mat2Type, mat3Type, mat4Type,
+                         ivec2Type, ivec3Type, ivec4Type,
+                         bvec2Type, bvec3Type, bvec4Type,
+                         uvec2Type, uvec3Type, uvec4Type };
+    for (int i = 0; i < sizeof(builtins) / sizeof(builtins[0]); i++)
+        if (strcmp(builtins[i]->typeName, name) == 0)
+            return builtins[i];
+    return NULL;
+}
+
 bool Type::IsNumeric() { 
     return this->IsEquivalentTo(Type::intType) || this->IsEquivalentTo(Type::floatType);
 }
@@ -76,6 +90,13 @@ bool Type::IsMatrix() {
            this->IsEquivalentTo(Type::mat4Type);
 }
 
+bool Type::IsUnsigned() {
+    return this->IsEquivalentTo(Type::uintType) ||
+           this->IsEquivalentTo(Type::uvec2Type) ||
+           this->IsEquivalentTo(Type::uvec3Type) ||
+           this->IsEquivalentTo(Type::uvec4Type);
+}
+
 bool Type::IsError() { 
     return this->IsEquivalentTo(Type::errorType);
 }
@@ -24,7 +24,7 @@ class TypeQualifier : public Node
     char *typeQualifierName;
 
   public :
-    static TypeQualifier *inTypeQualifier, *outTypeQualifier, *constTypeQualifier, *uniformTypeQualifier;
+    static TypeQualifier *inTypeQualifier, *outTypeQualifier, *inoutTypeQualifier, *constTypeQualifier, *uniformTypeQualifier;
 
     TypeQualifier(yyltype loc) : Node(loc) {}
     TypeQualifier(const char *str);
@@ -52,6 +52,8 @@ class Type : public Node
     
     const char *GetPrintNameForNode() { return "Type"; }
     void PrintChildren(int indentLevel);
+    const char *GetName() { return typeName; }
+    static Type *LookUp(const char *name);
 
     virtual void PrintToStream(ostream& out) { out << typeName; }
     friend ostream& operator<<(ostream& out, Type *t) { t->PrintToStream(out); return out; }
@@ -60,6 +62,7 @@ class Type : public Node
     bool IsNumeric();
     bool IsVector();
     bool IsMatrix();
+    bool IsUnsigned();
     bool IsError();
 };
 
@@ -0,0 +1,243 @@
+/* File: columns.cc
+ * ----------------
+ * Implementation of column shapes and of mapping column files.
+ */
+
+#include "columns.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const char ColumnMagic[8] = "GLCCOL1";
+
+static size_t ScalarSize(int scalar) {
+    return scalar == BoolScalar ? 1 : 4;
+}
+
+static size_t AlignUp(size_t n, size_t align) {
+    return (n + align - 1) / align * align;
+}
+
+// A vector of lanes scalars occupies the next power of two of them
+static size_t VectorSize(int scalar, int lanes) {
+    size_t n = 1;
+    while(n < (size_t)lanes)
+        n *= 2;
+    return n * ScalarSize(scalar);
+}
+
+ColumnShape ColumnShape::Make(ScalarKind scalar, int lanes, int vectors) {
+    ColumnShape s;
+    s.scalar = scalar;
+    s.lanes = lanes;
+    s.vectors = vectors;
+    s.stride = VectorSize(scalar, lanes) * vectors;
+    return s;
+}
+
+bool ColumnShape::FromTypeName(const char *name, ColumnShape &shape) {
+    int n;
+    char rest;
+    if(!strcmp(name, "float"))
+        shape = Make(FloatScalar, 1, 1);
+    else if(!strcmp(name, "int"))
+        shape = Make(IntScalar, 1, 1);
+    else if(!strcmp(name, "bool"))
+        shape = Make(BoolScalar, 1, 1);
+    else if(sscanf(name, "vec%d%c", &n, &rest) == 1 && n >= 2 && n <= 4)
+        shape = Make(FloatScalar, n, 1);
+    else if(!strcmp(name, "uint"))
+        shape = Make(IntScalar, 1, 1);
+    else if((sscanf(name, "ivec%d%c", &n, &rest) == 1 || sscanf(name, "uvec%d%c", &n, &rest) == 1)
+            && n >= 2 && n <= 4)
+        shape = Make(IntScalar, n, 1);
+    else if(sscanf(name, "bvec%d%c", &n, &rest) == 1 && n >= 2 && n <= 4)
+        shape = Make(BoolScalar, n, 1);
+    else if(sscanf(name, "mat%d%c", &n, &rest) == 1 && n >= 2 && n <= 4)
+        shape = Make(FloatScalar, n, n);
+    else
+        return false;
+    return true;
+}
+
+size_t ColumnShape::Offset(int i) const {
+    return (i / lanes) * VectorSize(scalar, lanes) + (i % lanes) * ScalarSize(scalar);
+}
+
+void ColumnShape::Store(const double *vals, char *row) const {
+    for(int i = 0; i < NumScalars(); i++) {
+        char *dst = row + Offset(i);
+        if(scalar == FloatScalar)
+            *(float*)dst = (float)vals[i];
+        else if(scalar == IntScalar)
+            *(int32_t*)dst = (int32_t)(int64_t)vals[i];   // a uint above 2^31 wraps
+        else
+            *dst = vals[i] != 0;
+    }
+}
+
+void ColumnShape::Print(FILE *f, const char *row) const {
+    for(int i = 0; i < NumScalars(); i++) {
+        const char *src = row + Offset(i);
+        if(scalar == FloatScalar)
+            fprintf(f, " %e", *(const float*)src);
+        else if(scalar == IntScalar)
+            fprintf(f, " %d", *(const int32_t*)src);
+        else
+            fprintf(f, " %d", *src != 0);
+    }
+}
+
+bool ColumnShape::operator==(const ColumnShape &s) const {
+    return scalar == s.scalar && lanes == s.lanes && vectors == s.vectors && stride == s.stride;
+}
+
+const char ColumnStream::Magic[8] = "GLCSTM1";
+
+bool ColumnStream::WriteHeader(FILE *f, const char *entry, const vector<ColumnDesc> &cols) {
+    ColumnStreamHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, Magic, sizeof(Magic));
+    strncpy(h.entry, entry, sizeof(h.entry) - 1);
+    h.numColumns = cols.size();
+    return fwrite(&h, sizeof(h), 1, f) == 1
+           && (cols.empty() || fwrite(&cols[0], sizeof(ColumnDesc), cols.size(), f) == cols.size());
+}
+
+bool ColumnStream::ReadHeader(FILE *f, string &entry, uint32_t &numColumns, vector<ColumnDesc> &cols) {
+    ColumnStreamHeader h;
+    if(fread(&h, sizeof(h), 1, f) != 1 || memcmp(h.magic, Magic, sizeof(Magic)))
+        return false;
+    entry.assign(h.entry, strnlen(h.entry, sizeof(h.entry)));
+    numColumns = h.numColumns;
+    if(numColumns > MaxColumns)
+        return false;
+    cols.resize(numColumns);
+    return cols.empty() || fread(&cols[0], sizeof(ColumnDesc), cols.size(), f) == cols.size();
+}
+
+bool ColumnFile::ParseValues(const char *text, vector<double> &vals) {
+    char *end;
+    while(*text != '\0') {
+        if(strchr(" \t\r\n,", *text) != NULL) {
+            text++;
+            continue;
+        }
+        if(!strncmp(text, "true", 4) || !strncmp(text, "false", 5)) {
+            vals.push_back(*text == 't');
+            text += *text == 't' ? 4 : 5;
+            continue;
+        }
+        double v = strtod(text, &end);
+        if(end == text)
+            return false;
+        vals.push_back(v);
+        text = end;
+    }
+    return true;
+}
+
+ColumnFile::ColumnFile() : base(NULL), size(0) {}
+
+ColumnFile::~ColumnFile() {
+    if(base != NULL)
+        munmap(base, size);
+}
+
+const ColumnDesc &ColumnFile::GetDesc(int i) const {
+    return ((const ColumnDesc*)(base + sizeof(ColumnFileHeader)))[i];
+}
+
+int ColumnFile::Find(ColumnKind kind, const char *name) const {
+    for(int i = 0; i < NumColumns(); i++)
+        if(GetDesc(i).kind == (uint32_t)kind && !strncmp(GetDesc(i).name, name, sizeof(GetDesc(i).name)))
+            return i;
+    return -1;
+}
+
+// Every column must have a shape glc-exec knows and lie inside the file
+bool ColumnFile::Check() {
+    const ColumnFileHeader *h = GetHeader();
+    if(size < sizeof(ColumnFileHeader) || memcmp(h->magic, ColumnMagic, sizeof(ColumnMagic))) {
+        fprintf(stderr, "%s is not a column file\n", path.c_str());
+        return false;
+    }
+    if(sizeof(ColumnFileHeader) + (uint64_t)h->numColumns * sizeof(ColumnDesc) > size) {
+        fprintf(stderr, "%s is truncated\n", path.c_str());
+        return false;
+    }
+    for(int i = 0; i < NumColumns(); i++) {
+        const ColumnDesc &d = GetDesc(i);
+        if(d.shape.scalar > BoolScalar || d.shape.lanes < 1 || d.shape.lanes > 4 || d.shape.vectors < 1
+           || !(d.shape == ColumnShape::Make((ScalarKind)d.shape.scalar, d.shape.lanes, d.shape.vectors))) {
+            fprintf(stderr, "%s: column %.*s has an unknown type\n", path.c_str(), (int)sizeof(d.name), d.name);
+            return false;
+        }
+        // rows * stride is bounded by dividing, so a huge row count cannot
+        // wrap around into range
+        if(d.offset % ColumnAlign != 0 || d.offset > size || d.rows > (size - d.offset) / d.shape.stride) {
+            fprintf(stderr, "%s: column %.*s is truncated\n", path.c_str(), (int)sizeof(d.name), d.name);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ColumnFile::Open(const char *p) {
+    path = p;
+    int fd = open(p, O_RDONLY);
+    struct stat st;
+    if(fd < 0 || fstat(fd, &st) < 0) {
+        fprintf(stderr, "cannot open %s\n", p);
+        if(fd >= 0)
+            close(fd);
+        return false;
+    }
+    size = st.st_size;
+    void *m = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(m == MAP_FAILED) {
+        fprintf(stderr, "cannot map %s\n", p);
+        return false;
+    }
+    base = (char*)m;
+    return Check();
+}
+
+bool ColumnFile::Create(const char *p, const char *entry, uint64_t rows, vector<ColumnDesc> &cols) {
+    path = p;
+    size_t at = AlignUp(sizeof(ColumnFileHeader) + cols.size() * sizeof(ColumnDesc), ColumnAlign);
+    for(size_t i = 0; i < cols.size(); i++) {
+        cols[i].offset = at;
+        at = AlignUp(at + cols[i].rows * cols[i].shape.stride, ColumnAlign);
+    }
+    size = at;
+
+    int fd = open(p, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0 || ftruncate(fd, size) < 0) {
+        fprintf(stderr, "cannot write %s\n", p);
+        if(fd >= 0)
+            close(fd);
+        return false;
+    }
+    void *m = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(m == MAP_FAILED) {
+        fprintf(stderr, "cannot map %s\n", p);
+        return false;
+    }
+    base = (char*)m;
+
+    ColumnFileHeader *h = (ColumnFileHeader*)base;
+    memcpy(h->magic, ColumnMagic, sizeof(ColumnMagic));
+    strncpy(h->entry, entry, sizeof(h->entry) - 1);
+    h->numColumns = cols.size();
+    h->rows = rows;
+    if(!cols.empty())
+        memcpy(base + sizeof(ColumnFileHeader), &cols[0], cols.size() * sizeof(ColumnDesc));
+    return true;
+}
@@ -0,0 +1,129 @@
+/**
+ * File: columns.h
+ * ---------------
+ *  This file defines the binary columnar format for glc-exec invocation
+ *  data, and the file that holds it.
+ *
+ *  A column file is a header, an array of column descriptors and the
+ *  columns themselves, each starting on a 64-byte boundary. A parameter
+ *  column holds one row per invocation, a global column a single row, and
+ *  a result column one row per invocation. Rows are laid out exactly as
+ *  the JIT-compiled code keeps values in memory, so the executor maps a
+ *  file and hands its columns to the compiled loop without copying.
+ *  Integers are in host byte order.
+ */
+
+#ifndef _H_Columns
+#define _H_Columns
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <vector>
+#include <string>
+
+using namespace std;
+
+static const size_t ColumnAlign = 64;
+
+typedef enum { ParamColumn, GlobalColumn, ResultColumn } ColumnKind;
+typedef enum { FloatScalar, IntScalar, BoolScalar } ScalarKind;
+
+// The memory layout of one value: vectors of lanes scalars each. A vector
+// of 3 is padded to 4, and a bool takes a byte.
+struct ColumnShape {
+    uint8_t  scalar;
+    uint8_t  lanes;
+    uint16_t vectors;
+    uint32_t stride;    // bytes from one row to the next
+
+    // float, int, uint, bool, vecN, ivecN, uvecN, bvecN and matN, as
+    // written in a .dat
+    static bool FromTypeName(const char *name, ColumnShape &shape);
+    static ColumnShape Make(ScalarKind scalar, int lanes, int vectors);
+
+    int NumScalars() const { return lanes * vectors; }
+    size_t Offset(int i) const;
+
+    // Stores a flat list of scalars, components in order, into a row, or
+    // prints a row as one
+    void Store(const double *vals, char *row) const;
+    void Print(FILE *f, const char *row) const;
+    bool operator==(const ColumnShape &s) const;
+};
+
+struct ColumnFileHeader {
+    char     magic[8];
+    char     entry[64];     // the entry function the file is for
+    uint32_t numColumns;
+    uint32_t reserved;
+    uint64_t rows;          // invocations
+};
+
+struct ColumnDesc {
+    char        name[48];   // the global's name; params are "param<k>"
+    uint32_t    kind;
+    ColumnShape shape;
+    uint32_t    reserved;
+    uint64_t    rows;
+    uint64_t    offset;     // from the start of the file
+};
+
+class ColumnFile {
+  public:
+    ColumnFile();
+    ~ColumnFile();
+
+    // Maps an existing file. Columns are copy-on-write, so out and inout
+    // parameters can be written without changing the file.
+    bool Open(const char *path);
+
+    // Creates a file of the given columns, zero-filled and mapped shared,
+    // so whatever is stored into a column lands in the file
+    bool Create(const char *path, const char *entry, uint64_t rows, vector<ColumnDesc> &cols);
+
+    const ColumnFileHeader *GetHeader() const { return (const ColumnFileHeader*)base; }
+    int NumColumns() const { return GetHeader()->numColumns; }
+    const ColumnDesc &GetDesc(int i) const;
+    char *GetData(int i) const { return base + GetDesc(i).offset; }
+
+    // Index of the named column of the given kind, or -1
+    int Find(ColumnKind kind, const char *name) const;
+
+    // Scalars separated by spaces or commas; true and false are 1 and 0
+    static bool ParseValues(const char *text, vector<double> &vals);
+
+  private:
+    char   *base;
+    size_t  size;
+    string  path;
+
+    bool Check();
+};
+
+// A column stream carries invocations through a pipe. It starts with a
+// header and the column descriptors, whose rows and offsets are unused.
+// Then come blocks: a uint64_t row count followed by that many rows of each
+// column in turn. A block of no rows, or the end of the input, ends it.
+struct ColumnStreamHeader {
+    char     magic[8];
+    char     entry[64];
+    uint32_t numColumns;
+    uint32_t reserved;
+};
+
+class ColumnStream {
+  public:
+    static bool WriteHeader(FILE *f, const char *entry, const vector<ColumnDesc> &cols);
+    // False for a malformed header, or one whose numColumns, returned
+    // either way once read, is above MaxColumns; the descriptors are then
+    // left unread
+    static bool ReadHeader(FILE *f, string &entry, uint32_t &numColumns, vector<ColumnDesc> &cols);
+
+    // The first byte of every stream; a text record never starts with it
+    static const char Magic[8];
+    // More columns than any entry function takes
+    static const uint32_t MaxColumns = 4096;
+};
+
+#endif
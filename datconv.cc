@@ -0,0 +1,222 @@
+/* File: datconv.cc
+ * ----------------
+ * Entry point of glc-dat2col, which converts a .dat and optional text
+ * records into a column file for glc-exec -fcolumns, or with -s into a
+ * column stream for glc-exec -fstream.
+ *
+ *   glc-dat2col [-s] file.dat out.col [records]
+ *
+ * Without records the file holds the single invocation of the .dat. A
+ * records file has one invocation per line, the values of all parameters
+ * in order, as for glc-exec -finput. The gin: lines become global columns
+ * of a column file; a stream carries only the parameters. A stream goes
+ * to stdout when out is "-" and reads records from stdin when they are.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <vector>
+#include <string>
+#include "columns.h"
+
+struct Field {
+    string         name;
+    ColumnShape    shape;
+    vector<double> vals;
+};
+
+static bool ReadDat(const char *path, string &entry, vector<Field> &params, vector<Field> &globals) {
+    FILE *f = fopen(path, "r");
+    if(f == NULL) {
+        fprintf(stderr, "glc-dat2col: cannot open %s\n", path);
+        return false;
+    }
+    char line[4096], name[48], type[64];
+    int n;
+    bool ok = true;
+    while(ok && fgets(line, sizeof(line), f) != NULL) {
+        Field field;
+        if(sscanf(line, " funct: %63[A-Za-z0-9_]", type) == 1)
+            entry = type;
+        else if(sscanf(line, " param: %63[A-Za-z0-9_] ,%n", type, &n) == 1) {
+            char pname[16];
+            sprintf(pname, "param%u", (unsigned)params.size());
+            field.name = pname;
+            ok = ColumnShape::FromTypeName(type, field.shape) && ColumnFile::ParseValues(line + n, field.vals)
+                 && field.vals.size() == (size_t)field.shape.NumScalars();
+            params.push_back(field);
+        }
+        else if(sscanf(line, " gin: %47[A-Za-z0-9_] , %63[A-Za-z0-9_] ,%n", name, type, &n) == 2) {
+            field.name = name;
+            ok = ColumnShape::FromTypeName(type, field.shape) && ColumnFile::ParseValues(line + n, field.vals)
+                 && field.vals.size() == (size_t)field.shape.NumScalars();
+            globals.push_back(field);
+        }
+    }
+    fclose(f);
+    if(!ok)
+        fprintf(stderr, "glc-dat2col: %s: cannot convert \"%s\"\n", path, line);
+    else if(entry.empty()) {
+        fprintf(stderr, "glc-dat2col: %s names no funct:\n", path);
+        ok = false;
+    }
+    return ok;
+}
+
+static ColumnDesc Describe(const Field &field, ColumnKind kind, uint64_t rows) {
+    ColumnDesc d;
+    memset(&d, 0, sizeof(d));
+    strncpy(d.name, field.name.c_str(), sizeof(d.name) - 1);
+    d.kind = kind;
+    d.shape = field.shape;
+    d.rows = rows;
+    return d;
+}
+
+static const size_t StreamBlock = 4096;
+
+// Records in blocks of StreamBlock rows, each column of a block in turn
+static int WriteStream(const char *entry, vector<Field> &params, FILE *records, FILE *out) {
+    vector<ColumnDesc> cols;
+    for(size_t k = 0; k < params.size(); k++)
+        cols.push_back(Describe(params[k], ParamColumn, 0));
+    if(!ColumnStream::WriteHeader(out, entry, cols))
+        return 1;
+
+    size_t width = 0;
+    vector<vector<char> > block(params.size());
+    for(size_t k = 0; k < params.size(); k++) {
+        width += params[k].shape.NumScalars();
+        block[k].resize(StreamBlock * params[k].shape.stride);
+    }
+    uint64_t rows = 0;
+    char line[4096];
+    int lineno = 0;
+    bool more = true, ok = true;
+    while(more && ok) {
+        vector<double> vals;
+        if(records == NULL) {
+            // the .dat's own invocation
+            for(size_t k = 0; k < params.size(); k++)
+                vals.insert(vals.end(), params[k].vals.begin(), params[k].vals.end());
+            more = false;
+        }
+        else if(fgets(line, sizeof(line), records) == NULL)
+            more = false;
+        else {
+            lineno++;
+            if(line[strspn(line, " \t\r\n")] == '\0' || line[0] == '#')
+                continue;
+            if(!ColumnFile::ParseValues(line, vals) || vals.size() != width) {
+                fprintf(stderr, "glc-dat2col: line %d: expected %u values\n", lineno, (unsigned)width);
+                return 1;
+            }
+        }
+        if(more || records == NULL) {
+            const double *v = vals.empty() ? NULL : &vals[0];
+            for(size_t k = 0; k < params.size(); k++) {
+                params[k].shape.Store(v, &block[k][rows * params[k].shape.stride]);
+                v += params[k].shape.NumScalars();
+            }
+            rows++;
+        }
+        if(rows == StreamBlock || (!more && rows > 0)) {
+            ok = fwrite(&rows, sizeof(rows), 1, out) == 1;
+            for(size_t k = 0; ok && k < params.size(); k++)
+                ok = fwrite(&block[k][0], params[k].shape.stride, rows, out) == rows;
+            rows = 0;
+        }
+    }
+    rows = 0;
+    if(!ok || fwrite(&rows, sizeof(rows), 1, out) != 1 || fflush(out) != 0) {
+        fprintf(stderr, "glc-dat2col: cannot write the stream\n");
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    bool stream = argc > 1 && !strcmp(argv[1], "-s");
+    if(stream) {
+        argc--;
+        argv++;
+    }
+    if(argc < 3 || argc > 4) {
+        printf("Correct Usage:   glc-dat2col [-s] file.dat out.col [records]\n");
+        return 2;
+    }
+    string entry;
+    vector<Field> params, globals;
+    if(!ReadDat(argv[1], entry, params, globals))
+        return 1;
+
+    if(stream) {
+        FILE *records = argc < 4 ? NULL : strcmp(argv[3], "-") ? fopen(argv[3], "r") : stdin;
+        FILE *out = strcmp(argv[2], "-") ? fopen(argv[2], "wb") : stdout;
+        if((argc == 4 && records == NULL) || out == NULL) {
+            fprintf(stderr, "glc-dat2col: cannot open %s\n", out == NULL ? argv[2] : argv[3]);
+            return 1;
+        }
+        return WriteStream(entry.c_str(), params, records, out);
+    }
+
+    // records are counted first, so the file is created at its final size
+    FILE *records = NULL;
+    uint64_t rows = 1;
+    char line[4096];
+    if(argc == 4) {
+        records = fopen(argv[3], "r");
+        if(records == NULL) {
+            fprintf(stderr, "glc-dat2col: cannot read %s\n", argv[3]);
+            return 1;
+        }
+        rows = 0;
+        while(fgets(line, sizeof(line), records) != NULL)
+            if(line[strspn(line, " \t\r\n")] != '\0' && line[0] != '#')
+                rows++;
+        rewind(records);
+    }
+
+    vector<ColumnDesc> cols;
+    for(size_t k = 0; k < params.size(); k++)
+        cols.push_back(Describe(params[k], ParamColumn, rows));
+    for(size_t g = 0; g < globals.size(); g++)
+        cols.push_back(Describe(globals[g], GlobalColumn, 1));
+    ColumnFile file;
+    if(!file.Create(argv[2], entry.c_str(), rows, cols))
+        return 1;
+
+    for(size_t g = 0; g < globals.size(); g++)
+        globals[g].shape.Store(&globals[g].vals[0], file.GetData(params.size() + g));
+    if(records == NULL) {
+        for(size_t k = 0; k < params.size(); k++)
+            params[k].shape.Store(&params[k].vals[0], file.GetData(k));
+        return 0;
+    }
+
+    size_t width = 0;
+    for(size_t k = 0; k < params.size(); k++)
+        width += params[k].shape.NumScalars();
+    uint64_t row = 0;
+    int lineno = 0;
+    while(fgets(line, sizeof(line), records) != NULL) {
+        lineno++;
+        if(line[strspn(line, " \t\r\n")] == '\0' || line[0] == '#')
+            continue;
+        vector<double> vals;
+        if(!ColumnFile::ParseValues(line, vals) || vals.size() != width) {
+            fprintf(stderr, "glc-dat2col: %s:%d: expected %u values\n", argv[3], lineno, (unsigned)width);
+            fclose(records);
+            return 1;
+        }
+        const double *v = &vals[0];
+        for(size_t k = 0; k < params.size(); k++) {
+            params[k].shape.Store(v, file.GetData(k) + row * params[k].shape.stride);
+            v += params[k].shape.NumScalars();
+        }
+        row++;
+    }
+    fclose(records);
+    return 0;
+}
@@ -0,0 +1,376 @@
+/* File: exec_main.cc
+ * ------------------
+ * Entry point of glc-exec, which runs a compiled shader over a batch of
+ * invocations.
+ *
+ *   glc-exec [-f<option>[=<value>] ...] file.bc
+ *
+ * The entry function, its arguments and the globals come from file.dat
+ * (or -fdat=<file>). With no other options a single invocation is run and
+ * its result printed, as gli does. Options:
+ *
+ *   -fn=<count>        run count invocations
+ *   -finput=<file>     per-invocation arguments, one record per line
+ *   -fcolumns=<file>   per-invocation arguments from a column file
+ *   -foutput=<file>    write every result, one "Result:" line each
+ *   -fresult=<file>    write the results as a column file
+ *   -fthreads=<count>  worker threads (default: all online cores)
+ *   -fsched=<policy>   steal (default) or static
+ *   -fchunk=<count>    most invocations handed to a worker at a time; the
+ *                      chunk size of static scheduling
+ *   -fmin-chunk=<count>  fewest invocations handed to a worker at a time
+ *   -fpin              pin worker t to CPU t
+ *   -fstats            report busy time, chunks and steals per worker
+ *   -fscale            report throughput for 1, 2, 4 ... threads
+ *   -frepeat=<count>   runs per measurement; the best is reported
+ *   -flanes=<width>    run 4, 8 or 16 invocations per vector iteration;
+ *                      the module must come from glc -flanes=<width>
+ *   -fstream[=<file>]  stream text records or a column stream from file
+ *                      (default stdin) in blocks; results go to -foutput
+ *                      (default stdout) as text or to -fresult as a
+ *                      column stream
+ *   -fblock=<count>    invocations per streamed block
+ *   -fbuffers=<count>  blocks in flight while streaming (default 3)
+ *   -fgrid=<W>x<H>     shade a W x H framebuffer: the entry returns a vec4
+ *                      and reads the pixel centre from gl_FragCoord; the
+ *                      .dat arguments are the same for every pixel
+ *   -ftile=<size>      grid tile edge in pixels (default 32)
+ *   -fimage=<file>     write the framebuffer, as a PPM if file ends in
+ *                      .ppm, otherwise as raw RGBA floats
+ *   -fwatch=<file>     run batches (or grids) until interrupted, recompiling
+ *                      the shader source file whenever it changes and
+ *                      swapping the new code in between batches
+ *   -fglc=<path>       the compiler to recompile with (default: glc beside
+ *                      glc-exec)
+ *   -fglc-flags="<flags>"  space-separated options for that compiler, as
+ *                      the running module was compiled with, e.g.
+ *                      "-ffast-math -fssa"; -fdat and -flanes are added
+ *   -fwatch-interval=<ms>  how often the source is checked (default 200)
+ *   -fduration=<seconds>   stop watching after this long
+ *   -fprofile-report=<file>  where the profile of a module compiled with
+ *                      glc -finstrument goes at exit (default stderr)
+ *   -fprofile-out=<file>  where such a module's branch counts go at exit,
+ *                      for glc -fprofile-use (default: file.prof)
+ *   -fperf-map         list the JIT-compiled shader functions in
+ *                      /tmp/perf-<pid>.map for perf report
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <signal.h>
+#include <string>
+#include "utility.h"
+#include "executor.h"
+#include "stream.h"
+#include "reload.h"
+#include "profile.h"
+#include "perfmap.h"
+
+static long IntOption(const char *name, long def) {
+    const char *v = GetOption(name);
+    return v != NULL && *v != '\0' ? atol(v) : def;
+}
+
+static double Measure(Executor &exec, Scheduler &sched, int repeat) {
+    double best = 0;
+    for(int r = 0; r < repeat; r++) {
+        double t = exec.Run(sched);
+        if(r == 0 || t < best)
+            best = t;
+    }
+    return best;
+}
+
+static void PrintStats(Scheduler &sched) {
+    const vector<Scheduler::Stats> &stats = sched.GetStats();
+    double most = 0, least = 0;
+    printf("%8s %12s %14s %9s %9s\n", "worker", "busy", "invocations", "chunks", "steals");
+    for(size_t t = 0; t < stats.size(); t++) {
+        printf("%8d %12.6f %14lu %9lu %9lu\n", (int)t, stats[t].busy, (unsigned long)stats[t].invocations,
+               (unsigned long)stats[t].chunks, (unsigned long)stats[t].steals);
+        if(t == 0 || stats[t].busy > most)
+            most = stats[t].busy;
+        if(t == 0 || stats[t].busy < least)
+            least = stats[t].busy;
+    }
+    printf("%8s %12.6f\n", "spread", most - least);
+}
+
+static FILE *OpenStream(const char *path, const char *mode) {
+    if(path == NULL || *path == '\0' || !strcmp(path, "-"))
+        return *mode == 'r' ? stdin : stdout;
+    FILE *f = fopen(path, mode);
+    if(f == NULL)
+        fprintf(stderr, "glc-exec: cannot open %s\n", path);
+    return f;
+}
+
+// Memory use is the blocks in flight, however long the input
+static int RunStream(Executor &exec, Scheduler &sched) {
+    FILE *in = OpenStream(GetOption("stream"), "r");
+    bool binary = GetOption("result") != NULL;
+    FILE *out = OpenStream(binary ? GetOption("result") : GetOption("output"), binary ? "wb" : "w");
+    if(in == NULL || out == NULL)
+        return 1;
+    StreamRunner stream(exec, IntOption("block", 65536), (int)IntOption("buffers", 3));
+    double start = Executor::Now();
+    bool ok = stream.Run(sched, in, out, binary);
+    double secs = Executor::Now() - start;
+    fprintf(stderr, "%s: %lu invocations streamed in %.6f s (%.6f s running), %.4e inv/s, %lu bytes buffered\n",
+            exec.GetEntryName(), (unsigned long)stream.NumInvocations(), secs, stream.GetRunSeconds(),
+            stream.NumInvocations() / secs, (unsigned long)stream.GetBufferBytes());
+    if(in != stdin)
+        fclose(in);
+    if(out != stdout)
+        fclose(out);
+    return ok ? 0 : 1;
+}
+
+// The profile of an instrumented module, written whichever way glc-exec
+// finishes
+static void ReportProfile() {
+    const char *path = GetOption("profile-report");
+    FILE *f = path != NULL && *path != '\0' ? fopen(path, "w") : stderr;
+    if(f == NULL) {
+        fprintf(stderr, "glc-exec: cannot write %s\n", path);
+        return;
+    }
+    Profile::Report(f);
+    if(f != stderr)
+        fclose(f);
+    if(Profile::HasBranches())
+        Profile::WriteBranches(GetOption("profile-out"));
+}
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void Interrupt(int sig) {
+    interrupted = 1;
+}
+
+// Runs the inputs (the grid, when tile > 0) over and over, swapping in each
+// recompile of the watched source between two runs. Reports throughput
+// about once a second, and for each reload the compile latency and the
+// throughput of the last run before and the first run after.
+static int RunWatch(Executor &exec, Scheduler &sched, int tile, const char *dat, const char *glc, int lanes) {
+    Reloader reloader(exec, GetOption("watch"), dat, glc, GetOption("glc-flags"), lanes,
+                      IntOption("watch-interval", 200) / 1000.0);
+    double units = tile > 0 ? (double)exec.GetGridWidth() * exec.GetGridHeight() : exec.NumInvocations();
+    const char *unit = tile > 0 ? "Mpixel/s" : "inv/s";
+    double scale = tile > 0 ? 1e-6 : 1;
+    double duration = IntOption("duration", 0);
+    signal(SIGINT, Interrupt);
+    printf("%s: watching %s\n", exec.GetEntryName(), GetOption("watch"));
+    fflush(stdout);
+    reloader.Start();
+
+    double start = Executor::Now(), lastReport = start, rate = 0, before = 0, latency = 0;
+    int reloads = 0;
+    bool swapped = false;
+    while(!interrupted && (duration <= 0 || Executor::Now() - start < duration)) {
+        if(reloader.Swap(latency)) {
+            reloads++;
+            swapped = true;
+            before = rate;
+        }
+        double secs = tile > 0 ? exec.RunGrid(sched, tile) : exec.Run(sched);
+        rate = units / secs * scale;
+        double now = Executor::Now();
+        if(swapped) {
+            printf("reload %d: compiled in %.3f s, %.4e -> %.4e %s (%.2fx), %d lanes\n", reloads, latency,
+                   before, rate, unit, before > 0 ? rate / before : 0, exec.GetLanes());
+            swapped = false;
+        }
+        else if(now - lastReport >= 1) {
+            printf("%8.1f s %14.4e %s\n", now - start, rate, unit);
+            lastReport = now;
+        }
+        fflush(stdout);
+    }
+    signal(SIGINT, SIG_DFL);
+    return 0;
+}
+
+// Shades the grid one tile at a time per worker, reporting megapixels/s
+static int RunGrid(Executor &exec, Scheduler::Policy policy, int threads, bool pin, int repeat,
+                   const char *dat, const char *glc, int lanes) {
+    int tile = (int)IntOption("tile", 32);
+    if(tile < 1) {
+        fprintf(stderr, "glc-exec: -ftile must be positive\n");
+        return 2;
+    }
+    if(!exec.Replicate(1))
+        return 1;
+    if(IsOptionOn("watch")) {
+        Scheduler sched(policy, threads, 1, 1, 1, pin);
+        return RunWatch(exec, sched, tile, dat, glc, lanes);
+    }
+    double pixels = (double)exec.GetGridWidth() * exec.GetGridHeight();
+    printf("%s: %dx%d pixels, %dx%d tiles, %d lanes\n", exec.GetEntryName(), exec.GetGridWidth(),
+           exec.GetGridHeight(), tile, tile, exec.GetLanes());
+    printf("%8s %12s %14s %9s\n", "threads", "seconds", "Mpixel/s", "speedup");
+    double base = 0;
+    for(int t = IsOptionOn("scale") ? 1 : threads; t <= threads; t = t < threads && t * 2 > threads ? threads : t * 2) {
+        Scheduler sched(policy, t, 1, 1, 1, pin);
+        double secs = 0;
+        for(int r = 0; r < repeat; r++) {
+            double s = exec.RunGrid(sched, tile);
+            if(r == 0 || s < secs)
+                secs = s;
+        }
+        if(base == 0)
+            base = secs;
+        printf("%8d %12.6f %14.2f %9.2f\n", t, secs, pixels / secs * 1e-6, base / secs);
+        if(IsOptionOn("stats"))
+            PrintStats(sched);
+    }
+    if(const char *image = GetOption("image"))
+        return exec.WriteImage(image) ? 0 : 1;
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *bc = NULL;
+    for(int i = 1; i < argc; i++) {
+        if(!strncmp(argv[i], "-f", 2) && argv[i][2] != '\0') {
+            char *name = strdup(argv[i] + 2);
+            char *eq = strchr(name, '=');
+            if(eq) *eq = '\0';
+            SetOption(name, eq ? eq + 1 : "");
+        }
+        else if(bc == NULL)
+            bc = argv[i];
+        else {
+            printf("Correct Usage:   glc-exec [-f<option>[=<value>] ...] file.bc\n");
+            return 2;
+        }
+    }
+    if(bc == NULL)
+        bc = "-";
+
+    std::string dat;
+    if(GetOption("dat"))
+        dat = GetOption("dat");
+    else if(strcmp(bc, "-")) {
+        dat = bc;
+        size_t dot = dat.rfind('.');
+        dat = (dot == std::string::npos ? dat : dat.substr(0, dot)) + ".dat";
+    }
+    else {
+        fprintf(stderr, "glc-exec: reading the module from stdin needs -fdat\n");
+        return 2;
+    }
+    if(!GetOption("profile-out")) {
+        size_t dot = dat.rfind('.');
+        SetOption("profile-out", strdup(((dot == std::string::npos ? dat : dat.substr(0, dot)) + ".prof").c_str()));
+    }
+
+    Executor exec;
+    int lanes = (int)IntOption("lanes", 1);
+    if(lanes != 1 && lanes != 4 && lanes != 8 && lanes != 16) {
+        fprintf(stderr, "glc-exec: -flanes must be 4, 8 or 16\n");
+        return 2;
+    }
+    if(const char *grid = GetOption("grid")) {
+        int w = 0, h = 0;
+        if(sscanf(grid, "%dx%d", &w, &h) != 2 || w < 1 || h < 1) {
+            fprintf(stderr, "glc-exec: -fgrid must be <width>x<height>\n");
+            return 2;
+        }
+        exec.SetGrid(w, h);
+    }
+    if(IsOptionOn("perf-map") && !PerfMap::Enable())
+        return 1;
+    if(!exec.LoadModule(bc) || !exec.LoadDat(dat.c_str()) || !exec.Compile(lanes))
+        return 1;
+    if(exec.GetLanes() != lanes)
+        fprintf(stderr, "glc-exec: %s could not be vectorized: %s; running one lane\n", exec.GetEntryName(),
+                exec.GetLaneNote());
+    if(Profile::IsLoaded())
+        atexit(ReportProfile);
+
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = (int)IntOption("threads", cores > 0 ? cores : 1);
+    size_t chunk = IntOption("chunk", 4096);
+    size_t minChunk = IntOption("min-chunk", 64);
+    bool pin = IsOptionOn("pin");
+    Scheduler::Policy policy = Scheduler::Stealing;
+    if(const char *s = GetOption("sched")) {
+        if(!strcmp(s, "static"))
+            policy = Scheduler::Static;
+        else if(strcmp(s, "steal")) {
+            fprintf(stderr, "glc-exec: -fsched must be steal or static\n");
+            return 2;
+        }
+    }
+    int repeat = (int)IntOption("repeat", 1);
+    if(exec.WritesGlobals() && threads > 1) {
+        fprintf(stderr, "glc-exec: %s writes globals; running on one thread\n", exec.GetEntryName());
+        threads = 1;
+    }
+
+    // glc is looked for beside glc-exec, then on the path
+    std::string glc = GetOption("glc") ? GetOption("glc") : "glc";
+    if(!GetOption("glc") && strchr(argv[0], '/'))
+        glc = std::string(argv[0], strrchr(argv[0], '/') + 1) + "glc";
+
+    if(exec.GetGridWidth() > 0)
+        return RunGrid(exec, policy, threads, pin, repeat, dat.c_str(), glc.c_str(), lanes);
+    if(IsOptionOn("stream")) {
+        Scheduler sched(policy, threads, minChunk, chunk, exec.GetLanes(), pin);
+        return RunStream(exec, sched);
+    }
+
+    size_t n = IntOption("n", 0);
+    bool ok;
+    if(GetOption("columns"))
+        ok = exec.MapInputs(GetOption("columns"), n);
+    else if(GetOption("input"))
+        ok = exec.ReadInputs(GetOption("input"), n);
+    else
+        ok = exec.Replicate(n ? n : 1);
+    if(!ok || (GetOption("result") && !exec.MapResult(GetOption("result"))))
+        return 1;
+
+    if(IsOptionOn("watch")) {
+        Scheduler sched(policy, threads, minChunk, chunk, exec.GetLanes(), pin);
+        return RunWatch(exec, sched, 0, dat.c_str(), glc.c_str(), lanes);
+    }
+
+    // gli compatible: one invocation, its result on stdout
+    if(exec.NumInvocations() == 1 && !IsOptionOn("output") && !IsOptionOn("result") && !IsOptionOn("scale")) {
+        Scheduler one(Scheduler::Static, 1, 1, 1, 1, false);
+        exec.Run(one);
+        exec.PrintResults(stdout);
+        return 0;
+    }
+
+    printf("%s: %lu invocations, %s chunks of %lu, %d lanes\n", exec.GetEntryName(),
+           (unsigned long)exec.NumInvocations(), policy == Scheduler::Static ? "static" : "stolen",
+           (unsigned long)chunk, exec.GetLanes());
+    printf("%8s %12s %14s %9s\n", "threads", "seconds", "inv/s", "speedup");
+    double base = 0;
+    for(int t = IsOptionOn("scale") ? 1 : threads; t <= threads; t = t < threads && t * 2 > threads ? threads : t * 2) {
+        Scheduler sched(policy, t, minChunk, chunk, exec.GetLanes(), pin);
+        double secs = Measure(exec, sched, repeat);
+        if(base == 0)
+            base = secs;
+        printf("%8d %12.6f %14.4e %9.2f\n", t, secs, exec.NumInvocations() / secs, base / secs);
+        if(IsOptionOn("stats"))
+            PrintStats(sched);
+    }
+
+    if(const char *out = GetOption("output")) {
+        FILE *f = strcmp(out, "-") ? fopen(out, "w") : stdout;
+        if(f == NULL) {
+            fprintf(stderr, "glc-exec: cannot write %s\n", out);
+            return 1;
+        }
+        exec.PrintResults(f);
+        if(f != stdout)
+            fclose(f);
+    }
+    return 0;
+}
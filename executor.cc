@@ -0,0 +1,906 @@
+/* File: executor.cc
+ * -----------------
+ * Implementation of the batch executor used by glc-exec.
+ */
+
+#include "executor.h"
+#include "profile.h"
+#include "perfmap.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/Analysis/ValueTracking.h"
+#include "llvm/Bitcode/ReaderWriter.h"
+#include "llvm/ExecutionEngine/MCJIT.h"
+#include "llvm/PassManager.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/system_error.h"
+#include "llvm/ADT/OwningPtr.h"
+
+Executor::Executor() : module(NULL), engine(NULL), layout(NULL), entry(NULL),
+                       batch(NULL), writesGlobals(false), lanes(1), gridWidth(0),
+                       gridHeight(0), fragCoord(false), inputFile(NULL), resultFile(NULL), count(0) {
+    context = new llvm::LLVMContext();
+}
+
+Executor::~Executor() {
+    Release();
+    // the engine owns the module
+    delete engine;
+    if(engine == NULL)
+        delete module;
+    delete context;
+}
+
+double Executor::Now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+bool Executor::LoadModule(const char *path) {
+    llvm::OwningPtr<llvm::MemoryBuffer> buf;
+    if(llvm::MemoryBuffer::getFileOrSTDIN(path, buf)) {
+        fprintf(stderr, "glc-exec: cannot open %s\n", path);
+        return false;
+    }
+    string err;
+    module = llvm::ParseBitcodeFile(buf.get(), *context, &err);
+    if(module == NULL) {
+        fprintf(stderr, "glc-exec: %s: %s\n", path, err.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool Executor::LoadDat(const char *path) {
+    FILE *f = fopen(path, "r");
+    if(f == NULL) {
+        fprintf(stderr, "glc-exec: cannot open %s\n", path);
+        return false;
+    }
+    char line[4096], name[256], type[64];
+    int n;
+    bool ok = true;
+    while(ok && fgets(line, sizeof(line), f) != NULL) {
+        vector<double> vals;
+        if(sscanf(line, " funct: %255[A-Za-z0-9_]", name) == 1)
+            entryName = name;
+        else if(sscanf(line, " param: %63[A-Za-z0-9_] ,%n", type, &n) == 1) {
+            ok = ColumnFile::ParseValues(line + n, vals);
+            datParams.push_back(vals);
+        }
+        else if(sscanf(line, " gin: %255[A-Za-z0-9_] , %63[A-Za-z0-9_] ,%n", name, type, &n) == 2) {
+            ok = ColumnFile::ParseValues(line + n, vals);
+            datGlobals.push_back(make_pair(string(name), vals));
+        }
+    }
+    fclose(f);
+    if(!ok)
+        fprintf(stderr, "glc-exec: %s: bad value in \"%s\"\n", path, line);
+    else if(entryName.empty()) {
+        fprintf(stderr, "glc-exec: %s names no funct:\n", path);
+        ok = false;
+    }
+    return ok;
+}
+
+// The column layout of a value of type ty. False when the type has none,
+// or the JIT lays it out differently (vectors of bool are bit-packed).
+bool Executor::GetShape(llvm::Type *ty, ColumnShape &shape) const {
+    llvm::Type *elt = ty;
+    int vectors = 1, lanes = 1;
+    if(elt->isArrayTy()) {
+        vectors = elt->getArrayNumElements();
+        elt = elt->getArrayElementType();
+    }
+    if(elt->isVectorTy()) {
+        lanes = elt->getVectorNumElements();
+        elt = elt->getVectorElementType();
+    }
+    if(elt->isFloatTy())
+        shape = ColumnShape::Make(FloatScalar, lanes, vectors);
+    else if(elt->isIntegerTy(32))
+        shape = ColumnShape::Make(IntScalar, lanes, vectors);
+    else if(elt->isIntegerTy(1) && (lanes == 1 || vectors == 1))
+        shape = ColumnShape::Make(BoolScalar, lanes, vectors);
+    else
+        return false;
+    return shape.stride == layout->getTypeAllocSize(InMemory(ty));
+}
+
+// LLVM packs a bool vector into bits; a column holds a byte per lane, so
+// bool vectors are loaded and stored as byte vectors
+llvm::Type *Executor::InMemory(llvm::Type *ty) const {
+    if(ty->isVectorTy() && ty->getVectorElementType()->isIntegerTy(1))
+        return llvm::VectorType::get(llvm::Type::getInt8Ty(*context), ty->getVectorNumElements());
+    return ty;
+}
+
+llvm::Value *Executor::LoadColumn(llvm::Value *row, llvm::Type *ty, llvm::BasicBlock *bb) const {
+    llvm::Value *v = new llvm::LoadInst(row, "", bb);
+    return v->getType() == ty ? v : new llvm::TruncInst(v, ty, "", bb);
+}
+
+void Executor::StoreColumn(llvm::Value *v, llvm::Value *row, llvm::BasicBlock *bb) const {
+    llvm::Type *ty = llvm::cast<llvm::PointerType>(row->getType())->getElementType();
+    if(v->getType() != ty)
+        v = new llvm::ZExtInst(v, ty, "", bb);
+    new llvm::StoreInst(v, row, bb);
+}
+
+// A scalar other than a bool is a single element of its widened vector, so
+// the rows of a lane group lie in memory as that vector
+static bool IsPacked(llvm::Type *ty) {
+    return !ty->isAggregateType() && !ty->isVectorTy() && !ty->isIntegerTy(1);
+}
+
+// The rows from row on, one per lane, as a value of the widened entry
+llvm::Value *Executor::LoadLanes(LaneWidener &widen, llvm::Value *row, llvm::Type *ty, llvm::BasicBlock *bb) const {
+    llvm::Type *wideTy = widen.WideType(ty);
+    if(IsPacked(ty)) {
+        llvm::Value *vec = new llvm::BitCastInst(row, llvm::PointerType::getUnqual(wideTy), "", bb);
+        return new llvm::LoadInst(vec, "", false, layout->getABITypeAlignment(ty), bb);
+    }
+    llvm::Value *v = llvm::UndefValue::get(wideTy);
+    for(int l = 0; l < widen.GetWidth(); l++) {
+        llvm::Value *at = llvm::GetElementPtrInst::Create(row, llvm::ConstantInt::get(layout->getIntPtrType(*context), l), "", bb);
+        v = widen.InsertLane(v, LoadColumn(at, ty, bb), l, bb);
+    }
+    return v;
+}
+
+void Executor::StoreLanes(LaneWidener &widen, llvm::Value *v, llvm::Value *row, llvm::Type *ty, llvm::BasicBlock *bb) const {
+    if(IsPacked(ty)) {
+        llvm::Value *vec = new llvm::BitCastInst(row, llvm::PointerType::getUnqual(v->getType()), "", bb);
+        new llvm::StoreInst(v, vec, false, layout->getABITypeAlignment(ty), bb);
+        return;
+    }
+    for(int l = 0; l < widen.GetWidth(); l++) {
+        llvm::Value *at = llvm::GetElementPtrInst::Create(row, llvm::ConstantInt::get(layout->getIntPtrType(*context), l), "", bb);
+        StoreColumn(widen.ExtractLane(v, ty, l, bb), at, bb);
+    }
+}
+
+// void glc.batch(i8** columns, i8* result, i64 begin, i64 end)
+//   for(i = begin; i < end; i++)
+//     result[i] = entry(columns[0][i], columns[1][i], ...)
+// Parameters passed by pointer (arrays, out and inout) get the address of
+// their row, so out values land in the input column. Given the entry
+// widened by glc -flanes, a first loop calls that on groups of lanes rows
+// and the loop above finishes the rows left over.
+llvm::Function *Executor::CreateBatchWrapper(llvm::Function *wide) {
+    llvm::Type *i8p = llvm::Type::getInt8PtrTy(*context);
+    llvm::Type *sizeTy = layout->getIntPtrType(*context);
+    vector<llvm::Type*> argTys;
+    argTys.push_back(llvm::PointerType::getUnqual(i8p));
+    argTys.push_back(i8p);
+    argTys.push_back(sizeTy);
+    argTys.push_back(sizeTy);
+    llvm::FunctionType *fnTy = llvm::FunctionType::get(llvm::Type::getVoidTy(*context), argTys, false);
+    llvm::Function *fn = llvm::Function::Create(fnTy, llvm::GlobalValue::ExternalLinkage, "glc.batch", module);
+
+    llvm::Function::arg_iterator ai = fn->arg_begin();
+    llvm::Value *columns = ai++, *out = ai++, *begin = ai++, *end = ai++;
+
+    llvm::BasicBlock *entryBB = llvm::BasicBlock::Create(*context, "entry", fn);
+    llvm::BasicBlock *loopBB = llvm::BasicBlock::Create(*context, "loop", fn);
+    llvm::BasicBlock *exitBB = llvm::BasicBlock::Create(*context, "exit", fn);
+
+    // the column base pointers are loop invariant
+    vector<llvm::Value*> bases;
+    for(size_t k = 0; k < params.size(); k++) {
+        llvm::Value *slot = llvm::GetElementPtrInst::Create(columns, llvm::ConstantInt::get(sizeTy, k), "", entryBB);
+        llvm::Value *base = new llvm::LoadInst(slot, "", entryBB);
+        bases.push_back(new llvm::BitCastInst(base, llvm::PointerType::getUnqual(InMemory(params[k].type)), "", entryBB));
+    }
+    llvm::Value *resultBase = NULL;
+    if(HasResult())
+        resultBase = new llvm::BitCastInst(out, llvm::PointerType::getUnqual(InMemory(result.type)), "", entryBB);
+
+    llvm::BasicBlock *tailBB = entryBB;
+    llvm::Value *start = begin;
+    if(wide != NULL) {
+        llvm::BasicBlock *headBB = llvm::BasicBlock::Create(*context, "lanes.head", fn, loopBB);
+        llvm::BasicBlock *lanesBB = llvm::BasicBlock::Create(*context, "lanes", fn, loopBB);
+        tailBB = llvm::BasicBlock::Create(*context, "tail", fn, loopBB);
+        LaneWidener widen(module, lanes);
+
+        llvm::PHINode *g = llvm::PHINode::Create(sizeTy, 2, "g", headBB);
+        g->addIncoming(begin, entryBB);
+        llvm::Value *next = llvm::BinaryOperator::Create(llvm::Instruction::Add, g, llvm::ConstantInt::get(sizeTy, lanes), "", headBB);
+        llvm::Value *fits = new llvm::ICmpInst(*headBB, llvm::ICmpInst::ICMP_ULE, next, end);
+        llvm::BranchInst::Create(lanesBB, tailBB, fits, headBB);
+
+        // every lane of a group is active; parameters passed by pointer
+        // point at a widened copy of the group's rows
+        vector<llvm::Value*> args(1, llvm::Constant::getAllOnesValue(widen.WideType(llvm::Type::getInt1Ty(*context))));
+        vector<llvm::Value*> rows, temps;
+        for(size_t k = 0; k < params.size(); k++) {
+            llvm::Value *row = llvm::GetElementPtrInst::Create(bases[k], g, "", lanesBB);
+            llvm::Value *v = LoadLanes(widen, row, params[k].type, lanesBB);
+            llvm::Value *temp = NULL;
+            if(entry->getFunctionType()->getParamType(k)->isPointerTy()) {
+                temp = new llvm::AllocaInst(v->getType(), "", entryBB);
+                new llvm::StoreInst(v, temp, lanesBB);
+                v = temp;
+            }
+            rows.push_back(row);
+            temps.push_back(temp);
+            args.push_back(v);
+        }
+        llvm::CallInst *call = llvm::CallInst::Create(wide, args, "", lanesBB);
+        call->setCallingConv(wide->getCallingConv());
+        for(size_t k = 0; k < params.size(); k++)
+            if(temps[k] != NULL && !entry->getAttributes().hasAttribute(k + 1, llvm::Attribute::ReadOnly))
+                StoreLanes(widen, new llvm::LoadInst(temps[k], "", lanesBB), rows[k], params[k].type, lanesBB);
+        if(resultBase != NULL)
+            StoreLanes(widen, call, llvm::GetElementPtrInst::Create(resultBase, g, "", lanesBB), result.type, lanesBB);
+        g->addIncoming(next, lanesBB);
+        llvm::BranchInst::Create(headBB, lanesBB);
+
+        llvm::BranchInst::Create(headBB, entryBB);
+        start = g;
+    }
+    llvm::Value *empty = new llvm::ICmpInst(*tailBB, llvm::ICmpInst::ICMP_UGE, start, end);
+    llvm::BranchInst::Create(exitBB, loopBB, empty, tailBB);
+
+    llvm::PHINode *i = llvm::PHINode::Create(sizeTy, 2, "i", loopBB);
+    i->addIncoming(start, tailBB);
+    vector<llvm::Value*> args;
+    for(size_t k = 0; k < params.size(); k++) {
+        llvm::Value *row = llvm::GetElementPtrInst::Create(bases[k], i, "", loopBB);
+        bool byRef = entry->getFunctionType()->getParamType(k)->isPointerTy();
+        args.push_back(byRef ? row : LoadColumn(row, params[k].type, loopBB));
+    }
+    llvm::CallInst *call = llvm::CallInst::Create(entry, args, "", loopBB);
+    call->setCallingConv(entry->getCallingConv());
+    if(resultBase != NULL)
+        StoreColumn(call, llvm::GetElementPtrInst::Create(resultBase, i, "", loopBB), loopBB);
+    llvm::Value *next = llvm::BinaryOperator::Create(llvm::Instruction::Add, i, llvm::ConstantInt::get(sizeTy, 1), "", loopBB);
+    i->addIncoming(next, loopBB);
+    llvm::Value *more = new llvm::ICmpInst(*loopBB, llvm::ICmpInst::ICMP_ULT, next, end);
+    llvm::BranchInst::Create(loopBB, exitBB, more, loopBB);
+
+    llvm::ReturnInst::Create(*context, exitBB);
+    return fn;
+}
+
+// void glc.grid(i8** columns, i8* framebuffer, i64 begin, i64 end)
+//   y = begin / W
+//   for(i = begin; i < end; i++)
+//     framebuffer[i] = entry(columns[0][0], ..., vec4(i - y * W + 0.5, y + 0.5, 0, 1))
+// Pixels begin to end lie in one row of the W-wide framebuffer. Every
+// pixel gets the single row of arguments, passed by pointer as in
+// glc.batch. With the widened entry, groups of lanes pixels come first as
+// in glc.batch.
+llvm::Function *Executor::CreateGridWrapper(llvm::Function *wide) {
+    llvm::Type *i8p = llvm::Type::getInt8PtrTy(*context);
+    llvm::Type *sizeTy = layout->getIntPtrType(*context);
+    llvm::Type *floatTy = llvm::Type::getFloatTy(*context);
+    vector<llvm::Type*> argTys;
+    argTys.push_back(llvm::PointerType::getUnqual(i8p));
+    argTys.push_back(i8p);
+    argTys.push_back(sizeTy);
+    argTys.push_back(sizeTy);
+    llvm::FunctionType *fnTy = llvm::FunctionType::get(llvm::Type::getVoidTy(*context), argTys, false);
+    llvm::Function *fn = llvm::Function::Create(fnTy, llvm::GlobalValue::ExternalLinkage, "glc.grid", module);
+
+    llvm::Function::arg_iterator ai = fn->arg_begin();
+    llvm::Value *columns = ai++, *out = ai++, *begin = ai++, *end = ai++;
+
+    llvm::BasicBlock *entryBB = llvm::BasicBlock::Create(*context, "entry", fn);
+    llvm::BasicBlock *loopBB = llvm::BasicBlock::Create(*context, "loop", fn);
+    llvm::BasicBlock *exitBB = llvm::BasicBlock::Create(*context, "exit", fn);
+
+    // the arguments are the same for every pixel
+    vector<llvm::Value*> args;
+    for(size_t k = 0; k < params.size(); k++) {
+        llvm::Value *slot = llvm::GetElementPtrInst::Create(columns, llvm::ConstantInt::get(sizeTy, k), "", entryBB);
+        llvm::Value *base = new llvm::LoadInst(slot, "", entryBB);
+        llvm::Value *row = new llvm::BitCastInst(base, llvm::PointerType::getUnqual(InMemory(params[k].type)), "", entryBB);
+        bool byRef = entry->getFunctionType()->getParamType(k)->isPointerTy();
+        args.push_back(byRef ? row : LoadColumn(row, params[k].type, entryBB));
+    }
+    llvm::Value *resultBase = new llvm::BitCastInst(out, llvm::PointerType::getUnqual(result.type), "", entryBB);
+    llvm::Value *gridW = llvm::ConstantInt::get(sizeTy, gridWidth);
+    llvm::Value *y = llvm::BinaryOperator::Create(llvm::Instruction::UDiv, begin, gridW, "y", entryBB);
+    llvm::Value *rowStart = llvm::BinaryOperator::Create(llvm::Instruction::Mul, y, gridW, "", entryBB);
+    llvm::Value *half = llvm::ConstantFP::get(floatTy, 0.5);
+    llvm::Value *fy = new llvm::UIToFPInst(y, floatTy, "", entryBB);
+    fy = llvm::BinaryOperator::Create(llvm::Instruction::FAdd, fy, half, "", entryBB);
+    llvm::Constant *zeroOne[] = { llvm::ConstantFP::get(floatTy, 0.0), llvm::ConstantFP::get(floatTy, 0.0),
+                                  llvm::ConstantFP::get(floatTy, 0.0), llvm::ConstantFP::get(floatTy, 1.0) };
+    llvm::Value *rowCoord = llvm::InsertElementInst::Create(llvm::ConstantVector::get(zeroOne), fy,
+                                                            llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context), 1), "", entryBB);
+
+    llvm::BasicBlock *tailBB = entryBB;
+    llvm::Value *start = begin;
+    if(wide != NULL) {
+        llvm::BasicBlock *headBB = llvm::BasicBlock::Create(*context, "lanes.head", fn, loopBB);
+        llvm::BasicBlock *lanesBB = llvm::BasicBlock::Create(*context, "lanes", fn, loopBB);
+        tailBB = llvm::BasicBlock::Create(*context, "tail", fn, loopBB);
+        LaneWidener widen(module, lanes);
+
+        // every lane gets the same arguments
+        vector<llvm::Value*> wideArgs(1, llvm::Constant::getAllOnesValue(widen.WideType(llvm::Type::getInt1Ty(*context))));
+        for(size_t k = 0; k < params.size(); k++) {
+            if(!entry->getFunctionType()->getParamType(k)->isPointerTy()) {
+                wideArgs.push_back(widen.Splat(args[k], entryBB));
+                continue;
+            }
+            llvm::Value *v = widen.Splat(LoadColumn(args[k], params[k].type, entryBB), entryBB);
+            llvm::Value *temp = new llvm::AllocaInst(v->getType(), "", entryBB);
+            new llvm::StoreInst(v, temp, entryBB);
+            wideArgs.push_back(temp);
+        }
+        // gl_FragCoord of the group: the lanes' x, then y, 0 and 1 for all
+        vector<llvm::Constant*> offsets, zw, all;
+        for(int l = 0; l < lanes; l++) {
+            offsets.push_back(llvm::ConstantFP::get(floatTy, l + 0.5));
+            zw.push_back(llvm::ConstantFP::get(floatTy, 0.0));
+        }
+        zw.insert(zw.end(), lanes, llvm::ConstantFP::get(floatTy, 1.0));
+        for(int c = 0; c < 4 * lanes; c++)
+            all.push_back(llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context), c));
+        llvm::Value *ys = widen.Splat(fy, entryBB);
+
+        llvm::PHINode *g = llvm::PHINode::Create(sizeTy, 2, "g", headBB);
+        g->addIncoming(begin, entryBB);
+        llvm::Value *next = llvm::BinaryOperator::Create(llvm::Instruction::Add, g, llvm::ConstantInt::get(sizeTy, lanes), "", headBB);
+        llvm::Value *fits = new llvm::ICmpInst(*headBB, llvm::ICmpInst::ICMP_ULE, next, end);
+        llvm::BranchInst::Create(lanesBB, tailBB, fits, headBB);
+
+        vector<llvm::Value*> groupArgs(wideArgs);
+        if(fragCoord) {
+            llvm::Value *x = llvm::BinaryOperator::Create(llvm::Instruction::Sub, g, rowStart, "", lanesBB);
+            llvm::Value *xs = widen.Splat(new llvm::UIToFPInst(x, floatTy, "", lanesBB), lanesBB);
+            xs = llvm::BinaryOperator::Create(llvm::Instruction::FAdd, xs, llvm::ConstantVector::get(offsets), "", lanesBB);
+            llvm::Constant *xy = llvm::ConstantVector::get(llvm::ArrayRef<llvm::Constant*>(all).slice(0, 2 * lanes));
+            llvm::Value *coord = new llvm::ShuffleVectorInst(xs, ys, xy, "", lanesBB);
+            groupArgs.push_back(new llvm::ShuffleVectorInst(coord, llvm::ConstantVector::get(zw), llvm::ConstantVector::get(all),
+                                                            "gl_FragCoord", lanesBB));
+        }
+        llvm::CallInst *call = llvm::CallInst::Create(wide, groupArgs, "", lanesBB);
+        call->setCallingConv(wide->getCallingConv());
+        StoreLanes(widen, call, llvm::GetElementPtrInst::Create(resultBase, g, "", lanesBB), result.type, lanesBB);
+        g->addIncoming(next, lanesBB);
+        llvm::BranchInst::Create(headBB, lanesBB);
+
+        llvm::BranchInst::Create(headBB, entryBB);
+        start = g;
+    }
+    llvm::Value *empty = new llvm::ICmpInst(*tailBB, llvm::ICmpInst::ICMP_UGE, start, end);
+    llvm::BranchInst::Create(exitBB, loopBB, empty, tailBB);
+
+    llvm::PHINode *i = llvm::PHINode::Create(sizeTy, 2, "i", loopBB);
+    i->addIncoming(start, tailBB);
+    llvm::Value *x = llvm::BinaryOperator::Create(llvm::Instruction::Sub, i, rowStart, "x", loopBB);
+    llvm::Value *fx = new llvm::UIToFPInst(x, floatTy, "", loopBB);
+    fx = llvm::BinaryOperator::Create(llvm::Instruction::FAdd, fx, half, "", loopBB);
+    vector<llvm::Value*> pixelArgs(args);
+    if(fragCoord)
+        pixelArgs.push_back(llvm::InsertElementInst::Create(rowCoord, fx, llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context), 0),
+                                                            "gl_FragCoord", loopBB));
+    llvm::CallInst *call = llvm::CallInst::Create(entry, pixelArgs, "", loopBB);
+    call->setCallingConv(entry->getCallingConv());
+    new llvm::StoreInst(call, llvm::GetElementPtrInst::Create(resultBase, i, "", loopBB), loopBB);
+    llvm::Value *next = llvm::BinaryOperator::Create(llvm::Instruction::Add, i, llvm::ConstantInt::get(sizeTy, 1), "", loopBB);
+    i->addIncoming(next, loopBB);
+    llvm::Value *more = new llvm::ICmpInst(*loopBB, llvm::ICmpInst::ICMP_ULT, next, end);
+    llvm::BranchInst::Create(loopBB, exitBB, more, loopBB);
+
+    llvm::ReturnInst::Create(*context, exitBB);
+    return fn;
+}
+
+// The entry as glc -flanes widened it to width lanes, or NULL with
+// laneNote saying why there is none: the reason glc gave in glc.lanes, or
+// how the module was compiled
+llvm::Function *Executor::GetLaneEntry(int width) {
+    char buf[64];
+    llvm::Function *wide = module->getFunction(entryName + ".lanes");
+    if(wide != NULL && !wide->isDeclaration() && wide->getFunctionType()->getNumParams() > 0
+       && wide->getFunctionType()->getParamType(0)->isVectorTy()) {
+        unsigned compiled = wide->getFunctionType()->getParamType(0)->getVectorNumElements();
+        if(compiled == (unsigned)width)
+            return wide;
+        snprintf(buf, sizeof buf, "it was compiled for %u lanes", compiled);
+        laneNote = buf;
+        return NULL;
+    }
+    snprintf(buf, sizeof buf, "it was compiled without glc -flanes=%d", width);
+    laneNote = buf;
+    llvm::GlobalVariable *notes = module->getGlobalVariable("glc.lanes");
+    llvm::ConstantDataSequential *text = notes == NULL ? NULL
+        : llvm::dyn_cast_or_null<llvm::ConstantDataSequential>(notes->getInitializer());
+    if(text == NULL || !text->isCString())
+        return NULL;
+    // one "<function>: <reason>" line per function glc could not widen
+    string all = text->getAsCString().str(), prefix = entryName + ": ";
+    for(size_t at = 0; at < all.size(); ) {
+        size_t eol = all.find('\n', at);
+        if(eol == string::npos)
+            eol = all.size();
+        if(all.compare(at, prefix.size(), prefix) == 0) {
+            laneNote = "it " + all.substr(at + prefix.size(), eol - at - prefix.size());
+            break;
+        }
+        at = eol + 1;
+    }
+    return NULL;
+}
+
+// The widened code keeps its variables in memory and merges every masked
+// store with a select; the usual cleanup turns that into registers. The
+// vectorizers stay off, the lanes being explicit already.
+void Executor::Optimize() {
+    llvm::PassManager pm;
+    pm.add(new llvm::DataLayout(*layout));
+    engine->getTargetMachine()->addAnalysisPasses(pm);
+    llvm::PassManagerBuilder builder;
+    builder.OptLevel = 3;
+    builder.LoopVectorize = false;
+    builder.SLPVectorize = false;
+    builder.populateModulePassManager(pm);
+    pm.run(*module);
+}
+
+void Executor::SetGrid(int width, int height) {
+    gridWidth = width;
+    gridHeight = height;
+}
+
+bool Executor::Compile(int width) {
+    entry = module->getFunction(entryName);
+    if(entry == NULL || entry->isDeclaration() || entry->hasLocalLinkage()) {
+        fprintf(stderr, "glc-exec: module has no entry function %s\n", entryName.c_str());
+        return false;
+    }
+    llvm::FunctionType *fnTy = entry->getFunctionType();
+    // glc appends gl_FragCoord to the parameters of a shader that reads it
+    llvm::Function::arg_iterator last = entry->arg_begin();
+    for(unsigned k = 1; k < fnTy->getNumParams(); k++)
+        last++;
+    fragCoord = fnTy->getNumParams() > 0 && last->getName() == "gl_FragCoord";
+    if(fragCoord && gridWidth == 0) {
+        fprintf(stderr, "glc-exec: %s reads gl_FragCoord; run it with -fgrid\n", entryName.c_str());
+        return false;
+    }
+    unsigned numParams = fnTy->getNumParams() - (fragCoord ? 1 : 0);
+    if(numParams != datParams.size()) {
+        fprintf(stderr, "glc-exec: %s takes %u arguments, .dat gives %u\n", entryName.c_str(),
+                numParams, (unsigned)datParams.size());
+        return false;
+    }
+
+    // an instrumented module calls the profile hooks
+    if(llvm::GlobalVariable *names = module->getGlobalVariable("glc.prof.names")) {
+        llvm::ConstantDataSequential *text = llvm::dyn_cast_or_null<llvm::ConstantDataSequential>(names->getInitializer());
+        if(text == NULL || !text->isCString()) {
+            fprintf(stderr, "glc-exec: malformed glc.prof.names\n");
+            return false;
+        }
+        if(!Profile::Load(text->getAsCString().str()))
+            return false;
+    }
+
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    string err;
+    engine = llvm::EngineBuilder(module).setUseMCJIT(true).setErrorStr(&err)
+                 .setOptLevel(llvm::CodeGenOpt::Aggressive).create();
+    if(engine == NULL) {
+        fprintf(stderr, "glc-exec: %s\n", err.c_str());
+        return false;
+    }
+    if(llvm::JITEventListener *listener = PerfMap::Listener())
+        engine->RegisterJITEventListener(listener);
+    layout = engine->getDataLayout();
+    module->setDataLayout(layout->getStringRepresentation());
+
+    for(unsigned k = 0; k < numParams; k++) {
+        Column col;
+        col.type = fnTy->getParamType(k);
+        if(col.type->isPointerTy())
+            col.type = col.type->getPointerElementType();
+        if(!GetShape(col.type, col.shape) || col.shape.NumScalars() != datParams[k].size()) {
+            fprintf(stderr, "glc-exec: argument %u of %s does not match the .dat\n", k + 1, entryName.c_str());
+            return false;
+        }
+        if(fnTy->getParamType(k)->isPointerTy() && InMemory(col.type) != col.type) {
+            fprintf(stderr, "glc-exec: argument %u of %s is a bool vector passed by reference, which is not supported\n",
+                    k + 1, entryName.c_str());
+            return false;
+        }
+        params.push_back(col);
+    }
+    if(!fnTy->getReturnType()->isVoidTy()) {
+        result.type = fnTy->getReturnType();
+        if(!GetShape(result.type, result.shape)) {
+            fprintf(stderr, "glc-exec: unsupported return type of %s\n", entryName.c_str());
+            return false;
+        }
+    }
+    if(gridWidth > 0) {
+        if(!HasResult() || !(result.shape == ColumnShape::Make(FloatScalar, 4, 1))) {
+            fprintf(stderr, "glc-exec: %s must return a vec4 to shade a grid\n", entryName.c_str());
+            return false;
+        }
+        // every pixel shares the arguments, so none may be written
+        for(unsigned k = 0; k < numParams; k++)
+            if(fnTy->getParamType(k)->isPointerTy() && !entry->getAttributes().hasAttribute(k + 1, llvm::Attribute::ReadOnly)) {
+                fprintf(stderr, "glc-exec: argument %u of %s is an out parameter, which a grid cannot have\n", k + 1, entryName.c_str());
+                return false;
+            }
+    }
+
+    for(llvm::Module::iterator f = module->begin(); f != module->end(); ++f)
+        for(llvm::Function::iterator bb = f->begin(); bb != f->end(); ++bb)
+            for(llvm::BasicBlock::iterator it = bb->begin(); it != bb->end(); ++it)
+                if(llvm::StoreInst *st = llvm::dyn_cast<llvm::StoreInst>(it))
+                    if(llvm::isa<llvm::GlobalVariable>(llvm::GetUnderlyingObject(st->getPointerOperand(), layout)))
+                        writesGlobals = true;
+    llvm::Function *wide = width > 1 ? GetLaneEntry(width) : NULL;
+    if(wide != NULL)
+        lanes = width;
+    llvm::Function *fn = gridWidth > 0 ? CreateGridWrapper(wide) : CreateBatchWrapper(wide);
+    if(wide != NULL)
+        Optimize();
+    engine->finalizeObject();
+    batch = (BatchFn)engine->getFunctionAddress(fn->getName().str());
+    return batch != NULL && SetGlobals();
+}
+
+// Where the JIT keeps a global, or NULL if the module has no such global;
+// an unused global may have been left out. Sets ok to false on an error.
+char *Executor::GetGlobal(const char *name, ColumnShape &shape, bool &ok) {
+    llvm::GlobalVariable *gv = module->getGlobalVariable(name);
+    if(gv == NULL)
+        return NULL;
+    char *addr = (char*)engine->getGlobalValueAddress(name);
+    if(!GetShape(gv->getType()->getElementType(), shape)) {
+        fprintf(stderr, "glc-exec: unsupported type of global %s\n", name);
+        ok = false;
+    }
+    else if(addr == NULL) {
+        fprintf(stderr, "glc-exec: global %s is not visible; compile with -fdat\n", name);
+        ok = false;
+    }
+    return ok ? addr : NULL;
+}
+
+bool Executor::SetGlobals() {
+    bool ok = true;
+    for(size_t i = 0; ok && i < datGlobals.size(); i++) {
+        const char *name = datGlobals[i].first.c_str();
+        ColumnShape shape;
+        char *addr = GetGlobal(name, shape, ok);
+        if(addr == NULL)
+            continue;
+        if(shape.NumScalars() != datGlobals[i].second.size()) {
+            fprintf(stderr, "glc-exec: global %s does not match the .dat\n", name);
+            return false;
+        }
+        shape.Store(&datGlobals[i].second[0], addr);
+    }
+    return ok;
+}
+
+bool Executor::Adopt(Executor &fresh) {
+    bool same = fresh.params.size() == params.size() && fresh.HasResult() == HasResult()
+                && (!HasResult() || fresh.result.shape == result.shape);
+    for(size_t k = 0; same && k < params.size(); k++)
+        same = fresh.params[k].shape == params[k].shape;
+    if(!same) {
+        fprintf(stderr, "glc-exec: %s no longer matches the inputs; the running version stays\n", entryName.c_str());
+        return false;
+    }
+    if(fresh.writesGlobals && !writesGlobals) {
+        fprintf(stderr, "glc-exec: %s now writes globals; the running version stays\n", entryName.c_str());
+        return false;
+    }
+
+    // globals carry over, so values from a column file or written by
+    // earlier runs survive the swap
+    for(llvm::Module::global_iterator g = module->global_begin(); g != module->global_end(); ++g) {
+        llvm::GlobalVariable *other = fresh.module->getGlobalVariable(g->getName(), true);
+        ColumnShape shape, otherShape;
+        if(other == NULL || g->isConstant() || !GetShape(g->getType()->getElementType(), shape)
+           || !fresh.GetShape(other->getType()->getElementType(), otherShape) || !(shape == otherShape))
+            continue;
+        char *from = (char*)engine->getGlobalValueAddress(g->getName().str());
+        char *to = (char*)fresh.engine->getGlobalValueAddress(other->getName().str());
+        if(from != NULL && to != NULL)
+            memcpy(to, from, shape.stride);
+    }
+
+    std::swap(context, fresh.context);
+    std::swap(module, fresh.module);
+    std::swap(engine, fresh.engine);
+    std::swap(layout, fresh.layout);
+    std::swap(entry, fresh.entry);
+    std::swap(batch, fresh.batch);
+    std::swap(lanes, fresh.lanes);
+    std::swap(laneNote, fresh.laneNote);
+    std::swap(fragCoord, fresh.fragCoord);
+    for(size_t k = 0; k < params.size(); k++)
+        std::swap(params[k].type, fresh.params[k].type);
+    std::swap(result.type, fresh.result.type);
+    return true;
+}
+
+static char *AlignedAlloc(size_t size) {
+    void *p = NULL;
+    if(posix_memalign(&p, ColumnAlign, size ? size : ColumnAlign) != 0) {
+        fprintf(stderr, "glc-exec: out of memory\n");
+        exit(2);
+    }
+    return (char*)p;
+}
+
+void Executor::Release() {
+    for(size_t k = 0; k < params.size(); k++) {
+        if(params[k].owned)
+            free(params[k].data);
+        params[k].data = NULL;
+    }
+    if(result.owned)
+        free(result.data);
+    result.data = NULL;
+    paramData.clear();
+    delete inputFile;
+    delete resultFile;
+    inputFile = resultFile = NULL;
+    count = 0;
+}
+
+void Executor::Allocate(size_t n) {
+    Release();
+    for(size_t k = 0; k < params.size(); k++) {
+        params[k].data = AlignedAlloc(n * params[k].shape.stride);
+        params[k].owned = true;
+        paramData.push_back(params[k].data);
+    }
+    // in grid mode the results are the framebuffer
+    if(HasResult()) {
+        size_t rows = gridWidth > 0 ? (size_t)gridWidth * gridHeight : n;
+        result.data = AlignedAlloc(rows * result.shape.stride);
+        result.owned = true;
+    }
+    count = n;
+}
+
+bool Executor::Replicate(size_t n) {
+    Allocate(n);
+    for(size_t k = 0; k < params.size(); k++) {
+        if(n == 0)
+            break;
+        params[k].shape.Store(&datParams[k][0], params[k].Row(0));
+        for(size_t i = 1; i < n; i++)
+            memcpy(params[k].Row(i), params[k].Row(0), params[k].shape.stride);
+    }
+    return true;
+}
+
+bool Executor::ReadInputs(const char *path, size_t n) {
+    FILE *f = strcmp(path, "-") ? fopen(path, "r") : stdin;
+    if(f == NULL) {
+        fprintf(stderr, "glc-exec: cannot open %s\n", path);
+        return false;
+    }
+    size_t width = 0;
+    for(size_t k = 0; k < params.size(); k++)
+        width += params[k].shape.NumScalars();
+
+    vector<vector<double> > records;
+    char line[4096];
+    int lineno = 0;
+    while(fgets(line, sizeof(line), f) != NULL) {
+        lineno++;
+        if(line[strspn(line, " \t\r\n")] == '\0' || line[0] == '#')
+            continue;
+        vector<double> vals;
+        if(!ColumnFile::ParseValues(line, vals) || vals.size() != width) {
+            fprintf(stderr, "glc-exec: %s:%d: expected %u values\n", path, lineno, (unsigned)width);
+            if(f != stdin)
+                fclose(f);
+            return false;
+        }
+        records.push_back(vals);
+    }
+    if(f != stdin)
+        fclose(f);
+    if(records.empty()) {
+        fprintf(stderr, "glc-exec: %s has no records\n", path);
+        return false;
+    }
+
+    // with -fn the records are repeated to fill n invocations
+    if(n == 0)
+        n = records.size();
+    Allocate(n);
+    for(size_t i = 0; i < n; i++) {
+        const double *vals = &records[i % records.size()][0];
+        for(size_t k = 0; k < params.size(); k++) {
+            params[k].shape.Store(vals, params[k].Row(i));
+            vals += params[k].shape.NumScalars();
+        }
+    }
+    return true;
+}
+
+// Parameter k is the file's column "param<k>", which must have the layout
+// the compiled code expects. Globals in the file override the .dat.
+bool Executor::MapInputs(const char *path, size_t n) {
+    ColumnFile *file = new ColumnFile();
+    if(!file->Open(path)) {
+        delete file;
+        return false;
+    }
+    const ColumnFileHeader *h = file->GetHeader();
+    if(strncmp(h->entry, entryName.c_str(), sizeof(h->entry))) {
+        fprintf(stderr, "glc-exec: %s is for %.*s, not %s\n", path, (int)sizeof(h->entry), h->entry, entryName.c_str());
+        delete file;
+        return false;
+    }
+    Release();
+    inputFile = file;
+    count = n != 0 && n < h->rows ? n : h->rows;
+    for(size_t k = 0; k < params.size(); k++) {
+        char name[16];
+        sprintf(name, "param%u", (unsigned)k);
+        int i = file->Find(ParamColumn, name);
+        if(i < 0 || !(file->GetDesc(i).shape == params[k].shape) || file->GetDesc(i).rows < count) {
+            fprintf(stderr, "glc-exec: %s: %s is missing or does not match argument %u\n", path, name, (unsigned)k + 1);
+            return false;
+        }
+        params[k].data = file->GetData(i);
+        params[k].owned = false;
+        paramData.push_back(params[k].data);
+    }
+    bool ok = true;
+    for(int i = 0; ok && i < file->NumColumns(); i++) {
+        const ColumnDesc &d = file->GetDesc(i);
+        if(d.kind != GlobalColumn || d.rows < 1)
+            continue;
+        string name(d.name, strnlen(d.name, sizeof(d.name)));
+        ColumnShape shape;
+        char *addr = GetGlobal(name.c_str(), shape, ok);
+        if(addr != NULL && !(shape == d.shape)) {
+            fprintf(stderr, "glc-exec: %s: global %s does not match the module\n", path, name.c_str());
+            ok = false;
+        }
+        else if(addr != NULL)
+            memcpy(addr, file->GetData(i), shape.stride);
+    }
+    if(ok && HasResult()) {
+        result.data = AlignedAlloc(count * result.shape.stride);
+        result.owned = true;
+    }
+    return ok;
+}
+
+// Results go straight into a mapped column file of the same format
+bool Executor::MapResult(const char *path) {
+    if(!HasResult()) {
+        fprintf(stderr, "glc-exec: %s returns nothing\n", entryName.c_str());
+        return false;
+    }
+    ColumnDesc d;
+    memset(&d, 0, sizeof(d));
+    strcpy(d.name, "result");
+    d.kind = ResultColumn;
+    d.shape = result.shape;
+    d.rows = count;
+    vector<ColumnDesc> cols(1, d);
+    ColumnFile *file = new ColumnFile();
+    if(!file->Create(path, entryName.c_str(), count, cols)) {
+        delete file;
+        return false;
+    }
+    if(result.owned)
+        free(result.data);
+    delete resultFile;
+    resultFile = file;
+    result.data = file->GetData(0);
+    result.owned = false;
+    return true;
+}
+
+struct BatchRun {
+    void (*batch)(char **columns, char *result, size_t begin, size_t end);
+    char **columns;
+    char  *results;
+};
+
+static void RunChunk(void *arg, size_t begin, size_t end) {
+    BatchRun *run = (BatchRun*)arg;
+    run->batch(run->columns, run->results, begin, end);
+}
+
+double Executor::Run(Scheduler &sched, char **columns, char *results, size_t n) {
+    BatchRun run = { batch, columns, results };
+    return sched.Run(n, RunChunk, &run);
+}
+
+double Executor::Run(Scheduler &sched) {
+    return Run(sched, paramData.empty() ? NULL : &paramData[0], result.data, count);
+}
+
+struct GridRun {
+    void (*batch)(char **columns, char *result, size_t begin, size_t end);
+    char **columns;
+    char  *framebuffer;
+    size_t width, height, tile, across;
+};
+
+// Tiles are numbered across each band of rows in turn, so neighbouring
+// tiles go to the same worker while the static split lasts
+static void RunTiles(void *arg, size_t begin, size_t end) {
+    GridRun *run = (GridRun*)arg;
+    for(size_t t = begin; t < end; t++) {
+        size_t x0 = t % run->across * run->tile, y0 = t / run->across * run->tile;
+        size_t x1 = x0 + run->tile < run->width ? x0 + run->tile : run->width;
+        size_t y1 = y0 + run->tile < run->height ? y0 + run->tile : run->height;
+        for(size_t y = y0; y < y1; y++)
+            run->batch(run->columns, run->framebuffer, y * run->width + x0, y * run->width + x1);
+    }
+}
+
+double Executor::RunGrid(Scheduler &sched, int tile) {
+    size_t t = tile < 1 ? 1 : tile;
+    GridRun run = { batch, paramData.empty() ? NULL : &paramData[0], result.data,
+                    (size_t)gridWidth, (size_t)gridHeight, t, (gridWidth + t - 1) / t };
+    size_t tiles = run.across * ((gridHeight + t - 1) / t);
+    return sched.Run(tiles, RunTiles, &run);
+}
+
+bool Executor::WriteImage(const char *path) const {
+    FILE *f = fopen(path, "wb");
+    if(f == NULL) {
+        fprintf(stderr, "glc-exec: cannot write %s\n", path);
+        return false;
+    }
+    size_t len = strlen(path);
+    bool ppm = len > 4 && !strcmp(path + len - 4, ".ppm");
+    if(ppm)
+        fprintf(f, "P6\n%d %d\n255\n", gridWidth, gridHeight);
+    vector<unsigned char> rgb(3 * gridWidth);
+    // gl_FragCoord counts rows from the bottom, images from the top
+    for(int y = gridHeight - 1; y >= 0; y--) {
+        const float *row = (const float*)result.Row((size_t)y * gridWidth);
+        if(!ppm) {
+            fwrite(row, 4 * sizeof(float), gridWidth, f);
+            continue;
+        }
+        for(int x = 0; x < gridWidth; x++)
+            for(int c = 0; c < 3; c++) {
+                float v = row[4 * x + c];
+                rgb[3 * x + c] = (unsigned char)(v <= 0 ? 0 : v >= 1 ? 255 : v * 255 + 0.5f);
+            }
+        fwrite(&rgb[0], 3, gridWidth, f);
+    }
+    bool ok = !ferror(f);
+    if(fclose(f) != 0 || !ok) {
+        fprintf(stderr, "glc-exec: cannot write %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+void Executor::PrintResults(FILE *f) const {
+    if(!HasResult())
+        return;
+    for(size_t i = 0; i < count; i++) {
+        fprintf(f, "Result:");
+        result.shape.Print(f, result.Row(i));
+        fprintf(f, "\n");
+    }
+}
@@ -0,0 +1,167 @@
+/**
+ * File: executor.h
+ * ----------------
+ *  This file defines the batch executor behind glc-exec. It JIT-compiles
+ *  a module written by glc and calls one entry function over many
+ *  invocations, spread across threads.
+ *
+ *  Inputs are columns: one packed array per parameter, holding that
+ *  parameter for every invocation. Results go to one more column. A
+ *  generated wrapper, glc.batch, loads a range of rows from the columns,
+ *  calls the entry function and stores each result, so the loop over
+ *  invocations runs in compiled code rather than in the executor.
+ *
+ *  In lane mode the wrapper calls <entry>.lanes, the entry as glc -flanes
+ *  widened it (see lanes.h), on a group of invocations at a time, one per
+ *  SIMD lane, and the plain entry only on the rows left over.
+ *
+ *  In grid mode the entry is a per-pixel shader instead. A second wrapper,
+ *  glc.grid, calls it across a span of one framebuffer row with the .dat
+ *  arguments and the pixel's centre as gl_FragCoord, and stores the vec4
+ *  it returns in the framebuffer. Work is handed to threads in square
+ *  tiles, small enough that a tile's pixels stay in cache.
+ */
+
+#ifndef _H_Executor
+#define _H_Executor
+
+#include <stdio.h>
+#include <vector>
+#include <string>
+#include "llvm/IR/Module.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/DataLayout.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/ExecutionEngine/ExecutionEngine.h"
+#include "scheduler.h"
+#include "columns.h"
+#include "lanes.h"
+
+using namespace std;
+
+// One packed array of values of a single type, 64-byte aligned. The data
+// is either the executor's own or part of a mapped column file.
+struct Column {
+    llvm::Type *type;
+    ColumnShape shape;
+    char       *data;
+    bool        owned;
+
+    Column() : type(NULL), data(NULL), owned(false) {}
+    char *Row(size_t i) const { return data + i * shape.stride; }
+};
+
+class Executor {
+  public:
+    Executor();
+    ~Executor();
+
+    // The module written by glc, and the .dat naming its entry function,
+    // the entry's arguments and the globals to set before a batch
+    bool LoadModule(const char *path);
+    bool LoadDat(const char *path);
+
+    // Takes over the compiled code of fresh, a recompile of the same shader
+    // in the same mode, keeping this executor's inputs and the values of
+    // the globals the two modules share; fresh is left with the old code.
+    // False, changing neither, if the entry's arguments or result differ.
+    // Call only between runs.
+    bool Adopt(Executor &fresh);
+
+    // Switches to grid mode over a width x height framebuffer; call before
+    // Compile
+    void SetGrid(int width, int height);
+
+    // JIT-compiles the module along with the glc.batch wrapper (glc.grid in
+    // grid mode); lanes > 1 asks for that many invocations per call of the
+    // widened entry
+    bool Compile(int lanes);
+
+    // Invocation inputs: n copies of the .dat arguments, one record per
+    // line of a text file (values of all parameters in order), or the
+    // columns of a column file, used in place
+    bool Replicate(size_t n);
+    bool ReadInputs(const char *path, size_t n);
+    bool MapInputs(const char *path, size_t n);
+
+    // Sends results to a column file rather than to memory of our own
+    bool MapResult(const char *path);
+
+    // Runs every invocation and returns the wall time in seconds, or runs
+    // n invocations from columns of the caller's
+    double Run(Scheduler &sched);
+    double Run(Scheduler &sched, char **columns, char *results, size_t n);
+
+    // Shades every pixel of the grid in tiles of tile x tile pixels and
+    // returns the wall time in seconds
+    double RunGrid(Scheduler &sched, int tile);
+
+    // The framebuffer, top row first, as a binary PPM (.ppm) with each
+    // channel clamped to [0, 1], or else as raw RGBA floats
+    bool WriteImage(const char *path) const;
+
+    void PrintResults(FILE *f) const;
+    size_t NumInvocations() const { return count; }
+    bool HasResult() const { return result.type != NULL; }
+    size_t NumParams() const { return params.size(); }
+    const ColumnShape &GetParamShape(size_t k) const { return params[k].shape; }
+    const ColumnShape &GetResultShape() const { return result.shape; }
+    const char *GetEntryName() const { return entryName.c_str(); }
+
+    // Invocations per iteration of the compiled loop: 1 unless lane mode
+    // was asked for and glc -flanes widened the entry to that width;
+    // otherwise GetLaneNote says why not
+    int GetLanes() const { return lanes; }
+    const char *GetLaneNote() const { return laneNote.c_str(); }
+    int GetGridWidth() const { return gridWidth; }
+    int GetGridHeight() const { return gridHeight; }
+
+    // A shader that stores to a global is not safe to run on several
+    // threads at once
+    bool WritesGlobals() const { return writesGlobals; }
+
+    static double Now();
+
+  private:
+    typedef void (*BatchFn)(char **columns, char *result, size_t begin, size_t end);
+
+    llvm::LLVMContext      *context;
+    llvm::Module           *module;
+    llvm::ExecutionEngine  *engine;
+    const llvm::DataLayout *layout;
+    llvm::Function         *entry;
+    BatchFn                 batch;
+    bool                    writesGlobals;
+    int                     lanes;
+    int                     gridWidth, gridHeight;
+    bool                    fragCoord;  // the entry takes gl_FragCoord
+    ColumnFile             *inputFile;
+    ColumnFile             *resultFile;
+
+    string                  entryName;
+    string                  laneNote;
+    vector<vector<double> > datParams;
+    vector<pair<string, vector<double> > > datGlobals;
+
+    vector<Column>          params;
+    vector<char*>           paramData;
+    Column                  result;
+    size_t                  count;
+
+    llvm::Function *CreateBatchWrapper(llvm::Function *wide);
+    llvm::Function *CreateGridWrapper(llvm::Function *wide);
+    llvm::Function *GetLaneEntry(int width);
+    void Optimize();
+    bool SetGlobals();
+    char *GetGlobal(const char *name, ColumnShape &shape, bool &ok);
+    bool GetShape(llvm::Type *ty, ColumnShape &shape) const;
+    llvm::Type *InMemory(llvm::Type *ty) const;
+    llvm::Value *LoadColumn(llvm::Value *row, llvm::Type *ty, llvm::BasicBlock *bb) const;
+    void StoreColumn(llvm::Value *v, llvm::Value *row, llvm::BasicBlock *bb) const;
+    llvm::Value *LoadLanes(LaneWidener &widen, llvm::Value *row, llvm::Type *ty, llvm::BasicBlock *bb) const;
+    void StoreLanes(LaneWidener &widen, llvm::Value *v, llvm::Value *row, llvm::Type *ty, llvm::BasicBlock *bb) const;
+    void Allocate(size_t n);
+    void Release();
+};
+
+#endif
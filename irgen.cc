@@ -4,16 +4,32 @@
  */
 
 #include "irgen.h"
+#include "lanes.h"
+#include "utility.h"
+#include "llvm/PassManager.h"
+#include "llvm/Transforms/IPO.h"
+#include <algorithm>
 
 IRGenerator::IRGenerator() :
     context(NULL),
     module(NULL),
     currentFunc(NULL),
-    currentBB(NULL)
+    currentBB(NULL),
+    trapBB(NULL),
+    fastMath(0),
+    profFunctions(0),
+    profSites(0),
+    profId(-1),
+    profCounters(0),
+    profBranch(0),
+    profileLoaded(false),
+    entriesLoaded(false),
+    laneWidth(0),
+    laneMask(NULL),
+    laneLive(NULL),
+    laneResult(NULL),
+    laneEntry(NULL)
 {
-    fbs = new stack<llvm::BasicBlock*>;
-    cbs = new stack<llvm::BasicBlock*>;
-    lbs = new stack<llvm::BasicBlock*>;
 }
 
 IRGenerator::~IRGenerator() {
@@ -46,6 +62,824 @@ llvm::BasicBlock *IRGenerator::GetBasicBlock() const {
    return currentBB;
 }
 
+llvm::BasicBlock *IRGenerator::CreateBlock(const char *name) {
+   return llvm::BasicBlock::Create(*context, name);
+}
+
+void IRGenerator::EmitBlock(llvm::BasicBlock *bb, bool seal) {
+   if(currentBB != NULL && currentBB->getTerminator() == NULL) {
+      // an empty block that would only fall through is replaced by bb
+      if(currentBB->empty() && currentBB != &currentFunc->getEntryBlock() &&
+         currentDef[currentBB].empty()) {
+         currentDef.erase(currentBB);
+         sealedBlocks.erase(currentBB);
+         currentBB->replaceAllUsesWith(bb);
+         currentBB->eraseFromParent();
+      }
+      else
+         llvm::BranchInst::Create(bb, currentBB);
+   }
+   currentBB = NULL;
+
+   if(pred_begin(bb) == pred_end(bb)) {
+      delete bb;
+      return;
+   }
+   currentFunc->getBasicBlockList().push_back(bb);
+   currentBB = bb;
+   if(seal)
+      SealBlock(bb);
+}
+
+void IRGenerator::SealBlock(llvm::BasicBlock *bb) {
+   // reads while filling in the phis see bb as sealed, so they can no
+   // longer add to the list being processed
+   vector<pair<llvm::Value*, llvm::PHINode*> > phis = incompletePhis[bb];
+   incompletePhis.erase(bb);
+   sealedBlocks.insert(bb);
+   for(size_t i = 0; i < phis.size(); i++)
+      AddPhiOperands(phis[i].first, phis[i].second);
+}
+
+void IRGenerator::BeginFunction(llvm::Function *func) {
+   currentFunc = func;
+   currentBB = llvm::BasicBlock::Create(*context, "entry", func);
+   SealBlock(currentBB);
+   fastMath = GetDefaultFastMath();
+   profBranch = 0;
+}
+
+void IRGenerator::EndFunction() {
+   if(fastMath != 0)
+      ApplyFastMath(currentFunc);
+   currentDef.clear();
+   sealedBlocks.clear();
+   incompletePhis.clear();
+   for(set<llvm::Value*>::iterator it = registerVars.begin(); it != registerVars.end(); it++) {
+      if((*it)->use_empty())
+         delete llvm::cast<llvm::Instruction>(*it);
+   }
+   registerVars.clear();
+   copyOuts.clear();
+   currentBB = NULL;
+   trapBB = NULL;
+}
+
+llvm::Value *IRGenerator::CreateRegister(llvm::Type *ty, const char *name) {
+   llvm::AllocaInst *key = new llvm::AllocaInst(ty, name);
+   registerVars.insert(key);
+   return key;
+}
+
+llvm::Value *IRGenerator::CreateLocal(llvm::Type *ty, const char *name, bool promotable) {
+   if(promotable && IsOptionOn("ssa"))
+      return CreateRegister(ty, name);
+   // at the top of the entry block, so locals in loops do not grow the stack
+   llvm::BasicBlock &entry = currentFunc->getEntryBlock();
+   if(entry.empty())
+      return new llvm::AllocaInst(ty, name, &entry);
+   return new llvm::AllocaInst(ty, name, &entry.front());
+}
+
+bool IRGenerator::IsRegisterVariable(llvm::Value *addr) const {
+   return registerVars.count(addr) != 0;
+}
+
+llvm::Value *IRGenerator::CreateLoad(llvm::Value *addr, const char *name) {
+   if(IsRegisterVariable(addr))
+      return ReadVariable(addr, currentBB);
+   return new llvm::LoadInst(addr, name, currentBB);
+}
+
+llvm::Value *IRGenerator::CreateStore(llvm::Value *val, llvm::Value *addr) {
+   // in a lane variant the invocations outside the mask keep the old value
+   if(InLanes()) {
+      llvm::Value *mask = GetLaneMask();
+      if(llvm::ConstantInt *c = llvm::dyn_cast<llvm::ConstantInt>(mask)) {
+         if(c->isZero())
+            return val;
+      }
+      else
+         val = llvm::SelectInst::Create(mask, val, CreateLoad(addr), "", currentBB);
+   }
+   if(IsRegisterVariable(addr)) {
+      WriteVariable(addr, currentBB, val);
+      return val;
+   }
+   return new llvm::StoreInst(val, addr, currentBB);
+}
+
+void IRGenerator::WriteVariable(llvm::Value *var, llvm::BasicBlock *bb, llvm::Value *val) {
+   currentDef[bb][var] = val;
+}
+
+llvm::Value *IRGenerator::ReadVariable(llvm::Value *var, llvm::BasicBlock *bb) {
+   DefMap &defs = currentDef[bb];
+   DefMap::iterator it = defs.find(var);
+   if(it != defs.end() && (llvm::Value*)it->second != NULL)
+      return it->second;
+   return ReadVariableRecursive(var, bb);
+}
+
+llvm::Value *IRGenerator::ReadVariableRecursive(llvm::Value *var, llvm::BasicBlock *bb) {
+   llvm::Type *ty = llvm::cast<llvm::AllocaInst>(var)->getAllocatedType();
+   llvm::Value *val;
+   if(sealedBlocks.count(bb) == 0) {
+      // more predecessors may still appear: operands are added on sealing
+      llvm::Instruction *first = bb->getFirstNonPHI();
+      llvm::PHINode *phi = first ? llvm::PHINode::Create(ty, 0, var->getName(), first)
+                                 : llvm::PHINode::Create(ty, 0, var->getName(), bb);
+      incompletePhis[bb].push_back(make_pair(var, phi));
+      val = phi;
+   }
+   else if(bb->getSinglePredecessor() != NULL)
+      val = ReadVariable(var, bb->getSinglePredecessor());
+   else if(pred_begin(bb) == pred_end(bb))
+      val = llvm::UndefValue::get(ty);
+   else {
+      // the phi is recorded first to break cycles through loops
+      llvm::Instruction *first = bb->getFirstNonPHI();
+      llvm::PHINode *phi = first ? llvm::PHINode::Create(ty, 0, var->getName(), first)
+                                 : llvm::PHINode::Create(ty, 0, var->getName(), bb);
+      WriteVariable(var, bb, phi);
+      val = AddPhiOperands(var, phi);
+   }
+   WriteVariable(var, bb, val);
+   return val;
+}
+
+llvm::Value *IRGenerator::AddPhiOperands(llvm::Value *var, llvm::PHINode *phi) {
+   llvm::BasicBlock *bb = phi->getParent();
+   for(llvm::pred_iterator p = pred_begin(bb); p != pred_end(bb); p++)
+      phi->addIncoming(ReadVariable(var, *p), *p);
+   return TryRemoveTrivialPhi(phi);
+}
+
+llvm::Value *IRGenerator::TryRemoveTrivialPhi(llvm::PHINode *phi) {
+   llvm::Value *same = NULL;
+   for(unsigned i = 0; i < phi->getNumIncomingValues(); i++) {
+      llvm::Value *op = phi->getIncomingValue(i);
+      if(op == same || op == phi)
+         continue;
+      if(same != NULL)
+         return phi;
+      same = op;
+   }
+   if(same == NULL)
+      same = llvm::UndefValue::get(phi->getType());
+
+   // phis using this one may become trivial in turn; the handles follow
+   // them if an earlier removal replaces or deletes them
+   vector<llvm::WeakVH> users;
+   for(llvm::Value::use_iterator u = phi->use_begin(); u != phi->use_end(); u++) {
+      if(*u != phi && llvm::isa<llvm::PHINode>(*u))
+         users.push_back(*u);
+   }
+   phi->replaceAllUsesWith(same);
+   phi->eraseFromParent();
+   for(size_t i = 0; i < users.size(); i++) {
+      if(llvm::PHINode *p = llvm::dyn_cast_or_null<llvm::PHINode>((llvm::Value*)users[i]))
+         TryRemoveTrivialPhi(p);
+   }
+   return same;
+}
+
+llvm::BranchInst *IRGenerator::EmitBranch(llvm::BasicBlock *target) {
+   llvm::BranchInst *br = NULL;
+   if(currentBB != NULL)
+      br = llvm::BranchInst::Create(target, currentBB);
+   currentBB = NULL;
+   return br;
+}
+
+llvm::BranchInst *IRGenerator::EmitCondBranch(llvm::Value *cond, llvm::BasicBlock *ifTrue, llvm::BasicBlock *ifFalse) {
+   if(currentBB == NULL)
+      return NULL;
+   if(llvm::ConstantInt *c = llvm::dyn_cast<llvm::ConstantInt>(cond))
+      return EmitBranch(c->isZero() ? ifFalse : ifTrue);
+   llvm::BranchInst *br = llvm::BranchInst::Create(ifTrue, ifFalse, cond, currentBB);
+   currentBB = NULL;
+   return br;
+}
+
+void IRGenerator::SetLoopHints(llvm::Instruction *latch, vector<pair<const char*, int> > &hints) {
+   if(latch == NULL || hints.empty())
+      return;
+   // a loop id is distinct because its first operand refers to itself
+   llvm::MDNode *temp = llvm::MDNode::getTemporary(*context, llvm::ArrayRef<llvm::Value*>());
+   vector<llvm::Value*> ops;
+   ops.push_back(temp);
+   for(size_t i = 0; i < hints.size(); i++) {
+      llvm::Value *hint[] = { llvm::MDString::get(*context, hints[i].first),
+                              llvm::ConstantInt::get(GetIntType(), hints[i].second) };
+      ops.push_back(llvm::MDNode::get(*context, hint));
+   }
+   llvm::MDNode *loop = llvm::MDNode::get(*context, ops);
+   loop->replaceOperandWith(0, loop);
+   llvm::MDNode::deleteTemporary(temp);
+   latch->setMetadata("llvm.loop", loop);
+}
+
+int IRGenerator::ParseFastMath(const char *spec) {
+   static const struct { const char *name; int flags; } names[] = {
+      { "fast",     FM_All },
+      { "none",     0 },
+      { "contract", FM_Contract },
+      { "reassoc",  FM_Reassoc },
+      { "nnan",     FM_NoNaNs },
+      { "ninf",     FM_NoInfs },
+      { "arcp",     FM_ArcP },
+   };
+   if(*spec == '\0')
+      return FM_All;
+   int flags = 0;
+   char *list = strdup(spec);
+   for(char *n = strtok(list, ","); n != NULL; n = strtok(NULL, ",")) {
+      int k = 0, count = sizeof(names) / sizeof(names[0]);
+      while(k < count && strcmp(names[k].name, n) != 0)
+         k++;
+      if(k == count) {
+         free(list);
+         return -1;
+      }
+      flags |= names[k].flags;
+   }
+   free(list);
+   return flags;
+}
+
+int IRGenerator::GetDefaultFastMath() {
+   int flags = 0;
+   if(const char *spec = GetOption("fast-math")) {
+      flags = ParseFastMath(spec);
+      if(flags < 0) {
+         fprintf(stderr, "glc: unknown flag in -ffast-math=%s\n", spec);
+         exit(2);
+      }
+   }
+   const char *single[] = { "contract", "reassoc", "nnan", "ninf", "arcp" };
+   for(int i = 0; i < sizeof(single) / sizeof(single[0]); i++)
+      if(IsOptionOn(single[i]))
+         flags |= ParseFastMath(single[i]);
+   return flags;
+}
+
+void IRGenerator::ApplyFastMath(llvm::Function *func) {
+   llvm::FastMathFlags fmf;
+   if(fastMath & FM_Reassoc)
+      fmf.setUnsafeAlgebra();
+   if(fastMath & FM_NoNaNs)
+      fmf.setNoNaNs();
+   if(fastMath & FM_NoInfs)
+      fmf.setNoInfs();
+   if(fastMath & FM_ArcP)
+      fmf.setAllowReciprocal();
+
+   // only arithmetic, comparisons and calls carry flags; a phi, select
+   // or load of a float just passes a value on
+   vector<llvm::BinaryOperator*> adds;
+   for(llvm::Function::iterator bb = func->begin(); bb != func->end(); bb++) {
+      for(llvm::BasicBlock::iterator it = bb->begin(); it != bb->end(); it++) {
+         llvm::Instruction *inst = &*it;
+         if(!llvm::isa<llvm::FPMathOperator>(inst))
+            continue;
+         switch(inst->getOpcode()) {
+            case llvm::Instruction::FAdd:
+            case llvm::Instruction::FSub:
+               adds.push_back(llvm::cast<llvm::BinaryOperator>(inst));
+               // fall through
+            case llvm::Instruction::FMul:
+            case llvm::Instruction::FDiv:
+            case llvm::Instruction::FRem:
+            case llvm::Instruction::FCmp:
+            case llvm::Instruction::Call:
+               inst->setFastMathFlags(fmf);
+               break;
+            default:
+               break;
+         }
+      }
+   }
+   if((fastMath & FM_Contract) == 0)
+      return;
+
+   // a*b + c and c + a*b become fmuladd(a, b, c), a*b - c becomes
+   // fmuladd(a, b, -c) and c - a*b becomes fmuladd(-a, b, c), when the
+   // product is used nowhere else
+   for(size_t i = 0; i < adds.size(); i++) {
+      llvm::BinaryOperator *add = adds[i];
+      bool sub = add->getOpcode() == llvm::Instruction::FSub;
+      for(int k = 0; k < 2; k++) {
+         llvm::BinaryOperator *mul = llvm::dyn_cast<llvm::BinaryOperator>(add->getOperand(k));
+         if(mul == NULL || mul->getOpcode() != llvm::Instruction::FMul ||
+            !mul->hasOneUse() || mul->getParent() != add->getParent())
+            continue;
+         llvm::Value *args[] = { mul->getOperand(0), mul->getOperand(1), add->getOperand(1 - k) };
+         if(sub) {
+            llvm::BinaryOperator *neg = llvm::BinaryOperator::CreateFNeg(args[k == 0 ? 2 : 0], "", add);
+            neg->setFastMathFlags(fmf);
+            args[k == 0 ? 2 : 0] = neg;
+         }
+         llvm::Function *fn = llvm::Intrinsic::getDeclaration(module, llvm::Intrinsic::fmuladd, add->getType());
+         llvm::CallInst *fused = llvm::CallInst::Create(fn, args, "", add);
+         fused->setFastMathFlags(fmf);
+         add->replaceAllUsesWith(fused);
+         add->eraseFromParent();
+         mul->eraseFromParent();
+         break;
+      }
+   }
+}
+
+void IRGenerator::LoadEntryPoints() {
+   entriesLoaded = true;
+   if(const char *list = GetOption("entry")) {
+      char *names = strdup(list);
+      for(char *n = strtok(names, ","); n != NULL; n = strtok(NULL, ","))
+         entryPoints.insert(n);
+      free(names);
+   }
+   const char *dat = GetOption("dat");
+   if(dat == NULL)
+      return;
+   FILE *f = fopen(dat, "r");
+   if(f == NULL) {
+      fprintf(stderr, "glc: cannot open %s\n", dat);
+      exit(2);
+   }
+   char line[1024], name[256];
+   while(fgets(line, sizeof(line), f) != NULL) {
+      if(sscanf(line, " funct: %255[A-Za-z0-9_]", name) == 1)
+         entryPoints.insert(name);
+      else if(sscanf(line, " gin: %255[A-Za-z0-9_]", name) == 1)
+         externalGlobals.insert(name);
+   }
+   fclose(f);
+}
+
+bool IRGenerator::HasEntryPoints() {
+   if(!entriesLoaded)
+      LoadEntryPoints();
+   return !entryPoints.empty();
+}
+
+llvm::GlobalValue::LinkageTypes IRGenerator::GetFunctionLinkage(const char *name) {
+   if(!HasEntryPoints() || entryPoints.count(name))
+      return llvm::GlobalValue::ExternalLinkage;
+   return llvm::GlobalValue::InternalLinkage;
+}
+
+llvm::GlobalValue::LinkageTypes IRGenerator::GetGlobalLinkage(const char *name) {
+   if(!HasEntryPoints() || externalGlobals.count(name))
+      return llvm::GlobalValue::ExternalLinkage;
+   return llvm::GlobalValue::InternalLinkage;
+}
+
+void IRGenerator::SetFunctionLinkage(llvm::Function *fun) {
+   fun->setLinkage(GetFunctionLinkage(fun->getName().data()));
+   if(fun->hasInternalLinkage())
+      fun->setCallingConv(llvm::CallingConv::Fast);
+}
+
+void IRGenerator::MarkInlineCandidate(llvm::Function *fun, int cost) {
+   if(fun->hasInternalLinkage() && cost <= InlineBudget && recursiveFuncs.count(fun) == 0)
+      fun->addFnAttr(llvm::Attribute::AlwaysInline);
+}
+
+llvm::CallInst *IRGenerator::CreateCall(llvm::Function *fn, vector<llvm::Value*> &args) {
+   if(fn == currentFunc)
+      recursiveFuncs.insert(fn);
+   llvm::CallInst *call = llvm::CallInst::Create(fn, args, "", currentBB);
+   call->setCallingConv(fn->getCallingConv());
+   return call;
+}
+
+void IRGenerator::AddCopyOut(llvm::Value *local, llvm::Value *arg) {
+   copyOuts.push_back(make_pair(local, arg));
+}
+
+void IRGenerator::EmitCopyOuts() {
+   for(size_t i = 0; i < copyOuts.size(); i++)
+      CreateStore(CreateLoad(copyOuts[i].first), copyOuts[i].second);
+}
+
+llvm::Function *IRGenerator::GetProfHook(const char *name) {
+   llvm::Type *i32 = llvm::Type::getInt32Ty(*context);
+   llvm::FunctionType *ty = llvm::FunctionType::get(llvm::Type::getVoidTy(*context), i32, false);
+   llvm::Function *hook = llvm::cast<llvm::Function>(module->getOrInsertFunction(name, ty));
+   hook->addFnAttr(llvm::Attribute::NoUnwind);
+   return hook;
+}
+
+void IRGenerator::EmitProfEnter(llvm::Function *fun) {
+   if(!IsOptionOn("instrument"))
+      return;
+   profId = profFunctions++;
+   char line[32];
+   sprintf(line, "f %d ", profId);
+   profNames += line + fun->getName().str() + "\n";
+   llvm::Value *id = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context), profId);
+   llvm::CallInst::Create(GetProfHook("glc_prof_enter"), id, "", currentBB);
+}
+
+void IRGenerator::EmitProfExit() {
+   if(!IsOptionOn("instrument") || currentBB == NULL)
+      return;
+   llvm::Value *id = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context), profId);
+   llvm::CallInst::Create(GetProfHook("glc_prof_exit"), id, "", currentBB);
+}
+
+void IRGenerator::EmitProfCall(llvm::Function *callee, int line) {
+   if(!IsOptionOn("instrument") || currentBB == NULL)
+      return;
+   int site = profSites++;
+   char num[32];
+   sprintf(num, "c %d ", site);
+   profNames += num + currentFunc->getName().str() + " " + callee->getName().str();
+   sprintf(num, " %d\n", line);
+   profNames += num;
+   llvm::Value *id = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context), site);
+   llvm::CallInst::Create(GetProfHook("glc_prof_call"), id, "", currentBB);
+}
+
+int IRGenerator::AddProfCounters(int n, int ways, const char *kind, int line) {
+   int base = profCounters;
+   profCounters += ways;
+   char text[64];
+   sprintf(text, "b %d %d ", base, ways);
+   profNames += text + currentFunc->getName().str();
+   sprintf(text, " %d %d %s\n", n, line, kind);
+   profNames += text;
+   return base;
+}
+
+void IRGenerator::EmitProfCount(llvm::Value *counter) {
+   llvm::CallInst::Create(GetProfHook("glc_prof_count"), counter, "", currentBB);
+}
+
+// Counts for branch n of the current function from -fprofile-use. A branch
+// whose line or number of ways differs is from other source, and gets none.
+bool IRGenerator::GetBranchCounts(int n, int ways, int line, vector<uint64_t> &counts) {
+   const char *path = GetOption("profile-use");
+   if(path == NULL)
+      return false;
+   if(!profileLoaded) {
+      profileLoaded = true;
+      FILE *f = fopen(path, "r");
+      if(f == NULL) {
+         fprintf(stderr, "glc: cannot open %s\n", path);
+         exit(2);
+      }
+      char text[4096], fn[256];
+      int num, pos;
+      while(fgets(text, sizeof(text), f) != NULL) {
+         BranchProfile bp;
+         if(text[0] == '#' || sscanf(text, "%255s %d %d %*s%n", fn, &num, &bp.line, &pos) != 3)
+            continue;
+         unsigned long long c;
+         int used;
+         for(char *p = text + pos; sscanf(p, "%llu%n", &c, &used) == 1; p += used)
+            bp.counts.push_back(c);
+         char key[300];
+         sprintf(key, "%s %d", fn, num);
+         branchProfile[key] = bp;
+      }
+      fclose(f);
+   }
+   char key[300];
+   snprintf(key, sizeof(key), "%s %d", currentFunc->getName().data(), n);
+   map<string, BranchProfile>::iterator it = branchProfile.find(key);
+   if(it == branchProfile.end() || it->second.line != line || it->second.counts.size() != (size_t)ways)
+      return false;
+   counts = it->second.counts;
+   return true;
+}
+
+// Weights are 32 bits, so large counts are scaled down; each is one more
+// than its count, so a way never seen is unlikely but not impossible
+void IRGenerator::SetBranchWeights(llvm::Instruction *term, vector<uint64_t> &counts) {
+   uint64_t most = 0;
+   for(size_t i = 0; i < counts.size(); i++)
+      most = counts[i] > most ? counts[i] : most;
+   uint64_t scale = most / UINT32_MAX + 1;
+   vector<llvm::Value*> ops;
+   ops.push_back(llvm::MDString::get(*context, "branch_weights"));
+   for(size_t i = 0; i < counts.size(); i++) {
+      uint64_t w = counts[i] / scale + 1;
+      ops.push_back(llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context), w > UINT32_MAX ? UINT32_MAX : w));
+   }
+   term->setMetadata(llvm::LLVMContext::MD_prof, llvm::MDNode::get(*context, ops));
+}
+
+llvm::BranchInst *IRGenerator::EmitProfiledBranch(llvm::Value *cond, llvm::BasicBlock *ifTrue, llvm::BasicBlock *ifFalse,
+                                                  const char *kind, int line) {
+   if(currentBB == NULL || llvm::isa<llvm::ConstantInt>(cond))
+      return EmitCondBranch(cond, ifTrue, ifFalse);
+   int n = profBranch++;
+   if(IsOptionOn("instrument")) {
+      llvm::Type *i32 = llvm::Type::getInt32Ty(*context);
+      llvm::Value *way = new llvm::ZExtInst(cond, i32, "", currentBB);
+      llvm::Value *base = llvm::ConstantInt::get(i32, AddProfCounters(n, 2, kind, line));
+      EmitProfCount(llvm::BinaryOperator::CreateAdd(base, way, "", currentBB));
+   }
+   llvm::BranchInst *br = EmitCondBranch(cond, ifTrue, ifFalse);
+   vector<uint64_t> counts;
+   if(GetBranchCounts(n, 2, line, counts)) {
+      // branch weights list the true successor first
+      std::swap(counts[0], counts[1]);
+      SetBranchWeights(br, counts);
+   }
+   return br;
+}
+
+llvm::SwitchInst *IRGenerator::EmitSwitch(llvm::Value *cond, llvm::BasicBlock *dflt,
+                                          vector<pair<llvm::ConstantInt*, llvm::BasicBlock*> > &cases, int line) {
+   if(currentBB == NULL)
+      return NULL;
+   int n = profBranch++;
+   int ways = cases.size() + 1;
+   vector<llvm::BasicBlock*> dests(1, dflt);
+   for(size_t k = 0; k < cases.size(); k++)
+      dests.push_back(cases[k].second);
+
+   // instrumented, each way goes through a block of its own that counts it
+   if(IsOptionOn("instrument")) {
+      llvm::Type *i32 = llvm::Type::getInt32Ty(*context);
+      int base = AddProfCounters(n, ways, "switch", line);
+      llvm::BasicBlock *bb = currentBB;
+      for(int k = 0; k < ways; k++) {
+         currentBB = llvm::BasicBlock::Create(*context, "prof.case", currentFunc);
+         SealBlock(currentBB);
+         EmitProfCount(llvm::ConstantInt::get(i32, base + k));
+         llvm::BranchInst::Create(dests[k], currentBB);
+         dests[k] = currentBB;
+      }
+      currentBB = bb;
+   }
+
+   vector<uint64_t> counts;
+   bool profiled = GetBranchCounts(n, ways, line, counts);
+   vector<pair<uint64_t, size_t> > order;
+   for(size_t k = 0; k < cases.size(); k++)
+      order.push_back(make_pair(profiled ? UINT64_MAX - counts[k + 1] : 0, k));
+   std::stable_sort(order.begin(), order.end());
+
+   llvm::SwitchInst *sw = llvm::SwitchInst::Create(cond, dests[0], cases.size(), currentBB);
+   vector<uint64_t> weights;
+   if(profiled)
+      weights.push_back(counts[0]);
+   for(size_t i = 0; i < order.size(); i++) {
+      size_t k = order[i].second;
+      sw->addCase(cases[k].first, dests[k + 1]);
+      if(profiled)
+         weights.push_back(counts[k + 1]);
+   }
+   if(profiled)
+      SetBranchWeights(sw, weights);
+   currentBB = NULL;
+   return sw;
+}
+
+void IRGenerator::MarkNoAlias(llvm::Function *fun) {
+   for(llvm::Function::iterator bb = fun->begin(); bb != fun->end(); bb++) {
+      for(llvm::BasicBlock::iterator it = bb->begin(); it != bb->end(); it++) {
+         if(llvm::StoreInst *st = llvm::dyn_cast<llvm::StoreInst>(&*it)) {
+            llvm::Value *ptr = st->getPointerOperand();
+            while(llvm::GEPOperator *gep = llvm::dyn_cast<llvm::GEPOperator>(ptr))
+               ptr = gep->getPointerOperand();
+            if(!llvm::isa<llvm::AllocaInst>(ptr))
+               return;
+         }
+         else if(llvm::CallInst *call = llvm::dyn_cast<llvm::CallInst>(&*it)) {
+            llvm::Function *callee = call->getCalledFunction();
+            if(callee == NULL || !callee->isIntrinsic())
+               return;
+         }
+      }
+   }
+   for(llvm::Function::arg_iterator arg = fun->arg_begin(); arg != fun->arg_end(); arg++)
+      if(arg->getType()->isPointerTy())
+         fun->addAttribute(arg->getArgNo() + 1, llvm::Attribute::NoAlias);
+}
+
+void IRGenerator::FinishModule() {
+   // a variant is widened after those it calls
+   if(!laneVariants.empty()) {
+      LaneWidener widener(module, GetLaneWidth());
+      for(size_t i = 0; i < laneVariants.size(); i++)
+         widener.AddVariant(laneVariants[i].first, laneVariants[i].second);
+      for(size_t i = 0; i < laneVariants.size(); i++) {
+         string why;
+         if(widener.Widen(laneVariants[i].first, why) == NULL)
+            AddLaneFallback(laneVariants[i].second->getName().data(), why);
+      }
+      for(size_t i = 0; i < laneVariants.size(); i++)
+         laneVariants[i].first->dropAllReferences();
+      for(size_t i = 0; i < laneVariants.size(); i++)
+         laneVariants[i].first->eraseFromParent();
+      laneVariants.clear();
+   }
+   if(!laneNotes.empty()) {
+      llvm::Constant *notes = llvm::ConstantDataArray::getString(*context, laneNotes);
+      new llvm::GlobalVariable(*module, notes->getType(), true, llvm::GlobalValue::ExternalLinkage,
+                               notes, "glc.lanes");
+   }
+   if(IsOptionOn("instrument") && module != NULL) {
+      llvm::Constant *names = llvm::ConstantDataArray::getString(*context, profNames);
+      new llvm::GlobalVariable(*module, names->getType(), true, llvm::GlobalValue::ExternalLinkage,
+                               names, "glc.prof.names");
+   }
+   if(!HasEntryPoints())
+      return;
+   llvm::PassManager pm;
+   pm.add(llvm::createAlwaysInlinerPass());
+   pm.add(llvm::createGlobalDCEPass());
+   pm.run(*module);
+}
+
+void IRGenerator::CreateBoundsCheck(llvm::Value *index, int count) {
+   if(!IsOptionOn("bounds-check") || currentBB == NULL)
+      return;
+   llvm::Value *limit = llvm::ConstantInt::get(index->getType(), count);
+   llvm::Value *inRange = CreateCompare(llvm::CmpInst::ICMP_ULT, index, limit);
+   if(trapBB == NULL) {
+      trapBB = llvm::BasicBlock::Create(*context, "trap", currentFunc);
+      llvm::CallInst::Create(llvm::Intrinsic::getDeclaration(module, llvm::Intrinsic::trap), "", trapBB);
+      new llvm::UnreachableInst(*context, trapBB);
+   }
+   llvm::BasicBlock *ok = CreateBlock("inbounds");
+   // a lane variant traps when any invocation under the mask is out of range
+   if(InLanes())
+      EmitCondBranch(CreateMaskAnd(GetLaneMask(), CreateNot(inRange)), trapBB, ok);
+   else
+      EmitCondBranch(inRange, ok, trapBB);
+   EmitBlock(ok);
+}
+
+void IRGenerator::PushJumpFrame(llvm::BasicBlock *breakTarget, llvm::BasicBlock *continueTarget) {
+   JumpFrame frame;
+   frame.breakTarget = breakTarget;
+   frame.continueTarget = continueTarget;
+   frame.continueMask = NULL;
+   jumps.push_back(frame);
+}
+
+void IRGenerator::PopJumpFrame() {
+   jumps.pop_back();
+}
+
+llvm::BasicBlock *IRGenerator::GetBreakTarget() const {
+   return jumps.empty() ? NULL : jumps.back().breakTarget;
+}
+
+llvm::BasicBlock *IRGenerator::GetContinueTarget() const {
+   for(int i = jumps.size() - 1; i >= 0; i--) {
+      if(jumps[i].continueTarget != NULL)
+         return jumps[i].continueTarget;
+   }
+   return NULL;
+}
+
+int IRGenerator::GetLaneWidth() {
+   if(laneWidth == 0) {
+      const char *width = GetOption("lanes");
+      laneWidth = width ? atoi(width) : 1;
+      if(laneWidth != 1 && laneWidth != 4 && laneWidth != 8 && laneWidth != 16) {
+         fprintf(stderr, "glc: -flanes must be 4, 8 or 16\n");
+         exit(2);
+      }
+   }
+   return laneWidth;
+}
+
+void IRGenerator::BeginLanes(llvm::Value *mask, llvm::Type *resultTy) {
+   laneEntry = mask;
+   laneMask = CreateRegister(GetBoolType(), "mask");
+   laneLive = CreateRegister(GetBoolType(), "live");
+   laneResult = resultTy->isVoidTy() ? NULL : CreateRegister(resultTy, "result");
+   laneFallback.clear();
+   WriteVariable(laneMask, currentBB, mask);
+   WriteVariable(laneLive, currentBB, llvm::ConstantInt::getTrue(*context));
+}
+
+string IRGenerator::EndLanes() {
+   if(currentBB != NULL) {
+      // out parameters are copied back for every invocation called,
+      // including those that returned early
+      WriteVariable(laneMask, currentBB, laneEntry);
+      EmitCopyOuts();
+      llvm::Value *result = laneResult ? ReadVariable(laneResult, currentBB) : NULL;
+      llvm::ReturnInst::Create(*context, result, currentBB);
+      currentBB = NULL;
+   }
+   laneMask = laneLive = laneResult = laneEntry = NULL;
+   return laneFallback;
+}
+
+llvm::Value *IRGenerator::GetLaneMask() {
+   return ReadMask(laneMask);
+}
+
+void IRGenerator::SetLaneMask(llvm::Value *mask) {
+   WriteMask(laneMask, mask);
+}
+
+bool IRGenerator::IsMaskClear() {
+   if(!InLanes())
+      return false;
+   llvm::ConstantInt *c = llvm::dyn_cast<llvm::ConstantInt>(GetLaneMask());
+   return c != NULL && c->isZero();
+}
+
+llvm::Value *IRGenerator::CreateMaskAnd(llvm::Value *a, llvm::Value *b) {
+   if(llvm::ConstantInt *c = llvm::dyn_cast<llvm::ConstantInt>(a))
+      return c->isZero() ? a : b;
+   if(llvm::ConstantInt *c = llvm::dyn_cast<llvm::ConstantInt>(b))
+      return c->isZero() ? b : a;
+   if(a == b)
+      return a;
+   return llvm::BinaryOperator::CreateAnd(a, b, "mask", currentBB);
+}
+
+llvm::Value *IRGenerator::CreateMaskOr(llvm::Value *a, llvm::Value *b) {
+   if(llvm::ConstantInt *c = llvm::dyn_cast<llvm::ConstantInt>(a))
+      return c->isZero() ? b : a;
+   if(llvm::ConstantInt *c = llvm::dyn_cast<llvm::ConstantInt>(b))
+      return c->isZero() ? a : b;
+   if(a == b)
+      return a;
+   return llvm::BinaryOperator::CreateOr(a, b, "mask", currentBB);
+}
+
+llvm::Value *IRGenerator::GetLiveMask() {
+   return ReadMask(laneLive);
+}
+
+llvm::Value *IRGenerator::CreateMaskVariable(const char *name) {
+   return CreateRegister(GetBoolType(), name);
+}
+
+// Masks are written whatever the current mask, and read as clear where
+// the code is unreachable
+llvm::Value *IRGenerator::ReadMask(llvm::Value *var) {
+   if(currentBB == NULL)
+      return llvm::ConstantInt::getFalse(*context);
+   return ReadVariable(var, currentBB);
+}
+
+void IRGenerator::WriteMask(llvm::Value *var, llvm::Value *mask) {
+   if(currentBB != NULL)
+      WriteVariable(var, currentBB, mask);
+}
+
+void IRGenerator::PushLaneLoop(llvm::Value *continued) {
+   JumpFrame frame;
+   frame.breakTarget = NULL;
+   frame.continueTarget = NULL;
+   frame.continueMask = continued;
+   jumps.push_back(frame);
+}
+
+llvm::Value *IRGenerator::GetContinueMask() const {
+   for(int i = jumps.size() - 1; i >= 0; i--) {
+      if(jumps[i].continueMask != NULL)
+         return jumps[i].continueMask;
+   }
+   return NULL;
+}
+
+void IRGenerator::EmitLaneBreak() {
+   SetLaneMask(llvm::ConstantInt::getFalse(*context));
+}
+
+void IRGenerator::EmitLaneContinue() {
+   if(llvm::Value *continued = GetContinueMask())
+      WriteMask(continued, CreateMaskOr(ReadMask(continued), GetLaneMask()));
+   SetLaneMask(llvm::ConstantInt::getFalse(*context));
+}
+
+void IRGenerator::EmitLaneReturn(llvm::Value *val) {
+   if(currentBB == NULL)
+      return;
+   if(val != NULL && laneResult != NULL)
+      CreateStore(val, laneResult);
+   WriteMask(laneLive, CreateMaskAnd(GetLiveMask(), CreateNot(GetLaneMask())));
+   SetLaneMask(llvm::ConstantInt::getFalse(*context));
+}
+
+void IRGenerator::NoteLaneFallback(const string &why) {
+   if(laneFallback.empty())
+      laneFallback = why;
+}
+
+void IRGenerator::AddLaneFallback(const char *name, const string &why) {
+   laneNotes += string(name) + ": " + why + "\n";
+}
+
+void IRGenerator::AddLaneVariant(llvm::Function *masked, llvm::Function *scalar) {
+   laneVariants.push_back(make_pair(masked, scalar));
+}
+
 llvm::Type *IRGenerator::GetIntType() const {
    llvm::Type *ty = llvm::Type::getInt32Ty(*context);
    return ty;
@@ -63,7 +897,9 @@ llvm::Type *IRGenerator::GetFloatType() const {
 
 llvm::Type *IRGenerator::GetType(Type *type) const {
    llvm::Type *ty = NULL;
-   if(type == Type::intType)
+   if(type == Type::voidType)
+      ty = llvm::Type::getVoidTy(*context);
+   else if(type == Type::intType || type == Type::uintType)
       ty = llvm::Type::getInt32Ty(*context);
    else if(type == Type::boolType)
       ty = llvm::Type::getInt1Ty(*context);
@@ -75,6 +911,24 @@ llvm::Type *IRGenerator::GetType(Type *type) const {
       ty = llvm::VectorType::get(llvm::Type::getFloatTy(*context), 3);
     else if (type == Type::vec4Type )
       ty = llvm::VectorType::get(llvm::Type::getFloatTy(*context), 4);
+    else if (type == Type::ivec2Type || type == Type::uvec2Type)
+      ty = llvm::VectorType::get(llvm::Type::getInt32Ty(*context), 2);
+    else if (type == Type::ivec3Type || type == Type::uvec3Type)
+      ty = llvm::VectorType::get(llvm::Type::getInt32Ty(*context), 3);
+    else if (type == Type::ivec4Type || type == Type::uvec4Type)
+      ty = llvm::VectorType::get(llvm::Type::getInt32Ty(*context), 4);
+    else if (type == Type::bvec2Type)
+      ty = llvm::VectorType::get(llvm::Type::getInt1Ty(*context), 2);
+    else if (type == Type::bvec3Type)
+      ty = llvm::VectorType::get(llvm::Type::getInt1Ty(*context), 3);
+    else if (type == Type::bvec4Type)
+      ty = llvm::VectorType::get(llvm::Type::getInt1Ty(*context), 4);
+    else if (type == Type::mat2Type)
+      ty = GetMatrixType(2);
+    else if (type == Type::mat3Type)
+      ty = GetMatrixType(3);
+    else if (type == Type::mat4Type)
+      ty = GetMatrixType(4);
     else if (dynamic_cast<ArrayType*>(type) != NULL) {
       ArrayType *arrType = dynamic_cast<ArrayType*>(type);
       ty = llvm::ArrayType::get(GetType(arrType->GetElemType()), arrType->GetElemCount());
@@ -83,6 +937,665 @@ llvm::Type *IRGenerator::GetType(Type *type) const {
     return ty;
 }
 
+llvm::Type *IRGenerator::GetMatrixType(int n) const {
+   char name[8];
+   sprintf(name, "mat%d", n);
+   llvm::StructType *ty = module->getTypeByName(name);
+   if(ty == NULL) {
+      llvm::Type *col = llvm::VectorType::get(llvm::Type::getFloatTy(*context), n);
+      llvm::Type *cols = llvm::ArrayType::get(col, n);
+      ty = llvm::StructType::create(*context, cols, name);
+   }
+   return ty;
+}
+
+bool IRGenerator::IsMatrixType(llvm::Type *ty) const {
+   llvm::StructType *st = llvm::dyn_cast<llvm::StructType>(ty);
+   return st != NULL && st->hasName() && st->getName().startswith("mat");
+}
+
+int IRGenerator::GetMatrixSize(llvm::Type *ty) const {
+   llvm::StructType *st = llvm::cast<llvm::StructType>(ty);
+   return llvm::cast<llvm::ArrayType>(st->getElementType(0))->getNumElements();
+}
+
+llvm::Value *IRGenerator::GetColumn(llvm::Value *mat, int col) {
+   unsigned idx[2] = { 0, (unsigned)col };
+   return llvm::ExtractValueInst::Create(mat, idx, "col", currentBB);
+}
+
+llvm::Value *IRGenerator::SetColumn(llvm::Value *mat, llvm::Value *vec, int col) {
+   unsigned idx[2] = { 0, (unsigned)col };
+   return llvm::InsertValueInst::Create(mat, vec, idx, "", currentBB);
+}
+
+llvm::Value *IRGenerator::CreateSplat(llvm::Value *scalar, int n) {
+   if(llvm::Constant *c = llvm::dyn_cast<llvm::Constant>(scalar))
+      return llvm::ConstantVector::getSplat(n, c);
+
+   llvm::Type *ty = llvm::VectorType::get(scalar->getType(), n);
+   llvm::Value *undef = llvm::UndefValue::get(ty);
+   llvm::Value *zero = llvm::ConstantInt::get(GetIntType(), 0);
+   llvm::Value *ins = llvm::InsertElementInst::Create(undef, scalar, zero, "", currentBB);
+   llvm::Constant *mask = llvm::ConstantAggregateZero::get(llvm::VectorType::get(GetIntType(), n));
+   return new llvm::ShuffleVectorInst(ins, undef, mask, "splat", currentBB);
+}
+
+llvm::Value *IRGenerator::CreateLaneSplat(llvm::Value *vec, int lane) {
+   int n = llvm::cast<llvm::VectorType>(vec->getType())->getNumElements();
+   llvm::Constant *idx = llvm::ConstantInt::get(GetIntType(), lane);
+   llvm::Constant *mask = llvm::ConstantVector::getSplat(n, idx);
+   return new llvm::ShuffleVectorInst(vec, llvm::UndefValue::get(vec->getType()), mask, "splat", currentBB);
+}
+
+static int SwizzleLane(char c) {
+   switch(c) {
+     case 'y': case 'g': case 't': return 1;
+     case 'z': case 'b': case 'p': return 2;
+     case 'w': case 'a': case 'q': return 3;
+     default: return 0;
+   }
+}
+
+llvm::Value *IRGenerator::CreateBinaryOp(char op, llvm::Value *lhs, llvm::Value *rhs, bool isUnsigned) {
+   if(lhs->getType()->isVectorTy() && !rhs->getType()->isVectorTy())
+      rhs = CreateSplat(rhs, lhs->getType()->getVectorNumElements());
+   else if(rhs->getType()->isVectorTy() && !lhs->getType()->isVectorTy())
+      lhs = CreateSplat(lhs, rhs->getType()->getVectorNumElements());
+
+   bool fp = lhs->getType()->isFPOrFPVectorTy();
+   llvm::Instruction::BinaryOps opc;
+   if(op == '+')
+      opc = fp ? llvm::Instruction::FAdd : llvm::Instruction::Add;
+   else if(op == '-')
+      opc = fp ? llvm::Instruction::FSub : llvm::Instruction::Sub;
+   else if(op == '*')
+      opc = fp ? llvm::Instruction::FMul : llvm::Instruction::Mul;
+   else
+      opc = fp ? llvm::Instruction::FDiv : (isUnsigned ? llvm::Instruction::UDiv : llvm::Instruction::SDiv);
+   if(llvm::isa<llvm::Constant>(lhs) && llvm::isa<llvm::Constant>(rhs))
+      return llvm::ConstantExpr::get(opc, llvm::cast<llvm::Constant>(lhs), llvm::cast<llvm::Constant>(rhs));
+   return llvm::BinaryOperator::Create(opc, lhs, rhs, "", currentBB);
+}
+
+llvm::Value *IRGenerator::CreateCast(llvm::Value *val, llvm::Type *to, bool fromUnsigned, bool toUnsigned) {
+   llvm::Type *from = val->getType();
+   if(from == to)
+      return val;
+
+   // scalar to vector: convert once, then broadcast
+   if(to->isVectorTy() && !from->isVectorTy())
+      return CreateSplat(CreateCast(val, to->getScalarType(), fromUnsigned, toUnsigned), to->getVectorNumElements());
+
+   llvm::Constant *c = llvm::dyn_cast<llvm::Constant>(val);
+
+   // vector to scalar keeps the first component
+   if(!to->isVectorTy() && from->isVectorTy()) {
+      llvm::Constant *zero = llvm::ConstantInt::get(GetIntType(), 0);
+      if(c != NULL)
+         val = llvm::ConstantExpr::getExtractElement(c, zero);
+      else
+         val = llvm::ExtractElementInst::Create(val, zero, "", currentBB);
+      return CreateCast(val, to, fromUnsigned, toUnsigned);
+   }
+
+   // narrowing vector conversions drop the trailing components
+   if(to->isVectorTy() && to->getVectorNumElements() != from->getVectorNumElements()) {
+      vector<llvm::Constant*> mask;
+      for(int i = 0; i < to->getVectorNumElements(); i++)
+         mask.push_back(llvm::ConstantInt::get(GetIntType(), i));
+      llvm::Constant *m = llvm::ConstantVector::get(mask);
+      if(c != NULL)
+         val = llvm::ConstantExpr::getShuffleVector(c, llvm::UndefValue::get(from), m);
+      else
+         val = new llvm::ShuffleVectorInst(val, llvm::UndefValue::get(from), m, "", currentBB);
+      return CreateCast(val, to, fromUnsigned, toUnsigned);
+   }
+
+   llvm::Type *fs = from->getScalarType();
+   llvm::Type *ts = to->getScalarType();
+   if(ts->isIntegerTy(1)) {
+      llvm::Constant *zero = llvm::Constant::getNullValue(from);
+      return CreateCompare(fs->isFloatingPointTy() ? llvm::CmpInst::FCMP_UNE : llvm::CmpInst::ICMP_NE, val, zero);
+   }
+
+   llvm::Instruction::CastOps opc;
+   if(fs->isFloatingPointTy())
+      opc = toUnsigned ? llvm::Instruction::FPToUI : llvm::Instruction::FPToSI;
+   else if(ts->isFloatingPointTy())
+      opc = (fromUnsigned || fs->isIntegerTy(1)) ? llvm::Instruction::UIToFP : llvm::Instruction::SIToFP;
+   else if(fs->isIntegerTy(1))
+      opc = llvm::Instruction::ZExt;
+   else
+      return val; // int <-> uint share a representation
+   if(c != NULL)
+      return llvm::ConstantExpr::getCast(opc, c, to);
+   return llvm::CastInst::Create(opc, val, to, "", currentBB);
+}
+
+llvm::Value *IRGenerator::CreateSwizzleInsert(llvm::Value *dst, llvm::Value *src, const char *swiz) {
+   int n = dst->getType()->getVectorNumElements();
+   int m = strlen(swiz);
+   if(!src->getType()->isVectorTy()) {
+      if(m == 1) {
+         llvm::Value *idx = llvm::ConstantInt::get(GetIntType(), SwizzleLane(swiz[0]));
+         return llvm::InsertElementInst::Create(dst, src, idx, "", currentBB);
+      }
+      src = CreateSplat(src, m);
+   }
+
+   // widen src to dst's width so a single shuffle can merge the two
+   int w = src->getType()->getVectorNumElements();
+   if(w != n) {
+      vector<llvm::Constant*> mask;
+      for(int i = 0; i < n; i++)
+         mask.push_back(i < w ? (llvm::Constant*)llvm::ConstantInt::get(GetIntType(), i) : llvm::UndefValue::get(GetIntType()));
+      src = new llvm::ShuffleVectorInst(src, llvm::UndefValue::get(src->getType()), llvm::ConstantVector::get(mask), "", currentBB);
+   }
+
+   vector<llvm::Constant*> mask;
+   for(int i = 0; i < n; i++)
+      mask.push_back(llvm::ConstantInt::get(GetIntType(), i));
+   for(int k = 0; k < m; k++)
+      mask[SwizzleLane(swiz[k])] = llvm::ConstantInt::get(GetIntType(), n + k);
+   return new llvm::ShuffleVectorInst(dst, src, llvm::ConstantVector::get(mask), "", currentBB);
+}
+
+llvm::Value *IRGenerator::CreateAll(llvm::Value *mask) {
+   int n = mask->getType()->getVectorNumElements();
+   llvm::Type *bits = llvm::IntegerType::get(*context, n);
+   llvm::Value *packed;
+   if(llvm::Constant *c = llvm::dyn_cast<llvm::Constant>(mask))
+      packed = llvm::ConstantExpr::getBitCast(c, bits);
+   else
+      packed = new llvm::BitCastInst(mask, bits, "", currentBB);
+   return CreateCompare(llvm::CmpInst::ICMP_EQ, packed, llvm::Constant::getAllOnesValue(bits));
+}
+
+llvm::Value *IRGenerator::CreateCompare(llvm::CmpInst::Predicate pred, llvm::Value *lhs, llvm::Value *rhs) {
+   if(llvm::isa<llvm::Constant>(lhs) && llvm::isa<llvm::Constant>(rhs))
+      return llvm::ConstantExpr::getCompare(pred, llvm::cast<llvm::Constant>(lhs), llvm::cast<llvm::Constant>(rhs));
+   llvm::Instruction::OtherOps kind = llvm::CmpInst::isFPPredicate(pred) ? llvm::Instruction::FCmp : llvm::Instruction::ICmp;
+   return llvm::CmpInst::Create(kind, pred, lhs, rhs, "", currentBB);
+}
+
+llvm::Value *IRGenerator::CreateNot(llvm::Value *val) {
+   if(llvm::Constant *c = llvm::dyn_cast<llvm::Constant>(val))
+      return llvm::ConstantExpr::getNot(c);
+   return llvm::BinaryOperator::CreateNot(val, "", currentBB);
+}
+
+enum BuiltinId {
+   B_Dot, B_Length, B_Distance, B_Normalize, B_Min, B_Max, B_Clamp, B_Mix,
+   B_Sqrt, B_InverseSqrt, B_Pow, B_Exp, B_Log, B_Sin, B_Cos, B_Abs,
+   B_Floor, B_Ceil, B_Fract, B_Fma, B_Any, B_All
+};
+
+static const struct {
+   const char *name;
+   int arity;
+   BuiltinId id;
+} builtins[] = {
+   { "dot",         2, B_Dot },
+   { "length",      1, B_Length },
+   { "distance",    2, B_Distance },
+   { "normalize",   1, B_Normalize },
+   { "min",         2, B_Min },
+   { "max",         2, B_Max },
+   { "clamp",       3, B_Clamp },
+   { "mix",         3, B_Mix },
+   { "sqrt",        1, B_Sqrt },
+   { "inversesqrt", 1, B_InverseSqrt },
+   { "pow",         2, B_Pow },
+   { "exp",         1, B_Exp },
+   { "log",         1, B_Log },
+   { "sin",         1, B_Sin },
+   { "cos",         1, B_Cos },
+   { "abs",         1, B_Abs },
+   { "floor",       1, B_Floor },
+   { "ceil",        1, B_Ceil },
+   { "fract",       1, B_Fract },
+   { "fma",         3, B_Fma },
+   { "any",         1, B_Any },
+   { "all",         1, B_All },
+};
+
+bool IRGenerator::IsBuiltin(const char *name) {
+   for(int i = 0; i < sizeof(builtins) / sizeof(builtins[0]); i++)
+      if(strcmp(builtins[i].name, name) == 0)
+         return true;
+   return false;
+}
+
+llvm::Value *IRGenerator::CreateIntrinsic(llvm::Intrinsic::ID id, vector<llvm::Value*> &args) {
+   llvm::Type *ty = args[0]->getType();
+   llvm::Function *fn = llvm::Intrinsic::getDeclaration(module, id, ty);
+   return llvm::CallInst::Create(fn, args, "", currentBB);
+}
+
+/* Horizontal add: log2(n) shuffle+fadd steps for power-of-two widths,
+ * a straight extract chain for vec3.
+ */
+llvm::Value *IRGenerator::CreateReduceAdd(llvm::Value *vec) {
+   if(!vec->getType()->isVectorTy())
+      return vec;
+   int n = vec->getType()->getVectorNumElements();
+   llvm::Value *zero = llvm::ConstantInt::get(GetIntType(), 0);
+   if((n & (n - 1)) == 0) {
+      for(int h = n / 2; h >= 1; h /= 2) {
+         vector<llvm::Constant*> mask;
+         for(int i = 0; i < n; i++)
+            mask.push_back(i < h ? (llvm::Constant*)llvm::ConstantInt::get(GetIntType(), i + h) : llvm::UndefValue::get(GetIntType()));
+         llvm::Value *hi = new llvm::ShuffleVectorInst(vec, llvm::UndefValue::get(vec->getType()), llvm::ConstantVector::get(mask), "", currentBB);
+         vec = llvm::BinaryOperator::CreateFAdd(vec, hi, "", currentBB);
+      }
+      return llvm::ExtractElementInst::Create(vec, zero, "", currentBB);
+   }
+   llvm::Value *sum = llvm::ExtractElementInst::Create(vec, zero, "", currentBB);
+   for(int i = 1; i < n; i++) {
+      llvm::Value *idx = llvm::ConstantInt::get(GetIntType(), i);
+      llvm::Value *lane = llvm::ExtractElementInst::Create(vec, idx, "", currentBB);
+      sum = llvm::BinaryOperator::CreateFAdd(sum, lane, "", currentBB);
+   }
+   return sum;
+}
+
+// there is no minnum/maxnum intrinsic to lean on, so compare and select
+llvm::Value *IRGenerator::CreateMinMax(bool isMax, llvm::Value *a, llvm::Value *b, bool isUnsigned) {
+   llvm::Value *cmp;
+   if(a->getType()->isFPOrFPVectorTy())
+      cmp = llvm::CmpInst::Create(llvm::CmpInst::FCmp, isMax ? llvm::CmpInst::FCMP_OGT : llvm::CmpInst::FCMP_OLT, a, b, "", currentBB);
+   else if(isUnsigned)
+      cmp = llvm::CmpInst::Create(llvm::CmpInst::ICmp, isMax ? llvm::CmpInst::ICMP_UGT : llvm::CmpInst::ICMP_ULT, a, b, "", currentBB);
+   else
+      cmp = llvm::CmpInst::Create(llvm::CmpInst::ICmp, isMax ? llvm::CmpInst::ICMP_SGT : llvm::CmpInst::ICMP_SLT, a, b, "", currentBB);
+   return llvm::SelectInst::Create(cmp, a, b, "", currentBB);
+}
+
+llvm::Value *IRGenerator::EmitBuiltin(const char *name, vector<llvm::Value*> &args, bool isUnsigned) {
+   int b = -1;
+   for(int i = 0; i < sizeof(builtins) / sizeof(builtins[0]); i++)
+      if(strcmp(builtins[i].name, name) == 0 && builtins[i].arity == args.size())
+         b = i;
+   if(b < 0)
+      return NULL;
+   BuiltinId id = builtins[b].id;
+
+   // everything except min/max/clamp/abs/any/all works on floats only
+   if(id != B_Min && id != B_Max && id != B_Clamp && id != B_Abs && id != B_Any && id != B_All) {
+      for(int i = 0; i < args.size(); i++) {
+         llvm::Type *ty = args[i]->getType();
+         if(ty->isIntOrIntVectorTy())
+            args[i] = CreateCast(args[i], ty->isVectorTy() ? llvm::VectorType::get(GetFloatType(), ty->getVectorNumElements()) : GetFloatType(), isUnsigned, false);
+      }
+   }
+
+   // min/max/clamp stay integer on integers; mixed with a float they
+   // compare floats, and a scalar takes the width of a vector operand
+   if(id == B_Min || id == B_Max || id == B_Clamp) {
+      bool anyFloat = false;
+      int width = 0;
+      for(int i = 0; i < args.size(); i++) {
+         llvm::Type *ty = args[i]->getType();
+         anyFloat = anyFloat || ty->isFPOrFPVectorTy();
+         if(ty->isVectorTy())
+            width = ty->getVectorNumElements();
+      }
+      for(int i = 0; i < args.size(); i++) {
+         llvm::Type *ty = args[i]->getType();
+         if(anyFloat && ty->isIntOrIntVectorTy())
+            args[i] = CreateCast(args[i], ty->isVectorTy() ? llvm::VectorType::get(GetFloatType(), ty->getVectorNumElements()) : GetFloatType(), isUnsigned, false);
+         if(width > 0 && !ty->isVectorTy())
+            args[i] = CreateSplat(args[i], width);
+      }
+   }
+
+   llvm::Value *x = args[0];
+   llvm::Type *ty = x->getType();
+   switch(id) {
+     case B_Dot:
+       return CreateReduceAdd(llvm::BinaryOperator::CreateFMul(x, args[1], "", currentBB));
+
+     case B_Length:
+     case B_Distance: {
+       if(id == B_Distance)
+          x = llvm::BinaryOperator::CreateFSub(x, args[1], "", currentBB);
+       if(!x->getType()->isVectorTy()) {
+          vector<llvm::Value*> a(1, x);
+          return CreateIntrinsic(llvm::Intrinsic::fabs, a);
+       }
+       vector<llvm::Value*> a(1, CreateReduceAdd(llvm::BinaryOperator::CreateFMul(x, x, "", currentBB)));
+       return CreateIntrinsic(llvm::Intrinsic::sqrt, a);
+     }
+
+     case B_Normalize: {
+       vector<llvm::Value*> a(1, CreateReduceAdd(llvm::BinaryOperator::CreateFMul(x, x, "", currentBB)));
+       llvm::Value *len = CreateIntrinsic(llvm::Intrinsic::sqrt, a);
+       llvm::Value *inv = llvm::BinaryOperator::CreateFDiv(llvm::ConstantFP::get(GetFloatType(), 1.0), len, "", currentBB);
+       if(ty->isVectorTy())
+          inv = CreateSplat(inv, ty->getVectorNumElements());
+       return llvm::BinaryOperator::CreateFMul(x, inv, "", currentBB);
+     }
+
+     case B_Min:
+       return CreateMinMax(false, x, args[1], isUnsigned);
+     case B_Max:
+       return CreateMinMax(true, x, args[1], isUnsigned);
+     case B_Clamp:
+       return CreateMinMax(false, CreateMinMax(true, x, args[1], isUnsigned), args[2], isUnsigned);
+
+     case B_Mix: {
+       // x + (y - x) * a as a single fmuladd
+       llvm::Value *a = args[2];
+       if(ty->isVectorTy() && !a->getType()->isVectorTy())
+          a = CreateSplat(a, ty->getVectorNumElements());
+       vector<llvm::Value*> ops;
+       ops.push_back(llvm::BinaryOperator::CreateFSub(args[1], x, "", currentBB));
+       ops.push_back(a);
+       ops.push_back(x);
+       return CreateIntrinsic(llvm::Intrinsic::fmuladd, ops);
+     }
+
+     case B_Sqrt:
+       return CreateIntrinsic(llvm::Intrinsic::sqrt, args);
+     case B_InverseSqrt: {
+       llvm::Value *s = CreateIntrinsic(llvm::Intrinsic::sqrt, args);
+       return llvm::BinaryOperator::CreateFDiv(llvm::ConstantFP::get(ty, 1.0), s, "", currentBB);
+     }
+     case B_Pow:
+       return CreateIntrinsic(llvm::Intrinsic::pow, args);
+     case B_Exp:
+       return CreateIntrinsic(llvm::Intrinsic::exp, args);
+     case B_Log:
+       return CreateIntrinsic(llvm::Intrinsic::log, args);
+     case B_Sin:
+       return CreateIntrinsic(llvm::Intrinsic::sin, args);
+     case B_Cos:
+       return CreateIntrinsic(llvm::Intrinsic::cos, args);
+     case B_Floor:
+       return CreateIntrinsic(llvm::Intrinsic::floor, args);
+     case B_Ceil:
+       return CreateIntrinsic(llvm::Intrinsic::ceil, args);
+     case B_Fract:
+       return llvm::BinaryOperator::CreateFSub(x, CreateIntrinsic(llvm::Intrinsic::floor, args), "", currentBB);
+     case B_Fma:
+       return CreateIntrinsic(llvm::Intrinsic::fma, args);
+
+     case B_Abs: {
+       if(ty->isFPOrFPVectorTy())
+          return CreateIntrinsic(llvm::Intrinsic::fabs, args);
+       llvm::Value *zero = llvm::Constant::getNullValue(ty);
+       llvm::Value *neg = llvm::BinaryOperator::CreateNeg(x, "", currentBB);
+       llvm::Value *cmp = llvm::CmpInst::Create(llvm::CmpInst::ICmp, llvm::CmpInst::ICMP_SLT, x, zero, "", currentBB);
+       return llvm::SelectInst::Create(cmp, neg, x, "", currentBB);
+     }
+
+     case B_All:
+       return ty->isVectorTy() ? CreateAll(x) : x;
+     case B_Any: {
+       if(!ty->isVectorTy())
+          return x;
+       llvm::Type *bits = llvm::IntegerType::get(*context, ty->getVectorNumElements());
+       llvm::Value *packed = new llvm::BitCastInst(x, bits, "", currentBB);
+       return llvm::CmpInst::Create(llvm::CmpInst::ICmp, llvm::CmpInst::ICMP_NE, packed,
+                                    llvm::Constant::getNullValue(bits), "", currentBB);
+     }
+   }
+   return NULL;
+}
+
+/* Splits constructor arguments into (value, lane) components in order;
+ * lane -1 marks a scalar. Matrix arguments contribute their columns.
+ */
+void IRGenerator::FlattenLanes(vector<llvm::Value*> &args, vector<pair<llvm::Value*, int> > &lanes) {
+   for(int i = 0; i < args.size(); i++) {
+      llvm::Type *aty = args[i]->getType();
+      if(aty->isVectorTy()) {
+         for(int l = 0; l < aty->getVectorNumElements(); l++)
+            lanes.push_back(make_pair(args[i], l));
+      }
+      else if(IsMatrixType(aty)) {
+         int m = GetMatrixSize(aty);
+         for(int c = 0; c < m; c++) {
+            llvm::Value *col = GetColumn(args[i], c);
+            for(int l = 0; l < m; l++)
+               lanes.push_back(make_pair(col, l));
+         }
+      }
+      else
+         lanes.push_back(make_pair(args[i], -1));
+   }
+}
+
+/* Assembles a vector of type ty from lanes[first..first+n). Constant lanes
+ * are folded into a ConstantVector seed, each vector source is merged with
+ * one shuffle (two when it is narrower than ty) and each non-constant
+ * scalar costs one insertelement. Missing trailing lanes are zero.
+ */
+llvm::Value *IRGenerator::BuildVector(llvm::Type *ty, vector<pair<llvm::Value*, int> > &lanes, int first) {
+   int n = ty->getVectorNumElements();
+   int avail = lanes.size() - first;
+   llvm::Type *elemTy = ty->getScalarType();
+   llvm::Constant *undefIdx = llvm::UndefValue::get(GetIntType());
+
+   // a source vector supplying every lane in order is used as is
+   llvm::Value *src = avail > 0 ? lanes[first].first : NULL;
+   if(src != NULL && src->getType() == ty) {
+      bool whole = true;
+      for(int i = 0; i < n && whole; i++)
+         whole = i < avail && lanes[first + i].first == src && lanes[first + i].second == i;
+      if(whole)
+         return src;
+   }
+
+   vector<llvm::Constant*> seed;
+   bool allConst = true, empty = true;
+   for(int i = 0; i < n; i++) {
+      llvm::Constant *c = NULL;
+      if(i >= avail)
+         c = llvm::Constant::getNullValue(elemTy);
+      else if(llvm::Constant *k = llvm::dyn_cast<llvm::Constant>(lanes[first + i].first)) {
+         int lane = lanes[first + i].second;
+         c = lane < 0 ? k : llvm::ConstantExpr::getExtractElement(k, llvm::ConstantInt::get(GetIntType(), lane));
+      }
+      if(c == NULL) {
+         allConst = false;
+         c = llvm::UndefValue::get(elemTy);
+      }
+      else
+         empty = false;
+      seed.push_back(c);
+   }
+   llvm::Value *result = llvm::ConstantVector::get(seed);
+   if(allConst)
+      return result;
+
+   for(int i = 0; i < n && i < avail; i++) {
+      llvm::Value *v = lanes[first + i].first;
+      if(llvm::isa<llvm::Constant>(v))
+         continue;
+      if(lanes[first + i].second < 0) {
+         llvm::Value *idx = llvm::ConstantInt::get(GetIntType(), i);
+         result = llvm::InsertElementInst::Create(result, v, idx, "", currentBB);
+         empty = false;
+         continue;
+      }
+
+      // each vector source is handled once, at its first lane
+      bool seen = false;
+      for(int j = 0; j < i && !seen; j++)
+         seen = lanes[first + j].first == v;
+      if(seen)
+         continue;
+
+      vector<llvm::Constant*> gather, merge;
+      for(int j = 0; j < n; j++) {
+         bool mine = j < avail && lanes[first + j].first == v;
+         int lane = mine ? lanes[first + j].second : -1;
+         gather.push_back(mine ? (llvm::Constant*)llvm::ConstantInt::get(GetIntType(), lane) : undefIdx);
+         merge.push_back(llvm::ConstantInt::get(GetIntType(), mine ? n + (v->getType() == ty ? lane : j) : j));
+      }
+      if(empty)
+         result = new llvm::ShuffleVectorInst(v, llvm::UndefValue::get(v->getType()), llvm::ConstantVector::get(gather), "", currentBB);
+      else if(v->getType() == ty)
+         result = new llvm::ShuffleVectorInst(result, v, llvm::ConstantVector::get(merge), "", currentBB);
+      else {
+         llvm::Value *wide = new llvm::ShuffleVectorInst(v, llvm::UndefValue::get(v->getType()), llvm::ConstantVector::get(gather), "", currentBB);
+         result = new llvm::ShuffleVectorInst(result, wide, llvm::ConstantVector::get(merge), "", currentBB);
+      }
+      empty = false;
+   }
+   return result;
+}
+
+llvm::Value *IRGenerator::CreateVector(llvm::Type *ty, vector<llvm::Value*> &args) {
+   if(args.size() == 1 && !args[0]->getType()->isVectorTy() && !IsMatrixType(args[0]->getType()))
+      return CreateSplat(args[0], ty->getVectorNumElements());
+   vector<pair<llvm::Value*, int> > lanes;
+   FlattenLanes(args, lanes);
+   return BuildVector(ty, lanes, 0);
+}
+
+/* Builds a matrix from a constructor argument list: a single scalar fills
+ * the diagonal, a single matrix is resized (padding with identity), and
+ * anything else is consumed component by component in column-major order.
+ */
+llvm::Value *IRGenerator::CreateMatrix(llvm::Type *ty, vector<llvm::Value*> &args) {
+   int n = GetMatrixSize(ty);
+   llvm::Type *colTy = llvm::VectorType::get(GetFloatType(), n);
+   llvm::Value *mat = llvm::UndefValue::get(ty);
+
+   for(int i = 0; i < args.size(); i++) {
+      llvm::Type *aty = args[i]->getType();
+      if(aty->getScalarType()->isIntegerTy())
+         args[i] = CreateCast(args[i], aty->isVectorTy() ? llvm::VectorType::get(GetFloatType(), aty->getVectorNumElements()) : GetFloatType(), false, false);
+   }
+
+   if(args.size() == 1 && !args[0]->getType()->isVectorTy() && !IsMatrixType(args[0]->getType())) {
+      llvm::Value *zero = llvm::Constant::getNullValue(colTy);
+      for(int j = 0; j < n; j++) {
+         llvm::Value *idx = llvm::ConstantInt::get(GetIntType(), j);
+         llvm::Value *col = llvm::InsertElementInst::Create(zero, args[0], idx, "", currentBB);
+         mat = SetColumn(mat, col, j);
+      }
+      return mat;
+   }
+
+   if(args.size() == 1 && IsMatrixType(args[0]->getType())) {
+      int m = GetMatrixSize(args[0]->getType());
+      for(int j = 0; j < n; j++) {
+         vector<llvm::Constant*> ident;
+         for(int i = 0; i < n; i++)
+            ident.push_back(llvm::ConstantFP::get(GetFloatType(), i == j ? 1.0 : 0.0));
+         llvm::Constant *identCol = llvm::ConstantVector::get(ident);
+         if(j >= m) {
+            mat = SetColumn(mat, identCol, j);
+            continue;
+         }
+         // keep the lanes the source has, take the rest from the identity
+         llvm::Value *src = GetColumn(args[0], j);
+         llvm::Value *wide = src;
+         if(m != n) {
+            vector<llvm::Constant*> mask;
+            for(int i = 0; i < n; i++)
+               mask.push_back(i < m ? llvm::ConstantInt::get(GetIntType(), i) : llvm::UndefValue::get(GetIntType()));
+            wide = new llvm::ShuffleVectorInst(src, llvm::UndefValue::get(src->getType()), llvm::ConstantVector::get(mask), "", currentBB);
+         }
+         vector<llvm::Constant*> mask;
+         for(int i = 0; i < n; i++)
+            mask.push_back(llvm::ConstantInt::get(GetIntType(), i < m ? i : n + i));
+         llvm::Value *col = new llvm::ShuffleVectorInst(wide, identCol, llvm::ConstantVector::get(mask), "", currentBB);
+         mat = SetColumn(mat, col, j);
+      }
+      return mat;
+   }
+
+   vector<pair<llvm::Value*, int> > comps;
+   FlattenLanes(args, comps);
+   for(int j = 0; j < n; j++)
+      mat = SetColumn(mat, BuildVector(colTy, comps, j * n), j);
+   return mat;
+}
+
+/* m * v as a sum of columns scaled by the matching vector lane:
+ * r = c0 * v.xxxx + c1 * v.yyyy + ...
+ */
+llvm::Value *IRGenerator::CreateMatVecMul(llvm::Value *mat, llvm::Value *vec) {
+   int n = GetMatrixSize(mat->getType());
+   llvm::Value *result = NULL;
+   for(int i = 0; i < n; i++) {
+      llvm::Value *prod = llvm::BinaryOperator::CreateFMul(GetColumn(mat, i), CreateLaneSplat(vec, i), "", currentBB);
+      result = result ? llvm::BinaryOperator::CreateFAdd(result, prod, "", currentBB) : prod;
+   }
+   return result;
+}
+
+llvm::Value *IRGenerator::CreateTranspose(llvm::Value *mat) {
+   int n = GetMatrixSize(mat->getType());
+   vector<llvm::Value*> cols;
+   for(int i = 0; i < n; i++)
+      cols.push_back(GetColumn(mat, i));
+
+   llvm::Value *result = llvm::UndefValue::get(mat->getType());
+   llvm::Constant *undefIdx = llvm::UndefValue::get(GetIntType());
+   for(int r = 0; r < n; r++) {
+      // gather lane r of every column, one shuffle per extra column
+      vector<llvm::Constant*> mask;
+      for(int i = 0; i < n; i++)
+         mask.push_back(i == 0 ? llvm::ConstantInt::get(GetIntType(), r) :
+                        i == 1 ? llvm::ConstantInt::get(GetIntType(), n + r) : undefIdx);
+      llvm::Value *row = new llvm::ShuffleVectorInst(cols[0], cols[1], llvm::ConstantVector::get(mask), "", currentBB);
+      for(int c = 2; c < n; c++) {
+         mask.clear();
+         for(int i = 0; i < n; i++)
+            mask.push_back(i < c ? llvm::ConstantInt::get(GetIntType(), i) :
+                           i == c ? llvm::ConstantInt::get(GetIntType(), n + r) : undefIdx);
+         row = new llvm::ShuffleVectorInst(row, cols[c], llvm::ConstantVector::get(mask), "", currentBB);
+      }
+      result = SetColumn(result, row, r);
+   }
+   return result;
+}
+
+llvm::Value *IRGenerator::CreateMatrixOp(char op, llvm::Value *lhs, llvm::Value *rhs) {
+   bool lm = IsMatrixType(lhs->getType());
+   bool rm = IsMatrixType(rhs->getType());
+
+   if(op == '*') {
+      if(lm && rm) {
+         llvm::Value *result = llvm::UndefValue::get(rhs->getType());
+         for(int j = 0; j < GetMatrixSize(rhs->getType()); j++)
+            result = SetColumn(result, CreateMatVecMul(lhs, GetColumn(rhs, j)), j);
+         return result;
+      }
+      if(lm && rhs->getType()->isVectorTy())
+         return CreateMatVecMul(lhs, rhs);
+      if(rm && lhs->getType()->isVectorTy())
+         return CreateMatVecMul(CreateTranspose(rhs), lhs);
+   }
+
+   // component-wise, broadcasting a scalar operand across every column
+   llvm::Type *ty = lm ? lhs->getType() : rhs->getType();
+   int n = GetMatrixSize(ty);
+   llvm::Value *ls = lm ? NULL : CreateSplat(lhs, n);
+   llvm::Value *rs = rm ? NULL : CreateSplat(rhs, n);
+   llvm::Instruction::BinaryOps opc = llvm::Instruction::FAdd;
+   if(op == '-')
+      opc = llvm::Instruction::FSub;
+   else if(op == '*')
+      opc = llvm::Instruction::FMul;
+   else if(op == '/')
+      opc = llvm::Instruction::FDiv;
+
+   llvm::Value *result = llvm::UndefValue::get(ty);
+   for(int j = 0; j < n; j++) {
+      llvm::Value *l = lm ? GetColumn(lhs, j) : ls;
+      llvm::Value *r = rm ? GetColumn(rhs, j) : rs;
+      result = SetColumn(result, llvm::BinaryOperator::Create(opc, l, r, "", currentBB), j);
+   }
+   return result;
+}
+
 const char *IRGenerator::TargetLayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64-S128";
 
 const char *IRGenerator::TargetTriple = "x86_64-redhat-linux-gnu";
@@ -13,12 +13,17 @@
 
 // LLVM headers
 #include <vector>
-#include <stack>
+#include <map>
+#include <set>
+#include <string>
 #include "llvm/IR/Module.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Constants.h"
+#include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/Operator.h"
 #include "llvm/Support/CFG.h"
+#include "llvm/Support/ValueHandle.h"
 #include "ast_type.h"
 
 using namespace std;
@@ -38,22 +43,278 @@ class IRGenerator {
     llvm::BasicBlock *GetBasicBlock() const;
     void        SetBasicBlock(llvm::BasicBlock *bb);
 
+    // BeginFunction enters a sealed entry block; EndFunction drops the
+    // per-function variable state
+    void BeginFunction(llvm::Function *func);
+    void EndFunction();
+
+    // Local variables. Under -fssa, locals the caller marks promotable
+    // live in registers: the returned value is only a key, and loads and
+    // stores through it read and write the variable's current definition,
+    // placing phis on the fly over the structured CFG (Braun et al.,
+    // "Simple and Efficient Construction of SSA Form"). Everything else
+    // gets an alloca at the top of the entry block.
+    llvm::Value *CreateLocal(llvm::Type *ty, const char *name, bool promotable);
+    llvm::Value *CreateLoad(llvm::Value *addr, const char *name = "");
+    llvm::Value *CreateStore(llvm::Value *val, llvm::Value *addr);
+    bool IsRegisterVariable(llvm::Value *addr) const;
+
     llvm::Type *GetIntType() const;
     llvm::Type *GetBoolType() const;
     llvm::Type *GetFloatType() const;
     llvm::Type *GetType(Type *type) const;
 
-    stack<llvm::BasicBlock*> *fbs;
-    stack<llvm::BasicBlock*> *cbs;
-    stack<llvm::BasicBlock*> *lbs;
+    // Matrices are named structs wrapping an array of column vectors,
+    // e.g. mat4 is %mat4 = type { [4 x <4 x float>] }
+    bool IsMatrixType(llvm::Type *ty) const;
+    int GetMatrixSize(llvm::Type *ty) const;
+    llvm::Value *GetColumn(llvm::Value *mat, int col);
+    llvm::Value *SetColumn(llvm::Value *mat, llvm::Value *vec, int col);
+
+    // Vectorized lowering for matrix constructors and arithmetic; op is
+    // one of '+', '-', '*', '/'
+    llvm::Value *CreateMatrix(llvm::Type *ty, vector<llvm::Value*> &args);
+    // vecN/ivecN/bvecN(...) from scalars, vectors and matrices whose
+    // element type already matches ty
+    llvm::Value *CreateVector(llvm::Type *ty, vector<llvm::Value*> &args);
+    llvm::Value *CreateMatrixOp(char op, llvm::Value *lhs, llvm::Value *rhs);
+    llvm::Value *CreateMatVecMul(llvm::Value *mat, llvm::Value *vec);
+    llvm::Value *CreateTranspose(llvm::Value *mat);
+
+    // The Create* helpers below fold to constants when every operand is
+    // a constant, so constant subtrees never reach the instruction stream.
+
+    // Arithmetic on scalars or vectors of either element kind; a scalar
+    // operand is broadcast to the width of a vector one
+    llvm::Value *CreateBinaryOp(char op, llvm::Value *lhs, llvm::Value *rhs, bool isUnsigned);
+    // Conversion constructor semantics: int(f), vec3(iv), bvec2(v), ...
+    llvm::Value *CreateCast(llvm::Value *val, llvm::Type *to, bool fromUnsigned, bool toUnsigned);
+    // Writes src into the lanes of dst named by a swizzle like "xz"
+    llvm::Value *CreateSwizzleInsert(llvm::Value *dst, llvm::Value *src, const char *swiz);
+    // True when every lane of an <N x i1> mask is set
+    llvm::Value *CreateAll(llvm::Value *mask);
+    llvm::Value *CreateCompare(llvm::CmpInst::Predicate pred, llvm::Value *lhs, llvm::Value *rhs);
+    llvm::Value *CreateNot(llvm::Value *val);
+
+    // Built-in function library (dot, length, min, mix, sqrt, ...), lowered
+    // inline to intrinsics and vector code. EmitBuiltin returns NULL when
+    // name/arity is not a built-in.
+    static bool IsBuiltin(const char *name);
+    llvm::Value *EmitBuiltin(const char *name, vector<llvm::Value*> &args, bool isUnsigned);
+    llvm::Value *CreateIntrinsic(llvm::Intrinsic::ID id, vector<llvm::Value*> &args);
+    llvm::Value *CreateReduceAdd(llvm::Value *vec);
+    llvm::Value *CreateMinMax(bool isMax, llvm::Value *a, llvm::Value *b, bool isUnsigned);
+
+    // Broadcast a scalar into every lane of an n wide vector
+    llvm::Value *CreateSplat(llvm::Value *scalar, int n);
+    llvm::Value *CreateLaneSplat(llvm::Value *vec, int lane);
+
+    // Structured control flow. Blocks are created detached and inserted
+    // into the function by EmitBlock only once something branches to them;
+    // the current block is NULL while the code being emitted is unreachable.
+    llvm::BasicBlock *CreateBlock(const char *name);
+    // A block is sealed once all its predecessors exist; that is true when
+    // it is emitted except for loop headers, sealed after the back edge.
+    void EmitBlock(llvm::BasicBlock *bb, bool seal = true);
+    void SealBlock(llvm::BasicBlock *bb);
+    llvm::BranchInst *EmitBranch(llvm::BasicBlock *target);
+    llvm::BranchInst *EmitCondBranch(llvm::Value *cond, llvm::BasicBlock *ifTrue, llvm::BasicBlock *ifFalse);
+    // Attaches llvm.loop metadata made of (name, value) hints to a latch
+    void SetLoopHints(llvm::Instruction *latch, vector<pair<const char*, int> > &hints);
+    bool IsReachable() const { return currentBB != NULL; }
+    // Under -fbounds-check, branches to a per-function llvm.trap block
+    // unless 0 <= index < count
+    void CreateBoundsCheck(llvm::Value *index, int count);
+
+    // Fast-math. The -ffast-math family sets these flags for every function
+    // and "#pragma fastmath <flags>" overrides them for the next one. With
+    // LLVM 3.4 reassoc is UnsafeAlgebra, which implies the other flags;
+    // contract fuses a single-use fmul into its fadd as llvm.fmuladd.
+    enum FastMath { FM_Contract = 1, FM_Reassoc = 2, FM_NoNaNs = 4, FM_NoInfs = 8,
+                    FM_ArcP = 16, FM_All = 31 };
+    // "fast" (or "") for all flags, "none" for strict IEEE, otherwise a
+    // comma separated list of flag names; -1 for an unknown name
+    static int ParseFastMath(const char *spec);
+    // From -ffast-math[=<flags>] plus -fcontract, -freassoc, -fnnan,
+    // -fninf and -farcp
+    int GetDefaultFastMath();
+    void SetFastMath(int flags) { fastMath = flags; }
+
+    // Linkage. Entry points come from -fentry=<f>[,<g>...] or from the
+    // funct: line of -fdat=<file.dat>, whose gin: lines name the globals
+    // the runner sets. Once they are known every other function and global
+    // is internal; without them everything stays external.
+    bool HasEntryPoints();
+    llvm::GlobalValue::LinkageTypes GetFunctionLinkage(const char *name);
+    llvm::GlobalValue::LinkageTypes GetGlobalLinkage(const char *name);
+    // Internal functions use fastcc; once emitted, those costing at most
+    // InlineBudget that do not call themselves are always inlined
+    void SetFunctionLinkage(llvm::Function *fun);
+    void MarkInlineCandidate(llvm::Function *fun, int cost);
+    llvm::CallInst *CreateCall(llvm::Function *fn, vector<llvm::Value*> &args);
+    // out/inout parameters: the local a parameter lives in is stored back
+    // through its pointer argument in front of every return
+    void AddCopyOut(llvm::Value *local, llvm::Value *arg);
+    void EmitCopyOuts();
+
+    // Instrumentation, under -finstrument. A function calls
+    // glc_prof_enter(id) on entry and glc_prof_exit(id) before each return,
+    // and each call of a function is preceded by glc_prof_call(site). The
+    // runner supplies the hooks; the module's "glc.prof.names" string names
+    // the ids, one "f <id> <function>" or "c <site> <caller> <callee>
+    // <line>" per line.
+    void EmitProfEnter(llvm::Function *fun);
+    void EmitProfExit();
+    void EmitProfCall(llvm::Function *callee, int line);
+
+    // Profiled branches: the ifs, ?:s, loop tests and switches of a
+    // function are numbered in the order they are emitted. Instrumented,
+    // each way out of one counts through glc_prof_count(counter), named by
+    // a "b <first counter> <ways> <function> <n> <line> <kind>" line. With
+    // -fprofile-use=<file> the counts of such a run, one "<function> <n>
+    // <line> <kind> <count>..." line per branch, become branch weights and
+    // order the cases of a switch, most frequent first. Ways are false then
+    // true for a branch, and the default then the cases in source order
+    // for a switch.
+    llvm::BranchInst *EmitProfiledBranch(llvm::Value *cond, llvm::BasicBlock *ifTrue, llvm::BasicBlock *ifFalse,
+                                         const char *kind, int line);
+    llvm::SwitchInst *EmitSwitch(llvm::Value *cond, llvm::BasicBlock *dflt,
+                                 vector<pair<llvm::ConstantInt*, llvm::BasicBlock*> > &cases, int line);
+
+    // Pointer arguments are noalias when the function stores only to its
+    // own locals and calls nothing but intrinsics
+    void MarkNoAlias(llvm::Function *fun);
+    // Widens the lane variants, then inlines the always-inline helpers and
+    // drops unreferenced internals (after adding the instrumentation names,
+    // and a "glc.lanes" string naming each function left without a lane
+    // variant, one "<function>: <reason>" per line)
+    void FinishModule();
+
+    // break/continue targets of the enclosing loops and switches; a switch
+    // pushes a NULL continue target and inherits its loop's
+    void PushJumpFrame(llvm::BasicBlock *breakTarget, llvm::BasicBlock *continueTarget);
+    void PopJumpFrame();
+    llvm::BasicBlock *GetBreakTarget() const;
+    llvm::BasicBlock *GetContinueTarget() const;
+
+    // Lane variants, under -flanes=<width> (4, 8 or 16). Each function is
+    // emitted a second time as <name>.masked, whose first parameter is an
+    // i1 execution mask: the code of one invocation with its control flow
+    // turned into masks. A condition narrows the mask instead of branching,
+    // a store only changes the variable where the mask is set, and break,
+    // continue and return clear it until the lanes rejoin after the
+    // statement. What branches remain skip code or leave a loop, and are
+    // taken when the condition holds for any invocation of the group; so
+    // an arm no invocation takes is skipped, and a loop ends once none is
+    // left in it. FinishModule widens each into <name>.lanes (see lanes.h).
+    int GetLaneWidth();
+    bool InLanes() const { return laneMask != NULL; }
+    void BeginLanes(llvm::Value *mask, llvm::Type *resultTy);
+    // Copies out and returns for the invocations the function was called
+    // for; the reason the variant cannot be widened, or "" if it can
+    string EndLanes();
+    llvm::Value *GetLaneMask();
+    void SetLaneMask(llvm::Value *mask);
+    // True once no invocation can still be running at this point
+    bool IsMaskClear();
+    // a and b, a or b of masks, folding a constant operand
+    llvm::Value *CreateMaskAnd(llvm::Value *a, llvm::Value *b);
+    llvm::Value *CreateMaskOr(llvm::Value *a, llvm::Value *b);
+    // The invocations that have not returned
+    llvm::Value *GetLiveMask();
+    // Each loop trip gathers the invocations that continue, to resume them
+    // at the step; NULL outside any loop
+    void PushLaneLoop(llvm::Value *continued);
+    llvm::Value *CreateMaskVariable(const char *name);
+    llvm::Value *ReadMask(llvm::Value *var);
+    void WriteMask(llvm::Value *var, llvm::Value *mask);
+    llvm::Value *GetContinueMask() const;
+    void EmitLaneBreak();
+    void EmitLaneContinue();
+    void EmitLaneReturn(llvm::Value *val);
+    // A function without a variant, and why; the first reason noted while
+    // emitting one is what EndLanes returns
+    void NoteLaneFallback(const string &why);
+    void AddLaneFallback(const char *name, const string &why);
+    void AddLaneVariant(llvm::Function *masked, llvm::Function *scalar);
 
   private:
+    struct JumpFrame {
+        llvm::BasicBlock *breakTarget;
+        llvm::BasicBlock *continueTarget;
+        llvm::Value *continueMask;
+    };
+
     llvm::LLVMContext *context;
     llvm::Module      *module;
 
     // track which function or basic block is active
     llvm::Function    *currentFunc;
     llvm::BasicBlock  *currentBB;
+    llvm::BasicBlock  *trapBB;
+    vector<JumpFrame>  jumps;
+    vector<pair<llvm::Value*, llvm::Value*> > copyOuts;
+
+    // instrumentation: "f"/"c" lines of glc.prof.names, and the id of the
+    // function being emitted
+    string profNames;
+    int profFunctions, profSites, profId;
+    llvm::Function *GetProfHook(const char *name);
+
+    // profiled branches: counters handed out, the number of the next branch
+    // in the function, and the counts read for -fprofile-use by
+    // "<function> <n>"
+    struct BranchProfile {
+        int line;
+        vector<uint64_t> counts;
+    };
+    int profCounters, profBranch;
+    bool profileLoaded;
+    map<string, BranchProfile> branchProfile;
+    int AddProfCounters(int n, int ways, const char *kind, int line);
+    void EmitProfCount(llvm::Value *counter);
+    bool GetBranchCounts(int n, int ways, int line, vector<uint64_t> &counts);
+    void SetBranchWeights(llvm::Instruction *term, vector<uint64_t> &counts);
+
+    // fast-math flags of the function being emitted
+    int fastMath;
+    void ApplyFastMath(llvm::Function *func);
+
+    // entry points and runner-visible globals, read on first use
+    bool entriesLoaded;
+    set<string> entryPoints;
+    set<string> externalGlobals;
+    set<llvm::Function*> recursiveFuncs;
+    static const int InlineBudget = 32;
+    void LoadEntryPoints();
+
+    // lane variants: the width, the current mask, not-yet-returned and
+    // result variables of the one being emitted, the mask it was called
+    // with and why it cannot be widened; the variants to widen with their
+    // scalar functions, and "<function>: <reason>" lines for glc.lanes
+    int laneWidth;
+    llvm::Value *laneMask, *laneLive, *laneResult, *laneEntry;
+    string laneFallback;
+    vector<pair<llvm::Function*, llvm::Function*> > laneVariants;
+    string laneNotes;
+
+    // SSA construction state, keyed by the variable keys of CreateLocal
+    typedef map<llvm::Value*, llvm::WeakVH> DefMap;
+    set<llvm::Value*> registerVars;
+    map<llvm::BasicBlock*, DefMap> currentDef;
+    set<llvm::BasicBlock*> sealedBlocks;
+    map<llvm::BasicBlock*, vector<pair<llvm::Value*, llvm::PHINode*> > > incompletePhis;
+
+    llvm::Value *CreateRegister(llvm::Type *ty, const char *name);
+    void WriteVariable(llvm::Value *var, llvm::BasicBlock *bb, llvm::Value *val);
+    llvm::Value *ReadVariable(llvm::Value *var, llvm::BasicBlock *bb);
+    llvm::Value *ReadVariableRecursive(llvm::Value *var, llvm::BasicBlock *bb);
+    llvm::Value *AddPhiOperands(llvm::Value *var, llvm::PHINode *phi);
+    llvm::Value *TryRemoveTrivialPhi(llvm::PHINode *phi);
+
+    llvm::Type *GetMatrixType(int n) const;
+    void FlattenLanes(vector<llvm::Value*> &args, vector<pair<llvm::Value*, int> > &lanes);
+    llvm::Value *BuildVector(llvm::Type *ty, vector<pair<llvm::Value*, int> > &lanes, int first);
 
     static const char *TargetTriple;
     static const char *TargetLayout;
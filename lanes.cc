@@ -0,0 +1,824 @@
+/* File: lanes.cc
+ * --------------
+ * Implementation of the lane widener of glc -flanes.
+ */
+
+#include "lanes.h"
+#include <vector>
+#include <set>
+#include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/Operator.h"
+#include "llvm/ADT/PostOrderIterator.h"
+#include "llvm/Support/CFG.h"
+
+static unsigned NumElements(llvm::Type *ty) {
+    if(llvm::StructType *st = llvm::dyn_cast<llvm::StructType>(ty))
+        return st->getNumElements();
+    if(llvm::ArrayType *at = llvm::dyn_cast<llvm::ArrayType>(ty))
+        return at->getNumElements();
+    return ty->getVectorNumElements();
+}
+
+static llvm::Type *ElementType(llvm::Type *ty, unsigned i) {
+    if(llvm::StructType *st = llvm::dyn_cast<llvm::StructType>(ty))
+        return st->getElementType(i);
+    if(llvm::ArrayType *at = llvm::dyn_cast<llvm::ArrayType>(ty))
+        return at->getElementType();
+    return ty->getVectorElementType();
+}
+
+// The type index k of ty picks, k a constant for a struct
+static llvm::Type *IndexedType(llvm::Type *ty, llvm::Value *k) {
+    if(llvm::StructType *st = llvm::dyn_cast<llvm::StructType>(ty))
+        return st->getElementType(llvm::cast<llvm::ConstantInt>(k)->getZExtValue());
+    return ElementType(ty, 0);
+}
+
+static llvm::Constant *GetIndex(llvm::LLVMContext &ctx, int i) {
+    return llvm::ConstantInt::get(llvm::Type::getInt32Ty(ctx), i);
+}
+
+LaneWidener::LaneWidener(llvm::Module *m, int w) : module(m), width(w) {}
+
+void LaneWidener::AddVariant(llvm::Function *masked, llvm::Function *scalar) {
+    scalars[masked] = scalar;
+}
+
+llvm::Type *LaneWidener::WideType(llvm::Type *ty) {
+    map<llvm::Type*, llvm::Type*>::iterator it = types.find(ty);
+    if(it != types.end())
+        return it->second;
+    llvm::Type *wide;
+    if(ty->isVoidTy() || ty->isLabelTy())
+        wide = ty;
+    else if(llvm::VectorType *vt = llvm::dyn_cast<llvm::VectorType>(ty))
+        wide = llvm::VectorType::get(vt->getElementType(), vt->getNumElements() * width);
+    else if(llvm::ArrayType *at = llvm::dyn_cast<llvm::ArrayType>(ty))
+        wide = llvm::ArrayType::get(WideType(at->getElementType()), at->getNumElements());
+    else if(llvm::PointerType *pt = llvm::dyn_cast<llvm::PointerType>(ty))
+        wide = llvm::PointerType::get(WideType(pt->getElementType()), pt->getAddressSpace());
+    else if(llvm::StructType *st = llvm::dyn_cast<llvm::StructType>(ty)) {
+        vector<llvm::Type*> elems;
+        for(unsigned i = 0; i < st->getNumElements(); i++)
+            elems.push_back(WideType(st->getElementType(i)));
+        if(!st->hasName())
+            wide = llvm::StructType::get(ty->getContext(), elems, st->isPacked());
+        // a module glc-exec read back already has the named ones
+        else if((wide = module->getTypeByName(st->getName().str() + ".lanes")) == NULL)
+            wide = llvm::StructType::create(ty->getContext(), elems, st->getName().str() + ".lanes", st->isPacked());
+    }
+    else
+        wide = llvm::VectorType::get(ty, width);
+    types[ty] = wide;
+    return wide;
+}
+
+llvm::Constant *LaneWidener::SplatConstant(llvm::Constant *c) {
+    llvm::Type *ty = c->getType();
+    if(llvm::isa<llvm::UndefValue>(c))
+        return llvm::UndefValue::get(WideType(ty));
+    if(c->isNullValue())
+        return llvm::Constant::getNullValue(WideType(ty));
+    if(llvm::isa<llvm::ConstantExpr>(c) || llvm::isa<llvm::GlobalValue>(c))
+        return NULL;
+    if(ty->isIntegerTy() || ty->isFloatingPointTy())
+        return llvm::ConstantVector::getSplat(width, c);
+
+    vector<llvm::Constant*> elems;
+    for(unsigned i = 0; i < NumElements(ty); i++) {
+        llvm::Constant *e = c->getAggregateElement(i);
+        if(e == NULL)
+            return NULL;
+        if(ty->isVectorTy()) {
+            elems.insert(elems.end(), width, e);
+            continue;
+        }
+        if((e = SplatConstant(e)) == NULL)
+            return NULL;
+        elems.push_back(e);
+    }
+    if(ty->isVectorTy())
+        return llvm::ConstantVector::get(elems);
+    if(ty->isArrayTy())
+        return llvm::ConstantArray::get(llvm::cast<llvm::ArrayType>(WideType(ty)), elems);
+    return llvm::ConstantStruct::get(llvm::cast<llvm::StructType>(WideType(ty)), elems);
+}
+
+llvm::Value *LaneWidener::Splat(llvm::Value *v, llvm::BasicBlock *bb) {
+    if(llvm::Constant *c = llvm::dyn_cast<llvm::Constant>(v))
+        if(llvm::Constant *wide = SplatConstant(c))
+            return wide;
+    llvm::LLVMContext &ctx = v->getContext();
+    llvm::Type *ty = v->getType();
+    if(ty->isAggregateType()) {
+        llvm::Value *wide = llvm::UndefValue::get(WideType(ty));
+        for(unsigned i = 0; i < NumElements(ty); i++) {
+            llvm::Value *e = llvm::ExtractValueInst::Create(v, i, "", bb);
+            wide = llvm::InsertValueInst::Create(wide, Splat(e, bb), i, "", bb);
+        }
+        return wide;
+    }
+    vector<llvm::Constant*> mask;
+    if(ty->isVectorTy()) {
+        for(unsigned c = 0; c < ty->getVectorNumElements(); c++)
+            mask.insert(mask.end(), width, GetIndex(ctx, c));
+        return new llvm::ShuffleVectorInst(v, llvm::UndefValue::get(ty), llvm::ConstantVector::get(mask), "", bb);
+    }
+    llvm::Type *wt = WideType(ty);
+    llvm::Value *first = llvm::InsertElementInst::Create(llvm::UndefValue::get(wt), v, GetIndex(ctx, 0), "", bb);
+    mask.assign(width, GetIndex(ctx, 0));
+    return new llvm::ShuffleVectorInst(first, llvm::UndefValue::get(wt), llvm::ConstantVector::get(mask), "", bb);
+}
+
+llvm::Value *LaneWidener::Slice(llvm::Value *vec, int first, int count, llvm::BasicBlock *bb) {
+    vector<llvm::Constant*> mask;
+    for(int i = 0; i < count; i++)
+        mask.push_back(GetIndex(vec->getContext(), first + i));
+    return new llvm::ShuffleVectorInst(vec, llvm::UndefValue::get(vec->getType()), llvm::ConstantVector::get(mask), "", bb);
+}
+
+llvm::Value *LaneWidener::ExtractLane(llvm::Value *wide, llvm::Type *ty, int lane, llvm::BasicBlock *bb) {
+    llvm::LLVMContext &ctx = wide->getContext();
+    if(ty->isAggregateType()) {
+        llvm::Value *v = llvm::UndefValue::get(ty);
+        for(unsigned i = 0; i < NumElements(ty); i++) {
+            llvm::Value *e = llvm::ExtractValueInst::Create(wide, i, "", bb);
+            v = llvm::InsertValueInst::Create(v, ExtractLane(e, ElementType(ty, i), lane, bb), i, "", bb);
+        }
+        return v;
+    }
+    if(ty->isVectorTy()) {
+        vector<llvm::Constant*> mask;
+        for(unsigned c = 0; c < ty->getVectorNumElements(); c++)
+            mask.push_back(GetIndex(ctx, c * width + lane));
+        return new llvm::ShuffleVectorInst(wide, llvm::UndefValue::get(wide->getType()), llvm::ConstantVector::get(mask), "", bb);
+    }
+    return llvm::ExtractElementInst::Create(wide, GetIndex(ctx, lane), "", bb);
+}
+
+llvm::Value *LaneWidener::InsertLane(llvm::Value *wide, llvm::Value *v, int lane, llvm::BasicBlock *bb) {
+    llvm::LLVMContext &ctx = wide->getContext();
+    llvm::Type *ty = v->getType();
+    if(ty->isAggregateType()) {
+        for(unsigned i = 0; i < NumElements(ty); i++) {
+            llvm::Value *w = llvm::ExtractValueInst::Create(wide, i, "", bb);
+            llvm::Value *e = llvm::ExtractValueInst::Create(v, i, "", bb);
+            wide = llvm::InsertValueInst::Create(wide, InsertLane(w, e, lane, bb), i, "", bb);
+        }
+        return wide;
+    }
+    if(ty->isVectorTy()) {
+        for(unsigned c = 0; c < ty->getVectorNumElements(); c++) {
+            llvm::Value *e = llvm::ExtractElementInst::Create(v, GetIndex(ctx, c), "", bb);
+            wide = llvm::InsertElementInst::Create(wide, e, GetIndex(ctx, c * width + lane), "", bb);
+        }
+        return wide;
+    }
+    return llvm::InsertElementInst::Create(wide, v, GetIndex(ctx, lane), "", bb);
+}
+
+/* A variable the widened code reads or writes: the widened alloca or
+ * pointer argument of lane memory, which keeps every lane of the group,
+ * or a global, which is the same for all of them. indices follow the
+ * leading 0 of the GEPs that reached it, as constants or widened values;
+ * when the last one picks a vector component the lanes of that component
+ * are a slice of the widened vector.
+ */
+struct Address {
+    llvm::Value *base;
+    bool         uniform;
+    llvm::Type  *root;              // the scalar type of the variable
+    vector<llvm::Value*> indices;
+    bool         component;
+};
+
+class FunctionWidener {
+  public:
+    FunctionWidener(LaneWidener *l, llvm::Function *f, llvm::Function *t);
+    bool Run(string &reason);
+
+  private:
+    LaneWidener *lanes;
+    llvm::Function *from, *to;
+    llvm::LLVMContext &ctx;
+    int width;
+    map<llvm::Value*, llvm::Value*> vals;
+    map<llvm::Value*, Address> addrs;
+    map<llvm::BasicBlock*, llvm::BasicBlock*> blocks;
+    vector<llvm::PHINode*> phis;
+    llvm::BasicBlock *bb;
+    string why;
+
+    bool Fail(const string &reason) { why = reason; return false; }
+    llvm::Value *Get(llvm::Value *v);
+    llvm::Value *CreateAlloca(llvm::Type *ty);
+    bool GetAddress(llvm::Value *ptr, Address &a);
+    bool IsVarying(const Address &a);
+    llvm::Value *CreateGEP(const Address &a, int lane, size_t count, bool toLane);
+    llvm::Value *Load(const Address &a, llvm::Type *ty);
+    llvm::Value *LoadLane(const Address &a, llvm::Type *ty, int lane);
+    bool Store(const Address &a, llvm::Value *val, llvm::Type *ty);
+    void StoreLane(const Address &a, llvm::Value *val, llvm::Type *ty, int lane);
+    llvm::Value *Select(llvm::Value *cond, bool scalarCond, llvm::Value *a, llvm::Value *b, llvm::Type *ty);
+    llvm::Value *Divide(llvm::BinaryOperator *inst, llvm::Value *x, llvm::Value *d);
+    bool WidenCall(llvm::CallInst *call);
+    bool Widen(llvm::Instruction *inst);
+};
+
+FunctionWidener::FunctionWidener(LaneWidener *l, llvm::Function *f, llvm::Function *t)
+    : lanes(l), from(f), to(t), ctx(f->getContext()), width(l->GetWidth()), bb(NULL) {}
+
+llvm::Value *FunctionWidener::Get(llvm::Value *v) {
+    map<llvm::Value*, llvm::Value*>::iterator it = vals.find(v);
+    if(it != vals.end())
+        return it->second;
+    if(llvm::isa<llvm::Constant>(v) && !v->getType()->isPointerTy())
+        return lanes->Splat(v, bb);
+    return NULL;
+}
+
+llvm::Value *FunctionWidener::CreateAlloca(llvm::Type *ty) {
+    llvm::BasicBlock *entry = &to->getEntryBlock();
+    if(entry->empty())
+        return new llvm::AllocaInst(ty, "", entry);
+    return new llvm::AllocaInst(ty, "", &entry->front());
+}
+
+bool FunctionWidener::GetAddress(llvm::Value *ptr, Address &a) {
+    map<llvm::Value*, Address>::iterator it = addrs.find(ptr);
+    if(it != addrs.end()) {
+        a = it->second;
+        return true;
+    }
+    if(llvm::GlobalVariable *g = llvm::dyn_cast<llvm::GlobalVariable>(ptr)) {
+        a.base = g;
+        a.uniform = true;
+        a.root = g->getType()->getElementType();
+        a.indices.clear();
+        a.component = false;
+        return true;
+    }
+    llvm::GEPOperator *gep = llvm::dyn_cast<llvm::GEPOperator>(ptr);
+    if(gep == NULL)
+        return Fail("selects between variables");
+    if(!GetAddress(gep->getPointerOperand(), a))
+        return false;
+    llvm::ConstantInt *first = llvm::dyn_cast<llvm::ConstantInt>(gep->getOperand(1));
+    if(first == NULL || !first->isZero() || a.component)
+        return Fail("indexes past the end of a variable");
+
+    llvm::Type *ty = a.root;
+    for(size_t i = 0; i < a.indices.size(); i++)
+        ty = IndexedType(ty, a.indices[i]);
+    for(unsigned i = 2; i < gep->getNumOperands(); i++) {
+        llvm::Value *idx = gep->getOperand(i);
+        if(llvm::isa<llvm::ConstantInt>(idx))
+            a.indices.push_back(idx);
+        else if((idx = Get(idx)) != NULL)
+            a.indices.push_back(idx);
+        else
+            return Fail("indexes with a value it cannot follow");
+        a.component = ty->isVectorTy();
+        ty = IndexedType(ty, idx);
+    }
+    return true;
+}
+
+bool FunctionWidener::IsVarying(const Address &a) {
+    for(size_t i = 0; i < a.indices.size(); i++)
+        if(!llvm::isa<llvm::ConstantInt>(a.indices[i]))
+            return true;
+    return false;
+}
+
+/* The GEP of the first count indices of a. For lane memory it reaches a
+ * widened value; a lane >= 0 takes that lane's element of each varying
+ * index, clamped into range as the other lanes need not be, and toLane
+ * goes on to the lane's element in a widened scalar, or its element of a
+ * component. For a global it is the scalar GEP of the lane, or of all of
+ * them when no index varies.
+ */
+llvm::Value *FunctionWidener::CreateGEP(const Address &a, int lane, size_t count, bool toLane) {
+    vector<llvm::Value*> idx;
+    idx.push_back(GetIndex(ctx, 0));
+    llvm::Type *ty = a.root;
+    for(size_t i = 0; i < count; i++) {
+        llvm::Value *k = a.indices[i];
+        if(!llvm::isa<llvm::ConstantInt>(k)) {
+            k = llvm::ExtractElementInst::Create(k, GetIndex(ctx, lane), "", bb);
+            llvm::Value *n = llvm::ConstantInt::get(k->getType(), NumElements(ty));
+            llvm::Value *in = llvm::CmpInst::Create(llvm::Instruction::ICmp, llvm::CmpInst::ICMP_ULT, k, n, "", bb);
+            k = llvm::SelectInst::Create(in, k, llvm::ConstantInt::get(k->getType(), 0), "", bb);
+        }
+        if(a.uniform || !(a.component && i + 1 == a.indices.size()))
+            idx.push_back(k);
+        else if(toLane) {
+            llvm::Value *w = llvm::ConstantInt::get(k->getType(), width);
+            llvm::Value *l = llvm::ConstantInt::get(k->getType(), lane);
+            k = llvm::BinaryOperator::CreateMul(k, w, "", bb);
+            idx.push_back(llvm::BinaryOperator::CreateAdd(k, l, "", bb));
+        }
+        ty = IndexedType(ty, a.indices[i]);
+    }
+    if(toLane && !a.uniform && !a.component)
+        idx.push_back(GetIndex(ctx, lane));
+    return llvm::GetElementPtrInst::Create(a.base, idx, "", bb);
+}
+
+llvm::Value *FunctionWidener::Load(const Address &a, llvm::Type *ty) {
+    size_t n = a.indices.size();
+    if(!IsVarying(a)) {
+        if(a.uniform)
+            return lanes->Splat(new llvm::LoadInst(CreateGEP(a, 0, n, false), "", bb), bb);
+        if(!a.component)
+            return new llvm::LoadInst(CreateGEP(a, 0, n, false), "", bb);
+        // the lanes of a component are consecutive
+        llvm::Value *vec = new llvm::LoadInst(CreateGEP(a, 0, n - 1, false), "", bb);
+        int c = llvm::cast<llvm::ConstantInt>(a.indices[n - 1])->getZExtValue();
+        return lanes->Slice(vec, c * width, width, bb);
+    }
+    llvm::Value *wide = llvm::UndefValue::get(lanes->WideType(ty));
+    for(int l = 0; l < width; l++)
+        wide = lanes->InsertLane(wide, LoadLane(a, ty, l), l, bb);
+    return wide;
+}
+
+llvm::Value *FunctionWidener::LoadLane(const Address &a, llvm::Type *ty, int lane) {
+    size_t n = a.indices.size();
+    // the lane's own element where it has one; an i1 vector has none
+    if(a.uniform || (ty->isSingleValueType() && !ty->isVectorTy() && !ty->isIntegerTy(1)))
+        return new llvm::LoadInst(CreateGEP(a, lane, n, true), "", bb);
+    if(a.component) {
+        llvm::Value *vec = new llvm::LoadInst(CreateGEP(a, lane, n - 1, false), "", bb);
+        llvm::Value *k = llvm::ExtractElementInst::Create(a.indices[n - 1], GetIndex(ctx, lane), "", bb);
+        k = llvm::BinaryOperator::CreateMul(k, llvm::ConstantInt::get(k->getType(), width), "", bb);
+        k = llvm::BinaryOperator::CreateAdd(k, llvm::ConstantInt::get(k->getType(), lane), "", bb);
+        return llvm::ExtractElementInst::Create(vec, k, "", bb);
+    }
+    llvm::Value *wide = new llvm::LoadInst(CreateGEP(a, lane, n, false), "", bb);
+    return lanes->ExtractLane(wide, ty, lane, bb);
+}
+
+bool FunctionWidener::Store(const Address &a, llvm::Value *val, llvm::Type *ty) {
+    size_t n = a.indices.size();
+    if(a.uniform)
+        return Fail("stores to global " + a.base->getName().str());
+    if(!IsVarying(a)) {
+        if(!a.component) {
+            new llvm::StoreInst(val, CreateGEP(a, 0, n, false), bb);
+            return true;
+        }
+        llvm::Value *ptr = CreateGEP(a, 0, n - 1, false);
+        llvm::Value *vec = new llvm::LoadInst(ptr, "", bb);
+        int c = llvm::cast<llvm::ConstantInt>(a.indices[n - 1])->getZExtValue();
+        for(int l = 0; l < width; l++) {
+            llvm::Value *e = llvm::ExtractElementInst::Create(val, GetIndex(ctx, l), "", bb);
+            vec = llvm::InsertElementInst::Create(vec, e, GetIndex(ctx, c * width + l), "", bb);
+        }
+        new llvm::StoreInst(vec, ptr, bb);
+        return true;
+    }
+    for(int l = 0; l < width; l++)
+        StoreLane(a, lanes->ExtractLane(val, ty, l, bb), ty, l);
+    return true;
+}
+
+void FunctionWidener::StoreLane(const Address &a, llvm::Value *val, llvm::Type *ty, int lane) {
+    size_t n = a.indices.size();
+    if(ty->isSingleValueType() && !ty->isVectorTy() && !ty->isIntegerTy(1)) {
+        new llvm::StoreInst(val, CreateGEP(a, lane, n, true), bb);
+        return;
+    }
+    if(a.component) {
+        llvm::Value *ptr = CreateGEP(a, lane, n - 1, false);
+        llvm::Value *vec = new llvm::LoadInst(ptr, "", bb);
+        llvm::Value *k = llvm::ExtractElementInst::Create(a.indices[n - 1], GetIndex(ctx, lane), "", bb);
+        k = llvm::BinaryOperator::CreateMul(k, llvm::ConstantInt::get(k->getType(), width), "", bb);
+        k = llvm::BinaryOperator::CreateAdd(k, llvm::ConstantInt::get(k->getType(), lane), "", bb);
+        new llvm::StoreInst(llvm::InsertElementInst::Create(vec, val, k, "", bb), ptr, bb);
+        return;
+    }
+    llvm::Value *ptr = CreateGEP(a, lane, n, false);
+    llvm::Value *wide = new llvm::LoadInst(ptr, "", bb);
+    new llvm::StoreInst(lanes->InsertLane(wide, val, lane, bb), ptr, bb);
+}
+
+// A select of vectors picks whole invocations when its condition is a
+// scalar, whose lanes are then repeated for every component
+llvm::Value *FunctionWidener::Select(llvm::Value *cond, bool scalarCond, llvm::Value *a, llvm::Value *b, llvm::Type *ty) {
+    if(ty->isAggregateType()) {
+        llvm::Value *v = llvm::UndefValue::get(lanes->WideType(ty));
+        for(unsigned i = 0; i < NumElements(ty); i++) {
+            llvm::Value *ea = llvm::ExtractValueInst::Create(a, i, "", bb);
+            llvm::Value *eb = llvm::ExtractValueInst::Create(b, i, "", bb);
+            llvm::Value *e = Select(cond, scalarCond, ea, eb, ElementType(ty, i));
+            v = llvm::InsertValueInst::Create(v, e, i, "", bb);
+        }
+        return v;
+    }
+    if(ty->isVectorTy() && scalarCond) {
+        vector<llvm::Constant*> mask;
+        for(unsigned c = 0; c < ty->getVectorNumElements(); c++)
+            for(int l = 0; l < width; l++)
+                mask.push_back(GetIndex(ctx, l));
+        cond = new llvm::ShuffleVectorInst(cond, llvm::UndefValue::get(cond->getType()), llvm::ConstantVector::get(mask), "", bb);
+    }
+    return llvm::SelectInst::Create(cond, a, b, "", bb);
+}
+
+// Lanes outside the mask divide whatever they hold: a divisor of 0, or
+// -1 that overflows, is replaced by 1 and x / -1 computed as -x
+llvm::Value *FunctionWidener::Divide(llvm::BinaryOperator *inst, llvm::Value *x, llvm::Value *d) {
+    llvm::Instruction::BinaryOps op = inst->getOpcode();
+    bool isSigned = op == llvm::Instruction::SDiv || op == llvm::Instruction::SRem;
+    llvm::Type *ty = d->getType();
+    llvm::Value *zero = llvm::Constant::getNullValue(ty);
+    llvm::Value *bad = llvm::CmpInst::Create(llvm::Instruction::ICmp, llvm::CmpInst::ICMP_EQ, d, zero, "", bb);
+    llvm::Value *minus = NULL;
+    if(isSigned) {
+        minus = llvm::CmpInst::Create(llvm::Instruction::ICmp, llvm::CmpInst::ICMP_EQ, d,
+                                      llvm::Constant::getAllOnesValue(ty), "", bb);
+        bad = llvm::BinaryOperator::CreateOr(bad, minus, "", bb);
+    }
+    d = llvm::SelectInst::Create(bad, llvm::ConstantInt::get(ty, 1), d, "", bb);
+    llvm::Value *q = llvm::BinaryOperator::Create(op, x, d, "", bb);
+    if(minus == NULL)
+        return q;
+    llvm::Value *neg = op == llvm::Instruction::SDiv ? llvm::BinaryOperator::CreateNeg(x, "", bb) : zero;
+    return llvm::SelectInst::Create(minus, neg, q, "", bb);
+}
+
+/* Intrinsics are declared again at the widened type. A call to another
+ * variant calls its widened function; a variable passed by pointer is
+ * passed as is when it is a whole one or a constant part of one in lane
+ * memory, and otherwise copied to a temporary and back.
+ */
+bool FunctionWidener::WidenCall(llvm::CallInst *call) {
+    llvm::Function *callee = call->getCalledFunction();
+    llvm::Function *target = NULL;
+    if(callee == NULL)
+        return Fail("calls through a pointer");
+    if(callee->isIntrinsic()) {
+        llvm::Intrinsic::ID id = (llvm::Intrinsic::ID)callee->getIntrinsicID();
+        target = callee;
+        if(llvm::Intrinsic::isOverloaded(id))
+            target = llvm::Intrinsic::getDeclaration(lanes->GetModule(), id, lanes->WideType(call->getType()));
+    }
+    else if(lanes->IsVariant(callee)) {
+        string reason;
+        if((target = lanes->Widen(callee, reason)) == NULL)
+            return Fail("calls " + lanes->GetScalar(callee)->getName().str() + ", which " + reason);
+    }
+    else
+        return Fail("calls " + callee->getName().str());
+
+    vector<llvm::Value*> args, temps;
+    vector<Address> copies;
+    vector<llvm::Type*> copyTypes;
+    for(unsigned i = 0; i < call->getNumArgOperands(); i++) {
+        llvm::Value *arg = call->getArgOperand(i);
+        if(!arg->getType()->isPointerTy()) {
+            if((arg = Get(arg)) == NULL)
+                return Fail("passes a value it cannot follow");
+            args.push_back(arg);
+            continue;
+        }
+        Address a;
+        if(!GetAddress(arg, a))
+            return false;
+        llvm::Type *ty = arg->getType()->getPointerElementType();
+        if(!a.uniform && !a.component && !IsVarying(a)) {
+            args.push_back(CreateGEP(a, 0, a.indices.size(), false));
+            continue;
+        }
+        llvm::Value *tmp = CreateAlloca(lanes->WideType(ty));
+        new llvm::StoreInst(Load(a, ty), tmp, bb);
+        args.push_back(tmp);
+        if(!a.uniform) {
+            copies.push_back(a);
+            temps.push_back(tmp);
+            copyTypes.push_back(ty);
+        }
+    }
+    llvm::CallInst *wide = llvm::CallInst::Create(target, args, "", bb);
+    wide->setCallingConv(call->getCallingConv());
+    wide->setAttributes(call->getAttributes());
+    if(llvm::isa<llvm::FPMathOperator>(call))
+        wide->setFastMathFlags(call->getFastMathFlags());
+    vals[call] = wide;
+    for(size_t i = 0; i < copies.size(); i++)
+        Store(copies[i], new llvm::LoadInst(temps[i], "", bb), copyTypes[i]);
+    return true;
+}
+
+bool FunctionWidener::Widen(llvm::Instruction *inst) {
+    llvm::Type *ty = inst->getType();
+    llvm::Value *v = NULL;
+    vector<llvm::Value*> ops;
+    for(unsigned i = 0; i < inst->getNumOperands(); i++) {
+        llvm::Value *op = inst->getOperand(i);
+        if(op->getType()->isPointerTy() || llvm::isa<llvm::BasicBlock>(op) || llvm::isa<llvm::PHINode>(inst)
+           || llvm::isa<llvm::Function>(op))
+            ops.push_back(NULL);
+        else if((op = Get(op)) == NULL)
+            return Fail("uses a value it cannot follow");
+        else
+            ops.push_back(op);
+    }
+
+    switch(inst->getOpcode()) {
+        case llvm::Instruction::Add: case llvm::Instruction::Sub: case llvm::Instruction::Mul:
+        case llvm::Instruction::Shl: case llvm::Instruction::LShr: case llvm::Instruction::AShr:
+        case llvm::Instruction::And: case llvm::Instruction::Or: case llvm::Instruction::Xor:
+        case llvm::Instruction::FAdd: case llvm::Instruction::FSub: case llvm::Instruction::FMul:
+        case llvm::Instruction::FDiv: case llvm::Instruction::FRem: {
+            llvm::BinaryOperator *bin = llvm::cast<llvm::BinaryOperator>(inst);
+            llvm::BinaryOperator *wide = llvm::BinaryOperator::Create(bin->getOpcode(), ops[0], ops[1], "", bb);
+            if(llvm::isa<llvm::FPMathOperator>(inst))
+                wide->setFastMathFlags(inst->getFastMathFlags());
+            v = wide;
+            break;
+        }
+        case llvm::Instruction::SDiv: case llvm::Instruction::UDiv:
+        case llvm::Instruction::SRem: case llvm::Instruction::URem:
+            v = Divide(llvm::cast<llvm::BinaryOperator>(inst), ops[0], ops[1]);
+            break;
+        case llvm::Instruction::ICmp: case llvm::Instruction::FCmp: {
+            llvm::CmpInst *cmp = llvm::cast<llvm::CmpInst>(inst);
+            llvm::CmpInst *wide = llvm::CmpInst::Create(cmp->getOpcode(), cmp->getPredicate(), ops[0], ops[1], "", bb);
+            if(llvm::isa<llvm::FPMathOperator>(inst))
+                wide->setFastMathFlags(inst->getFastMathFlags());
+            v = wide;
+            break;
+        }
+        case llvm::Instruction::Select: {
+            if(ty->isPointerTy())
+                return Fail("selects between variables");
+            bool scalarCond = !inst->getOperand(0)->getType()->isVectorTy();
+            v = Select(ops[0], scalarCond, ops[1], ops[2], ty);
+            break;
+        }
+        case llvm::Instruction::Trunc: case llvm::Instruction::ZExt: case llvm::Instruction::SExt:
+        case llvm::Instruction::FPToUI: case llvm::Instruction::FPToSI: case llvm::Instruction::UIToFP:
+        case llvm::Instruction::SIToFP: case llvm::Instruction::FPTrunc: case llvm::Instruction::FPExt:
+        case llvm::Instruction::BitCast: {
+            llvm::Type *from = inst->getOperand(0)->getType();
+            if(from->isPointerTy() || ty->isPointerTy())
+                return Fail("casts a pointer");
+            if(from->isVectorTy() && !ty->isVectorTy()) {
+                // the bits of an i1 vector (any, all): component c of each
+                // lane is bit c of its integer
+                if(!from->getVectorElementType()->isIntegerTy(1))
+                    return Fail("casts a vector to a scalar");
+                llvm::Type *wt = lanes->WideType(ty);
+                v = llvm::Constant::getNullValue(wt);
+                for(unsigned c = 0; c < from->getVectorNumElements(); c++) {
+                    llvm::Value *bits = new llvm::ZExtInst(lanes->Slice(ops[0], c * width, width, bb), wt, "", bb);
+                    if(c > 0)
+                        bits = llvm::BinaryOperator::CreateShl(bits, lanes->Splat(llvm::ConstantInt::get(ty, c), bb), "", bb);
+                    v = llvm::BinaryOperator::CreateOr(v, bits, "", bb);
+                }
+                break;
+            }
+            if(from->isVectorTy() != ty->isVectorTy()
+               || (ty->isVectorTy() && from->getVectorNumElements() != ty->getVectorNumElements()))
+                return Fail("casts between vectors of different sizes");
+            v = llvm::CastInst::Create((llvm::Instruction::CastOps)inst->getOpcode(), ops[0], lanes->WideType(ty), "", bb);
+            break;
+        }
+        case llvm::Instruction::ShuffleVector: {
+            // component m of the operands is m*width+l, the second's after the first's
+            llvm::ShuffleVectorInst *sh = llvm::cast<llvm::ShuffleVectorInst>(inst);
+            int n = inst->getOperand(0)->getType()->getVectorNumElements();
+            vector<llvm::Constant*> mask;
+            for(unsigned k = 0; k < ty->getVectorNumElements(); k++) {
+                int m = sh->getMaskValue(k);
+                for(int l = 0; l < width; l++) {
+                    if(m < 0)
+                        mask.push_back(llvm::UndefValue::get(llvm::Type::getInt32Ty(ctx)));
+                    else if(m < n)
+                        mask.push_back(GetIndex(ctx, m * width + l));
+                    else
+                        mask.push_back(GetIndex(ctx, n * width + (m - n) * width + l));
+                }
+            }
+            v = new llvm::ShuffleVectorInst(ops[0], ops[1], llvm::ConstantVector::get(mask), "", bb);
+            break;
+        }
+        case llvm::Instruction::ExtractElement: {
+            llvm::Value *idx = inst->getOperand(1);
+            if(llvm::ConstantInt *c = llvm::dyn_cast<llvm::ConstantInt>(idx)) {
+                v = lanes->Slice(ops[0], c->getZExtValue() * width, width, bb);
+                break;
+            }
+            int n = inst->getOperand(0)->getType()->getVectorNumElements();
+            v = llvm::UndefValue::get(lanes->WideType(ty));
+            for(int l = 0; l < width; l++) {
+                llvm::Value *k = llvm::ExtractElementInst::Create(ops[1], GetIndex(ctx, l), "", bb);
+                llvm::Value *in = llvm::CmpInst::Create(llvm::Instruction::ICmp, llvm::CmpInst::ICMP_ULT, k,
+                                                        llvm::ConstantInt::get(k->getType(), n), "", bb);
+                k = llvm::SelectInst::Create(in, k, llvm::ConstantInt::get(k->getType(), 0), "", bb);
+                k = llvm::BinaryOperator::CreateMul(k, llvm::ConstantInt::get(k->getType(), width), "", bb);
+                k = llvm::BinaryOperator::CreateAdd(k, llvm::ConstantInt::get(k->getType(), l), "", bb);
+                llvm::Value *e = llvm::ExtractElementInst::Create(ops[0], k, "", bb);
+                v = llvm::InsertElementInst::Create(v, e, GetIndex(ctx, l), "", bb);
+            }
+            break;
+        }
+        case llvm::Instruction::InsertElement: {
+            llvm::Value *idx = inst->getOperand(2);
+            int n = ty->getVectorNumElements();
+            v = ops[0];
+            for(int l = 0; l < width; l++) {
+                llvm::Value *e = llvm::ExtractElementInst::Create(ops[1], GetIndex(ctx, l), "", bb);
+                llvm::Value *k;
+                if(llvm::ConstantInt *c = llvm::dyn_cast<llvm::ConstantInt>(idx))
+                    k = GetIndex(ctx, c->getZExtValue() * width + l);
+                else {
+                    k = llvm::ExtractElementInst::Create(ops[2], GetIndex(ctx, l), "", bb);
+                    llvm::Value *in = llvm::CmpInst::Create(llvm::Instruction::ICmp, llvm::CmpInst::ICMP_ULT, k,
+                                                            llvm::ConstantInt::get(k->getType(), n), "", bb);
+                    k = llvm::SelectInst::Create(in, k, llvm::ConstantInt::get(k->getType(), 0), "", bb);
+                    k = llvm::BinaryOperator::CreateMul(k, llvm::ConstantInt::get(k->getType(), width), "", bb);
+                    k = llvm::BinaryOperator::CreateAdd(k, llvm::ConstantInt::get(k->getType(), l), "", bb);
+                }
+                v = llvm::InsertElementInst::Create(v, e, k, "", bb);
+            }
+            break;
+        }
+        case llvm::Instruction::ExtractValue:
+            v = llvm::ExtractValueInst::Create(ops[0], llvm::cast<llvm::ExtractValueInst>(inst)->getIndices(), "", bb);
+            break;
+        case llvm::Instruction::InsertValue:
+            v = llvm::InsertValueInst::Create(ops[0], ops[1], llvm::cast<llvm::InsertValueInst>(inst)->getIndices(), "", bb);
+            break;
+        case llvm::Instruction::Alloca: {
+            llvm::AllocaInst *alloca = llvm::cast<llvm::AllocaInst>(inst);
+            Address a;
+            a.base = CreateAlloca(lanes->WideType(alloca->getAllocatedType()));
+            a.uniform = false;
+            a.root = alloca->getAllocatedType();
+            a.component = false;
+            addrs[inst] = a;
+            return true;
+        }
+        case llvm::Instruction::GetElementPtr: {
+            Address a;
+            if(!GetAddress(inst, a))
+                return false;
+            addrs[inst] = a;
+            return true;
+        }
+        case llvm::Instruction::Load: {
+            Address a;
+            if(!GetAddress(inst->getOperand(0), a))
+                return false;
+            v = Load(a, ty);
+            break;
+        }
+        case llvm::Instruction::Store: {
+            Address a;
+            if(!GetAddress(inst->getOperand(1), a))
+                return false;
+            return Store(a, ops[0], inst->getOperand(0)->getType());
+        }
+        case llvm::Instruction::PHI: {
+            if(ty->isPointerTy())
+                return Fail("selects between variables");
+            llvm::PHINode *phi = llvm::cast<llvm::PHINode>(inst);
+            v = llvm::PHINode::Create(lanes->WideType(ty), phi->getNumIncomingValues(), "", bb);
+            phis.push_back(phi);
+            break;
+        }
+        case llvm::Instruction::Call:
+            return WidenCall(llvm::cast<llvm::CallInst>(inst));
+        case llvm::Instruction::Br: {
+            // taken when the condition holds for any lane
+            llvm::BranchInst *br = llvm::cast<llvm::BranchInst>(inst);
+            llvm::BranchInst *wide;
+            if(br->isUnconditional())
+                wide = llvm::BranchInst::Create(blocks[br->getSuccessor(0)], bb);
+            else {
+                llvm::Value *cond = br->getCondition();
+                if(!llvm::isa<llvm::ConstantInt>(cond)) {
+                    llvm::Type *bits = llvm::IntegerType::get(ctx, width);
+                    cond = new llvm::BitCastInst(ops[0], bits, "", bb);
+                    cond = llvm::CmpInst::Create(llvm::Instruction::ICmp, llvm::CmpInst::ICMP_NE, cond,
+                                                 llvm::ConstantInt::get(bits, 0), "", bb);
+                }
+                wide = llvm::BranchInst::Create(blocks[br->getSuccessor(0)], blocks[br->getSuccessor(1)], cond, bb);
+            }
+            if(llvm::MDNode *loop = br->getMetadata("llvm.loop"))
+                wide->setMetadata("llvm.loop", loop);
+            return true;
+        }
+        case llvm::Instruction::Ret: {
+            llvm::Value *ret = inst->getNumOperands() ? ops[0] : NULL;
+            llvm::ReturnInst::Create(ctx, ret, bb);
+            return true;
+        }
+        case llvm::Instruction::Unreachable:
+            new llvm::UnreachableInst(ctx, bb);
+            return true;
+        default:
+            return Fail(string("uses the ") + inst->getOpcodeName() + " instruction");
+    }
+    vals[inst] = v;
+    return true;
+}
+
+bool FunctionWidener::Run(string &reason) {
+    llvm::Function::arg_iterator wa = to->arg_begin();
+    for(llvm::Function::arg_iterator arg = from->arg_begin(); arg != from->arg_end(); arg++, wa++) {
+        if(!arg->getType()->isPointerTy()) {
+            vals[&*arg] = &*wa;
+            continue;
+        }
+        Address a;
+        a.base = &*wa;
+        a.uniform = false;
+        a.root = arg->getType()->getPointerElementType();
+        a.component = false;
+        addrs[&*arg] = a;
+    }
+    for(llvm::Function::iterator b = from->begin(); b != from->end(); b++)
+        blocks[&*b] = llvm::BasicBlock::Create(ctx, b->getName(), to);
+
+    // in reverse post-order every operand but a phi's is widened before its use
+    set<llvm::BasicBlock*> visited;
+    llvm::ReversePostOrderTraversal<llvm::Function*> rpot(from);
+    for(llvm::ReversePostOrderTraversal<llvm::Function*>::rpo_iterator b = rpot.begin(); b != rpot.end(); b++) {
+        bb = blocks[*b];
+        visited.insert(*b);
+        for(llvm::BasicBlock::iterator it = (*b)->begin(); it != (*b)->end(); it++) {
+            if(!Widen(&*it)) {
+                reason = why;
+                return false;
+            }
+        }
+    }
+    for(size_t i = 0; i < phis.size(); i++) {
+        llvm::PHINode *wide = llvm::cast<llvm::PHINode>(vals[phis[i]]);
+        for(unsigned k = 0; k < phis[i]->getNumIncomingValues(); k++) {
+            llvm::BasicBlock *in = phis[i]->getIncomingBlock(k);
+            if(visited.count(in) == 0)
+                continue;
+            // a constant that does not fold is splatted before the branch
+            bb = blocks[in];
+            llvm::Value *val = phis[i]->getIncomingValue(k);
+            llvm::Value *wv;
+            if(llvm::Constant *c = llvm::dyn_cast<llvm::Constant>(val)) {
+                llvm::BasicBlock *tmp = llvm::BasicBlock::Create(ctx, "", to);
+                bb = tmp;
+                wv = lanes->Splat(c, bb);
+                while(!tmp->empty())
+                    tmp->front().moveBefore(blocks[in]->getTerminator());
+                tmp->eraseFromParent();
+            }
+            else if((wv = Get(val)) == NULL) {
+                reason = "uses a value it cannot follow";
+                return false;
+            }
+            wide->addIncoming(wv, blocks[in]);
+        }
+    }
+    // blocks nothing reaches were left empty
+    for(llvm::Function::iterator b = from->begin(); b != from->end(); b++)
+        if(visited.count(&*b) == 0)
+            blocks[&*b]->eraseFromParent();
+    return true;
+}
+
+llvm::Function *LaneWidener::Widen(llvm::Function *masked, string &why) {
+    map<llvm::Function*, llvm::Function*>::iterator it = widened.find(masked);
+    if(it != widened.end()) {
+        if(it->second == NULL)
+            why = reasons[masked];
+        return it->second;
+    }
+    // a variant reached again while it is being widened calls itself
+    widened[masked] = NULL;
+    reasons[masked] = "is recursive";
+
+    llvm::Function *scalar = scalars[masked];
+    llvm::FunctionType *fnTy = masked->getFunctionType();
+    vector<llvm::Type*> params;
+    for(unsigned i = 0; i < fnTy->getNumParams(); i++)
+        params.push_back(WideType(fnTy->getParamType(i)));
+    llvm::FunctionType *wideTy = llvm::FunctionType::get(WideType(fnTy->getReturnType()), params, false);
+    llvm::Function *wide = llvm::Function::Create(wideTy, scalar->getLinkage(), scalar->getName() + ".lanes", module);
+    wide->setCallingConv(scalar->getCallingConv());
+    wide->setAttributes(masked->getAttributes());
+    if(scalar->getAttributes().hasAttribute(llvm::AttributeSet::FunctionIndex, llvm::Attribute::AlwaysInline))
+        wide->addFnAttr(llvm::Attribute::AlwaysInline);
+
+    FunctionWidener fw(this, masked, wide);
+    if(!fw.Run(why)) {
+        reasons[masked] = why;
+        wide->dropAllReferences();
+        wide->eraseFromParent();
+        return NULL;
+    }
+    widened[masked] = wide;
+    return wide;
+}
@@ -0,0 +1,69 @@
+/**
+ * File: lanes.h
+ * -------------
+ *  This file defines the lane widener of glc -flanes. The frontend emits
+ *  each function a second time as <name>.masked, the code of a single
+ *  invocation whose first parameter is its execution mask (see irgen.h).
+ *  The widener rewrites that into <name>.lanes, which runs a group of
+ *  <width> invocations at once: every value becomes a vector with one
+ *  element per invocation, and a branch is taken when its condition holds
+ *  for any of them.
+ *
+ *  A scalar of type T becomes <width x T>; a vector <n x T> becomes
+ *  <n*width x T>, component by component, so that component c of lane l
+ *  is element c*width+l and a component of the group is a slice of
+ *  consecutive elements. Arrays and structs hold the widened elements
+ *  (matN becomes matN.lanes), and variables keep one such value for the
+ *  whole group. Globals are the same for every invocation: they are read
+ *  once and splatted, or lane by lane when the index differs.
+ */
+
+#ifndef _H_Lanes
+#define _H_Lanes
+
+#include <map>
+#include <string>
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Constants.h"
+
+using namespace std;
+
+class LaneWidener {
+  public:
+    LaneWidener(llvm::Module *m, int width);
+
+    // The variants to widen, each with the function it was emitted from
+    void AddVariant(llvm::Function *masked, llvm::Function *scalar);
+    // The widened variant, after those it calls; NULL, with why set to
+    // the reason, if some instruction in it or its callees cannot be
+    llvm::Function *Widen(llvm::Function *masked, string &why);
+
+    int GetWidth() const { return width; }
+    llvm::Type *WideType(llvm::Type *ty);
+    // v for every lane; constants fold, anything else is appended to bb
+    llvm::Value *Splat(llvm::Value *v, llvm::BasicBlock *bb);
+    // Lane lane of a widened value of type WideType(ty), and the widened
+    // value with that lane replaced by v
+    llvm::Value *ExtractLane(llvm::Value *wide, llvm::Type *ty, int lane, llvm::BasicBlock *bb);
+    llvm::Value *InsertLane(llvm::Value *wide, llvm::Value *v, int lane, llvm::BasicBlock *bb);
+    // count consecutive elements of a vector from first on
+    llvm::Value *Slice(llvm::Value *vec, int first, int count, llvm::BasicBlock *bb);
+
+    bool IsVariant(llvm::Function *fn) const { return scalars.count(fn) != 0; }
+    llvm::Function *GetScalar(llvm::Function *masked) { return scalars[masked]; }
+    llvm::Module *GetModule() const { return module; }
+
+  private:
+    llvm::Module *module;
+    int width;
+    map<llvm::Type*, llvm::Type*> types;
+    map<llvm::Function*, llvm::Function*> scalars;
+    // NULL for a variant that could not be widened, or is being widened
+    map<llvm::Function*, llvm::Function*> widened;
+    map<llvm::Function*, string> reasons;
+
+    llvm::Constant *SplatConstant(llvm::Constant *c);
+};
+
+#endif
@@ -53,6 +53,7 @@ void yyerror(const char *msg); // standard error-handling routine
     List<VarDecl *> *varDeclList;
     List<Stmt*> *stmtList;
     Stmt       *stmt;
+    LoopStmt   *loopStmt;
     Operator *ops;
     Identifier *funcId;
     List<Expr*> *argList;
@@ -71,7 +72,7 @@ void yyerror(const char *msg); // standard error-handling routine
 %token   T_Mat2  T_Mat3 T_Mat4
 %token   T_While T_For T_If T_Else T_Return T_Break T_Continue T_Do 
 %token   T_Switch T_Case T_Default
-%token   T_In T_Out T_Const T_Uniform
+%token   T_In T_Out T_Inout T_Const T_Uniform
 %token   T_LeftParen T_RightParen T_LeftBracket T_RightBracket T_LeftBrace T_RightBrace
 %token   T_Dot T_Comma T_Colon T_Semicolon T_Question
 
@@ -85,6 +86,8 @@ void yyerror(const char *msg); // standard error-handling routine
 %token   <integerConstant> T_IntConstant
 %token   <floatConstant> T_FloatConstant
 %token   <boolConstant> T_BoolConstant
+%token   <integerConstant> T_PragmaUnroll T_PragmaVectorize
+%token   <identifier> T_PragmaFastMath
 %token   <identifier> T_FieldSelection
 
 %nonassoc LOWEST
@@ -119,7 +122,8 @@ void yyerror(const char *msg); // standard error-handling routine
 %type <varDeclList> ParameterList
 %type <stmt>       Statement
 %type <stmtList>   StatementList
-%type <stmt>       SingleStatement SelectionStmt SwitchStmt CaseStmt JumpStmt WhileStmt ForStmt
+%type <stmt>       SingleStatement SelectionStmt SwitchStmt CaseStmt JumpStmt
+%type <loopStmt>   IterationStmt WhileStmt ForStmt
 %type <stmt>       CompoundStatement
 %type <ops>        AssignOp
 %type <funcId>     FunctionIdentifier
@@ -162,6 +166,8 @@ DeclList  :    DeclList Decl        { ($$=$1)->Append($2); }
    
 Decl      :    Declaration                   { $$ = $1; }
           |    FuncDecl CompoundStatement    { $1->SetFunctionBody($2); $$ = $1; }
+          |    T_PragmaFastMath FuncDecl CompoundStatement
+                                             { $2->SetFunctionBody($3); $2->SetFastMath($1); $$ = $2; }
           ;
 
 /* combine declaration and init_decl_list into a single rule
@@ -232,6 +238,7 @@ Initializer        : Expression    { $$ = $1; }
 
 TypeQualify    : T_In       {$$ = TypeQualifier::inTypeQualifier;}
                | T_Out      {$$ = TypeQualifier::outTypeQualifier;}
+               | T_Inout    {$$ = TypeQualifier::inoutTypeQualifier;}
                | T_Const    {$$ = TypeQualifier::constTypeQualifier;}
                | T_Uniform  {$$ = TypeQualifier::uniformTypeQualifier;}
                ;
@@ -246,6 +253,16 @@ TypeDecl       : T_Int                   { $$ = Type::intType;    }
                | T_Mat2                  { $$ = Type::mat2Type;   }
                | T_Mat3                  { $$ = Type::mat3Type;   }
                | T_Mat4                  { $$ = Type::mat4Type;   }
+               | T_Uint                  { $$ = Type::uintType;   }
+               | T_Ivec2                 { $$ = Type::ivec2Type;  }
+               | T_Ivec3                 { $$ = Type::ivec3Type;  }
+               | T_Ivec4                 { $$ = Type::ivec4Type;  }
+               | T_Uvec2                 { $$ = Type::uvec2Type;  }
+               | T_Uvec3                 { $$ = Type::uvec3Type;  }
+               | T_Uvec4                 { $$ = Type::uvec4Type;  }
+               | T_Bvec2                 { $$ = Type::bvec2Type;  }
+               | T_Bvec3                 { $$ = Type::bvec3Type;  }
+               | T_Bvec4                 { $$ = Type::bvec4Type;  }
                ;
 
 CompoundStatement : T_LeftBrace T_RightBrace               { $$ = new StmtBlock(new List<VarDecl*>, new List<Stmt *>); }
@@ -270,8 +287,7 @@ SingleStatement   : T_Semicolon      { $$ = new EmptyExpr();  }
                   | SwitchStmt       { $$ = $1; }
                   | CaseStmt         { $$ = $1; }
                   | JumpStmt         { $$ = $1; }
-                  | WhileStmt        { $$ = $1; }
-                  | ForStmt          { $$ = $1; }
+                  | IterationStmt    { $$ = $1; }
                   ;
 
 SelectionStmt     : T_If T_LeftParen Expression T_RightParen Statement T_Else Statement
@@ -286,7 +302,7 @@ SelectionStmt     : T_If T_LeftParen Expression T_RightParen Statement T_Else St
 
 SwitchStmt         : T_Switch T_LeftParen Expression T_RightParen T_LeftBrace StatementList T_RightBrace
                                      {
-                                        $$ = new SwitchStmt($3, $6, NULL);
+                                        $$ = new SwitchStmt($3, $6);
                                      }
                    ;
 CaseStmt           : T_Case Expression T_Colon Statement  { $$ = new Case($2, $4); }
@@ -299,6 +315,12 @@ JumpStmt           : T_Break   T_Semicolon    { $$ = new BreakStmt(yylloc); }
                    | T_Return Expression T_Semicolon { $$ = new ReturnStmt(yyloc, $2); }
                    ; 
 
+IterationStmt      : WhileStmt        { $$ = $1; }
+                   | ForStmt          { $$ = $1; }
+                   | T_PragmaUnroll IterationStmt    { ($$ = $2)->SetUnroll($1); }
+                   | T_PragmaVectorize IterationStmt { ($$ = $2)->SetVectorize($1); }
+                   ;
+
 WhileStmt          : T_While T_LeftParen Expression T_RightParen Statement { $$ = new WhileStmt($3, $5); }
                    ;
 
@@ -333,6 +355,7 @@ ArgumentList : Expression                       { ($$ = new List<Expr*>)->Append
              ;
 
 FunctionIdentifier  : T_Identifier        { $$ = new Identifier(@1, $1); }
+                    | TypeDecl            { $$ = new Identifier(@1, $1->GetName()); }
                     ;
 
 PostfixExpr        : PrimaryExpr     { $$ = $1; }
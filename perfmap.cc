@@ -0,0 +1,49 @@
+/* File: perfmap.cc
+ * ----------------
+ * Implementation of the perf map of JIT-compiled shader functions.
+ */
+
+#include "perfmap.h"
+#include <unistd.h>
+#include "llvm/ExecutionEngine/ObjectImage.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/system_error.h"
+
+PerfMap *PerfMap::map = NULL;
+
+PerfMap::PerfMap(FILE *f) : file(f) {
+    pthread_mutex_init(&lock, NULL);
+}
+
+bool PerfMap::Enable() {
+    if(map != NULL)
+        return true;
+    char path[64];
+    sprintf(path, "/tmp/perf-%d.map", (int)getpid());
+    FILE *f = fopen(path, "w");
+    if(f == NULL) {
+        fprintf(stderr, "glc-exec: cannot write %s\n", path);
+        return false;
+    }
+    map = new PerfMap(f);
+    return true;
+}
+
+// The object's symbols carry the addresses the JIT loaded it at. Each
+// object is flushed whole, so perf never reads half a line.
+void PerfMap::NotifyObjectEmitted(const llvm::ObjectImage &obj) {
+    pthread_mutex_lock(&lock);
+    llvm::error_code ec;
+    for(llvm::object::symbol_iterator it = obj.begin_symbols(), end = obj.end_symbols(); it != end && !ec;
+        it.increment(ec)) {
+        llvm::object::SymbolRef::Type type;
+        llvm::StringRef name;
+        uint64_t addr, size;
+        if(it->getType(type) || type != llvm::object::SymbolRef::ST_Function || it->getName(name)
+           || it->getAddress(addr) || it->getSize(size) || addr == 0 || size == 0)
+            continue;
+        fprintf(file, "%llx %llx %s\n", (unsigned long long)addr, (unsigned long long)size, name.str().c_str());
+    }
+    fflush(file);
+    pthread_mutex_unlock(&lock);
+}
@@ -0,0 +1,37 @@
+/**
+ * File: perfmap.h
+ * ---------------
+ *  This file defines the perf map of glc-exec. Linux perf looks up samples
+ *  in anonymous executable memory in /tmp/perf-<pid>.map, a text file of
+ *  "<start> <size> <name>" lines in hex. Once enabled, every module the
+ *  JIT loads (recompiles under -fwatch included) adds its functions there,
+ *  named as in the shader source, so perf report shows shader functions
+ *  and the glc.batch or glc.grid loop around them rather than bare
+ *  addresses. Functions glc inlined are charged to their callers.
+ */
+
+#ifndef _H_PerfMap
+#define _H_PerfMap
+
+#include <stdio.h>
+#include <pthread.h>
+#include "llvm/ExecutionEngine/JITEventListener.h"
+
+class PerfMap : public llvm::JITEventListener {
+  public:
+    // Creates the map; false if it cannot be written
+    static bool Enable();
+    // The listener to register with each engine, or NULL when not enabled
+    static llvm::JITEventListener *Listener() { return map; }
+
+    virtual void NotifyObjectEmitted(const llvm::ObjectImage &obj);
+
+  private:
+    FILE           *file;
+    pthread_mutex_t lock;          // engines may load on the watcher thread
+
+    PerfMap(FILE *f);
+    static PerfMap *map;
+};
+
+#endif
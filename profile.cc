@@ -0,0 +1,277 @@
+/* File: profile.cc
+ * ----------------
+ * Implementation of the -finstrument hooks and the profile report.
+ */
+
+#include "profile.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include "llvm/Support/DynamicLibrary.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+static inline uint64_t Stamp() {
+#ifdef HAVE_TSC
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+struct Frame {
+    int32_t  fn, site;
+    uint64_t start, children;
+};
+
+// One thread's counts, by function and by call site. Frames are the calls
+// in progress; site is the call about to enter its callee.
+struct ProfThread {
+    vector<uint64_t> calls, self, total;
+    vector<uint64_t> siteCalls, siteTotal;
+    vector<uint64_t> counters;
+    vector<Frame>    stack;
+    int32_t          site;
+};
+
+// Live threads' records, and the sum of those of threads that have exited
+static pthread_mutex_t threadsLock = PTHREAD_MUTEX_INITIALIZER;
+static vector<ProfThread*> threads;
+static ProfThread retired;
+static pthread_key_t threadKey;
+static __thread ProfThread *current = NULL;
+static size_t numFunctions = 0, numSites = 0, numCounters = 0;
+
+bool           Profile::loaded = false;
+string         Profile::table;
+vector<string> Profile::functions;
+vector<Profile::Site> Profile::sites;
+vector<Profile::Branch> Profile::branches;
+
+static void Size(ProfThread *t) {
+    t->calls.resize(numFunctions);
+    t->self.resize(numFunctions);
+    t->total.resize(numFunctions);
+    t->siteCalls.resize(numSites);
+    t->siteTotal.resize(numSites);
+    t->counters.resize(numCounters);
+    t->site = -1;
+}
+
+static void Add(ProfThread *to, const ProfThread *from) {
+    for(size_t i = 0; i < numFunctions; i++) {
+        to->calls[i] += from->calls[i];
+        to->self[i] += from->self[i];
+        to->total[i] += from->total[i];
+    }
+    for(size_t s = 0; s < numSites; s++) {
+        to->siteCalls[s] += from->siteCalls[s];
+        to->siteTotal[s] += from->siteTotal[s];
+    }
+    for(size_t c = 0; c < numCounters; c++)
+        to->counters[c] += from->counters[c];
+}
+
+// Runs as a thread exits: its counts join the retired sum, so records do
+// not pile up as the scheduler's threads come and go
+static void Retire(void *p) {
+    ProfThread *t = (ProfThread*)p;
+    pthread_mutex_lock(&threadsLock);
+    Add(&retired, t);
+    threads.erase(std::find(threads.begin(), threads.end(), t));
+    pthread_mutex_unlock(&threadsLock);
+    delete t;
+}
+
+static ProfThread *Current() {
+    if(current == NULL) {
+        ProfThread *t = new ProfThread();
+        Size(t);
+        t->stack.reserve(16);
+        pthread_mutex_lock(&threadsLock);
+        threads.push_back(t);
+        pthread_mutex_unlock(&threadsLock);
+        pthread_setspecific(threadKey, t);
+        current = t;
+    }
+    return current;
+}
+
+// The counts of all threads, live and exited
+static ProfThread Sum() {
+    ProfThread sum;
+    Size(&sum);
+    pthread_mutex_lock(&threadsLock);
+    Add(&sum, &retired);
+    for(size_t t = 0; t < threads.size(); t++)
+        Add(&sum, threads[t]);
+    pthread_mutex_unlock(&threadsLock);
+    return sum;
+}
+
+void glc_prof_enter(int32_t fn) {
+    ProfThread *t = Current();
+    Frame f = { fn, t->site, 0, 0 };
+    t->site = -1;
+    t->calls[fn]++;
+    t->stack.push_back(f);
+    t->stack.back().start = Stamp();
+}
+
+// GLSL has no recursion, so no function's inclusive time counts twice
+void glc_prof_exit(int32_t fn) {
+    uint64_t now = Stamp();
+    ProfThread *t = current;
+    if(t == NULL || t->stack.empty())
+        return;
+    Frame f = t->stack.back();
+    t->stack.pop_back();
+    uint64_t elapsed = now - f.start;
+    t->self[f.fn] += elapsed - f.children;
+    t->total[f.fn] += elapsed;
+    if(f.site >= 0)
+        t->siteTotal[f.site] += elapsed;
+    if(!t->stack.empty())
+        t->stack.back().children += elapsed;
+}
+
+void glc_prof_call(int32_t site) {
+    ProfThread *t = Current();
+    t->siteCalls[site]++;
+    t->site = site;
+}
+
+void glc_prof_count(int32_t counter) {
+    Current()->counters[counter]++;
+}
+
+bool Profile::Load(const string &names) {
+    if(loaded) {
+        if(names == table)
+            return true;
+        fprintf(stderr, "glc-exec: the instrumented functions changed; profiles cannot be combined\n");
+        return false;
+    }
+    const char *p = names.c_str();
+    while(*p != '\0') {
+        const char *end = strchr(p, '\n');
+        string line(p, end ? end - p : strlen(p));
+        p = end ? end + 1 : p + line.size();
+        char a[256], b[256];
+        int id, n, ways, num;
+        if(sscanf(line.c_str(), "f %d %255s", &id, a) == 2 && id == (int)functions.size())
+            functions.push_back(a);
+        else if(sscanf(line.c_str(), "c %d %255s %255s %d", &id, a, b, &n) == 4 && id == (int)sites.size()) {
+            Site s = { a, b, n };
+            sites.push_back(s);
+        }
+        else if(sscanf(line.c_str(), "b %d %d %255s %d %d %255s", &id, &ways, a, &num, &n, b) == 6
+                && id == (int)numCounters && ways > 0) {
+            Branch br = { a, b, num, n, id, ways };
+            branches.push_back(br);
+            numCounters += ways;
+        }
+        else {
+            fprintf(stderr, "glc-exec: malformed glc.prof.names line \"%s\"\n", line.c_str());
+            functions.clear();
+            sites.clear();
+            branches.clear();
+            numCounters = 0;
+            return false;
+        }
+    }
+    table = names;
+    numFunctions = functions.size();
+    numSites = sites.size();
+    Size(&retired);
+    if(pthread_key_create(&threadKey, Retire) != 0) {
+        fprintf(stderr, "glc-exec: cannot create the profile's thread key\n");
+        return false;
+    }
+    llvm::sys::DynamicLibrary::AddSymbol("glc_prof_enter", (void*)glc_prof_enter);
+    llvm::sys::DynamicLibrary::AddSymbol("glc_prof_exit", (void*)glc_prof_exit);
+    llvm::sys::DynamicLibrary::AddSymbol("glc_prof_call", (void*)glc_prof_call);
+    llvm::sys::DynamicLibrary::AddSymbol("glc_prof_count", (void*)glc_prof_count);
+    loaded = true;
+    return true;
+}
+
+struct ByCount {
+    const vector<uint64_t> &count;
+    ByCount(const vector<uint64_t> &c) : count(c) {}
+    bool operator()(size_t a, size_t b) const { return count[a] > count[b]; }
+};
+
+void Profile::Report(FILE *f) {
+    ProfThread sum = Sum();
+    const vector<uint64_t> &calls = sum.calls, &self = sum.self, &total = sum.total;
+    const vector<uint64_t> &siteCalls = sum.siteCalls, &siteTotal = sum.siteTotal;
+#ifdef HAVE_TSC
+    const char *unit = "cycles";
+#else
+    const char *unit = "ns";
+#endif
+
+    uint64_t all = 0;
+    vector<size_t> order;
+    for(size_t i = 0; i < functions.size(); i++) {
+        all += self[i];
+        order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(), ByCount(self));
+    fprintf(f, "Flat profile (%s, all threads):\n", unit);
+    fprintf(f, "%7s %16s %16s %14s %12s  %s\n", "%self", "self", "total", "calls", "self/call", "function");
+    for(size_t k = 0; k < order.size(); k++) {
+        size_t i = order[k];
+        if(calls[i] == 0)
+            continue;
+        fprintf(f, "%7.2f %16llu %16llu %14llu %12.1f  %s\n", all ? 100.0 * self[i] / all : 0.0,
+                (unsigned long long)self[i], (unsigned long long)total[i], (unsigned long long)calls[i],
+                (double)self[i] / calls[i], functions[i].c_str());
+    }
+
+    // each function, then where it is called from and what it calls
+    std::stable_sort(order.begin(), order.end(), ByCount(total));
+    fprintf(f, "\nCall graph (inclusive %s):\n", unit);
+    for(size_t k = 0; k < order.size(); k++) {
+        size_t i = order[k];
+        if(calls[i] == 0)
+            continue;
+        fprintf(f, "%-32s %14llu calls %16llu\n", functions[i].c_str(), (unsigned long long)calls[i],
+                (unsigned long long)total[i]);
+        for(size_t s = 0; s < sites.size(); s++)
+            if(siteCalls[s] > 0 && sites[s].callee == functions[i])
+                fprintf(f, "    <- %-25s %14llu calls   line %d\n", sites[s].caller.c_str(),
+                        (unsigned long long)siteCalls[s], sites[s].line);
+        for(size_t s = 0; s < sites.size(); s++)
+            if(siteCalls[s] > 0 && sites[s].caller == functions[i])
+                fprintf(f, "    -> %-25s %14llu calls %16llu   line %d\n", sites[s].callee.c_str(),
+                        (unsigned long long)siteCalls[s], (unsigned long long)siteTotal[s], sites[s].line);
+    }
+}
+
+bool Profile::WriteBranches(const char *path) {
+    ProfThread sum = Sum();
+    const vector<uint64_t> &counters = sum.counters;
+
+    FILE *f = fopen(path, "w");
+    if(f == NULL) {
+        fprintf(stderr, "glc-exec: cannot write %s\n", path);
+        return false;
+    }
+    fprintf(f, "# function branch line kind counts (false true, or default then cases)\n");
+    for(size_t i = 0; i < branches.size(); i++) {
+        const Branch &b = branches[i];
+        fprintf(f, "%s %d %d %s", b.function.c_str(), b.n, b.line, b.kind.c_str());
+        for(int w = 0; w < b.ways; w++)
+            fprintf(f, " %llu", (unsigned long long)counters[b.first + w]);
+        fprintf(f, "\n");
+    }
+    return fclose(f) == 0;
+}
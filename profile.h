@@ -0,0 +1,69 @@
+/**
+ * File: profile.h
+ * ---------------
+ *  This file defines the runtime of glc -finstrument for glc-exec: the
+ *  hooks an instrumented module calls, and the profile they build.
+ *
+ *  Each thread counts into a record of its own, so the hooks take no lock
+ *  and share no cache lines. A hook is a call, a time stamp counter read
+ *  and a few adds. Time is in cycles (nanoseconds where there is no time
+ *  stamp counter). A thread's record is folded into a shared sum as the
+ *  thread exits. Once the runs are over the sums make a flat profile, with
+ *  each function's own and inclusive time, and a call graph of call sites
+ *  with their counts and inclusive time.
+ *
+ *  The ways taken out of each branch and switch are counted too; written
+ *  out, they are the profile glc -fprofile-use reads.
+ */
+
+#ifndef _H_Profile
+#define _H_Profile
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include <string>
+
+using namespace std;
+
+extern "C" {
+void glc_prof_enter(int32_t fn);
+void glc_prof_exit(int32_t fn);
+void glc_prof_call(int32_t site);
+void glc_prof_count(int32_t counter);
+}
+
+class Profile {
+  public:
+    // Takes the names of an instrumented module (its glc.prof.names) and
+    // makes the hooks visible to the JIT. A module whose names differ from
+    // those already loaded is refused, since its ids would mean other
+    // functions.
+    static bool Load(const string &names);
+    static bool IsLoaded() { return loaded; }
+
+    static void Report(FILE *f);
+
+    // One "<function> <n> <line> <kind> <count>..." line per branch, for
+    // glc -fprofile-use
+    static bool HasBranches() { return !branches.empty(); }
+    static bool WriteBranches(const char *path);
+
+  private:
+    struct Site {
+        string caller, callee;
+        int    line;
+    };
+    struct Branch {
+        string function, kind;
+        int    n, line, first, ways;
+    };
+
+    static bool           loaded;
+    static string         table;
+    static vector<string> functions;
+    static vector<Site>   sites;
+    static vector<Branch> branches;
+};
+
+#endif
@@ -0,0 +1,167 @@
+/* File: reload.cc
+ * ---------------
+ * Implementation of the source watcher that recompiles a shader while
+ * glc-exec keeps running it.
+ */
+
+#include "reload.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+Reloader::Reloader(Executor &e, const char *src, const char *d, const char *g, const char *flags, int l, double i)
+    : exec(e), source(src), dat(d), glc(g), lanes(l), interval(i), started(false), stopping(false),
+      pending(NULL), pendingLatency(0) {
+    pthread_mutex_init(&lock, NULL);
+    for(const char *at = flags; at != NULL && *at != '\0'; ) {
+        size_t n = strcspn(at, " \t");
+        if(n > 0)
+            glcFlags.push_back(string(at, n));
+        at += n + strspn(at + n, " \t");
+    }
+}
+
+Reloader::~Reloader() {
+    pthread_mutex_lock(&lock);
+    stopping = true;
+    pthread_mutex_unlock(&lock);
+    if(started)
+        pthread_join(thread, NULL);
+    delete pending;
+    pthread_mutex_destroy(&lock);
+}
+
+void Reloader::Start() {
+    started = pthread_create(&thread, NULL, WatcherMain, this) == 0;
+    if(!started)
+        fprintf(stderr, "glc-exec: cannot watch %s\n", source.c_str());
+}
+
+bool Reloader::Stopping() {
+    pthread_mutex_lock(&lock);
+    bool s = stopping;
+    pthread_mutex_unlock(&lock);
+    return s;
+}
+
+// The source's modification time and size, false while it cannot be read
+// (an editor may be replacing it)
+bool Reloader::Modified(double &mtime, off_t &size) const {
+    struct stat st;
+    if(stat(source.c_str(), &st) != 0)
+        return false;
+    mtime = st.st_mtim.tv_sec + st.st_mtim.tv_nsec * 1e-9;
+    size = st.st_size;
+    return true;
+}
+
+// Runs glc on the source into a temporary module and compiles that the
+// way the running executor was. NULL on any error, which glc or the
+// executor has already reported.
+Executor *Reloader::Recompile() {
+    char bc[] = "/tmp/glc-exec-XXXXXX";
+    int out = mkstemp(bc);
+    int in = open(source.c_str(), O_RDONLY);
+    if(out < 0 || in < 0) {
+        fprintf(stderr, "glc-exec: cannot recompile %s\n", source.c_str());
+        if(out >= 0) {
+            close(out);
+            unlink(bc);
+        }
+        return NULL;
+    }
+    string datFlag = "-fdat=" + dat;
+    char lanesFlag[32];
+    snprintf(lanesFlag, sizeof lanesFlag, "-flanes=%d", lanes);
+    string failed = "glc-exec: cannot run " + glc + "\n";
+    vector<char*> argv(1, (char*)glc.c_str());
+    for(size_t k = 0; k < glcFlags.size(); k++)
+        argv.push_back((char*)glcFlags[k].c_str());
+    argv.push_back((char*)datFlag.c_str());
+    argv.push_back(lanesFlag);
+    argv.push_back(NULL);
+    pid_t pid = fork();
+    if(pid == 0) {
+        // this process is a copy of a threaded one, so everything it needs
+        // is prepared before the fork and only async-signal-safe calls
+        // remain until exec
+        dup2(in, 0);
+        dup2(out, 1);
+        execvp(argv[0], &argv[0]);
+        ssize_t n = write(2, failed.data(), failed.size());
+        (void)n;
+        _exit(127);
+    }
+    close(in);
+    close(out);
+    int status = 0;
+    bool ok = pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+
+    Executor *fresh = NULL;
+    if(ok) {
+        fresh = new Executor();
+        fresh->SetGrid(exec.GetGridWidth(), exec.GetGridHeight());
+        if(!fresh->LoadModule(bc) || !fresh->LoadDat(dat.c_str()) || !fresh->Compile(lanes)) {
+            delete fresh;
+            fresh = NULL;
+        }
+    }
+    unlink(bc);
+    if(fresh == NULL)
+        fprintf(stderr, "glc-exec: %s does not compile; the running version stays\n", source.c_str());
+    return fresh;
+}
+
+// A change is compiled once two polls in a row see the same new time and
+// size, so a file caught half written is not
+void *Reloader::WatcherMain(void *self) {
+    Reloader *r = (Reloader*)self;
+    double built = 0, seen = 0, mtime;
+    off_t builtSize = 0, seenSize = 0, size;
+    r->Modified(built, builtSize);
+    seen = built;
+    seenSize = builtSize;
+    double noticed = 0;
+    while(!r->Stopping()) {
+        usleep((useconds_t)(r->interval * 1e6));
+        if(!r->Modified(mtime, size) || (mtime == built && size == builtSize))
+            continue;
+        if(mtime != seen || size != seenSize) {
+            if(noticed == 0)
+                noticed = Executor::Now();
+            seen = mtime;
+            seenSize = size;
+            continue;
+        }
+        built = mtime;
+        builtSize = size;
+        Executor *fresh = r->Recompile();
+        if(fresh != NULL) {
+            pthread_mutex_lock(&r->lock);
+            delete r->pending;
+            r->pending = fresh;
+            r->pendingLatency = Executor::Now() - noticed;
+            pthread_mutex_unlock(&r->lock);
+        }
+        noticed = 0;
+    }
+    return NULL;
+}
+
+bool Reloader::Swap(double &latency) {
+    pthread_mutex_lock(&lock);
+    Executor *fresh = pending;
+    latency = pendingLatency;
+    pending = NULL;
+    pthread_mutex_unlock(&lock);
+    if(fresh == NULL)
+        return false;
+    bool ok = exec.Adopt(*fresh);
+    // fresh now holds the old code, or the rejected new code
+    delete fresh;
+    return ok;
+}
@@ -0,0 +1,60 @@
+/**
+ * File: reload.h
+ * --------------
+ *  This file defines hot reloading for glc-exec. A watcher thread polls
+ *  the shader source; once it has changed and settled, the thread runs
+ *  glc on it and JIT-compiles the result into an executor of its own,
+ *  while the batches keep running on the old code. Between two batches
+ *  the runner swaps the new code in (see Executor::Adopt), so every batch
+ *  runs entirely on one version. A source that does not compile, or whose
+ *  entry no longer matches the inputs, leaves the old version running.
+ */
+
+#ifndef _H_Reload
+#define _H_Reload
+
+#include <pthread.h>
+#include <sys/types.h>
+#include <string>
+#include <vector>
+#include "executor.h"
+
+using namespace std;
+
+class Reloader {
+  public:
+    // glc is the compiler to run, given the space-separated glcFlags (NULL
+    // for none) ahead of the -fdat and -flanes the running module needs;
+    // interval is the polling period in seconds
+    Reloader(Executor &exec, const char *source, const char *dat, const char *glc, const char *glcFlags,
+             int lanes, double interval);
+    ~Reloader();
+
+    void Start();
+
+    // Takes the newest recompile, if one is ready; call only between
+    // batches. latency is the time from noticing the change to the new
+    // code being ready.
+    bool Swap(double &latency);
+
+  private:
+    Executor       &exec;
+    string          source, dat, glc;
+    vector<string>  glcFlags;
+    int             lanes;
+    double          interval;
+
+    pthread_t       thread;
+    pthread_mutex_t lock;          // guards stopping and pending
+    bool            started;
+    bool            stopping;
+    Executor       *pending;       // compiled, not yet swapped in
+    double          pendingLatency;
+
+    static void *WatcherMain(void *self);
+    bool Modified(double &mtime, off_t &size) const;
+    bool Stopping();
+    Executor *Recompile();
+};
+
+#endif
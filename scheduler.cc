@@ -0,0 +1,164 @@
+/* File: scheduler.cc
+ * ------------------
+ * Implementation of the static and work-stealing batch schedulers.
+ */
+
+#include "scheduler.h"
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+
+static double Now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+Scheduler::Scheduler(Policy p, int t, size_t minc, size_t maxc, size_t g, bool pn)
+    : policy(p), threads(t < 1 ? 1 : t), grain(g < 1 ? 1 : g), pin(pn), total(0), fn(NULL), arg(NULL) {
+    minChunk = Align(minc < 1 ? 1 : minc);
+    maxChunk = Align(maxc < minChunk ? minChunk : maxc);
+    ranges.resize(threads);
+    for(int i = 0; i < threads; i++)
+        pthread_mutex_init(&ranges[i].lock, NULL);
+}
+
+Scheduler::~Scheduler() {
+    for(int i = 0; i < threads; i++)
+        pthread_mutex_destroy(&ranges[i].lock);
+}
+
+// Rounds up to whole lane groups
+size_t Scheduler::Align(size_t i) const {
+    return (i + grain - 1) / grain * grain;
+}
+
+void Scheduler::Execute(int id, size_t begin, size_t end) {
+    double start = Now();
+    fn(arg, begin, end);
+    stats[id].busy += Now() - start;
+    stats[id].invocations += end - begin;
+    stats[id].chunks++;
+}
+
+void Scheduler::RunStatic(int id) {
+    for(size_t begin = id * maxChunk; begin < total; begin += threads * maxChunk)
+        Execute(id, begin, begin + maxChunk < total ? begin + maxChunk : total);
+}
+
+bool Scheduler::TakeOwn(int id, size_t &begin, size_t &end) {
+    Range &r = ranges[id];
+    pthread_mutex_lock(&r.lock);
+    bool found = r.lo < r.hi;
+    if(found) {
+        size_t chunk = Align((r.hi - r.lo) / threads);
+        if(chunk < minChunk)
+            chunk = minChunk;
+        if(chunk > maxChunk)
+            chunk = maxChunk;
+        begin = r.lo;
+        end = r.lo + chunk < r.hi ? r.lo + chunk : r.hi;
+        r.lo = end;
+    }
+    pthread_mutex_unlock(&r.lock);
+    return found;
+}
+
+// Moves the back half of some other worker's range into this worker's
+// own (empty) range. A range of one minimum chunk or less is taken whole.
+bool Scheduler::Steal(int id) {
+    for(int k = 1; k < threads; k++) {
+        Range &victim = ranges[(id + k) % threads];
+        size_t lo = 0, hi = 0;
+        pthread_mutex_lock(&victim.lock);
+        if(victim.lo < victim.hi) {
+            size_t left = victim.hi - victim.lo;
+            lo = left <= minChunk ? victim.lo : victim.lo + Align(left / 2);
+            if(lo >= victim.hi)
+                lo = victim.lo;
+            hi = victim.hi;
+            victim.hi = lo;
+        }
+        pthread_mutex_unlock(&victim.lock);
+        if(lo < hi) {
+            Range &own = ranges[id];
+            pthread_mutex_lock(&own.lock);
+            own.lo = lo;
+            own.hi = hi;
+            pthread_mutex_unlock(&own.lock);
+            stats[id].steals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+// A stolen range is invisible to other thieves until it lands in the
+// thief's own range, so a worker may give up while work remains; the thief
+// then runs that work itself.
+void Scheduler::RunStealing(int id) {
+    size_t begin, end;
+    for(;;) {
+        if(TakeOwn(id, begin, end))
+            Execute(id, begin, end);
+        else if(!Steal(id))
+            break;
+    }
+}
+
+void *Scheduler::WorkerMain(void *p) {
+    Worker *w = (Worker*)p;
+    Scheduler *s = w->sched;
+    if(s->pin) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(w->id % CPU_SETSIZE, &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+    if(s->policy == Static)
+        s->RunStatic(w->id);
+    else
+        s->RunStealing(w->id);
+    return NULL;
+}
+
+double Scheduler::Run(size_t n, RunFn f, void *a) {
+    total = n;
+    fn = f;
+    arg = a;
+    stats.assign(threads, Stats());
+    memset(&stats[0], 0, threads * sizeof(Stats));
+
+    // work stealing starts from an even split in whole lane groups
+    size_t share = Align((n + threads - 1) / threads);
+    for(int i = 0; i < threads; i++) {
+        ranges[i].lo = i * share < n ? i * share : n;
+        ranges[i].hi = (i + 1) * share < n ? (i + 1) * share : n;
+    }
+
+    // the calling thread is worker 0; pinning it lasts only for the run, so
+    // threads it starts later (stream I/O, the reload watcher) are not
+    // confined to worker 0's CPU
+    cpu_set_t callerCpus;
+    bool restore = pin && pthread_getaffinity_np(pthread_self(), sizeof(callerCpus), &callerCpus) == 0;
+
+    vector<Worker> workers(threads);
+    double start = Now();
+    for(int t = 0; t < threads; t++) {
+        workers[t].sched = this;
+        workers[t].id = t;
+        workers[t].started = t > 0 && pthread_create(&workers[t].thread, NULL, WorkerMain, &workers[t]) == 0;
+    }
+    WorkerMain(&workers[0]);
+    // a worker that could not be started does its share on this thread
+    for(int t = 1; t < threads; t++)
+        if(!workers[t].started)
+            WorkerMain(&workers[t]);
+    for(int t = 1; t < threads; t++)
+        if(workers[t].started)
+            pthread_join(workers[t].thread, NULL);
+    double elapsed = Now() - start;
+    if(restore)
+        pthread_setaffinity_np(pthread_self(), sizeof(callerCpus), &callerCpus);
+    return elapsed;
+}
@@ -0,0 +1,85 @@
+/**
+ * File: scheduler.h
+ * -----------------
+ *  This file defines how glc-exec spreads a batch of invocations over
+ *  worker threads.
+ *
+ *  Static scheduling hands worker t the chunks t, t + threads, ... Work
+ *  stealing gives every worker a contiguous range of its own. A worker
+ *  takes chunks from the front of its range, and when the range runs dry
+ *  it steals the back half of another worker's. Chunks shrink as a range
+ *  drains (1/threads of what is left, between the minimum and maximum
+ *  chunk), so the bulk of a batch costs little scheduling and the tail is
+ *  shared out finely.
+ */
+
+#ifndef _H_Scheduler
+#define _H_Scheduler
+
+#include <pthread.h>
+#include <stddef.h>
+#include <vector>
+
+using namespace std;
+
+class Scheduler {
+  public:
+    typedef enum { Static, Stealing } Policy;
+
+    // Runs invocations [begin, end)
+    typedef void (*RunFn)(void *arg, size_t begin, size_t end);
+
+    struct Stats {
+        double busy;        // seconds spent running invocations
+        size_t invocations;
+        size_t chunks;
+        size_t steals;
+    };
+
+    // Chunk boundaries are multiples of grain, the lane width, so only
+    // the final chunk of a batch has a partial lane group
+    Scheduler(Policy policy, int threads, size_t minChunk, size_t maxChunk, size_t grain, bool pin);
+    ~Scheduler();
+
+    // Runs invocations [0, n) and returns the wall time in seconds
+    double Run(size_t n, RunFn fn, void *arg);
+
+    int GetThreads() const { return threads; }
+    const vector<Stats> &GetStats() const { return stats; }
+
+  private:
+    // A worker's remaining invocations [lo, hi), padded to its own cache
+    // line so owners and thieves of different ranges do not collide
+    struct Range {
+        pthread_mutex_t lock;
+        size_t          lo, hi;
+        char            pad[64];
+    };
+
+    struct Worker {
+        Scheduler *sched;
+        int        id;
+        pthread_t  thread;
+        bool       started;
+    };
+
+    Policy        policy;
+    int           threads;
+    size_t        minChunk, maxChunk, grain;
+    bool          pin;
+    vector<Range> ranges;
+    vector<Stats> stats;
+    size_t        total;
+    RunFn         fn;
+    void         *arg;
+
+    static void *WorkerMain(void *w);
+    void RunStatic(int id);
+    void RunStealing(int id);
+    bool TakeOwn(int id, size_t &begin, size_t &end);
+    bool Steal(int id);
+    size_t Align(size_t i) const;
+    void Execute(int id, size_t begin, size_t end);
+};
+
+#endif
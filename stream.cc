@@ -0,0 +1,274 @@
+/* File: stream.cc
+ * ---------------
+ * Implementation of streaming execution: block queues, the reader and
+ * writer threads, and the loop that runs blocks in between.
+ */
+
+#include "stream.h"
+#include <stdlib.h>
+#include <string.h>
+
+BlockQueue::BlockQueue() : closed(false) {
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&ready, NULL);
+}
+
+BlockQueue::~BlockQueue() {
+    pthread_cond_destroy(&ready);
+    pthread_mutex_destroy(&lock);
+}
+
+void BlockQueue::Push(Block *b) {
+    pthread_mutex_lock(&lock);
+    blocks.push_back(b);
+    pthread_cond_signal(&ready);
+    pthread_mutex_unlock(&lock);
+}
+
+Block *BlockQueue::Pop() {
+    pthread_mutex_lock(&lock);
+    while(blocks.empty() && !closed)
+        pthread_cond_wait(&ready, &lock);
+    Block *b = NULL;
+    if(!blocks.empty()) {
+        b = blocks.front();
+        blocks.pop_front();
+    }
+    pthread_mutex_unlock(&lock);
+    return b;
+}
+
+void BlockQueue::Close() {
+    pthread_mutex_lock(&lock);
+    closed = true;
+    pthread_cond_broadcast(&ready);
+    pthread_mutex_unlock(&lock);
+}
+
+static char *AllocColumn(size_t size) {
+    void *p = NULL;
+    if(posix_memalign(&p, ColumnAlign, size ? size : ColumnAlign) != 0) {
+        fprintf(stderr, "glc-exec: out of memory\n");
+        exit(2);
+    }
+    return (char*)p;
+}
+
+// Blocks are whole lane groups, so only the last one has a scalar tail
+StreamRunner::StreamRunner(Executor &e, size_t rows, int buffers)
+    : exec(e), bufferBytes(0), in(NULL), out(NULL), binaryIn(false), binaryOut(false),
+      failed(false), pending(0), total(0), runSeconds(0), lineno(0) {
+    size_t lanes = exec.GetLanes();
+    blockRows = rows < lanes ? lanes : (rows + lanes - 1) / lanes * lanes;
+    blocks.resize(buffers < 2 ? 2 : buffers);
+    for(size_t i = 0; i < blocks.size(); i++) {
+        Block &b = blocks[i];
+        for(size_t k = 0; k < exec.NumParams(); k++) {
+            b.columns.push_back(AllocColumn(blockRows * exec.GetParamShape(k).stride));
+            bufferBytes += blockRows * exec.GetParamShape(k).stride;
+        }
+        b.results = NULL;
+        if(exec.HasResult()) {
+            b.results = AllocColumn(blockRows * exec.GetResultShape().stride);
+            bufferBytes += blockRows * exec.GetResultShape().stride;
+        }
+        b.rows = 0;
+    }
+    pthread_mutex_init(&failLock, NULL);
+}
+
+StreamRunner::~StreamRunner() {
+    pthread_mutex_destroy(&failLock);
+    for(size_t i = 0; i < blocks.size(); i++) {
+        for(size_t k = 0; k < blocks[i].columns.size(); k++)
+            free(blocks[i].columns[k]);
+        free(blocks[i].results);
+    }
+}
+
+void StreamRunner::Fail() {
+    pthread_mutex_lock(&failLock);
+    failed = true;
+    pthread_mutex_unlock(&failLock);
+}
+
+bool StreamRunner::Failed() {
+    pthread_mutex_lock(&failLock);
+    bool f = failed;
+    pthread_mutex_unlock(&failLock);
+    return f;
+}
+
+// Fills b with up to a block of text records. False at the end of the
+// input or on a malformed record.
+bool StreamRunner::ReadText(Block &b) {
+    size_t width = 0;
+    for(size_t k = 0; k < exec.NumParams(); k++)
+        width += exec.GetParamShape(k).NumScalars();
+    char line[4096];
+    vector<double> vals;
+    while(b.rows < blockRows) {
+        if(fgets(line, sizeof(line), in) == NULL)
+            return false;
+        lineno++;
+        if(line[strspn(line, " \t\r\n")] == '\0' || line[0] == '#')
+            continue;
+        vals.clear();
+        if(!ColumnFile::ParseValues(line, vals) || vals.size() != width) {
+            fprintf(stderr, "glc-exec: line %d: expected %u values\n", lineno, (unsigned)width);
+            Fail();
+            return false;
+        }
+        const double *v = vals.empty() ? NULL : &vals[0];
+        for(size_t k = 0; k < exec.NumParams(); k++) {
+            const ColumnShape &shape = exec.GetParamShape(k);
+            shape.Store(v, b.columns[k] + b.rows * shape.stride);
+            v += shape.NumScalars();
+        }
+        b.rows++;
+    }
+    return true;
+}
+
+// Fills b with whole stream blocks. One that does not fit in what is left
+// of b waits, its row count already read, for the next.
+bool StreamRunner::ReadBinary(Block &b) {
+    for(;;) {
+        if(pending == 0 && (fread(&pending, sizeof(pending), 1, in) != 1 || pending == 0))
+            return false;
+        if(pending > blockRows) {
+            fprintf(stderr, "glc-exec: stream block of %lu rows is larger than -fblock\n", (unsigned long)pending);
+            Fail();
+            return false;
+        }
+        if(b.rows + pending > blockRows)
+            return true;
+        for(size_t k = 0; k < exec.NumParams(); k++) {
+            size_t stride = exec.GetParamShape(k).stride;
+            if(fread(b.columns[k] + b.rows * stride, stride, pending, in) != pending) {
+                fprintf(stderr, "glc-exec: stream ends inside a block\n");
+                Fail();
+                return false;
+            }
+        }
+        b.rows += pending;
+        pending = 0;
+    }
+}
+
+bool StreamRunner::CheckHeader() {
+    string entry;
+    vector<ColumnDesc> cols;
+    uint32_t numColumns = 0;
+    if(!ColumnStream::ReadHeader(in, entry, numColumns, cols)) {
+        if(numColumns > ColumnStream::MaxColumns)
+            fprintf(stderr, "glc-exec: stream header claims %u columns, more than the %u allowed\n",
+                    (unsigned)numColumns, (unsigned)ColumnStream::MaxColumns);
+        else
+            fprintf(stderr, "glc-exec: malformed stream header\n");
+        return false;
+    }
+    if(entry != exec.GetEntryName()) {
+        fprintf(stderr, "glc-exec: stream is for %s, not %s\n", entry.c_str(), exec.GetEntryName());
+        return false;
+    }
+    bool ok = cols.size() == exec.NumParams();
+    for(size_t k = 0; ok && k < cols.size(); k++)
+        ok = cols[k].kind == ParamColumn && cols[k].shape == exec.GetParamShape(k);
+    if(!ok)
+        fprintf(stderr, "glc-exec: stream columns do not match the arguments of %s\n", exec.GetEntryName());
+    return ok;
+}
+
+// Reading stops once the writer has failed, as the rest of the input
+// would only be run into a dead sink
+void *StreamRunner::ReaderMain(void *self) {
+    StreamRunner *s = (StreamRunner*)self;
+    bool more = true;
+    while(more && !s->Failed()) {
+        Block *b = s->empty.Pop();
+        if(b == NULL)
+            break;
+        b->rows = 0;
+        more = s->binaryIn ? s->ReadBinary(*b) : s->ReadText(*b);
+        if(b->rows > 0)
+            s->full.Push(b);
+    }
+    s->full.Close();
+    return NULL;
+}
+
+void StreamRunner::Write(Block &b) {
+    if(Failed() || !exec.HasResult())
+        return;
+    const ColumnShape &shape = exec.GetResultShape();
+    if(binaryOut) {
+        uint64_t rows = b.rows;
+        if(fwrite(&rows, sizeof(rows), 1, out) != 1 || fwrite(b.results, shape.stride, b.rows, out) != b.rows)
+            Fail();
+        return;
+    }
+    for(size_t i = 0; i < b.rows; i++) {
+        fprintf(out, "Result:");
+        shape.Print(out, b.results + i * shape.stride);
+        fprintf(out, "\n");
+    }
+    if(ferror(out))
+        Fail();
+}
+
+void *StreamRunner::WriterMain(void *self) {
+    StreamRunner *s = (StreamRunner*)self;
+    while(Block *b = s->done.Pop()) {
+        s->Write(*b);
+        s->empty.Push(b);
+    }
+    return NULL;
+}
+
+bool StreamRunner::Run(Scheduler &sched, FILE *input, FILE *output, bool binary) {
+    in = input;
+    out = output;
+    binaryOut = binary;
+    int c = getc(in);
+    binaryIn = c == ColumnStream::Magic[0];
+    if(c != EOF)
+        ungetc(c, in);
+    if(binaryIn && !CheckHeader())
+        return false;
+    if(binaryOut) {
+        vector<ColumnDesc> cols(1);
+        memset(&cols[0], 0, sizeof(ColumnDesc));
+        strcpy(cols[0].name, "result");
+        cols[0].kind = ResultColumn;
+        cols[0].shape = exec.GetResultShape();
+        if(!ColumnStream::WriteHeader(out, exec.GetEntryName(), cols))
+            return false;
+    }
+
+    for(size_t i = 0; i < blocks.size(); i++)
+        empty.Push(&blocks[i]);
+    pthread_t reader, writer;
+    pthread_create(&reader, NULL, ReaderMain, this);
+    pthread_create(&writer, NULL, WriterMain, this);
+    while(Block *b = full.Pop()) {
+        // blocks read before a failure still go back to the reader
+        if(!Failed()) {
+            runSeconds += exec.Run(sched, b->columns.empty() ? NULL : &b->columns[0], b->results, b->rows);
+            total += b->rows;
+        }
+        done.Push(b);
+    }
+    done.Close();
+    pthread_join(reader, NULL);
+    pthread_join(writer, NULL);
+
+    if(binaryOut && !Failed()) {
+        uint64_t end = 0;
+        if(fwrite(&end, sizeof(end), 1, out) != 1)
+            Fail();
+    }
+    if(fflush(out) != 0)
+        Fail();
+    return !Failed();
+}
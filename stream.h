@@ -0,0 +1,91 @@
+/**
+ * File: stream.h
+ * --------------
+ *  This file defines streaming execution for glc-exec. Invocations are
+ *  read, run and written a block at a time, so memory stays bounded
+ *  whatever the size of the input. A reader thread fills blocks, the
+ *  calling thread runs them on the scheduler's workers, and a writer
+ *  thread drains their results. With two or three blocks in flight the
+ *  three overlap.
+ *
+ *  Input is text records, one invocation per line as for -finput, or a
+ *  column stream (see columns.h). Output is "Result:" lines or a column
+ *  stream of the results.
+ */
+
+#ifndef _H_Stream
+#define _H_Stream
+
+#include <stdio.h>
+#include <pthread.h>
+#include <deque>
+#include <vector>
+#include "executor.h"
+
+using namespace std;
+
+// Columns for up to a block's worth of invocations
+struct Block {
+    vector<char*> columns;
+    char         *results;
+    size_t        rows;
+};
+
+// A blocking queue of blocks handed from one thread to the next
+class BlockQueue {
+  public:
+    BlockQueue();
+    ~BlockQueue();
+
+    void Push(Block *b);
+    // NULL once the queue is closed and empty
+    Block *Pop();
+    void Close();
+
+  private:
+    pthread_mutex_t lock;
+    pthread_cond_t  ready;
+    deque<Block*>   blocks;
+    bool            closed;
+};
+
+class StreamRunner {
+  public:
+    StreamRunner(Executor &exec, size_t blockRows, int buffers);
+    ~StreamRunner();
+
+    // Runs every invocation of in, writing results to out as text or as
+    // a column stream. False on a malformed input or a failed write.
+    bool Run(Scheduler &sched, FILE *in, FILE *out, bool binaryOut);
+
+    size_t NumInvocations() const { return total; }
+    double GetRunSeconds() const { return runSeconds; }
+    size_t GetBufferBytes() const { return bufferBytes; }
+
+  private:
+    Executor      &exec;
+    size_t         blockRows;
+    vector<Block>  blocks;
+    BlockQueue     empty, full, done;
+    size_t         bufferBytes;
+
+    FILE          *in, *out;
+    bool           binaryIn, binaryOut;
+    pthread_mutex_t failLock;
+    bool           failed;      // set by the reader or the writer, under failLock
+    uint64_t       pending;     // rows of the next stream block, whose count is read
+    size_t         total;
+    double         runSeconds;
+    int            lineno;
+
+    static void *ReaderMain(void *self);
+    static void *WriterMain(void *self);
+    void Fail();
+    bool Failed();
+    bool ReadText(Block &b);
+    bool ReadBinary(Block &b);
+    bool CheckHeader();
+    void Write(Block &b);
+};
+
+#endif
@@ -9,7 +9,7 @@
 #include "ast_decl.h"
 
 SymbolTable::SymbolTable() {
-  map<string, llvm::Value*> s;
+  scope s;
   vector<scope> vec;
   sv = vec;
   sv.push_back(s);
@@ -26,24 +26,41 @@ void SymbolTable::Pop() {
   sv.pop_back();
 }
 
-void SymbolTable::AddSymbol(string id, llvm::Value *val) {
+void SymbolTable::AddSymbol(string id, llvm::Value *val, Type *type, llvm::Constant *constant) {
   scope *s = &sv.back();
-  s->insert(pair<string, llvm::Value*>(id,val));
+  s->insert(pair<string, Symbol>(id, Symbol(val, type, constant)));
 }
 
 llvm::Value *SymbolTable::LookUpValue(string id) {
-  llvm::Value* val = NULL;
   for(vector<scope>::reverse_iterator it = sv.rbegin(); it != sv.rend(); it++) {
-    scope* s = &(*it);
-    val = LookUpHelper(id, s);
-    if(val != NULL)
-      break;
+    Symbol *sym = LookUpHelper(id, &(*it));
+    if(sym != NULL)
+      return sym->value;
   }
-  return val;
+  return NULL;
+}
+
+Type *SymbolTable::LookUpType(string id) {
+  for(vector<scope>::reverse_iterator it = sv.rbegin(); it != sv.rend(); it++) {
+    Symbol *sym = LookUpHelper(id, &(*it));
+    if(sym != NULL)
+      return sym->type;
+  }
+  return NULL;
+}
+
+llvm::Constant *SymbolTable::LookUpConstant(string id) {
+  for(vector<scope>::reverse_iterator it = sv.rbegin(); it != sv.rend(); it++) {
+    Symbol *sym = LookUpHelper(id, &(*it));
+    if(sym != NULL)
+      return sym->constant;
+  }
+  return NULL;
 }
 
-llvm::Value *SymbolTable::LookUpHelper(string id, scope *s) {
-  if(s->count(id) > 0)
-    return s->at(id);
+Symbol *SymbolTable::LookUpHelper(string id, scope *s) {
+  scope::iterator it = s->find(id);
+  if(it != s->end())
+    return &it->second;
   return NULL;
 }
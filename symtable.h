@@ -19,7 +19,17 @@
 
 using namespace std;
 
-typedef map<string, llvm::Value*> scope;
+// a declared name: its storage, the source type it was declared with and,
+// for consts, the folded value every use is replaced with
+struct Symbol {
+  llvm::Value *value;
+  Type *type;
+  llvm::Constant *constant;
+
+  Symbol(llvm::Value *v = NULL, Type *t = NULL, llvm::Constant *c = NULL) : value(v), type(t), constant(c) {}
+};
+
+typedef map<string, Symbol> scope;
 
 class SymbolTable {
 
@@ -35,9 +45,11 @@ class SymbolTable {
 
     void Push(scope *s);
     void Pop();
-    void AddSymbol(string id, llvm::Value *val);
+    void AddSymbol(string id, llvm::Value *val, Type *type = NULL, llvm::Constant *constant = NULL);
     llvm::Value *LookUpValue(string id);
-    llvm::Value *LookUpHelper(string id, scope *s);
+    Type *LookUpType(string id);
+    llvm::Constant *LookUpConstant(string id);
+    Symbol *LookUpHelper(string id, scope *s);
 };
 
 #endif
@@ -11,6 +11,7 @@
 using std::vector;
 
 static vector<const char*> debugKeys;
+static vector<const char*> optionNames, optionValues;
 static const int BufferSize = 2048;
 
 void Failure(const char *format, ...) {
@@ -58,19 +59,53 @@ void PrintDebug(const char *key, const char *format, ...) {
   printf("+++ (%s): %s%s", key, buf, buf[strlen(buf)-1] != '\n'? "\n" : "");
 }
 
-void ParseCommandLine(int argc, char *argv[]) {
-  if (argc == 1)
-    return;
-  
-  if (strcmp(argv[1], "-d") != 0) { // first arg is not -d
-    printf("Incorrect Use:   ");
-    for (int i = 1; i < argc; i++) printf("%s ", argv[i]);
-    printf("\n");
-    printf("Correct Usage:   -d <debug-key-1> <debug-key-2> ... \n");
-    exit(2);
+static int OptionIndex(const char *name) {
+  for (unsigned int i = 0; i < optionNames.size(); i++)
+    if (!strcmp(optionNames[i], name))
+      return i;
+
+  return -1;
+}
+
+const char *GetOption(const char *name) {
+  int k = OptionIndex(name);
+  return k == -1 ? NULL : optionValues[k];
+}
+
+bool IsOptionOn(const char *name) {
+  return (OptionIndex(name) != -1);
+}
+
+void SetOption(const char *name, const char *value) {
+  int k = OptionIndex(name);
+  if (k == -1) {
+    optionNames.push_back(name);
+    optionValues.push_back(value);
   }
+  else
+    optionValues[k] = value;
+}
 
-  for (int i = 2; i < argc; i++)
-    SetDebugForKey(argv[i], true);
+void ParseCommandLine(int argc, char *argv[]) {
+  bool debug = false;
+  for (int i = 1; i < argc; i++) {
+    if (!strncmp(argv[i], "-f", 2) && argv[i][2] != '\0') { // -fname[=value]
+      char *name = strdup(argv[i] + 2);
+      char *eq = strchr(name, '=');
+      if (eq) *eq = '\0';
+      SetOption(name, eq ? eq + 1 : "");
+    }
+    else if (!strcmp(argv[i], "-d"))
+      debug = true;
+    else if (debug)
+      SetDebugForKey(argv[i], true);
+    else {
+      printf("Incorrect Use:   ");
+      for (int j = 1; j < argc; j++) printf("%s ", argv[j]);
+      printf("\n");
+      printf("Correct Usage:   [-f<option>[=<value>] ...] [-d <debug-key-1> <debug-key-2> ...] \n");
+      exit(2);
+    }
+  }
 }
 
@@ -73,12 +73,40 @@ void SetDebugForKey(const char *key, bool val);
 
 bool IsDebugOn(const char *key);
 
+/**
+ * Function: GetOption()
+ * Usage: const char *entry = GetOption("entry");
+ * ----------------------------------------------
+ * Return the value given to -f<name>=<value> on the command line, "" if
+ * the option was given without a value, or NULL if it was not given.
+ */
+
+const char *GetOption(const char *name);
+
+/**
+ * Function: IsOptionOn()
+ * Usage: if (IsOptionOn("ssa")) ...
+ * ---------------------------------
+ * Return true/false based on whether -f<name> was given.
+ */
+
+bool IsOptionOn(const char *name);
+
+/**
+ * Function: SetOption()
+ * Usage: SetOption("ssa", "");
+ * ----------------------------
+ * Set a compiler option as if -f<name>=<value> had been passed.
+ */
+
+void SetOption(const char *name, const char *value);
+
 /**
  * Function: ParseCommandLine
  * --------------------------
- * Turn on the debugging flags from the command line.  Verifies that
- * first argument is -d, and then interpret all the arguments that follow
- * as being flags to turn on.
+ * Turn on compiler options and debugging flags from the command line.
+ * Arguments of the form -f<name>[=<value>] set options; everything after
+ * a -d is interpreted as a debug key to turn on.
  */
 
 void ParseCommandLine(int argc, char *argv[]);